@@ -0,0 +1,747 @@
+#include "TexasGUI/BCnDecoder.hpp"
+#include "TexasGUI/BCnEncoder.hpp"
+#include "TexasGUI/FileOutputStream.hpp"
+#include "TexasGUI/FormatConverter.hpp"
+#include "TexasGUI/KTXWriter.hpp"
+#include "TexasGUI/MipGenerator.hpp"
+#include "TexasGUI/SimdKernels.hpp"
+#include "TexasGUI/TextureKernels.hpp"
+
+#include "Texas/Texas.hpp"
+#include "Texas/Tools.hpp"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDateTime>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSysInfo>
+#include <QTemporaryDir>
+#include <QThreadPool>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+namespace
+{
+	// The stream KTX export used before FileOutputStream, kept to compare against.
+	// Every write goes straight to QDataStream and sizes are truncated to int.
+	struct QDataStreamOutputStream : Texas::OutputStream
+	{
+		QFile file;
+		QDataStream stream;
+
+		virtual Texas::Result write(char const* data, std::uint64_t size) noexcept override
+		{
+			stream.writeRawData(data, static_cast<int>(size));
+
+			return { Texas::ResultType::Success, nullptr };
+		}
+	};
+
+	// The MinMaxData layout from before it was flattened, kept to compare against.
+	// Every subresource stores all three types for 4 channels, in a vector per mip.
+	struct LegacyMinMaxData
+	{
+		struct A
+		{
+			std::int64_t max_int64[4];
+			std::int64_t min_int64[4];
+			std::uint64_t max_uint64[4];
+			std::uint64_t min_uint64[4];
+			double max_float64[4];
+			double min_float64[4];
+		};
+		struct B
+		{
+			std::vector<A> layers;
+		};
+		std::vector<B> mipLevels;
+	};
+
+	struct SyntheticTexture
+	{
+		Texas::TextureInfo texInfo{};
+		std::vector<std::byte> buffer;
+
+		[[nodiscard]] Texas::ConstByteSpan span() const
+		{
+			return Texas::ConstByteSpan(buffer.data(), buffer.size());
+		}
+	};
+
+	[[nodiscard]] SyntheticTexture makeTexture(
+		Texas::PixelFormat pixelFormat,
+		std::uint64_t width,
+		std::uint64_t height,
+		std::uint64_t mipCount,
+		std::uint64_t layerCount)
+	{
+		SyntheticTexture texture;
+		texture.texInfo.textureType = layerCount > 1 ? Texas::TextureType::Array2D : Texas::TextureType::Texture2D;
+		texture.texInfo.pixelFormat = pixelFormat;
+		texture.texInfo.channelType = Texas::ChannelType::UnsignedNormalized;
+		texture.texInfo.colorSpace = Texas::ColorSpace::Linear;
+		texture.texInfo.baseDimensions = Texas::Dimensions{ width, height, 1 };
+		texture.texInfo.mipCount = mipCount;
+		texture.texInfo.layerCount = layerCount;
+
+		texture.buffer.resize(Texas::calculateTotalSize(texture.texInfo));
+		// Cheap xorshift noise, so min/max can't bail out early on constant data.
+		std::uint32_t state = 0x9E3779B9u;
+		for (std::byte& value : texture.buffer)
+		{
+			state ^= state << 13;
+			state ^= state >> 17;
+			state ^= state << 5;
+			value = static_cast<std::byte>(state);
+		}
+		return texture;
+	}
+
+	// Timings of the runs after the warm-up ones, in milliseconds.
+	struct Summary
+	{
+		int repetitions = 0;
+		double min = 0;
+		double max = 0;
+		double mean = 0;
+		double median = 0;
+		// Of the sample, so a single run has none.
+		double stddev = 0;
+		// Nearest rank.
+		double p90 = 0;
+	};
+
+	template<typename Func>
+	[[nodiscard]] Summary measure(Func const& func, int warmups, int repetitions)
+	{
+		for (int i = 0; i < warmups; i++)
+			func();
+		std::vector<double> times;
+		for (int i = 0; i < std::max(repetitions, 1); i++)
+		{
+			auto start = std::chrono::steady_clock::now();
+			func();
+			auto end = std::chrono::steady_clock::now();
+			times.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+		}
+		std::sort(times.begin(), times.end());
+
+		Summary summary;
+		std::size_t const count = times.size();
+		summary.repetitions = static_cast<int>(count);
+		summary.min = times.front();
+		summary.max = times.back();
+		summary.median = count % 2 == 1 ? times[count / 2] : (times[count / 2 - 1] + times[count / 2]) / 2.0;
+		summary.p90 = times[static_cast<std::size_t>(std::ceil(0.9 * static_cast<double>(count))) - 1];
+		double sum = 0.0;
+		for (double time : times)
+			sum += time;
+		summary.mean = sum / static_cast<double>(count);
+		if (count > 1)
+		{
+			double squaredDeviations = 0.0;
+			for (double time : times)
+				squaredDeviations += (time - summary.mean) * (time - summary.mean);
+			summary.stddev = std::sqrt(squaredDeviations / static_cast<double>(count - 1));
+		}
+		return summary;
+	}
+
+	// Median of a few runs after one warm-up run, in milliseconds.
+	template<typename Func>
+	[[nodiscard]] double timeMedian(Func const& func, int repetitions = 5)
+	{
+		return measure(func, 1, repetitions).median;
+	}
+
+	void benchFindMinMaxScaling(char const* name, SyntheticTexture const& texture)
+	{
+		int const maxThreads = std::max(QThreadPool::globalInstance()->maxThreadCount(), 1);
+		double const megabytes = static_cast<double>(texture.buffer.size()) / (1024.0 * 1024.0);
+
+		std::printf("FindMinMaxValues, %s (%.1f MiB)\n", name, megabytes);
+		std::printf("  %8s %12s %12s %10s\n", "threads", "ms", "GiB/s", "speedup");
+
+		double serialTime = 0.0;
+		for (int threadCount = 1; ; threadCount = std::min(threadCount * 2, maxThreads))
+		{
+			double time = timeMedian([&]()
+			{
+				TexasGUI::MinMaxData minMaxData;
+				TexasGUI::FindMinMaxValues(texture.texInfo, texture.span(), minMaxData, nullptr, threadCount);
+			});
+			if (threadCount == 1)
+				serialTime = time;
+
+			std::printf("  %8d %12.3f %12.2f %9.2fx\n",
+				threadCount,
+				time,
+				megabytes / 1024.0 / (time / 1000.0),
+				serialTime / time);
+
+			if (threadCount == maxThreads)
+				break;
+		}
+		std::printf("\n");
+	}
+
+	// Keeps the lookups below from being optimized away.
+	std::uint64_t volatile minMaxLookupSink = 0;
+
+	// Memory taken by the min/max of an RGBA_8 texture with lots of subresources, and the cost of looking
+	// every one of them up in a scattered order, like scrubbing through layers does.
+	void benchMinMaxStorage(std::uint64_t mipCount, std::uint64_t layerCount)
+	{
+		constexpr std::uint8_t channelCount = 4;
+		std::uint64_t const subresourceCount = mipCount * layerCount;
+
+		// An odd stride visits each of a power of two subresources once, every one far from the last.
+		std::vector<std::uint64_t> order(subresourceCount);
+		for (std::uint64_t i = 0; i < subresourceCount; i++)
+			order[i] = (i * 7919) % subresourceCount;
+
+		LegacyMinMaxData legacy;
+		legacy.mipLevels.resize(mipCount);
+		for (auto& mipLevel : legacy.mipLevels)
+			mipLevel.layers.resize(layerCount, LegacyMinMaxData::A{});
+		std::uint64_t const legacyBytes =
+			sizeof(LegacyMinMaxData::B) * mipCount + sizeof(LegacyMinMaxData::A) * subresourceCount;
+
+		TexasGUI::MinMaxData minMaxData;
+		minMaxData.reset(TexasGUI::MinMaxData::Type::UnsignedInt, channelCount, mipCount, layerCount);
+		std::uint64_t const flatBytes = sizeof(TexasGUI::MinMaxData::Value) * minMaxData.values.size();
+
+		std::uint64_t sum = 0;
+		double const legacyTime = timeMedian([&]()
+		{
+			for (std::uint64_t index : order)
+			{
+				auto const& layer = legacy.mipLevels[index / layerCount].layers[index % layerCount];
+				for (std::uint8_t i = 0; i < channelCount; i++)
+					sum += layer.min_uint64[i] + layer.max_uint64[i];
+			}
+		});
+		double const flatTime = timeMedian([&]()
+		{
+			for (std::uint64_t index : order)
+			{
+				TexasGUI::MinMaxData::Value const* min = minMaxData.min(index / layerCount, index % layerCount);
+				TexasGUI::MinMaxData::Value const* max = min + channelCount;
+				for (std::uint8_t i = 0; i < channelCount; i++)
+					sum += min[i].uint64 + max[i].uint64;
+			}
+		});
+
+		std::printf("  %-8s %12.2f %12.2f\n", "legacy",
+			static_cast<double>(legacyBytes) / (1024.0 * 1024.0),
+			legacyTime * 1e6 / static_cast<double>(subresourceCount));
+		std::printf("  %-8s %12.2f %12.2f\n", "flat",
+			static_cast<double>(flatBytes) / (1024.0 * 1024.0),
+			flatTime * 1e6 / static_cast<double>(subresourceCount));
+		minMaxLookupSink = sum;
+	}
+
+	void benchBCnDecode(char const* name, SyntheticTexture const& texture)
+	{
+		Texas::Dimensions const dimensions = texture.texInfo.baseDimensions;
+		double const megapixels = static_cast<double>(dimensions.width * dimensions.height) / 1e6;
+		std::vector<unsigned char> decoded(dimensions.width * dimensions.height * 4);
+
+		double time = timeMedian([&]()
+		{
+			TexasGUI::BCn::decodeSubresourceToRGBA8(texture.texInfo, texture.span(), 0, 0, decoded.data());
+		});
+		std::printf("  %-10s %12.3f %12.1f\n", name, time, megapixels / (time / 1000.0));
+	}
+
+	void benchBCnEncode(char const* name, Texas::PixelFormat targetFormat, SyntheticTexture const& texture)
+	{
+		Texas::Dimensions const dimensions = texture.texInfo.baseDimensions;
+		double const megapixels = static_cast<double>(dimensions.width * dimensions.height) / 1e6;
+
+		for (std::size_t i = 0; i < static_cast<std::size_t>(TexasGUI::BCn::EncodeQuality::COUNT); i += 1)
+		{
+			TexasGUI::BCn::EncodeQuality quality = static_cast<TexasGUI::BCn::EncodeQuality>(i);
+			// The slower tiers take long enough that a single run is stable.
+			double time = timeMedian([&]()
+			{
+				Texas::TextureInfo dstInfo;
+				std::vector<std::byte> dstData;
+				TexasGUI::BCn::encodeTexture(texture.texInfo, texture.span(), targetFormat, quality, dstInfo, dstData);
+			}, quality >= TexasGUI::BCn::EncodeQuality::High ? 1 : 5);
+			std::printf("  %-10s %-10s %12.3f %12.2f\n", name, TexasGUI::BCn::toString(quality), time, megapixels / (time / 1000.0));
+		}
+	}
+
+	void benchMipGeneration(char const* name, SyntheticTexture const& texture)
+	{
+		Texas::Dimensions const dimensions = texture.texInfo.baseDimensions;
+		double const megapixels = static_cast<double>(dimensions.width * dimensions.height * texture.texInfo.layerCount) / 1e6;
+
+		for (std::size_t i = 0; i < static_cast<std::size_t>(TexasGUI::Mips::Filter::COUNT); i += 1)
+		{
+			TexasGUI::Mips::Filter filter = static_cast<TexasGUI::Mips::Filter>(i);
+			double time = timeMedian([&]()
+			{
+				Texas::TextureInfo dstInfo;
+				std::vector<std::byte> dstData;
+				TexasGUI::Mips::generateMipChain(texture.texInfo, texture.span(), filter, dstInfo, dstData);
+			}, 3);
+			std::printf("  %-24s %-10s %12.1f %12.1f\n", name, TexasGUI::Mips::toString(filter), time, megapixels / (time / 1000.0));
+		}
+	}
+
+	// Scalar against whatever the CPU has, on every thread.
+	void benchFormatConversion(char const* name, SyntheticTexture const& texture, Texas::PixelFormat pixelFormat, Texas::ChannelType channelType)
+	{
+		Texas::Dimensions const dimensions = texture.texInfo.baseDimensions;
+		double const megapixels = static_cast<double>(dimensions.width * dimensions.height * texture.texInfo.layerCount) / 1e6;
+		std::vector<std::byte> dstData;
+
+		for (TexasGUI::Simd::InstructionSet instructionSet : { TexasGUI::Simd::InstructionSet::Scalar, TexasGUI::Simd::detectInstructionSet() })
+		{
+			TexasGUI::Simd::forceInstructionSet(instructionSet);
+			double time = timeMedian([&]()
+			{
+				TexasGUI::Convert::convertMipLevel(texture.texInfo, texture.span(), 0, pixelFormat, channelType, dstData);
+			});
+			std::printf("  %-28s %-8s %12.3f %12.1f\n", name, TexasGUI::Simd::toString(instructionSet), time, megapixels / (time / 1000.0));
+		}
+		TexasGUI::Simd::forceInstructionSet(TexasGUI::Simd::detectInstructionSet());
+	}
+
+	// The sRGB kernels on their own, one thread. The in-place ones work on a copy of each row, which costs
+	// little next to the curve.
+	void benchSRGBKernels(std::uint64_t pixelCount)
+	{
+		constexpr std::uint64_t rowPixels = 4096;
+		std::vector<float> floats(pixelCount * 4);
+		std::vector<unsigned char> bytes(pixelCount * 4);
+		std::uint32_t state = 0x9E3779B9u;
+		for (std::uint64_t i = 0; i < pixelCount * 4; i++)
+		{
+			state ^= state << 13;
+			state ^= state >> 17;
+			state ^= state << 5;
+			floats[i] = static_cast<float>(state >> 8) / 16777216.f;
+			bytes[i] = static_cast<unsigned char>(state);
+		}
+		std::vector<float> row(rowPixels * 4);
+		std::vector<float> floatsOut(pixelCount * 4);
+		std::vector<unsigned char> bytesOut(pixelCount * 4);
+
+		auto inPlace = [&](void(*kernel)(float*, std::uint64_t))
+		{
+			return [&, kernel]()
+			{
+				for (std::uint64_t first = 0; first < pixelCount; first += rowPixels)
+				{
+					std::uint64_t const count = std::min(rowPixels, pixelCount - first);
+					std::copy_n(floats.data() + first * 4, count * 4, row.data());
+					kernel(row.data(), count);
+				}
+			};
+		};
+		auto decode = inPlace(&TexasGUI::Simd::decodeSRGBRGBA32F);
+		auto encode = inPlace(&TexasGUI::Simd::encodeSRGBRGBA32F);
+		auto decode8 = [&]() { TexasGUI::Simd::decodeSRGBRGBA8ToRGBA32F(bytes.data(), pixelCount, floatsOut.data()); };
+		auto encode8 = [&]() { TexasGUI::Simd::encodeSRGBRGBA32FToRGBA8(floats.data(), pixelCount, bytesOut.data()); };
+
+		struct Kernel
+		{
+			char const* name;
+			std::function<void()> run;
+		};
+		Kernel const kernels[] = {
+			{ "RGBA_32F decode", decode },
+			{ "RGBA_32F encode", encode },
+			{ "RGBA_8 -> RGBA_32F decode", decode8 },
+			{ "RGBA_32F -> RGBA_8 encode", encode8 } };
+		for (Kernel const& kernel : kernels)
+		{
+			for (TexasGUI::Simd::InstructionSet instructionSet : { TexasGUI::Simd::InstructionSet::Scalar, TexasGUI::Simd::detectInstructionSet() })
+			{
+				TexasGUI::Simd::forceInstructionSet(instructionSet);
+				double time = timeMedian(kernel.run);
+				std::printf("  %-28s %-8s %12.3f %12.3f\n", kernel.name, TexasGUI::Simd::toString(instructionSet), time,
+					static_cast<double>(pixelCount) / 1e9 / (time / 1000.0));
+			}
+		}
+		TexasGUI::Simd::forceInstructionSet(TexasGUI::Simd::detectInstructionSet());
+	}
+
+	void benchKTXExport(char const* name, SyntheticTexture const& texture)
+	{
+		QTemporaryDir directory;
+		QString const path = directory.filePath("bench.ktx");
+		double const megabytes = static_cast<double>(texture.buffer.size()) / (1024.0 * 1024.0);
+
+		double time = timeMedian([&]()
+		{
+			QDataStreamOutputStream stream;
+			stream.file.setFileName(path);
+			stream.file.open(QIODevice::OpenModeFlag::WriteOnly);
+			stream.stream.setDevice(&stream.file);
+			stream.stream.setByteOrder(QDataStream::LittleEndian);
+			static_cast<void>(TexasGUI::KTX::saveToStream(texture.texInfo, texture.span(), stream));
+			stream.file.close();
+		}, 3);
+		std::printf("  %-16s %-18s %12.1f %12.1f\n", name, "QDataStream", time, megabytes / (time / 1000.0));
+
+		time = timeMedian([&]()
+		{
+			TexasGUI::FileOutputStream stream;
+			if (stream.open(path).isSuccessful())
+			{
+				static_cast<void>(TexasGUI::KTX::saveToStream(texture.texInfo, texture.span(), stream));
+				static_cast<void>(stream.close());
+			}
+		}, 3);
+		std::printf("  %-16s %-18s %12.1f %12.1f\n", name, "FileOutputStream", time, megabytes / (time / 1000.0));
+	}
+
+	// The regression suite: the same kernels and I/O paths on the same synthetic textures every release,
+	// so the JSON of two builds can be compared line by line.
+	struct SuiteOptions
+	{
+		int warmups = 2;
+		int repetitions = 10;
+		// Only cases whose "kernel, format, shape" contains this, ignoring case.
+		QString filter{};
+	};
+
+	struct SuiteFormat
+	{
+		char const* name;
+		Texas::PixelFormat pixelFormat;
+		Texas::ChannelType channelType;
+	};
+
+	constexpr SuiteFormat suiteFormats[] = {
+		{ "R_8", Texas::PixelFormat::R_8, Texas::ChannelType::UnsignedNormalized },
+		{ "RGB_8", Texas::PixelFormat::RGB_8, Texas::ChannelType::UnsignedNormalized },
+		{ "RGBA_8", Texas::PixelFormat::RGBA_8, Texas::ChannelType::UnsignedNormalized },
+		{ "RGBA_8 sRGB", Texas::PixelFormat::RGBA_8, Texas::ChannelType::sRGB },
+		{ "RGBA_16", Texas::PixelFormat::RGBA_16, Texas::ChannelType::UnsignedNormalized },
+		{ "RGBA_16F", Texas::PixelFormat::RGBA_16, Texas::ChannelType::SignedFloat },
+		{ "RGBA_32F", Texas::PixelFormat::RGBA_32, Texas::ChannelType::SignedFloat },
+		{ "BC1", Texas::PixelFormat::BC1_RGBA, Texas::ChannelType::UnsignedNormalized },
+		{ "BC7", Texas::PixelFormat::BC7_RGBA, Texas::ChannelType::UnsignedNormalized } };
+
+	struct SuiteShape
+	{
+		char const* name;
+		std::uint64_t size;
+		bool fullMipChain;
+		std::uint64_t layerCount;
+	};
+
+	constexpr SuiteShape suiteShapes[] = {
+		{ "256x256, all mips", 256, true, 1 },
+		{ "1024x1024, all mips", 1024, true, 1 },
+		{ "4096x4096", 4096, false, 1 },
+		{ "512x512, all mips, 32 layers", 512, true, 32 } };
+
+	struct SuiteResult
+	{
+		char const* kernel;
+		SuiteFormat const* format;
+		SuiteShape const* shape;
+		Texas::TextureInfo texInfo{};
+		std::uint64_t bytes = 0;
+		Summary summary{};
+	};
+
+	// What the loading tab does, the file is mapped and Texas parses out of the mapping.
+	[[nodiscard]] bool loadMapped(QString const& path)
+	{
+		QFile file(path);
+		file.open(QFile::ReadOnly);
+		uchar const* mappedFile = file.isOpen() ? file.map(0, file.size()) : nullptr;
+		if (mappedFile == nullptr)
+			return false;
+		Texas::ResultValue<Texas::Texture> loadResult = Texas::loadFromBuffer(Texas::ConstByteSpan(
+			reinterpret_cast<std::byte const*>(mappedFile),
+			static_cast<std::size_t>(file.size())));
+		file.unmap(const_cast<uchar*>(mappedFile));
+		return loadResult.isSuccessful();
+	}
+
+	void runSuite(SuiteOptions const& options, std::vector<SuiteResult>& results)
+	{
+		QTemporaryDir directory;
+		QString const path = directory.filePath("suite.ktx");
+		QByteArray const nativePath = QFile::encodeName(path);
+
+		std::printf("Regression suite, %d warm-up and %d timed runs each\n", options.warmups, options.repetitions);
+		std::printf("  %-36s %-36s %10s %10s %8s %10s\n", "kernel", "texture", "median ms", "p90 ms", "stddev", "MiB/s");
+		for (SuiteShape const& shape : suiteShapes)
+		{
+			for (SuiteFormat const& format : suiteFormats)
+			{
+				Texas::Dimensions const baseDimensions{ shape.size, shape.size, 1 };
+				std::uint64_t const mipCount = shape.fullMipChain ? TexasGUI::Mips::fullMipCount(baseDimensions) : 1;
+				SyntheticTexture texture = makeTexture(format.pixelFormat, shape.size, shape.size, mipCount, shape.layerCount);
+				texture.texInfo.channelType = format.channelType;
+				texture.texInfo.colorSpace = format.channelType == Texas::ChannelType::sRGB ? Texas::ColorSpace::sRGB : Texas::ColorSpace::Linear;
+				QString const textureName = QString(format.name) + ", " + shape.name;
+
+				auto run = [&](char const* kernel, auto const& func)
+				{
+					if (!options.filter.isEmpty() && !(QString(kernel) + ", " + textureName).contains(options.filter, Qt::CaseInsensitive))
+						return;
+					SuiteResult result;
+					result.kernel = kernel;
+					result.format = &format;
+					result.shape = &shape;
+					result.texInfo = texture.texInfo;
+					result.bytes = texture.buffer.size();
+					result.summary = measure(func, options.warmups, options.repetitions);
+					std::printf("  %-36s %-36s %10.3f %10.3f %7.1f%% %10.1f\n",
+						kernel,
+						qPrintable(textureName),
+						result.summary.median,
+						result.summary.p90,
+						result.summary.stddev * 100.0 / result.summary.mean,
+						static_cast<double>(result.bytes) / (1024.0 * 1024.0) / (result.summary.median / 1000.0));
+					results.push_back(result);
+				};
+
+				// Nothing is gathered for block compressed formats.
+				if (!TexasGUI::BCn::isBlockCompressed(format.pixelFormat))
+				{
+					run("FindMinMaxValues", [&]()
+					{
+						TexasGUI::MinMaxData minMaxData;
+						TexasGUI::FindMinMaxValues(texture.texInfo, texture.span(), minMaxData);
+					});
+				}
+				// What opening a file runs, and what scrubbing through every subresource adds to that.
+				run("FindMinMaxValuesAndBuildDisplayable", [&]()
+				{
+					TexasGUI::MinMaxData minMaxData;
+					QByteArray displayData;
+					TexasGUI::FindMinMaxValuesAndBuildDisplayable(texture.texInfo, texture.span(), minMaxData, 0, 0, displayData);
+				});
+				run("BuildDisplayableSubresource, all", [&]()
+				{
+					QByteArray displayData;
+					for (std::uint64_t mipIndex = 0; mipIndex < texture.texInfo.mipCount; mipIndex++)
+					{
+						for (std::uint64_t layerIndex = 0; layerIndex < texture.texInfo.layerCount; layerIndex++)
+							TexasGUI::BuildDisplayableSubresource(texture.texInfo, texture.span(), mipIndex, layerIndex, displayData);
+					}
+				});
+
+				if (!TexasGUI::KTX::canSave(texture.texInfo).isSuccessful())
+					continue;
+				auto save = [&]()
+				{
+					TexasGUI::FileOutputStream stream;
+					Texas::Result result = stream.open(path);
+					if (result.isSuccessful())
+						result = TexasGUI::KTX::saveToStream(texture.texInfo, texture.span(), stream);
+					Texas::Result closeResult = stream.close();
+					return result.isSuccessful() && closeResult.isSuccessful();
+				};
+				run("KTX::saveToStream", save);
+
+				// Loads read the file back out of the page cache, this is parsing and copying, not the disk.
+				if (!save() || !Texas::loadFromPath(nativePath.constData()).isSuccessful())
+				{
+					std::printf("  %-36s %-36s %10s\n", "Texas::loadFromPath", qPrintable(textureName), "failed");
+					continue;
+				}
+				run("Texas::loadFromPath", [&]()
+				{
+					static_cast<void>(Texas::loadFromPath(nativePath.constData()));
+				});
+				run("Texas::loadFromBuffer, mapped", [&]()
+				{
+					static_cast<void>(loadMapped(path));
+				});
+			}
+		}
+		std::printf("\n");
+	}
+
+	[[nodiscard]] bool writeJson(QString const& path, SuiteOptions const& options, std::vector<SuiteResult> const& results)
+	{
+		QJsonObject machine;
+		machine["os"] = QSysInfo::prettyProductName();
+		machine["cpuArchitecture"] = QSysInfo::currentCpuArchitecture();
+		machine["instructionSet"] = TexasGUI::Simd::toString(TexasGUI::Simd::detectInstructionSet());
+		machine["threads"] = QThreadPool::globalInstance()->maxThreadCount();
+		machine["qtVersion"] = qVersion();
+
+		QJsonArray jsonResults;
+		for (SuiteResult const& result : results)
+		{
+			QJsonObject timings;
+			timings["min"] = result.summary.min;
+			timings["max"] = result.summary.max;
+			timings["mean"] = result.summary.mean;
+			timings["median"] = result.summary.median;
+			timings["stddev"] = result.summary.stddev;
+			timings["p90"] = result.summary.p90;
+
+			QJsonObject jsonResult;
+			jsonResult["kernel"] = result.kernel;
+			jsonResult["format"] = result.format->name;
+			jsonResult["width"] = static_cast<qint64>(result.texInfo.baseDimensions.width);
+			jsonResult["height"] = static_cast<qint64>(result.texInfo.baseDimensions.height);
+			jsonResult["mipCount"] = static_cast<qint64>(result.texInfo.mipCount);
+			jsonResult["layerCount"] = static_cast<qint64>(result.texInfo.layerCount);
+			jsonResult["bytes"] = static_cast<qint64>(result.bytes);
+			jsonResult["repetitions"] = result.summary.repetitions;
+			jsonResult["milliseconds"] = timings;
+			jsonResult["mibPerSecond"] = static_cast<double>(result.bytes) / (1024.0 * 1024.0) / (result.summary.median / 1000.0);
+			jsonResults.append(jsonResult);
+		}
+
+		QJsonObject root;
+		// Bumped whenever a field changes meaning, so old results aren't compared against new ones by mistake.
+		root["schemaVersion"] = 1;
+		root["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+		root["machine"] = machine;
+		root["warmups"] = options.warmups;
+		root["repetitions"] = options.repetitions;
+		root["results"] = jsonResults;
+
+		QFile file(path);
+		if (!file.open(QFile::WriteOnly | QFile::Truncate))
+			return false;
+		QByteArray const json = QJsonDocument(root).toJson(QJsonDocument::Indented);
+		return file.write(json) == json.size();
+	}
+}
+
+int main(int argc, char** argv)
+{
+	QCoreApplication app(argc, argv);
+	QCoreApplication::setApplicationName("texas_bench");
+
+	QCommandLineParser parser;
+	parser.setApplicationDescription("Benchmarks the texture kernels and I/O paths on synthetic textures.");
+	parser.addHelpOption();
+	QCommandLineOption jsonOption("json", "Also write the regression suite's results to this file as JSON.", "file");
+	QCommandLineOption suiteOnlyOption("suite-only", "Only run the regression suite, not the comparisons against older implementations and instruction sets.");
+	QCommandLineOption warmupsOption("warmups", "Untimed runs before each suite case.", "N", "2");
+	QCommandLineOption repetitionsOption("repetitions", "Timed runs of each suite case.", "N", "10");
+	QCommandLineOption filterOption("filter", "Only run the suite cases whose kernel, format or shape contains this.", "text");
+	parser.addOptions({ jsonOption, suiteOnlyOption, warmupsOption, repetitionsOption, filterOption });
+	parser.process(app);
+
+	SuiteOptions suiteOptions;
+	bool warmupsValid = false;
+	suiteOptions.warmups = parser.value(warmupsOption).toInt(&warmupsValid);
+	bool repetitionsValid = false;
+	suiteOptions.repetitions = parser.value(repetitionsOption).toInt(&repetitionsValid);
+	if (!warmupsValid || suiteOptions.warmups < 0 || !repetitionsValid || suiteOptions.repetitions < 1)
+	{
+		std::fprintf(stderr, "--warmups must be 0 or more and --repetitions at least 1.\n");
+		return 1;
+	}
+	suiteOptions.filter = parser.value(filterOption);
+
+	if (!parser.isSet(suiteOnlyOption))
+	{
+		benchFindMinMaxScaling("RGBA_8 8192x8192, 14 mips", makeTexture(Texas::PixelFormat::RGBA_8, 8192, 8192, 14, 1));
+		benchFindMinMaxScaling("RGB_8 4096x4096, 13 mips", makeTexture(Texas::PixelFormat::RGB_8, 4096, 4096, 13, 1));
+		benchFindMinMaxScaling("RGBA_8 256x256, 9 mips, 2048 layers", makeTexture(Texas::PixelFormat::RGBA_8, 256, 256, 9, 2048));
+
+		std::printf("MinMaxData storage, RGBA_8, 16 mips, 65536 layers\n");
+		std::printf("  %-8s %12s %12s\n", "layout", "MiB", "ns/lookup");
+		benchMinMaxStorage(16, 65536);
+		std::printf("\n");
+
+		// Random bytes are valid blocks for every BCn format, and hit every BC6H and BC7 mode.
+		std::printf("BCn decode to RGBA8, 4096x4096\n");
+		std::printf("  %-10s %12s %12s\n", "format", "ms", "MPix/s");
+		benchBCnDecode("BC1", makeTexture(Texas::PixelFormat::BC1_RGBA, 4096, 4096, 1, 1));
+		benchBCnDecode("BC2", makeTexture(Texas::PixelFormat::BC2_RGBA, 4096, 4096, 1, 1));
+		benchBCnDecode("BC3", makeTexture(Texas::PixelFormat::BC3_RGBA, 4096, 4096, 1, 1));
+		benchBCnDecode("BC4", makeTexture(Texas::PixelFormat::BC4, 4096, 4096, 1, 1));
+		benchBCnDecode("BC5", makeTexture(Texas::PixelFormat::BC5, 4096, 4096, 1, 1));
+		SyntheticTexture bc6h = makeTexture(Texas::PixelFormat::BC6H, 4096, 4096, 1, 1);
+		bc6h.texInfo.channelType = Texas::ChannelType::UnsignedFloat;
+		benchBCnDecode("BC6H", bc6h);
+		benchBCnDecode("BC7", makeTexture(Texas::PixelFormat::BC7_RGBA, 4096, 4096, 1, 1));
+		std::printf("\n");
+
+		std::printf("BCn encode, RGBA_8 512x512\n");
+		std::printf("  %-10s %-10s %12s %12s\n", "format", "quality", "ms", "MPix/s");
+		SyntheticTexture encodeSource = makeTexture(Texas::PixelFormat::RGBA_8, 512, 512, 1, 1);
+		benchBCnEncode("BC1", Texas::PixelFormat::BC1_RGB, encodeSource);
+		benchBCnEncode("BC3", Texas::PixelFormat::BC3_RGBA, encodeSource);
+		benchBCnEncode("BC4", Texas::PixelFormat::BC4, encodeSource);
+		benchBCnEncode("BC5", Texas::PixelFormat::BC5, encodeSource);
+		benchBCnEncode("BC7", Texas::PixelFormat::BC7_RGBA, encodeSource);
+		std::printf("\n");
+
+		// Rates are in base level pixels.
+		std::printf("Mip generation\n");
+		std::printf("  %-24s %-10s %12s %12s\n", "texture", "filter", "ms", "MPix/s");
+		SyntheticTexture srgbSource = makeTexture(Texas::PixelFormat::RGBA_8, 4096, 4096, 1, 1);
+		srgbSource.texInfo.channelType = Texas::ChannelType::sRGB;
+		srgbSource.texInfo.colorSpace = Texas::ColorSpace::sRGB;
+		benchMipGeneration("RGBA_8 sRGB 4096x4096", srgbSource);
+		SyntheticTexture floatSource = makeTexture(Texas::PixelFormat::RGBA_16, 2048, 2048, 1, 1);
+		floatSource.texInfo.channelType = Texas::ChannelType::SignedFloat;
+		benchMipGeneration("RGBA_16F 2048x2048", floatSource);
+		benchMipGeneration("RGBA_8 256x256 x256", makeTexture(Texas::PixelFormat::RGBA_8, 256, 256, 1, 256));
+		std::printf("\n");
+
+		std::printf("Format conversion, 4096x4096\n");
+		std::printf("  %-28s %-8s %12s %12s\n", "conversion", "isa", "ms", "MPix/s");
+		SyntheticTexture rgb8 = makeTexture(Texas::PixelFormat::RGB_8, 4096, 4096, 1, 1);
+		SyntheticTexture rgba8 = makeTexture(Texas::PixelFormat::RGBA_8, 4096, 4096, 1, 1);
+		SyntheticTexture rgba16 = makeTexture(Texas::PixelFormat::RGBA_16, 4096, 4096, 1, 1);
+		SyntheticTexture rgba16f = makeTexture(Texas::PixelFormat::RGBA_16, 4096, 4096, 1, 1);
+		rgba16f.texInfo.channelType = Texas::ChannelType::SignedFloat;
+		SyntheticTexture rgba32f = makeTexture(Texas::PixelFormat::RGBA_32, 4096, 4096, 1, 1);
+		rgba32f.texInfo.channelType = Texas::ChannelType::SignedFloat;
+		benchFormatConversion("RGB_8 -> RGBA_8", rgb8, Texas::PixelFormat::RGBA_8, Texas::ChannelType::UnsignedNormalized);
+		benchFormatConversion("RGBA_8 -> BGRA_8", rgba8, Texas::PixelFormat::BGRA_8, Texas::ChannelType::UnsignedNormalized);
+		benchFormatConversion("RGBA_16 -> RGBA_8", rgba16, Texas::PixelFormat::RGBA_8, Texas::ChannelType::UnsignedNormalized);
+		benchFormatConversion("RGBA_32F -> RGBA_16F", rgba32f, Texas::PixelFormat::RGBA_16, Texas::ChannelType::SignedFloat);
+		benchFormatConversion("RGBA_16F -> RGBA_32F", rgba16f, Texas::PixelFormat::RGBA_32, Texas::ChannelType::SignedFloat);
+		// No fast path, these go through RGBA floats.
+		benchFormatConversion("RGBA_32F -> RGBA_8 sRGB", rgba32f, Texas::PixelFormat::RGBA_8, Texas::ChannelType::sRGB);
+		benchFormatConversion("RGB_8 -> RG_16", rgb8, Texas::PixelFormat::RG_16, Texas::ChannelType::UnsignedNormalized);
+		std::printf("\n");
+
+		std::printf("sRGB conversion, 4M pixels, one thread\n");
+		std::printf("  %-28s %-8s %12s %12s\n", "kernel", "isa", "ms", "GPix/s");
+		benchSRGBKernels(std::uint64_t(1) << 22);
+		std::printf("\n");
+
+		std::printf("KTX export\n");
+		std::printf("  %-16s %-18s %12s %12s\n", "texture", "stream", "ms", "MiB/s");
+		benchKTXExport("1 GiB array", makeTexture(Texas::PixelFormat::RGBA_8, 2048, 2048, 1, 64));
+		// KTX stores each mip as a single block with a 32-bit size, so this is about as big as an array gets.
+		benchKTXExport("3.75 GiB array", makeTexture(Texas::PixelFormat::RGBA_8, 2048, 2048, 1, 240));
+		std::printf("\n");
+	}
+
+	std::vector<SuiteResult> results;
+	runSuite(suiteOptions, results);
+	if (parser.isSet(jsonOption) && !writeJson(parser.value(jsonOption), suiteOptions, results))
+	{
+		std::fprintf(stderr, "Unable to write '%s'.\n", qPrintable(parser.value(jsonOption)));
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,664 @@
+#include "TexasGUI/BCnEncoder.hpp"
+#include "TexasGUI/FileOutputStream.hpp"
+#include "TexasGUI/FormatConverter.hpp"
+#include "TexasGUI/ImageCompare.hpp"
+#include "TexasGUI/KTXWriter.hpp"
+#include "TexasGUI/Parallel.hpp"
+#include "TexasGUI/TextureKernels.hpp"
+
+#include <QByteArray>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
+
+#include "Texas/Texas.hpp"
+#include "Texas/Tools.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+	// What a file is converted to before it is saved as KTX.
+	enum class TargetFormat
+	{
+		Source,
+		RGBA8,
+		BC1,
+		BC1A,
+		BC3,
+		BC4,
+		BC5,
+		BC7,
+		COUNT
+	};
+
+	[[nodiscard]] char const* toString(TargetFormat format)
+	{
+		switch (format)
+		{
+		case TargetFormat::Source:
+			return "source";
+		case TargetFormat::RGBA8:
+			return "rgba8";
+		case TargetFormat::BC1:
+			return "bc1";
+		case TargetFormat::BC1A:
+			return "bc1a";
+		case TargetFormat::BC3:
+			return "bc3";
+		case TargetFormat::BC4:
+			return "bc4";
+		case TargetFormat::BC5:
+			return "bc5";
+		case TargetFormat::BC7:
+			return "bc7";
+		default:
+			return "error";
+		}
+	}
+
+	[[nodiscard]] Texas::PixelFormat toPixelFormat(TargetFormat format)
+	{
+		switch (format)
+		{
+		case TargetFormat::BC1:
+			return Texas::PixelFormat::BC1_RGB;
+		case TargetFormat::BC1A:
+			return Texas::PixelFormat::BC1_RGBA;
+		case TargetFormat::BC3:
+			return Texas::PixelFormat::BC3_RGBA;
+		case TargetFormat::BC4:
+			return Texas::PixelFormat::BC4;
+		case TargetFormat::BC5:
+			return Texas::PixelFormat::BC5;
+		case TargetFormat::BC7:
+			return Texas::PixelFormat::BC7_RGBA;
+		default:
+			return Texas::PixelFormat::Invalid;
+		}
+	}
+
+	struct Options
+	{
+		TargetFormat format = TargetFormat::Source;
+		TexasGUI::BCn::EncodeQuality quality = TexasGUI::BCn::EncodeQuality::Normal;
+		// Empty means next to the input file.
+		QString outputDirectory{};
+		int jobCount = 1;
+		// Threads each file's kernels may use, so jobs * kernel threads roughly matches the core count.
+		int kernelThreads = 0;
+	};
+
+	// Limits how many bytes the files being converted at the same time may hold, in MiB units.
+	// A file that needs more than the whole budget still runs, just on its own.
+	class MemoryBudget
+	{
+	public:
+		explicit MemoryBudget(int megabytes) :
+			totalUnits(std::max(megabytes, 1)),
+			semaphore(std::max(megabytes, 1))
+		{
+		}
+
+		[[nodiscard]] int acquire(std::uint64_t bytes)
+		{
+			int units = static_cast<int>(std::min<std::uint64_t>((bytes >> 20) + 1, static_cast<std::uint64_t>(totalUnits)));
+			semaphore.acquire(units);
+			return units;
+		}
+
+		void release(int units)
+		{
+			semaphore.release(units);
+		}
+
+	private:
+		int totalUnits = 0;
+		QSemaphore semaphore;
+	};
+
+	struct FileResult
+	{
+		bool success = false;
+		QString message{};
+	};
+
+	// What the converted file will look like.
+	[[nodiscard]] Texas::TextureInfo targetTextureInfo(Texas::TextureInfo const& srcInfo, TargetFormat format)
+	{
+		if (format == TargetFormat::Source)
+			return srcInfo;
+		if (format != TargetFormat::RGBA8)
+			return TexasGUI::BCn::encodedTextureInfo(srcInfo, toPixelFormat(format));
+
+		Texas::TextureInfo dstInfo = srcInfo;
+		dstInfo.pixelFormat = Texas::PixelFormat::RGBA_8;
+		dstInfo.channelType = srcInfo.colorSpace == Texas::ColorSpace::sRGB ? Texas::ChannelType::sRGB : Texas::ChannelType::UnsignedNormalized;
+		return dstInfo;
+	}
+
+	// Texas parses straight out of a mapping of the file and copies the image data into the Texture.
+	[[nodiscard]] bool loadTexture(QString const& path, Texas::Texture& texture, QString& errorMessage)
+	{
+		QFile file(path);
+		file.open(QFile::ReadOnly);
+		uchar const* mappedFile = file.isOpen() ? file.map(0, file.size()) : nullptr;
+		if (mappedFile == nullptr)
+		{
+			errorMessage = "unable to open file";
+			return false;
+		}
+		Texas::ResultValue<Texas::Texture> loadResult = Texas::loadFromBuffer(Texas::ConstByteSpan(
+			reinterpret_cast<std::byte const*>(mappedFile),
+			static_cast<std::size_t>(file.size())));
+		file.unmap(const_cast<uchar*>(mappedFile));
+		file.close();
+		if (!loadResult.isSuccessful())
+		{
+			errorMessage = QString("unable to load file: ") + loadResult.errorMessage();
+			return false;
+		}
+		texture = static_cast<Texas::Texture&&>(loadResult.value());
+		return true;
+	}
+
+	// Converts every layer of one mip level into dstData, back to back.
+	[[nodiscard]] bool convertMipLevel(
+		Texas::Texture const& texture,
+		std::uint64_t mipIndex,
+		Options const& options,
+		std::vector<std::byte>& dstData)
+	{
+		Texas::TextureInfo const& srcInfo = texture.textureInfo();
+		if (options.format != TargetFormat::RGBA8)
+		{
+			return TexasGUI::BCn::encodeMipLevel(
+				srcInfo,
+				texture.rawBufferSpan(),
+				mipIndex,
+				toPixelFormat(options.format),
+				options.quality,
+				dstData,
+				options.kernelThreads);
+		}
+
+		// Uncompressed normalized and float sources convert directly, everything else is decoded like it's displayed.
+		Texas::TextureInfo const dstInfo = targetTextureInfo(srcInfo, options.format);
+		if (TexasGUI::Convert::canConvert(srcInfo, dstInfo.pixelFormat, dstInfo.channelType))
+		{
+			return TexasGUI::Convert::convertMipLevel(
+				srcInfo,
+				texture.rawBufferSpan(),
+				mipIndex,
+				dstInfo.pixelFormat,
+				dstInfo.channelType,
+				dstData,
+				nullptr,
+				options.kernelThreads);
+		}
+
+		Texas::Dimensions const dimensions = Texas::calculateMipDimensions(srcInfo.baseDimensions, mipIndex);
+		std::uint64_t const layerSize = dimensions.width * dimensions.height * dimensions.depth * 4;
+		dstData.resize(layerSize * srcInfo.layerCount);
+
+		std::atomic<bool> failed{ false };
+		TexasGUI::parallelFor(srcInfo.layerCount, [&](std::uint64_t layerIndex)
+		{
+			QByteArray rgba;
+			if (!TexasGUI::BuildDisplayableSubresource(srcInfo, texture.rawBufferSpan(), mipIndex, layerIndex, rgba))
+			{
+				failed.store(true);
+				return;
+			}
+			std::memcpy(dstData.data() + layerIndex * layerSize, rgba.constData(), rgba.size());
+		}, options.kernelThreads);
+		return !failed.load();
+	}
+
+	// Where the converted file is saved, as an absolute path.
+	[[nodiscard]] QString outputPathFor(QString const& inputPath, Options const& options)
+	{
+		QFileInfo inputInfo(inputPath);
+		QString outputDirectory = options.outputDirectory.isEmpty() ? inputInfo.absolutePath() : options.outputDirectory;
+		return QFileInfo(outputDirectory + "/" + inputInfo.completeBaseName() + ".ktx").absoluteFilePath();
+	}
+
+	[[nodiscard]] FileResult convertFile(QString const& inputPath, Options const& options, MemoryBudget& budget)
+	{
+		FileResult result;
+
+		QFileInfo inputInfo(inputPath);
+		QString outputPath = outputPathFor(inputPath, options);
+		if (outputPath == inputInfo.absoluteFilePath())
+		{
+			result.message = "output would overwrite the input";
+			return result;
+		}
+
+		// Reserve for the loaded texture first, the rest is only known once it's parsed.
+		int reservedUnits = budget.acquire(static_cast<std::uint64_t>(inputInfo.size()));
+
+		QElapsedTimer timer;
+		timer.start();
+
+		Texas::Texture texture;
+		if (!loadTexture(inputPath, texture, result.message))
+		{
+			budget.release(reservedUnits);
+			return result;
+		}
+		Texas::TextureInfo const& srcInfo = texture.textureInfo();
+
+		// Now reserve for everything at once. Nothing is held while waiting, so files can't block each other.
+		// Converted files are streamed out a mip level at a time, so on top of the source that's at most
+		// an RGBA8 copy of the base level plus its converted version.
+		if (options.format != TargetFormat::Source)
+		{
+			Texas::Dimensions const baseDimensions = srcInfo.baseDimensions;
+			std::uint64_t baseLevelRGBA8Size = baseDimensions.width * baseDimensions.height * baseDimensions.depth * 4 * srcInfo.layerCount;
+			std::uint64_t neededBytes = texture.rawBufferSpan().size() + baseLevelRGBA8Size * 2;
+			budget.release(reservedUnits);
+			reservedUnits = budget.acquire(neededBytes);
+		}
+
+		Texas::TextureInfo const dstInfo = targetTextureInfo(srcInfo, options.format);
+		TexasGUI::FileOutputStream fileStream;
+		TexasGUI::KTX::StreamingWriter writer;
+		Texas::Result writeResult = TexasGUI::KTX::canSave(dstInfo);
+		if (writeResult.isSuccessful())
+			writeResult = fileStream.open(outputPath);
+		if (writeResult.isSuccessful())
+			writeResult = writer.begin(dstInfo, fileStream);
+
+		std::vector<std::byte> mipData;
+		for (std::uint64_t mipIndex = 0; mipIndex < srcInfo.mipCount && writeResult.isSuccessful(); mipIndex++)
+		{
+			if (options.format == TargetFormat::Source)
+			{
+				std::uint64_t mipOffset = Texas::calculateMipOffset(srcInfo, mipIndex);
+				std::uint64_t mipSize = TexasGUI::KTX::subresourceLayout(srcInfo, mipIndex).packedSize * srcInfo.layerCount;
+				writeResult = writer.writeMipLevel(Texas::ConstByteSpan(texture.rawBufferSpan().data() + mipOffset, static_cast<std::size_t>(mipSize)));
+				continue;
+			}
+
+			if (!convertMipLevel(texture, mipIndex, options, mipData))
+			{
+				writeResult = Texas::Result(Texas::ResultType::InvalidInputParameter, "unable to convert this pixel format");
+				break;
+			}
+			writeResult = writer.writeMipLevel(Texas::ConstByteSpan(mipData.data(), mipData.size()));
+		}
+		if (writeResult.isSuccessful())
+			writeResult = writer.finish();
+		Texas::Result closeResult = fileStream.close();
+		if (writeResult.isSuccessful())
+			writeResult = closeResult;
+		budget.release(reservedUnits);
+
+		if (!writeResult.isSuccessful())
+			result.message = QString("unable to save as KTX: ") + writeResult.errorMessage();
+		else
+		{
+			result.success = true;
+			result.message = outputPath + " (" + QString::number(fileStream.bytesWritten()) + " bytes, " + QString::number(timer.elapsed()) + " ms)";
+		}
+		return result;
+	}
+
+	struct CompareOptions
+	{
+		// NaN means no threshold.
+		double minPSNR = NAN;
+		double minSSIM = NAN;
+		// Empty means no heatmaps.
+		QString heatmapDirectory{};
+		float maxError = 0.05f;
+	};
+
+	// Every compared subresource as an RGBA8 KTX, 3D textures only get their first slice.
+	[[nodiscard]] Texas::Result saveHeatmap(
+		TexasGUI::Compare::Input const& a,
+		TexasGUI::Compare::Input const& b,
+		float maxError,
+		QString const& path)
+	{
+		Texas::TextureInfo info = a.texInfo;
+		info.pixelFormat = Texas::PixelFormat::RGBA_8;
+		info.channelType = Texas::ChannelType::UnsignedNormalized;
+		info.colorSpace = Texas::ColorSpace::sRGB;
+		info.mipCount = TexasGUI::Compare::comparedMipCount(a.texInfo, b.texInfo);
+		info.layerCount = TexasGUI::Compare::comparedLayerCount(a.texInfo, b.texInfo);
+		if (info.textureType == Texas::TextureType::Texture3D || info.textureType == Texas::TextureType::Array3D)
+		{
+			info.textureType = info.textureType == Texas::TextureType::Texture3D ? Texas::TextureType::Texture2D : Texas::TextureType::Array2D;
+			info.baseDimensions.depth = 1;
+		}
+
+		std::vector<std::byte> data(Texas::calculateTotalSize(info));
+		for (std::uint64_t mipIndex = 0; mipIndex < info.mipCount; mipIndex++)
+		{
+			Texas::Dimensions const mipDims = Texas::calculateMipDimensions(info.baseDimensions, mipIndex);
+			TexasGUI::KTX::Region region{};
+			region.width = mipDims.width;
+			region.height = mipDims.height;
+			for (std::uint64_t layerIndex = 0; layerIndex < info.layerCount; layerIndex++)
+			{
+				QByteArray rgba;
+				if (!TexasGUI::Compare::buildDiffHeatmap(a, b, mipIndex, layerIndex, region, maxError, rgba))
+					return Texas::Result(Texas::ResultType::InvalidInputParameter, "unable to build the heatmap");
+				std::memcpy(data.data() + Texas::calculateLayerOffset(info, mipIndex, layerIndex), rgba.constData(), rgba.size());
+			}
+		}
+
+		TexasGUI::FileOutputStream fileStream;
+		Texas::Result result = fileStream.open(path);
+		if (result.isSuccessful())
+			result = TexasGUI::KTX::saveToStream(info, Texas::ConstByteSpan(data.data(), data.size()), fileStream);
+		Texas::Result closeResult = fileStream.close();
+		return result.isSuccessful() ? closeResult : result;
+	}
+
+	// Prints the metrics of every compared subresource, the message says whether the pair passed the thresholds.
+	[[nodiscard]] FileResult comparePair(QString const& pathA, QString const& pathB, CompareOptions const& options)
+	{
+		FileResult result;
+
+		Texas::Texture textureA;
+		Texas::Texture textureB;
+		QString errorMessage;
+		if (!loadTexture(pathA, textureA, errorMessage))
+		{
+			result.message = pathA + ": " + errorMessage;
+			return result;
+		}
+		if (!loadTexture(pathB, textureB, errorMessage))
+		{
+			result.message = pathB + ": " + errorMessage;
+			return result;
+		}
+		TexasGUI::Compare::Input const a{ textureA.textureInfo(), textureA.rawBufferSpan() };
+		TexasGUI::Compare::Input const b{ textureB.textureInfo(), textureB.rawBufferSpan() };
+		if (!TexasGUI::Compare::canCompare(a.texInfo, b.texInfo))
+		{
+			result.message = "these textures can't be compared, they need the same dimensions and normalized, float or block compressed channels";
+			return result;
+		}
+
+		QElapsedTimer timer;
+		timer.start();
+		TexasGUI::Compare::Metrics metrics;
+		if (!TexasGUI::Compare::compareTextures(a, b, metrics))
+		{
+			result.message = "unable to compare these textures";
+			return result;
+		}
+
+		static char const channelNames[] = "RGBA";
+		double minPSNR = INFINITY;
+		double minSSIM = INFINITY;
+		for (TexasGUI::Compare::SubresourceMetrics const& subresource : metrics.subresources)
+		{
+			std::printf("  mip %llu layer %llu:", static_cast<unsigned long long>(subresource.mipIndex), static_cast<unsigned long long>(subresource.layerIndex));
+			for (std::uint8_t i = 0; i < metrics.channelCount; i++)
+			{
+				TexasGUI::Compare::ChannelMetrics const& channel = subresource.channels[i];
+				std::printf("  %c PSNR %.2f dB SSIM %.4f", channelNames[i], channel.psnr, channel.ssim);
+				minPSNR = std::min(minPSNR, channel.psnr);
+				minSSIM = std::min(minSSIM, channel.ssim);
+			}
+			std::printf("\n");
+		}
+
+		if (!options.heatmapDirectory.isEmpty())
+		{
+			QString heatmapPath = options.heatmapDirectory + "/" + QFileInfo(pathA).completeBaseName() + "_vs_" + QFileInfo(pathB).completeBaseName() + ".ktx";
+			Texas::Result heatmapResult = saveHeatmap(a, b, options.maxError, heatmapPath);
+			if (!heatmapResult.isSuccessful())
+			{
+				result.message = QString("unable to save the heatmap: ") + heatmapResult.errorMessage();
+				return result;
+			}
+		}
+
+		// NaN thresholds compare false, so they never fail a pair.
+		bool const belowPSNR = minPSNR < options.minPSNR;
+		bool const belowSSIM = minSSIM < options.minSSIM;
+		result.success = !belowPSNR && !belowSSIM;
+		result.message = "worst PSNR " + QString::number(minPSNR, 'f', 2) + " dB, worst SSIM " + QString::number(minSSIM, 'f', 4) +
+			" (" + QString::number(timer.elapsed()) + " ms)";
+		if (belowPSNR)
+			result.message += ", PSNR below " + QString::number(options.minPSNR);
+		if (belowSSIM)
+			result.message += ", SSIM below " + QString::number(options.minSSIM);
+		return result;
+	}
+
+	// Arguments can be files, directories or wildcard patterns in the file name part, like textures/*.png.
+	[[nodiscard]] QStringList expandInputs(QStringList const& arguments, bool recursive)
+	{
+		QDirIterator::IteratorFlags flags = recursive ? QDirIterator::Subdirectories : QDirIterator::NoIteratorFlags;
+		QStringList files;
+		for (QString const& argument : arguments)
+		{
+			QFileInfo info(argument);
+			if (info.isFile())
+			{
+				files.append(info.filePath());
+				continue;
+			}
+			QString directory = info.isDir() ? info.filePath() : info.path();
+			QStringList nameFilters;
+			if (!info.isDir())
+				nameFilters.append(info.fileName());
+			QDirIterator it(directory, nameFilters, QDir::Files, flags);
+			while (it.hasNext())
+				files.append(it.next());
+		}
+		files.removeDuplicates();
+		return files;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	QCoreApplication app(argc, argv);
+	QCoreApplication::setApplicationName("texas_cli");
+	QCoreApplication::setApplicationVersion("0.1");
+
+	QCommandLineParser parser;
+	parser.setApplicationDescription("Converts textures to KTX, or measures how far pairs of textures are apart with --compare.");
+	parser.addHelpOption();
+	parser.addPositionalArgument("inputs", "Files, directories or wildcard patterns to convert, or pairs of files to compare.", "inputs...");
+
+	QString formatNames;
+	for (std::size_t i = 0; i < static_cast<std::size_t>(TargetFormat::COUNT); i += 1)
+		formatNames += QString(i == 0 ? "" : ", ") + toString(static_cast<TargetFormat>(i));
+	QString qualityNames;
+	for (std::size_t i = 0; i < static_cast<std::size_t>(TexasGUI::BCn::EncodeQuality::COUNT); i += 1)
+		qualityNames += QString(i == 0 ? "" : ", ") + QString(TexasGUI::BCn::toString(static_cast<TexasGUI::BCn::EncodeQuality>(i))).toLower();
+
+	QCommandLineOption outputOption({ "o", "output" }, "Output directory, defaults to next to each input.", "directory");
+	QCommandLineOption formatOption({ "f", "format" }, "Output pixel format: " + formatNames + ".", "format", "source");
+	QCommandLineOption qualityOption({ "q", "quality" }, "Block compression quality: " + qualityNames + ".", "quality", "normal");
+	QCommandLineOption jobsOption({ "j", "jobs" }, "Number of files converted at the same time.", "N", QString::number(QThread::idealThreadCount()));
+	QCommandLineOption memoryOption({ "m", "memory" }, "Memory the files being converted may use together, in MiB.", "MiB", "2048");
+	QCommandLineOption recursiveOption({ "r", "recursive" }, "Also look in subdirectories.");
+	QCommandLineOption compareOption("compare", "Compare each pair of inputs, the second usually being an encoded version of the first.");
+	QCommandLineOption minPSNROption("min-psnr", "With --compare, fail pairs with a channel below this PSNR in any subresource.", "dB");
+	QCommandLineOption minSSIMOption("min-ssim", "With --compare, fail pairs with a channel below this SSIM in any subresource.", "value");
+	QCommandLineOption heatmapOption("heatmap", "With --compare, save a KTX heatmap of the differences of each pair into this directory.", "directory");
+	QCommandLineOption maxErrorOption("max-error", "The difference at the hot end of the heatmaps.", "value", "0.05");
+	parser.addOptions({ outputOption, formatOption, qualityOption, jobsOption, memoryOption, recursiveOption,
+		compareOption, minPSNROption, minSSIMOption, heatmapOption, maxErrorOption });
+	parser.process(app);
+
+	// Pairs are compared one after the other, each spread across every core.
+	if (parser.isSet(compareOption))
+	{
+		CompareOptions compareOptions;
+		bool valid = true;
+		if (parser.isSet(minPSNROption))
+			compareOptions.minPSNR = parser.value(minPSNROption).toDouble(&valid);
+		if (valid && parser.isSet(minSSIMOption))
+			compareOptions.minSSIM = parser.value(minSSIMOption).toDouble(&valid);
+		if (valid)
+			compareOptions.maxError = parser.value(maxErrorOption).toFloat(&valid);
+		if (!valid || !(compareOptions.maxError > 0.f))
+		{
+			std::fprintf(stderr, "--min-psnr, --min-ssim and --max-error must be numbers, --max-error above 0.\n");
+			return 1;
+		}
+		if (parser.isSet(heatmapOption))
+		{
+			compareOptions.heatmapDirectory = parser.value(heatmapOption);
+			if (!QDir().mkpath(compareOptions.heatmapDirectory))
+			{
+				std::fprintf(stderr, "Unable to create heatmap directory '%s'.\n", qPrintable(compareOptions.heatmapDirectory));
+				return 1;
+			}
+		}
+
+		QStringList const paths = parser.positionalArguments();
+		if (paths.isEmpty() || paths.size() % 2 != 0)
+		{
+			std::fprintf(stderr, "--compare takes pairs of files.\n");
+			return 1;
+		}
+
+		int failedPairCount = 0;
+		for (int i = 0; i < paths.size(); i += 2)
+		{
+			std::printf("%s vs %s\n", qPrintable(paths[i]), qPrintable(paths[i + 1]));
+			FileResult result = comparePair(paths[i], paths[i + 1], compareOptions);
+			if (result.success)
+				std::printf("  %s\n", qPrintable(result.message));
+			else
+			{
+				failedPairCount++;
+				std::fprintf(stderr, "  error: %s\n", qPrintable(result.message));
+			}
+		}
+		std::printf("%d of %d pairs passed.\n", paths.size() / 2 - failedPairCount, paths.size() / 2);
+		return failedPairCount == 0 ? 0 : 1;
+	}
+
+	Options options;
+	QString formatName = parser.value(formatOption).toLower();
+	options.format = TargetFormat::COUNT;
+	for (std::size_t i = 0; i < static_cast<std::size_t>(TargetFormat::COUNT); i += 1)
+	{
+		if (formatName == toString(static_cast<TargetFormat>(i)))
+			options.format = static_cast<TargetFormat>(i);
+	}
+	if (options.format == TargetFormat::COUNT)
+	{
+		std::fprintf(stderr, "Unknown format '%s'.\n", qPrintable(formatName));
+		return 1;
+	}
+
+	QString qualityName = parser.value(qualityOption).toLower();
+	options.quality = TexasGUI::BCn::EncodeQuality::COUNT;
+	for (std::size_t i = 0; i < static_cast<std::size_t>(TexasGUI::BCn::EncodeQuality::COUNT); i += 1)
+	{
+		TexasGUI::BCn::EncodeQuality quality = static_cast<TexasGUI::BCn::EncodeQuality>(i);
+		if (qualityName == QString(TexasGUI::BCn::toString(quality)).toLower())
+			options.quality = quality;
+	}
+	if (options.quality == TexasGUI::BCn::EncodeQuality::COUNT)
+	{
+		std::fprintf(stderr, "Unknown quality '%s'.\n", qPrintable(qualityName));
+		return 1;
+	}
+
+	bool jobsValid = false;
+	options.jobCount = parser.value(jobsOption).toInt(&jobsValid);
+	bool memoryValid = false;
+	int memoryMegabytes = parser.value(memoryOption).toInt(&memoryValid);
+	if (!jobsValid || options.jobCount < 1 || !memoryValid || memoryMegabytes < 1)
+	{
+		std::fprintf(stderr, "--jobs and --memory must be positive numbers.\n");
+		return 1;
+	}
+
+	if (parser.isSet(outputOption))
+	{
+		options.outputDirectory = parser.value(outputOption);
+		if (!QDir().mkpath(options.outputDirectory))
+		{
+			std::fprintf(stderr, "Unable to create output directory '%s'.\n", qPrintable(options.outputDirectory));
+			return 1;
+		}
+	}
+
+	QStringList files = expandInputs(parser.positionalArguments(), parser.isSet(recursiveOption));
+	if (files.isEmpty())
+	{
+		std::fprintf(stderr, "No input files.\n");
+		return 1;
+	}
+
+	// Jobs run at the same time, two of them writing the same file would corrupt it.
+	// Happens with the same base name in different directories under -o, or foo.png next to foo.ktx.
+	QHash<QString, QString> inputByOutputPath;
+	bool hasCollision = false;
+	for (QString const& inputPath : files)
+	{
+		QString outputPath = outputPathFor(inputPath, options);
+		auto it = inputByOutputPath.constFind(outputPath);
+		if (it != inputByOutputPath.constEnd())
+		{
+			std::fprintf(stderr, "%s and %s would both be saved as %s.\n", qPrintable(it.value()), qPrintable(inputPath), qPrintable(outputPath));
+			hasCollision = true;
+		}
+		else
+			inputByOutputPath.insert(outputPath, inputPath);
+	}
+	if (hasCollision)
+	{
+		std::fprintf(stderr, "Rename the inputs or convert them in separate runs.\n");
+		return 1;
+	}
+
+	// Files are spread across the global pool and so are the kernels inside each of them.
+	// parallelFor lets its caller do all the work itself, so the nesting can't starve.
+	QThreadPool* pool = QThreadPool::globalInstance();
+	int const idealThreads = std::max(QThread::idealThreadCount(), 1);
+	options.jobCount = std::min(options.jobCount, static_cast<int>(files.size()));
+	pool->setMaxThreadCount(std::max(idealThreads, options.jobCount));
+	options.kernelThreads = std::max(idealThreads / options.jobCount, 1);
+
+	MemoryBudget budget(memoryMegabytes);
+	std::mutex outputMutex;
+	std::atomic<int> failedCount{ 0 };
+	TexasGUI::parallelFor(static_cast<std::uint64_t>(files.size()), [&](std::uint64_t fileIndex)
+	{
+		QString const& inputPath = files.at(static_cast<int>(fileIndex));
+		FileResult result = convertFile(inputPath, options, budget);
+		if (!result.success)
+			failedCount.fetch_add(1);
+
+		std::lock_guard<std::mutex> lock(outputMutex);
+		if (result.success)
+			std::printf("%s -> %s\n", qPrintable(inputPath), qPrintable(result.message));
+		else
+			std::fprintf(stderr, "%s: error: %s\n", qPrintable(inputPath), qPrintable(result.message));
+	}, options.jobCount);
+
+	std::printf("%d of %d files converted.\n", static_cast<int>(files.size()) - failedCount.load(), static_cast<int>(files.size()));
+	return failedCount.load() == 0 ? 0 : 1;
+}
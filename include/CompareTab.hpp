@@ -0,0 +1,72 @@
+#pragma once
+
+#include <QWidget>
+#include <QString>
+#include <QFutureWatcher>
+
+#include "Texas/Texture.hpp"
+
+#include "TexasGUI/ImageCompare.hpp"
+#include "TexasGUI/TileSource.hpp"
+
+#include <memory>
+
+class QDoubleSpinBox;
+class QLabel;
+class QLayout;
+class QProgressBar;
+class QSpinBox;
+class QTimer;
+
+namespace TexasGUI
+{
+	struct CompareJob;
+	class TextureViewport;
+
+	// Measures PSNR and SSIM between two loaded textures on the global thread pool, and shows a heatmap of
+	// where they differ. The textures are shared with the tabs they came from, closing those keeps them alive.
+	// Destroying the tab cancels the measurement.
+	class CompareTab : public QWidget
+	{
+		Q_OBJECT
+
+	public:
+		// The pair must pass Compare::canCompare.
+		CompareTab(
+			QString const& nameA,
+			std::shared_ptr<Texas::Texture const> textureA,
+			QString const& nameB,
+			std::shared_ptr<Texas::Texture const> textureB);
+		~CompareTab() override;
+
+	private slots:
+		void subresourceChanged();
+		void maxErrorChanged(double maxError);
+		void workerFinished();
+		void updateProgress();
+
+	private:
+		void createLeftPanel(QLayout* parentLayout, QString const& nameA, QString const& nameB);
+		void updateMetricLabels();
+		// The viewport caches tiles, so a new max error means a new source.
+		void setHeatmapSource(float maxError);
+
+		std::shared_ptr<Texas::Texture const> textureA{};
+		std::shared_ptr<Texas::Texture const> textureB{};
+		Compare::Input inputA{};
+		Compare::Input inputB{};
+		std::shared_ptr<CompareJob> job{};
+
+		QFutureWatcher<bool>* watcher = nullptr;
+		QTimer* progressTimer = nullptr;
+		QProgressBar* progressBar = nullptr;
+		QSpinBox* mipSpinBox = nullptr;
+		QSpinBox* layerSpinBox = nullptr;
+		QDoubleSpinBox* maxErrorSpinBox = nullptr;
+		QLabel* channelLabels[4] = {};
+		QLabel* worstLabel = nullptr;
+
+		TextureViewport* viewport = nullptr;
+		std::unique_ptr<DiffHeatmapTileSource> tileSource{};
+	};
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <QDialog>
+#include <QElapsedTimer>
+#include <QString>
+#include <QFutureWatcher>
+
+#include "Texas/Texture.hpp"
+
+#include <memory>
+#include <vector>
+
+class QComboBox;
+class QLabel;
+class QProgressBar;
+class QPushButton;
+class QTimer;
+
+namespace TexasGUI
+{
+	struct ExportJob;
+	struct ExportResult;
+
+	// What the format dropdown exports to. Block compressed formats ignore the channel type,
+	// an invalid pixel format keeps the source's.
+	struct ExportTarget
+	{
+		Texas::PixelFormat pixelFormat;
+		Texas::ChannelType channelType;
+	};
+
+	// Lets the user pick a target format, quality and whether to generate mipmaps, then encodes or converts the texture
+	// and saves it as KTX on the global thread pool. The texture must outlive the dialog, closing it cancels the export.
+	class ExportDialog : public QDialog
+	{
+		Q_OBJECT
+
+	public:
+		explicit ExportDialog(Texas::Texture const& texture, QWidget* parent = nullptr);
+		~ExportDialog() override;
+
+		// Exports with the options currently picked, like the export button does but without asking for a file name.
+		void exportTo(QString const& fileName);
+
+	signals:
+		// Once the worker is done, after any error has been shown.
+		void exportFinished(bool succeeded);
+
+	private slots:
+		void formatChanged(int index);
+		void startExport();
+		void workerFinished();
+		void updateProgress();
+
+	private:
+		Texas::Texture const& sourceTexture;
+		std::shared_ptr<ExportJob> job{};
+		// One per format dropdown item.
+		std::vector<ExportTarget> exportTargets{};
+		QElapsedTimer exportTimer{};
+
+		QFutureWatcher<std::shared_ptr<ExportResult>>* watcher = nullptr;
+		QTimer* progressTimer = nullptr;
+		QComboBox* formatDropdown = nullptr;
+		QComboBox* qualityDropdown = nullptr;
+		QComboBox* mipDropdown = nullptr;
+		QPushButton* exportButton = nullptr;
+		QProgressBar* progressBar = nullptr;
+		QLabel* statusLabel = nullptr;
+	};
+}
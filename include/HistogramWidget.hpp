@@ -0,0 +1,28 @@
+#pragma once
+
+#include <QWidget>
+
+#include "TexasGUI/Statistics.hpp"
+
+#include <memory>
+
+namespace TexasGUI
+{
+	// Draws the histograms of every channel of a subresource on top of each other, each in its own color.
+	// Single channel textures are drawn in gray. Nothing is drawn while there are no statistics.
+	class HistogramWidget : public QWidget
+	{
+		Q_OBJECT
+
+	public:
+		explicit HistogramWidget(QWidget* parent = nullptr);
+
+		void setStatistics(std::shared_ptr<SubresourceStatistics const> statistics);
+
+	protected:
+		void paintEvent(QPaintEvent* event) override;
+
+	private:
+		std::shared_ptr<SubresourceStatistics const> statistics{};
+	};
+}
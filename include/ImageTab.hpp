@@ -1,43 +1,31 @@
 #pragma once
 
 #include <QWidget>
-#include <QImage>
 #include <QLabel>
+#include <QFutureWatcher>
 
 #include "Texas/Texture.hpp"
 
+#include "TexasGUI/TextureKernels.hpp"
+#include "TexasGUI/DisplayCache.hpp"
+#include "TexasGUI/FloatVisualization.hpp"
+#include "TexasGUI/KTXReader.hpp"
+#include "TexasGUI/Statistics.hpp"
+#include "TexasGUI/TileSource.hpp"
+
+#include <memory>
+
 class QHBoxLayout;
 class QLabel;
 class QSpinBox;
+class QDoubleSpinBox;
 class QCheckBox;
 class QSlider;
 
 namespace TexasGUI
 {
-  struct MinMaxData
-  {
-    enum class Type
-    {
-      Int,
-      UnsignedInt,
-      Float
-    };
-    Type type{};
-    struct A
-    {
-      std::int64_t max_int64[4];
-      std::int64_t min_int64[4];
-      std::uint64_t max_uint64[4];
-      std::uint64_t min_uint64[4];
-      double max_float64[4];
-      double min_float64[4];
-    };
-    struct B
-    {
-      std::vector<A> layers;
-    };
-    std::vector<B> mipLevels;
-  };
+  class HistogramWidget;
+  class TextureViewport;
 
   struct MinMaxLabels
   {
@@ -52,29 +40,53 @@ namespace TexasGUI
   public:
       ImageTab(
           QString const& fullPath,
-          Texas::Texture&& texture);
+          Texas::Texture&& texture,
+          MinMaxData&& minMaxData,
+          QByteArray const& baseDisplayData);
+      // For files too large to load, every tile is read from disk as it comes into view.
+      // There are no statistics and nothing to export in this mode.
+      ImageTab(
+          QString const& fullPath,
+          std::shared_ptr<KTX::TiledReader> tiledReader);
+      ~ImageTab() override;
+
+      // Null for tabs that stream from disk.
+      [[nodiscard]] std::shared_ptr<Texas::Texture const> texture() const;
+      [[nodiscard]] Texas::TextureInfo const& textureInfo() const;
+      // Moves the mip and layer controls, for driving the tab without a user.
+      void showSubresource(std::uint64_t mipIndex, std::uint64_t layerIndex);
 
   public slots:
       void floatVisualizationModeChanged(int i);
+      void exposureChanged(double stops);
       void mipLevelSpinBoxChanged(int i);
       void mipLevelSliderChanged(int i);
       void scaleToMipChanged(int i);
+      void automaticMipChanged(int i);
+      void viewportMipChanged(int i);
       void arrayLayerSpinBoxChanged(int i);
       void arrayLayerSliderChanged(int i);
 
       void exportAsKTX();
+      void statisticsFinished();
 
   signals:
 
   private:
+      void createLayout(QString const& fullPath, bool enableControls);
       void createLeftPanel(QLayout* parentLayout, QString const& fullPath, bool enableControls);
       void createFloatVisualizationControls(QLayout* parentLayout);
       void createMipControls(QLayout* parentLayout);
       void createArrayControls(QLayout* parentLayout);
       void createMinMaxBox(QLayout* parentLayout);
+      void createStatisticsBox(QLayout* parentLayout);
       void createDetailsBox(QLayout* parentLayout);
 
+      void updateMipLabels(unsigned int mipIndex);
       void updateMinMaxLabels(uint8_t mipIndex, uint64_t layerIndex);
+      // Shows the statistics if they're cached, otherwise asks for them and shows them once they're done.
+      void updateStatistics(std::uint64_t mipIndex, std::uint64_t layerIndex);
+      void showStatistics(std::shared_ptr<SubresourceStatistics const> const& statistics);
       void updateImage(std::uint8_t mipIndex, std::uint64_t arrayIndex, bool scaleMipToBase);
 
       unsigned int getCurrentMipLevel() const;
@@ -83,25 +95,37 @@ namespace TexasGUI
 
       MinMaxData minMaxData{};
 
+      FloatVisualization floatVisualization{};
+      QDoubleSpinBox* exposureSpinBox = nullptr;
+
       QSpinBox* mipSelectorSpinBox = nullptr;
       QSlider* mipSelectorSlider = nullptr;
       QLabel* mipWidthLabel = nullptr;
       QLabel* mipHeightLabel = nullptr;
       QLabel* mipDepthLabel = nullptr;
       QCheckBox* scaleMipToBaseCheckBox = nullptr;
+      QCheckBox* automaticMipCheckBox = nullptr;
 
       QSpinBox* arraySelectorSpinBox = nullptr;
       QSlider* arraySelectorSlider = nullptr;
 
       MinMaxLabels minMaxLabels{};
 
-      QLabel* imgLabel = nullptr;
-        
+      HistogramWidget* histogramWidget = nullptr;
+      QLabel* statisticsLabels[4] = {};
+      QFutureWatcher<void>* statisticsWatcher = nullptr;
+
+      TextureViewport* viewport = nullptr;
+
+      // Whichever of the two the tab was opened with, texInfo describes both.
+      // Shared with the comparisons it's part of, which can outlive the tab.
+      std::shared_ptr<Texas::Texture> sourceTexture{};
+      std::shared_ptr<KTX::TiledReader> tiledReader{};
+      Texas::TextureInfo texInfo{};
 
-      Texas::Texture sourceTexture{};
-      QByteArray customImgData{};
-      QImage::Format qImgFormat{};
-        
+      std::unique_ptr<DisplayCache> displayCache{};
+      std::unique_ptr<StatisticsCache> statisticsCache{};
+      std::unique_ptr<TileSource> tileSource{};
 
   };
 }
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <QWidget>
+#include <QString>
+#include <QByteArray>
+#include <QFutureWatcher>
+
+#include "Texas/Texture.hpp"
+
+#include "TexasGUI/KTXReader.hpp"
+#include "TexasGUI/TextureKernels.hpp"
+
+#include <memory>
+
+class QLabel;
+class QProgressBar;
+class QTimer;
+
+namespace TexasGUI
+{
+	struct LoadJob;
+
+	// Everything the ImageTab needs, produced off the GUI thread.
+	struct LoadedTexture
+	{
+		Texas::Texture texture{};
+		MinMaxData minMaxData{};
+		// Displayable version of the (0, 0) subresource, the rest is converted on demand.
+		QByteArray baseDisplayData{};
+
+		// Set instead of everything above for KTX files too large to load, those are read tile by tile.
+		std::shared_ptr<KTX::TiledReader> tiledReader{};
+
+		// Only set if the load failed, in which case the rest is empty.
+		QString errorTitle{};
+		QString errorDetails{};
+	};
+
+	// Placeholder tab shown while a file is loaded on the global thread pool.
+	// Destroying the tab cancels the load.
+	class LoadingTab : public QWidget
+	{
+		Q_OBJECT
+
+	public:
+		explicit LoadingTab(QString const& fullPath);
+		~LoadingTab() override;
+
+		QString const& fullPath() const;
+		std::shared_ptr<LoadedTexture> takeResult();
+
+	signals:
+		void loadFinished(TexasGUI::LoadingTab* tab);
+
+	private slots:
+		void workerFinished();
+		void updateProgress();
+
+	private:
+		QString path{};
+		std::shared_ptr<LoadJob> job{};
+		std::shared_ptr<LoadedTexture> result{};
+
+		QFutureWatcher<std::shared_ptr<LoadedTexture>>* watcher = nullptr;
+		QTimer* progressTimer = nullptr;
+		QLabel* stageLabel = nullptr;
+		QProgressBar* progressBar = nullptr;
+	};
+}
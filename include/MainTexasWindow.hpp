@@ -9,6 +9,7 @@ class QStackedLayout;
 namespace TexasGUI
 {
     class ImageTab;
+    class LoadingTab;
 
     class MainTexasWindow : public QMainWindow
     {
@@ -17,13 +18,20 @@ namespace TexasGUI
     public:
         MainTexasWindow();
 
+        // Opens a file like the open dialog does, without asking for it.
+        void openPath(QString const& fileName);
+        [[nodiscard]] int tabCount() const;
+        // A LoadingTab until the file is loaded, then whatever it was swapped for.
+        [[nodiscard]] QWidget* tabWidget(int index) const;
 
     public slots:
         void clickedMenuQuit();
         void openFile();
+        void compareTabs();
         void tabCloseRequested(int index);
         void tabSelectedChanged(int index);
         void tabMoved(int from, int to);
+        void loadFinished(LoadingTab* loadingTab);
 
     signals:
 
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <QCache>
+#include <QHash>
+#include <QPixmap>
+
+#include <cstdint>
+
+namespace TexasGUI
+{
+	// Everything that decides what a tile looks like on screen.
+	struct PresentationKey
+	{
+		std::uint64_t mipIndex = 0;
+		std::uint64_t layerIndex = 0;
+		std::uint32_t tileX = 0;
+		std::uint32_t tileY = 0;
+		bool scaleToBase = false;
+		int visualizationKey = 0;
+		// Size on screen, which is where the zoom comes in.
+		int width = 0;
+		int height = 0;
+
+		[[nodiscard]] bool operator==(PresentationKey const& other) const
+		{
+			return mipIndex == other.mipIndex && layerIndex == other.layerIndex &&
+				tileX == other.tileX && tileY == other.tileY &&
+				scaleToBase == other.scaleToBase && visualizationKey == other.visualizationKey &&
+				width == other.width && height == other.height;
+		}
+		[[nodiscard]] friend uint qHash(PresentationKey const& key, uint seed = 0)
+		{
+			return qHash(key.mipIndex, seed) ^ qHash(key.layerIndex, seed) ^
+				qHash((quint64(key.tileX) << 32) | key.tileY, seed) ^
+				qHash((qint64(key.width) << 32) | key.height, seed) ^
+				qHash((key.visualizationKey << 1) | int(key.scaleToBase), seed);
+		}
+	};
+
+	// Tiles converted, visualized and scaled all the way to pixmaps, so going back to a subresource
+	// that has been on screen before paints straight away. The least recently used pixmaps are
+	// dropped once the memory budget is exceeded.
+	class PresentationCache
+	{
+	public:
+		static constexpr std::uint64_t defaultMemoryBudget = 128ull * 1024 * 1024;
+
+		explicit PresentationCache(std::uint64_t memoryBudget = defaultMemoryBudget);
+
+		PresentationCache(PresentationCache const&) = delete;
+		PresentationCache& operator=(PresentationCache const&) = delete;
+
+		[[nodiscard]] bool find(PresentationKey const& key, QPixmap& pixmap);
+		void insert(PresentationKey const& key, QPixmap const& pixmap);
+		void clear();
+
+		void setMemoryBudget(std::uint64_t memoryBudget);
+		[[nodiscard]] std::uint64_t memoryBudget() const;
+		[[nodiscard]] std::uint64_t memoryUsage() const;
+
+	private:
+		// QCache counts cost in int, so costs are in KiB.
+		QCache<PresentationKey, QPixmap> pixmaps;
+	};
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Texas/Texture.hpp"
+
+#include <cstdint>
+
+namespace TexasGUI::BCn
+{
+	[[nodiscard]] bool isBlockCompressed(Texas::PixelFormat pixelFormat) noexcept;
+
+	// Size of one 4x4 block in bytes, 0 if pixelFormat isn't block compressed.
+	[[nodiscard]] std::uint8_t blockSize(Texas::PixelFormat pixelFormat) noexcept;
+
+	// Single block decoders. dst receives the 4x4 block row by row as RGBA8, 64 bytes in total.
+	// Single and dual channel formats fill the remaining channels like the uncompressed ones do:
+	// BC4 is shown as grayscale, BC5 has a black blue channel.
+	void decodeBC1(unsigned char const* block, unsigned char* dst, bool hasAlpha) noexcept;
+	void decodeBC2(unsigned char const* block, unsigned char* dst) noexcept;
+	void decodeBC3(unsigned char const* block, unsigned char* dst) noexcept;
+	void decodeBC4(unsigned char const* block, unsigned char* dst, bool isSigned) noexcept;
+	void decodeBC5(unsigned char const* block, unsigned char* dst, bool isSigned) noexcept;
+	void decodeBC7(unsigned char const* block, unsigned char* dst) noexcept;
+
+	// BC6H is HDR, so it decodes to 16 RGBA floats instead. Alpha is always 1.
+	void decodeBC6H(unsigned char const* block, float* dst, bool isSigned) noexcept;
+
+	// Any of the above as 16 RGBA floats, normalized like decodeSubresourceToRGBA32F does.
+	void decodeBlockToRGBA32F(Texas::TextureInfo const& texInfo, unsigned char const* block, float* dst) noexcept;
+
+	// Decodes a single (mip, layer) subresource into tightly packed RGBA8, spread across the global thread pool
+	// one row of blocks at a time. BC6H is clamped to [0, 1] like the uncompressed float formats.
+	// Returns false if the format isn't block compressed.
+	bool decodeSubresourceToRGBA8(
+		Texas::TextureInfo const& texInfo,
+		Texas::ConstByteSpan byteSpan,
+		std::uint64_t mipIndex,
+		std::uint64_t layerIndex,
+		unsigned char* dst,
+		int maxThreads = 0);
+
+	// Same as above, but into tightly packed RGBA floats so BC6H keeps its range.
+	// The 8-bit formats are normalized to [0, 1], or [-1, 1] for the signed ones.
+	bool decodeSubresourceToRGBA32F(
+		Texas::TextureInfo const& texInfo,
+		Texas::ConstByteSpan byteSpan,
+		std::uint64_t mipIndex,
+		std::uint64_t layerIndex,
+		float* dst,
+		int maxThreads = 0);
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "TexasGUI/TextureKernels.hpp"
+
+#include "Texas/Texture.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace TexasGUI::BCn
+{
+	// Trades encoding time for quality. Each tier does everything the one before it does, and then some.
+	//  Fast:       bounding box endpoints, a single pass over the pixels.
+	//  Normal:     principal axis endpoints refined once by least squares.
+	//  High:       more refinement, also tries BC1's three color mode and two subset BC7 partitions.
+	//  Exhaustive: local search around the best endpoints found, and every BC7 mode we encode.
+	enum class EncodeQuality
+	{
+		Fast,
+		Normal,
+		High,
+		Exhaustive,
+		COUNT
+	};
+
+	[[nodiscard]] char const* toString(EncodeQuality quality) noexcept;
+
+	// BC1, BC3, BC4, BC5 and BC7.
+	[[nodiscard]] bool canEncode(Texas::PixelFormat pixelFormat) noexcept;
+
+	// Single block encoders. src is the 4x4 block row by row as RGBA8, 64 bytes in total.
+	// BC4 encodes the red channel, BC5 red and green.
+	void encodeBC1(unsigned char const* src, unsigned char* block, bool hasAlpha, EncodeQuality quality) noexcept;
+	void encodeBC3(unsigned char const* src, unsigned char* block, EncodeQuality quality) noexcept;
+	void encodeBC4(unsigned char const* src, unsigned char* block, EncodeQuality quality) noexcept;
+	void encodeBC5(unsigned char const* src, unsigned char* block, EncodeQuality quality) noexcept;
+	void encodeBC7(unsigned char const* src, unsigned char* block, EncodeQuality quality) noexcept;
+
+	// What encoding a texture into targetFormat produces. sRGB sources stay sRGB for the color formats,
+	// everything else becomes unsigned normalized.
+	[[nodiscard]] Texas::TextureInfo encodedTextureInfo(Texas::TextureInfo const& srcInfo, Texas::PixelFormat targetFormat) noexcept;
+
+	// Compresses every (mip, layer) of a texture into targetFormat. The source can be any format that
+	// BuildDisplayableSubresource understands, it is converted to RGBA8 first.
+	// Blocks are encoded in tiles of block rows spread across the global thread pool, one progress unit per tile.
+	// Returns false if either format isn't supported or the job was cancelled.
+	bool encodeTexture(
+		Texas::TextureInfo const& srcInfo,
+		Texas::ConstByteSpan srcData,
+		Texas::PixelFormat targetFormat,
+		EncodeQuality quality,
+		Texas::TextureInfo& dstInfo,
+		std::vector<std::byte>& dstData,
+		KernelProgress* progress = nullptr,
+		int maxThreads = 0);
+
+	// Compresses every layer of a single mip level, for writers that stream one mip at a time.
+	// dstData receives the layers back to back, exactly like that mip is laid out in encodeTexture's output.
+	bool encodeMipLevel(
+		Texas::TextureInfo const& srcInfo,
+		Texas::ConstByteSpan srcData,
+		std::uint64_t mipIndex,
+		Texas::PixelFormat targetFormat,
+		EncodeQuality quality,
+		std::vector<std::byte>& dstData,
+		int maxThreads = 0);
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Texas/Texture.hpp"
+
+#include <cstdint>
+
+// The sRGB transfer function (IEC 61966-2-1), and which textures it applies to.
+// Averaging, filtering and blending only make sense on linear values, so everything that does arithmetic on
+// sRGB encoded pixels decodes them first and encodes the result again. Whole rows at a time go through the
+// vectorized versions in SimdKernels.hpp, which give exactly the same results as the functions here.
+namespace TexasGUI::ColorSpace
+{
+	// Whether the color channels of a texture hold sRGB encoded values: sRGB channels, or unsigned normalized
+	// ones in an sRGB color space. Floats are always linear, and alpha never is encoded.
+	[[nodiscard]] bool isSRGBEncoded(Texas::TextureInfo const& texInfo) noexcept;
+
+	// Square roots and Newton steps instead of pow, the same operations the SIMD kernels do, so every
+	// instruction set gives the same bits. Both stay within 14 float ulps of the exact curves.
+	// Negative values and NaN encode to 0, values above 1 follow the curve.
+	[[nodiscard]] float linearToSRGB(float value) noexcept;
+	[[nodiscard]] float srgbToLinear(float value) noexcept;
+
+	// A table lookup.
+	[[nodiscard]] float srgb8ToLinear(std::uint8_t code) noexcept;
+	// The nearest 8-bit code, exactly rounded. Clamped to [0, 1], NaN becomes 0.
+	[[nodiscard]] std::uint8_t linearToSRGB8(float value) noexcept;
+}
+
+// For code that converts whole rows itself, like the SIMD kernels.
+namespace TexasGUI::ColorSpace::Detail
+{
+	constexpr int srgb8BucketCount = 4096;
+
+	struct SRGB8Tables
+	{
+		// [0, 256) decodes sRGB codes, [256, 512) is code / 255 for alpha, so a single gather can do both.
+		float toLinear[512];
+		// The smallest floats not below the linear values halfway between neighbouring codes.
+		// The last one is above 1 and never reached.
+		float thresholds[256];
+		// The code at the bottom of each 1/srgb8BucketCount slice of [0, 1]. sRGB is never steeper than 12.92,
+		// which keeps the slices thinner than one code, so encoding only has to step past one threshold at most.
+		// Padded so 32-bit gathers can read the last one.
+		std::uint8_t buckets[srgb8BucketCount + 4];
+	};
+
+	[[nodiscard]] SRGB8Tables const& srgb8Tables() noexcept;
+
+	// The Newton steps for x^(-1/3) and x^(-1/5) start from these minus a third or a fifth of the bits of x,
+	// which is within 3.5% everywhere.
+	constexpr std::int32_t inverseCbrtGuess = 0x54A23000;
+	constexpr std::int32_t inverseFifthRootGuess = 0x4C2BB000;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <QByteArray>
+#include <QMutex>
+
+#include "Texas/Texture.hpp"
+
+#include <cstdint>
+#include <list>
+#include <map>
+
+namespace TexasGUI
+{
+	// Lazily converted RGBA8 copies of a texture's subresources, keyed by (mip, layer).
+	// A subresource is only converted the first time it's asked for, and the least
+	// recently used ones are dropped once the memory budget is exceeded.
+	// Reading ahead is left to the TileScheduler, through prefetch().
+	//
+	// The source buffer must outlive the cache.
+	class DisplayCache
+	{
+	public:
+		static constexpr std::uint64_t defaultMemoryBudget = 512ull * 1024 * 1024;
+
+		DisplayCache(
+			Texas::TextureInfo const& texInfo,
+			Texas::ConstByteSpan byteSpan,
+			std::uint64_t memoryBudget = defaultMemoryBudget);
+
+		DisplayCache(DisplayCache const&) = delete;
+		DisplayCache& operator=(DisplayCache const&) = delete;
+
+		// Returns the RGBA8 data of the subresource, converting it if needed.
+		// Returns an empty array if the format can't be displayed.
+		[[nodiscard]] QByteArray get(std::uint64_t mipIndex, std::uint64_t layerIndex);
+
+		// Like get(), for reading ahead of the user. Doesn't count as a use: it is only converted if it fits in
+		// the spare budget, never pushes anything out and isn't protected from eviction.
+		// Returns an empty array if it doesn't fit.
+		[[nodiscard]] QByteArray prefetch(std::uint64_t mipIndex, std::uint64_t layerIndex);
+
+		// Hands the cache a subresource that has already been converted elsewhere.
+		void insert(std::uint64_t mipIndex, std::uint64_t layerIndex, QByteArray const& data);
+
+	private:
+		struct Key
+		{
+			std::uint64_t mipIndex;
+			std::uint64_t layerIndex;
+
+			[[nodiscard]] bool operator<(Key const& other) const
+			{
+				if (mipIndex != other.mipIndex)
+					return mipIndex < other.mipIndex;
+				return layerIndex < other.layerIndex;
+			}
+			[[nodiscard]] bool operator==(Key const& other) const
+			{
+				return mipIndex == other.mipIndex && layerIndex == other.layerIndex;
+			}
+		};
+		struct Entry
+		{
+			QByteArray data;
+			std::list<Key>::iterator lruPosition;
+		};
+
+		void insert_Locked(Key key, QByteArray const& data, bool isPrefetch = false);
+		void evict_Locked(Key justInserted);
+
+		Texas::TextureInfo texInfo{};
+		Texas::ConstByteSpan byteSpan{};
+
+		mutable QMutex mutex;
+		std::uint64_t budget = 0;
+		std::uint64_t usage = 0;
+		// The subresource last returned by get(), never evicted to make room for prefetches.
+		Key lastRequested{};
+		std::map<Key, Entry> entries;
+		// Most recently used at the front.
+		std::list<Key> lruOrder;
+	};
+}
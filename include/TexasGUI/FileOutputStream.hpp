@@ -0,0 +1,65 @@
+#pragma once
+
+#include <QString>
+
+#include "Texas/OutputStream.hpp"
+#include "Texas/Result.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+class QFile;
+
+namespace TexasGUI
+{
+	// Texas::OutputStream that writes to a file through a large staging buffer.
+	// Small writes like headers are gathered in the buffer. Large ones go straight to the file,
+	// in the same vectored write as whatever was buffered before them where the platform has one.
+	// The first error sticks, every write after it fails with the same result and so does close().
+	// Its message says why the OS refused and lives as long as the stream.
+	class FileOutputStream : public Texas::OutputStream
+	{
+	public:
+		static constexpr std::size_t defaultBufferSize = std::size_t(4) << 20;
+
+		explicit FileOutputStream(std::size_t bufferSize = defaultBufferSize);
+		FileOutputStream(FileOutputStream const&) = delete;
+		FileOutputStream& operator=(FileOutputStream const&) = delete;
+		// Closes the file if it's still open, without reporting errors. Call close() to see them.
+		~FileOutputStream();
+
+		// Creates or truncates the file.
+		[[nodiscard]] Texas::Result open(QString const& path);
+		// Writes out anything still buffered and closes the file.
+		[[nodiscard]] Texas::Result close() noexcept;
+
+		virtual Texas::Result write(char const* data, std::uint64_t size) noexcept override;
+
+		[[nodiscard]] bool isOpen() const noexcept;
+		[[nodiscard]] std::uint64_t bytesWritten() const noexcept;
+
+	private:
+		struct AlignedDeleter
+		{
+			void operator()(char* pointer) const noexcept;
+		};
+
+		Texas::Result flushBuffer() noexcept;
+		// Writes a followed by b, either can be empty.
+		Texas::Result writeToFile(char const* a, std::uint64_t aSize, char const* b, std::uint64_t bSize) noexcept;
+		// reason is the OS's explanation, if there is one.
+		Texas::Result fail(char const* message, char const* reason = nullptr) noexcept;
+
+		std::unique_ptr<char[], AlignedDeleter> buffer{};
+		std::size_t bufferCapacity = 0;
+		std::size_t bufferUsed = 0;
+		std::uint64_t totalWritten = 0;
+		Texas::Result error{ Texas::ResultType::Success, nullptr };
+		char errorMessage[256] = {};
+
+		// POSIX systems write through the file descriptor, everything else through QFile.
+		int fileDescriptor = -1;
+		std::unique_ptr<QFile> file{};
+	};
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "TexasGUI/KTXReader.hpp"
+
+#include <QByteArray>
+
+#include "Texas/Texture.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace TexasGUI
+{
+	enum class FloatVisualizationMode
+	{
+		// Stretches each color channel's own min/max to [0, 1], alpha is only clamped.
+		Remap,
+		// Shows values as they are, anything outside [0, 1] is clipped.
+		Clamp,
+		// Scales by 2^exposure and clips, sRGB encoded like a linear HDR image would be shown.
+		Exposure,
+		Reinhard,
+		ACES,
+		COUNT
+	};
+
+	[[nodiscard]] char const* toString(FloatVisualizationMode mode) noexcept;
+
+	// How float and HDR textures are turned into something displayable.
+	struct FloatVisualization
+	{
+		FloatVisualizationMode mode = FloatVisualizationMode::Remap;
+		// In stops, only used by the modes that tone map.
+		float exposure = 0.f;
+
+		[[nodiscard]] bool usesExposure() const noexcept;
+		// Tells apart visualizations that produce different pixels, for keying caches.
+		[[nodiscard]] int cacheKey() const noexcept;
+
+		[[nodiscard]] bool operator==(FloatVisualization const& other) const noexcept;
+		[[nodiscard]] bool operator!=(FloatVisualization const& other) const noexcept;
+	};
+
+	// Per-channel range of the finite values, NaN and infinity are skipped.
+	// Only the channels the format has are filled in.
+	struct FloatRange
+	{
+		float min[4] = {
+			std::numeric_limits<float>::max(),
+			std::numeric_limits<float>::max(),
+			std::numeric_limits<float>::max(),
+			std::numeric_limits<float>::max() };
+		float max[4] = {
+			std::numeric_limits<float>::lowest(),
+			std::numeric_limits<float>::lowest(),
+			std::numeric_limits<float>::lowest(),
+			std::numeric_limits<float>::lowest() };
+	};
+
+	// The uncompressed float formats and BC6H.
+	[[nodiscard]] bool isFloatFormat(Texas::TextureInfo const& texInfo) noexcept;
+
+	// Both functions below work on a region of one depth slice. slice points at its first row of pixels,
+	// or of blocks for BC6H, and rows are rowPitch bytes apart. BC6H regions don't have to be block aligned.
+
+	// Grows range by the values in region.
+	bool findFloatRange(
+		Texas::TextureInfo const& texInfo,
+		std::byte const* slice,
+		std::uint64_t rowPitch,
+		KTX::Region const& region,
+		FloatRange& range);
+
+	// Converts region to tightly packed RGBA8. range is only used by Remap.
+	// Single channel formats are shown as grayscale, missing channels are black and alpha defaults to opaque.
+	bool visualizeFloatRegion(
+		Texas::TextureInfo const& texInfo,
+		std::byte const* slice,
+		std::uint64_t rowPitch,
+		KTX::Region const& region,
+		FloatVisualization const& visualization,
+		FloatRange const& range,
+		QByteArray& rgba);
+}
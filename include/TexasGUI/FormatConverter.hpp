@@ -0,0 +1,72 @@
+#pragma once
+
+#include "TexasGUI/TextureKernels.hpp"
+
+#include "Texas/OutputStream.hpp"
+#include "Texas/Result.hpp"
+#include "Texas/Texture.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace TexasGUI::Convert
+{
+	// Reads a row of pixels as RGBA floats. Normalized channels become [0, 1] or [-1, 1], float channels stay
+	// as they are, missing channels are 0 and alpha 1. With decodeSRGB the color channels are decoded to linear.
+	using LoadRowFunc = void(*)(unsigned char const* src, std::uint64_t pixelCount, bool decodeSRGB, float* dst) noexcept;
+	// The reverse of LoadRowFunc, channels the format doesn't have are dropped.
+	using StoreRowFunc = void(*)(float const* src, std::uint64_t pixelCount, bool encodeSRGB, unsigned char* dst) noexcept;
+
+	struct RowFunctions
+	{
+		std::uint8_t bytesPerPixel;
+		bool isFloat;
+		LoadRowFunc loadRow;
+		StoreRowFunc storeRow;
+	};
+
+	// Uncompressed formats with normalized or float channels, null for everything else.
+	[[nodiscard]] RowFunctions const* findRowFunctions(Texas::PixelFormat pixelFormat, Texas::ChannelType channelType) noexcept;
+
+	// Any uncompressed format converts to any other, as long as both have normalized or float channels, or both have
+	// integer channels (scaled included). Integers are clamped to what the target holds, there's nothing sensible
+	// to map them to between the two groups.
+	[[nodiscard]] bool canConvert(
+		Texas::TextureInfo const& srcInfo,
+		Texas::PixelFormat pixelFormat,
+		Texas::ChannelType channelType) noexcept;
+
+	// What converting produces. Only targets with sRGB channels are sRGB encoded, like KTX stores them, so sRGB
+	// sources are decoded to linear for any other target and linear ones are encoded for sRGB targets.
+	[[nodiscard]] Texas::TextureInfo convertedTextureInfo(
+		Texas::TextureInfo const& srcInfo,
+		Texas::PixelFormat pixelFormat,
+		Texas::ChannelType channelType) noexcept;
+
+	// Converts every layer of a single mip level, dstData receives them back to back like that mip is laid out
+	// in a texture. The rows of every layer are spread across the global thread pool.
+	// Common pairs like RGB8 to RGBA8, RGBA8 to BGRA8, 16 to 8 bits and float to half have vectorized paths,
+	// the rest go through RGBA floats, or 64-bit integers for integer channels.
+	// Returns false if the pair can't be converted or the job was cancelled.
+	bool convertMipLevel(
+		Texas::TextureInfo const& srcInfo,
+		Texas::ConstByteSpan srcData,
+		std::uint64_t mipIndex,
+		Texas::PixelFormat pixelFormat,
+		Texas::ChannelType channelType,
+		std::vector<std::byte>& dstData,
+		KernelProgress* progress = nullptr,
+		int maxThreads = 0);
+
+	// Converts a whole texture and writes it as KTX, one mip level at a time straight into KTX::StreamingWriter,
+	// so only a single converted level is ever held in memory. One progress unit per mip level.
+	[[nodiscard]] Texas::Result saveToStream(
+		Texas::TextureInfo const& srcInfo,
+		Texas::ConstByteSpan srcData,
+		Texas::PixelFormat pixelFormat,
+		Texas::ChannelType channelType,
+		Texas::OutputStream& stream,
+		KernelProgress* progress = nullptr,
+		int maxThreads = 0);
+}
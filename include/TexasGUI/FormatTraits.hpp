@@ -0,0 +1,261 @@
+#pragma once
+
+#include "TexasGUI/TextureKernels.hpp"
+
+#include "Texas/Texture.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+namespace TexasGUI
+{
+	// Memory layout of a pixel format, independent of how the channels are interpreted.
+	// Formats that aren't specialized here (the block compressed ones) have no per-pixel layout.
+	template<Texas::PixelFormat pixelFormat>
+	struct PixelFormatTraits
+	{
+		static constexpr bool isUncompressed = false;
+		static constexpr std::uint8_t channelCount = 0;
+		static constexpr std::uint8_t bytesPerChannel = 0;
+		static constexpr bool isBGR = false;
+	};
+
+	template<std::uint8_t channelCount_, std::uint8_t bytesPerChannel_, bool isBGR_ = false>
+	struct UncompressedLayout
+	{
+		static constexpr bool isUncompressed = true;
+		static constexpr std::uint8_t channelCount = channelCount_;
+		static constexpr std::uint8_t bytesPerChannel = bytesPerChannel_;
+		static constexpr bool isBGR = isBGR_;
+	};
+
+	template<> struct PixelFormatTraits<Texas::PixelFormat::R_8> : UncompressedLayout<1, 1> {};
+	template<> struct PixelFormatTraits<Texas::PixelFormat::RG_8> : UncompressedLayout<2, 1> {};
+	template<> struct PixelFormatTraits<Texas::PixelFormat::RGB_8> : UncompressedLayout<3, 1> {};
+	template<> struct PixelFormatTraits<Texas::PixelFormat::BGR_8> : UncompressedLayout<3, 1, true> {};
+	template<> struct PixelFormatTraits<Texas::PixelFormat::RGBA_8> : UncompressedLayout<4, 1> {};
+	template<> struct PixelFormatTraits<Texas::PixelFormat::BGRA_8> : UncompressedLayout<4, 1, true> {};
+
+	template<> struct PixelFormatTraits<Texas::PixelFormat::R_16> : UncompressedLayout<1, 2> {};
+	template<> struct PixelFormatTraits<Texas::PixelFormat::RG_16> : UncompressedLayout<2, 2> {};
+	template<> struct PixelFormatTraits<Texas::PixelFormat::RGB_16> : UncompressedLayout<3, 2> {};
+	template<> struct PixelFormatTraits<Texas::PixelFormat::RGBA_16> : UncompressedLayout<4, 2> {};
+
+	template<> struct PixelFormatTraits<Texas::PixelFormat::R_32> : UncompressedLayout<1, 4> {};
+	template<> struct PixelFormatTraits<Texas::PixelFormat::RG_32> : UncompressedLayout<2, 4> {};
+	template<> struct PixelFormatTraits<Texas::PixelFormat::RGB_32> : UncompressedLayout<3, 4> {};
+	template<> struct PixelFormatTraits<Texas::PixelFormat::RGBA_32> : UncompressedLayout<4, 4> {};
+
+	// Every format with a PixelFormatTraits specialization above. The kernel table is generated from this list.
+	constexpr Texas::PixelFormat uncompressedPixelFormats[] = {
+		Texas::PixelFormat::R_8,
+		Texas::PixelFormat::RG_8,
+		Texas::PixelFormat::RGB_8,
+		Texas::PixelFormat::BGR_8,
+		Texas::PixelFormat::RGBA_8,
+		Texas::PixelFormat::BGRA_8,
+		Texas::PixelFormat::R_16,
+		Texas::PixelFormat::RG_16,
+		Texas::PixelFormat::RGB_16,
+		Texas::PixelFormat::RGBA_16,
+		Texas::PixelFormat::R_32,
+		Texas::PixelFormat::RG_32,
+		Texas::PixelFormat::RGB_32,
+		Texas::PixelFormat::RGBA_32 };
+
+	constexpr Texas::ChannelType allChannelTypes[] = {
+		Texas::ChannelType::UnsignedNormalized,
+		Texas::ChannelType::SignedNormalized,
+		Texas::ChannelType::UnsignedInteger,
+		Texas::ChannelType::SignedInteger,
+		Texas::ChannelType::UnsignedScaled,
+		Texas::ChannelType::SignedScaled,
+		Texas::ChannelType::UnsignedFloat,
+		Texas::ChannelType::SignedFloat,
+		Texas::ChannelType::sRGB };
+
+	enum class ChannelClass
+	{
+		Unsigned,
+		Signed,
+		Float,
+		Unsupported
+	};
+
+	[[nodiscard]] constexpr ChannelClass toChannelClass(Texas::ChannelType channelType)
+	{
+		switch (channelType)
+		{
+		case Texas::ChannelType::UnsignedNormalized:
+		case Texas::ChannelType::UnsignedInteger:
+		case Texas::ChannelType::UnsignedScaled:
+		case Texas::ChannelType::sRGB:
+			return ChannelClass::Unsigned;
+		case Texas::ChannelType::SignedNormalized:
+		case Texas::ChannelType::SignedInteger:
+		case Texas::ChannelType::SignedScaled:
+			return ChannelClass::Signed;
+		case Texas::ChannelType::UnsignedFloat:
+		case Texas::ChannelType::SignedFloat:
+			return ChannelClass::Float;
+		default:
+			return ChannelClass::Unsupported;
+		}
+	}
+
+	// The type a single channel is stored as in memory. 16-bit floats are stored as their raw bits.
+	template<ChannelClass channelClass, std::uint8_t bytesPerChannel>
+	struct ChannelStorage { using Type = void; };
+
+	template<> struct ChannelStorage<ChannelClass::Unsigned, 1> { using Type = std::uint8_t; };
+	template<> struct ChannelStorage<ChannelClass::Unsigned, 2> { using Type = std::uint16_t; };
+	template<> struct ChannelStorage<ChannelClass::Unsigned, 4> { using Type = std::uint32_t; };
+	template<> struct ChannelStorage<ChannelClass::Signed, 1> { using Type = std::int8_t; };
+	template<> struct ChannelStorage<ChannelClass::Signed, 2> { using Type = std::int16_t; };
+	template<> struct ChannelStorage<ChannelClass::Signed, 4> { using Type = std::int32_t; };
+	template<> struct ChannelStorage<ChannelClass::Float, 2> { using Type = std::uint16_t; };
+	template<> struct ChannelStorage<ChannelClass::Float, 4> { using Type = float; };
+
+	// Everything the generic kernels need to know about a format/channel type pair.
+	template<Texas::PixelFormat pixelFormat_, Texas::ChannelType channelType_>
+	struct FormatTraits : PixelFormatTraits<pixelFormat_>
+	{
+		using Layout = PixelFormatTraits<pixelFormat_>;
+
+		static constexpr Texas::PixelFormat pixelFormat = pixelFormat_;
+		static constexpr Texas::ChannelType channelType = channelType_;
+		static constexpr ChannelClass channelClass = toChannelClass(channelType_);
+		static constexpr std::uint8_t bytesPerPixel = Layout::channelCount * Layout::bytesPerChannel;
+
+		using Storage = typename ChannelStorage<channelClass, Layout::bytesPerChannel>::Type;
+		static constexpr bool isSupported = Layout::isUncompressed && !std::is_void_v<Storage>;
+		static constexpr bool isHalf = channelClass == ChannelClass::Float && Layout::bytesPerChannel == 2;
+
+		// What a channel is widened to before doing anything with it.
+		using Value = std::conditional_t<isHalf, float, Storage>;
+
+		static constexpr MinMaxData::Type minMaxType =
+			channelClass == ChannelClass::Float ? MinMaxData::Type::Float :
+			channelClass == ChannelClass::Signed ? MinMaxData::Type::Int :
+			MinMaxData::Type::UnsignedInt;
+	};
+
+	[[nodiscard]] inline float halfToFloat(std::uint16_t half) noexcept
+	{
+		std::uint32_t const sign = std::uint32_t(half & 0x8000) << 16;
+		std::uint32_t exponent = (half >> 10) & 0x1F;
+		std::uint32_t mantissa = half & 0x3FF;
+
+		std::uint32_t bits;
+		if (exponent == 0x1F)
+			bits = sign | 0x7F800000 | (mantissa << 13) | (mantissa != 0 ? 0x00400000 : 0);
+		else if (exponent != 0)
+			bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+		else if (mantissa == 0)
+			bits = sign;
+		else
+		{
+			// Subnormal, shift it up until it's a normal float.
+			exponent = 113;
+			while ((mantissa & 0x400) == 0)
+			{
+				mantissa <<= 1;
+				exponent--;
+			}
+			bits = sign | (exponent << 23) | ((mantissa & 0x3FF) << 13);
+		}
+
+		float result;
+		std::memcpy(&result, &bits, sizeof(result));
+		return result;
+	}
+
+	// Rounds to nearest even. Too large values become infinity, NaNs keep the top of their payload like F16C does.
+	[[nodiscard]] inline std::uint16_t floatToHalf(float value) noexcept
+	{
+		std::uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		std::uint16_t const sign = static_cast<std::uint16_t>((bits >> 16) & 0x8000);
+		std::uint32_t const magnitude = bits & 0x7FFFFFFF;
+
+		if (magnitude > 0x7F800000)
+			return sign | 0x7E00 | static_cast<std::uint16_t>((magnitude >> 13) & 0x3FF);
+		// 65520 and up round to infinity.
+		if (magnitude >= 0x477FF000)
+			return sign | 0x7C00;
+		if (magnitude < 0x38800000)
+		{
+			// Subnormal, scaling by 2^24 is exact and leaves the integer to round.
+			float absolute;
+			std::memcpy(&absolute, &magnitude, sizeof(absolute));
+			return sign | static_cast<std::uint16_t>(std::nearbyint(absolute * 16777216.f));
+		}
+
+		std::uint32_t half = (magnitude - 0x38000000) >> 13;
+		std::uint32_t const remainder = magnitude & 0x1FFF;
+		if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1) != 0))
+			half++;
+		return sign | static_cast<std::uint16_t>(half);
+	}
+
+	template<typename Traits>
+	[[nodiscard]] inline typename Traits::Value loadChannel(unsigned char const* src) noexcept
+	{
+		typename Traits::Storage stored;
+		std::memcpy(&stored, src, sizeof(stored));
+		if constexpr (Traits::isHalf)
+			return halfToFloat(stored);
+		else
+			return stored;
+	}
+
+	// Maps one channel into 0-255 for display.
+	// Integer channels keep their top 8 bits, signed ones are offset so the most negative value becomes 0.
+	// Floats are clamped to [0, 1].
+	template<typename Traits>
+	[[nodiscard]] inline std::uint8_t toDisplayChannel(typename Traits::Value value) noexcept
+	{
+		using Value = typename Traits::Value;
+		if constexpr (Traits::channelClass == ChannelClass::Float)
+		{
+			if (!(value > 0.f))
+				return 0;
+			if (value >= 1.f)
+				return 255;
+			return static_cast<std::uint8_t>(value * 255.f + 0.5f);
+		}
+		else
+		{
+			using Bits = std::make_unsigned_t<Value>;
+			constexpr int shift = static_cast<int>(sizeof(Value) * 8) - 8;
+			Bits bits = static_cast<Bits>(value);
+			if constexpr (Traits::channelClass == ChannelClass::Signed)
+				bits ^= static_cast<Bits>(Bits(1) << (sizeof(Value) * 8 - 1));
+			return static_cast<std::uint8_t>(bits >> shift);
+		}
+	}
+
+	// Single channel formats are shown as grayscale, missing channels are black and alpha defaults to opaque.
+	template<typename Traits>
+	inline void writeDisplayPixel(typename Traits::Value const* channels, unsigned char* dst) noexcept
+	{
+		unsigned char rgba[4] = { 0, 0, 0, 255 };
+		for (std::uint8_t i = 0; i < Traits::channelCount; i++)
+			rgba[i] = toDisplayChannel<Traits>(channels[i]);
+		if constexpr (Traits::channelCount == 1)
+		{
+			rgba[1] = rgba[0];
+			rgba[2] = rgba[0];
+		}
+		if constexpr (Traits::isBGR)
+		{
+			unsigned char temp = rgba[0];
+			rgba[0] = rgba[2];
+			rgba[2] = temp;
+		}
+		std::memcpy(dst, rgba, 4);
+	}
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "TexasGUI/KTXReader.hpp"
+#include "TexasGUI/TextureKernels.hpp"
+
+#include <QByteArray>
+
+#include "Texas/Texture.hpp"
+
+#include <cstdint>
+#include <vector>
+
+// Measures how far one texture is from another, usually a re-encoded asset from its source.
+//
+// Pixels are compared as RGBA floats, normalized channels in [0, 1] and floats as they are, so PSNR always
+// takes 1 as the peak. sRGB encoded textures are compared encoded, which is closer to what is seen, unless
+// only one of the two is, then that one is decoded to linear first.
+// SSIM uses 8x8 windows every 4 pixels, built from the sums of 4x4 blocks, and the constants of Wang et al.
+// Subresources smaller than one window in either direction are treated as a single window.
+namespace TexasGUI::Compare
+{
+	// One of the two textures, byteSpan must outlive whatever it's handed to.
+	struct Input
+	{
+		Texas::TextureInfo texInfo{};
+		Texas::ConstByteSpan byteSpan{};
+	};
+
+	struct ChannelMetrics
+	{
+		double mse = 0;
+		// Infinity if the channel is identical.
+		double psnr = 0;
+		double ssim = 0;
+	};
+
+	struct SubresourceMetrics
+	{
+		std::uint64_t mipIndex = 0;
+		std::uint64_t layerIndex = 0;
+		ChannelMetrics channels[4] = {};
+	};
+
+	struct Metrics
+	{
+		// Channels both textures have, the others aren't compared.
+		std::uint8_t channelCount = 0;
+		// Mip by mip, the layers of each in order.
+		std::vector<SubresourceMetrics> subresources{};
+
+		[[nodiscard]] SubresourceMetrics const* find(std::uint64_t mipIndex, std::uint64_t layerIndex) const noexcept;
+	};
+
+	// Both have to be uncompressed with normalized or float channels, or block compressed, and have the same
+	// base dimensions. Only the mips and layers both have are compared.
+	[[nodiscard]] bool canCompare(Texas::TextureInfo const& a, Texas::TextureInfo const& b) noexcept;
+
+	[[nodiscard]] std::uint64_t comparedMipCount(Texas::TextureInfo const& a, Texas::TextureInfo const& b) noexcept;
+	[[nodiscard]] std::uint64_t comparedLayerCount(Texas::TextureInfo const& a, Texas::TextureInfo const& b) noexcept;
+
+	// Measures every compared (mip, layer) subresource. The work is split into strips of rows across every
+	// subresource and spread across the global thread pool, one progress unit per strip. Only a strip of
+	// each texture is decoded at a time, whatever the size of the textures.
+	// Returns false if the pair can't be compared or the job was cancelled.
+	bool compareTextures(
+		Input const& a,
+		Input const& b,
+		Metrics& metrics,
+		KernelProgress* progress = nullptr,
+		int maxThreads = 0);
+
+	// Fills rgba with a heatmap of region of the first depth slice, as tightly packed RGBA8. Each pixel is the
+	// root mean square of the compared channels' differences, with maxError and up at the hot end of the ramp.
+	bool buildDiffHeatmap(
+		Input const& a,
+		Input const& b,
+		std::uint64_t mipIndex,
+		std::uint64_t layerIndex,
+		KTX::Region const& region,
+		float maxError,
+		QByteArray& rgba);
+}
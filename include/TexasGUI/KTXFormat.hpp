@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Texas/Texture.hpp"
+
+#include <cstdint>
+
+// The parts of the KTX 1 container that both our writer and reader need.
+namespace TexasGUI::KTX
+{
+	constexpr unsigned char identifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n' };
+	constexpr std::uint32_t endiannessReference = 0x04030201;
+	constexpr std::uint64_t headerSize = 64;
+
+	// The OpenGL enums a KTX header describes a pixel format with.
+	struct GLFormat
+	{
+		std::uint32_t glType = 0;
+		std::uint32_t glTypeSize = 0;
+		std::uint32_t glFormat = 0;
+		std::uint32_t glInternalFormat = 0;
+		std::uint32_t glBaseInternalFormat = 0;
+	};
+
+	// Returns false if KTX has no way to describe the format.
+	[[nodiscard]] bool toGLFormat(Texas::PixelFormat pixelFormat, Texas::ChannelType channelType, GLFormat& glFormat) noexcept;
+
+	// The other way around. BGR formats are told apart from RGB ones by glFormat, sRGB comes out as ChannelType::sRGB.
+	[[nodiscard]] bool fromGLFormat(GLFormat const& glFormat, Texas::PixelFormat& pixelFormat, Texas::ChannelType& channelType) noexcept;
+
+	// Bytes per pixel of an uncompressed format, 0 for the block compressed ones.
+	[[nodiscard]] std::uint8_t bytesPerPixel(Texas::PixelFormat pixelFormat) noexcept;
+
+	// Bytes in one tightly packed row that is width pixels wide, a row of blocks for the block compressed formats.
+	[[nodiscard]] std::uint64_t packedRowSize(Texas::PixelFormat pixelFormat, std::uint64_t width) noexcept;
+
+	// How a single (mip, layer) is laid out inside a KTX file.
+	// Uncompressed rows are padded to 4 bytes, Texas keeps them tightly packed.
+	struct SubresourceLayout
+	{
+		std::uint64_t rowCount = 0;
+		// Bytes of actual pixel data per row, and how far apart rows are in the file.
+		std::uint64_t rowSize = 0;
+		std::uint64_t rowPitch = 0;
+		std::uint64_t fileSize = 0;
+		std::uint64_t packedSize = 0;
+	};
+
+	[[nodiscard]] SubresourceLayout subresourceLayout(Texas::TextureInfo const& texInfo, std::uint64_t mipIndex) noexcept;
+
+	[[nodiscard]] bool isCubemap(Texas::TextureType textureType) noexcept;
+	[[nodiscard]] bool isArray(Texas::TextureType textureType) noexcept;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "TexasGUI/KTXFormat.hpp"
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+
+#include "Texas/Result.hpp"
+#include "Texas/Texture.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace TexasGUI::KTX
+{
+	// A rectangle within one depth slice of a subresource, in pixels.
+	struct Region
+	{
+		std::uint64_t x = 0;
+		std::uint64_t y = 0;
+		std::uint64_t z = 0;
+		std::uint64_t width = 0;
+		std::uint64_t height = 0;
+	};
+
+	// Reads parts of a KTX 1 file without loading the rest of it, for textures that don't fit in memory.
+	// Only the header and the offset of every subresource are parsed up front. The file is memory mapped
+	// when possible, so regions are read straight out of the page cache, otherwise with positional reads.
+	// Reading is thread safe.
+	class TiledReader
+	{
+	public:
+		TiledReader() = default;
+		TiledReader(TiledReader const&) = delete;
+		TiledReader& operator=(TiledReader const&) = delete;
+		~TiledReader();
+
+		[[nodiscard]] Texas::Result open(QString const& path);
+		void close();
+
+		// fileFormat is KTX, cubemaps count each face as a layer like Texas does.
+		[[nodiscard]] Texas::TextureInfo const& textureInfo() const noexcept;
+		[[nodiscard]] bool isMapped() const noexcept;
+
+		// Where a subresource starts in the file and how its rows are laid out there.
+		[[nodiscard]] std::uint64_t subresourceOffset(std::uint64_t mipIndex, std::uint64_t layerIndex) const noexcept;
+		[[nodiscard]] SubresourceLayout const& layout(std::uint64_t mipIndex) const noexcept;
+
+		// Reads a region of a subresource in its own pixel format, tightly packed.
+		// Block compressed formats can only be read in whole blocks, so region is grown to block boundaries
+		// (and clamped to the subresource) first and holds what was actually read afterwards.
+		[[nodiscard]] bool readRegion(
+			std::uint64_t mipIndex,
+			std::uint64_t layerIndex,
+			Region& region,
+			std::vector<std::byte>& dst) const;
+
+		// Reads a region and converts it to tightly packed RGBA8 with the same kernels whole subresources use.
+		// Exactly region is returned, block compressed formats are cropped after decoding.
+		[[nodiscard]] bool readDisplayRegion(
+			std::uint64_t mipIndex,
+			std::uint64_t layerIndex,
+			Region const& region,
+			QByteArray& rgba) const;
+
+	private:
+		bool readBytes(std::uint64_t offset, std::uint64_t size, std::byte* dst) const;
+
+		mutable QFile file{};
+		uchar const* mappedData = nullptr;
+		std::uint64_t fileSize = 0;
+		// Only taken when positional reads through QFile are used.
+		mutable std::mutex fileMutex{};
+
+		Texas::TextureInfo texInfo{};
+		std::vector<std::uint64_t> mipOffsets{};
+		std::vector<SubresourceLayout> mipLayouts{};
+	};
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "TexasGUI/KTXFormat.hpp"
+
+#include "Texas/OutputStream.hpp"
+#include "Texas/Result.hpp"
+#include "Texas/Texture.hpp"
+
+#include <cstdint>
+
+namespace TexasGUI::KTX
+{
+	// Writes a KTX 1 file one subresource at a time, so a conversion only ever needs the mip level it's
+	// working on in memory instead of the whole chain.
+	//
+	// Subresources go in the order KTX stores them: every layer of mip 0, then every layer of mip 1 and so on.
+	// Data is tightly packed like in a Texas::Texture, rows are padded to what KTX wants on the way out.
+	// Cubemaps count each face as a layer, like Texas does.
+	class StreamingWriter
+	{
+	public:
+		// Checks that texInfo can be stored as KTX and writes the header.
+		[[nodiscard]] Texas::Result begin(Texas::TextureInfo const& texInfo, Texas::OutputStream& stream);
+
+		// Writes the next subresource. data has to be exactly one (mip, layer) in size.
+		[[nodiscard]] Texas::Result writeSubresource(Texas::ConstByteSpan data);
+
+		// Writes every layer of the next mip level, back to back like in a Texas::Texture.
+		// Can't be mixed with writeSubresource within the same mip level.
+		[[nodiscard]] Texas::Result writeMipLevel(Texas::ConstByteSpan data);
+
+		// Fails if not every subresource has been written.
+		[[nodiscard]] Texas::Result finish();
+
+		[[nodiscard]] std::uint64_t nextMipIndex() const noexcept;
+
+	private:
+		Texas::Result writePadded(unsigned char const* data, SubresourceLayout const& layout);
+
+		Texas::TextureInfo texInfo{};
+		Texas::OutputStream* stream = nullptr;
+		std::uint64_t mipIndex = 0;
+		std::uint64_t layerIndex = 0;
+	};
+
+	// Whether StreamingWriter can store a texture with this description.
+	[[nodiscard]] Texas::Result canSave(Texas::TextureInfo const& texInfo) noexcept;
+
+	// Writes a whole texture that's already in memory through StreamingWriter.
+	[[nodiscard]] Texas::Result saveToStream(Texas::TextureInfo const& texInfo, Texas::ConstByteSpan data, Texas::OutputStream& stream);
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QMutex>
+
+#include <cstdint>
+#include <vector>
+
+// Timings of the stages between opening a file and seeing it, and of what the user does afterwards.
+// The GUI reports them whenever a recorder is installed, which only the latency harness does, so
+// everyone else pays for one atomic load per stage.
+namespace TexasGUI::Latency
+{
+	enum class Stage : std::uint8_t
+	{
+		// Opening and mapping the file.
+		FileIO,
+		// Texas parsing the mapping into a Texture.
+		Parse,
+		// The min/max sweep, which also converts the first displayed subresource.
+		Statistics,
+		// Everything the ImageTab constructor does, caches, controls and viewport.
+		ImageTab,
+		LeftPanel,
+		// From handing the viewport a source to the first paint without missing tiles.
+		FirstPaint,
+		// From the harness asking for a file to the first paint without missing tiles, the harness records these.
+		OpenToFirstPixel,
+		// Subresources the DisplayCache converts on demand.
+		DisplayConversion,
+		// Every paint of the viewport, which is where tiles are scaled and turned into pixmaps.
+		Paint,
+		// From moving to another subresource to the first paint of it without missing tiles.
+		SubresourceSwitch,
+		// From starting an export to the file being written.
+		Export,
+		COUNT
+	};
+
+	[[nodiscard]] char const* toString(Stage stage) noexcept;
+
+	// Collects the samples of every stage. Safe to record into from any thread.
+	class Recorder
+	{
+	public:
+		virtual ~Recorder();
+
+		// Called on whichever thread the stage ran on.
+		virtual void record(Stage stage, std::int64_t nanoseconds);
+
+		[[nodiscard]] std::size_t sampleCount(Stage stage) const;
+		// In the order they were recorded.
+		[[nodiscard]] std::vector<std::int64_t> samples(Stage stage) const;
+		void clear();
+
+	private:
+		mutable QMutex mutex;
+		std::vector<std::int64_t> stageSamples[static_cast<std::size_t>(Stage::COUNT)];
+	};
+
+	// The recorder must outlive every stage that can still report, nullptr stops recording.
+	void setRecorder(Recorder* recorder) noexcept;
+	[[nodiscard]] Recorder* recorder() noexcept;
+
+	// Does nothing without a recorder.
+	void record(Stage stage, std::int64_t nanoseconds);
+
+	// Records the time from construction to destruction. Only reads the clock if a recorder is installed.
+	class ScopedStage
+	{
+	public:
+		explicit ScopedStage(Stage stage) noexcept;
+		~ScopedStage();
+
+		// Records now instead of at destruction, for stages that end before their scope does.
+		void finish();
+		// Drops the stage without recording, for paths that fail before it completes.
+		void cancel() noexcept;
+
+		ScopedStage(ScopedStage const&) = delete;
+		ScopedStage& operator=(ScopedStage const&) = delete;
+
+	private:
+		Stage stage;
+		QElapsedTimer timer;
+	};
+}
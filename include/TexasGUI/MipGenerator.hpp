@@ -0,0 +1,49 @@
+#pragma once
+
+#include "TexasGUI/TextureKernels.hpp"
+
+#include "Texas/Texture.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace TexasGUI::Mips
+{
+	// How each level is resampled from the one above it.
+	//  Box:     averages every 2x2 (or 2x2x2) group, fast but a little blurry.
+	//  Kaiser:  Kaiser windowed sinc, sharper with only slight ringing.
+	//  Lanczos: 3-lobed Lanczos, the sharpest, and rings the most around hard edges.
+	enum class Filter
+	{
+		Box,
+		Kaiser,
+		Lanczos,
+		COUNT
+	};
+
+	[[nodiscard]] char const* toString(Filter filter) noexcept;
+
+	// Levels in a full chain, down to 1x1x1.
+	[[nodiscard]] std::uint64_t fullMipCount(Texas::Dimensions baseDimensions) noexcept;
+
+	// Uncompressed formats with normalized or float channels, integer channels have nothing sensible to filter.
+	[[nodiscard]] bool canGenerate(Texas::TextureInfo const& texInfo) noexcept;
+
+	// Replaces whatever mips a texture has with a full chain built from the base level, in the source's format.
+	// The base level is copied as is. Filtering is done in linear floats, so with an sRGB color space the
+	// color channels are decoded first and encoded again afterwards, alpha is always linear.
+	// dstData is laid out like Texas lays out textures, ready to be passed to KTX::saveToStream.
+	// The rows and layers of each level are spread across the global thread pool. Huge arrays are worked on in
+	// batches of layers to bound the memory used, with one progress unit per level of each batch, and levels
+	// where even one layer is too large for that are made a band of rows at a time.
+	// Returns false if the format isn't supported, a single row is too wide to fit, or the job was cancelled.
+	bool generateMipChain(
+		Texas::TextureInfo const& srcInfo,
+		Texas::ConstByteSpan srcData,
+		Filter filter,
+		Texas::TextureInfo& dstInfo,
+		std::vector<std::byte>& dstData,
+		KernelProgress* progress = nullptr,
+		int maxThreads = 0);
+}
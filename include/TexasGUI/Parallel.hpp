@@ -0,0 +1,71 @@
+#pragma once
+
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThreadPool>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace TexasGUI
+{
+	// Calls func(index) for every index in [0, count), spread across the global thread pool.
+	//
+	// Indices are handed out one at a time from a shared counter, so threads that finish early
+	// just pick up more work. The calling thread works too instead of only waiting on the pool,
+	// which makes this safe to call from a task that is itself running on the pool.
+	//
+	// maxThreads is the total number of threads working on it including the caller,
+	// 0 means one per thread in the pool.
+	template<typename Func>
+	void parallelFor(std::uint64_t count, Func const& func, int maxThreads = 0)
+	{
+		if (count == 0)
+			return;
+
+		QThreadPool* pool = QThreadPool::globalInstance();
+		std::uint64_t threadCount = maxThreads > 0 ? maxThreads : std::max(pool->maxThreadCount(), 1);
+		threadCount = std::min(threadCount, count);
+		if (threadCount == 1)
+		{
+			for (std::uint64_t i = 0; i < count; i++)
+				func(i);
+			return;
+		}
+
+		// Helpers can start after everything is done and the caller has returned,
+		// so they only hold on to this and only touch func if they actually got an index.
+		struct State
+		{
+			std::atomic<std::uint64_t> nextIndex{ 0 };
+			std::atomic<std::uint64_t> finishedCount{ 0 };
+			std::uint64_t count = 0;
+			Func const* func = nullptr;
+			QSemaphore completed;
+		};
+		std::shared_ptr<State> state = std::make_shared<State>();
+		state->count = count;
+		state->func = &func;
+
+		auto work = [state]()
+		{
+			while (true)
+			{
+				std::uint64_t index = state->nextIndex.fetch_add(1);
+				if (index >= state->count)
+					return;
+				(*state->func)(index);
+				// QSemaphore counts in ints, so only whoever finishes the last index wakes the caller.
+				if (state->finishedCount.fetch_add(1) + 1 == state->count)
+					state->completed.release();
+			}
+		};
+
+		for (std::uint64_t i = 0; i < threadCount - 1; i++)
+			pool->start(QRunnable::create(work));
+		work();
+		state->completed.acquire();
+	}
+}
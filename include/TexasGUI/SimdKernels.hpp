@@ -0,0 +1,236 @@
+#pragma once
+
+#include <cstdint>
+
+// The vectorized paths are only written for x86-64, everything else uses the scalar ones.
+#if defined(__x86_64__) || defined(_M_X64)
+#	define TEXASGUI_SIMD_X86
+#endif
+
+// Vectorized versions of the innermost pixel loops.
+// Every function picks the best implementation for the CPU it runs on the first time it's called,
+// and falls back to plain scalar code on CPUs (or architectures) without the needed instructions.
+namespace TexasGUI::Simd
+{
+	enum class InstructionSet
+	{
+		Scalar,
+		SSE2,
+		SSSE3,
+		AVX2
+	};
+
+	[[nodiscard]] InstructionSet detectInstructionSet() noexcept;
+	[[nodiscard]] char const* toString(InstructionSet instructionSet) noexcept;
+
+	// Overrides what detectInstructionSet() found, for benchmarking the different paths against each other.
+	// Asking for something the CPU doesn't support is clamped to what it does support.
+	void forceInstructionSet(InstructionSet instructionSet) noexcept;
+
+	// Copies tightly packed RGB8 pixels into RGBA8 pixels with alpha set to 255.
+	void expandRGB8ToRGBA8(
+		unsigned char const* src,
+		std::uint64_t pixelCount,
+		unsigned char* dst) noexcept;
+
+	// expandRGB8ToRGBA8 that also finds the per-channel min and max of the 3 source channels
+	// while the pixels are in registers anyway.
+	void expandRGB8ToRGBA8MinMax(
+		unsigned char const* src,
+		std::uint64_t pixelCount,
+		unsigned char* dst,
+		std::uint8_t* min,
+		std::uint8_t* max) noexcept;
+
+	// Copies RGBA8 pixels and finds the per-channel min and max of all 4 channels in the same pass.
+	void copyRGBA8MinMax(
+		unsigned char const* src,
+		std::uint64_t pixelCount,
+		unsigned char* dst,
+		std::uint8_t* min,
+		std::uint8_t* max) noexcept;
+
+	// Converts IEEE 754 half floats to floats, infinities, NaNs and subnormals included.
+	void halfToFloat(
+		std::uint16_t const* src,
+		std::uint64_t count,
+		float* dst) noexcept;
+
+	// Rounds floats to IEEE 754 half floats, to nearest even. Too large values become infinity.
+	void floatToHalf(
+		float const* src,
+		std::uint64_t count,
+		std::uint16_t* dst) noexcept;
+
+	// Swaps the first and third channel of 4 channel 8-bit pixels, which turns RGBA8 into BGRA8 and back.
+	void swapRedBlue8(
+		unsigned char const* src,
+		std::uint64_t pixelCount,
+		unsigned char* dst) noexcept;
+
+	// Narrows 16-bit unsigned normalized values to 8 bits, rounded to nearest.
+	void unorm16ToUnorm8(
+		std::uint16_t const* src,
+		std::uint64_t count,
+		std::uint8_t* dst) noexcept;
+
+	// Widens 8-bit unsigned normalized values to 16 bits, which is exact.
+	void unorm8ToUnorm16(
+		std::uint8_t const* src,
+		std::uint64_t count,
+		std::uint16_t* dst) noexcept;
+
+	// sRGB decodes the red, green and blue channels of RGBA32F pixels in place, alpha is left alone.
+	// The same results as ColorSpace::srgbToLinear.
+	void decodeSRGBRGBA32F(
+		float* rgba,
+		std::uint64_t pixelCount) noexcept;
+
+	// sRGB encodes the red, green and blue channels of RGBA32F pixels in place, alpha is left alone.
+	// The same results as ColorSpace::linearToSRGB, accurate enough to round to 16 bits afterwards.
+	void encodeSRGBRGBA32F(
+		float* rgba,
+		std::uint64_t pixelCount) noexcept;
+
+	// Decodes RGBA8 pixels with sRGB encoded color to linear RGBA32F, alpha is only scaled to [0, 1].
+	void decodeSRGBRGBA8ToRGBA32F(
+		unsigned char const* src,
+		std::uint64_t pixelCount,
+		float* dst) noexcept;
+
+	// Encodes linear RGBA32F pixels to RGBA8. Color is exactly rounded to the nearest sRGB code and alpha to the
+	// nearest step, both clamped to [0, 1] with NaN becoming 0. The same results as ColorSpace::linearToSRGB8.
+	void encodeSRGBRGBA32FToRGBA8(
+		float const* src,
+		std::uint64_t pixelCount,
+		unsigned char* dst) noexcept;
+
+	enum class ToneMapOperator
+	{
+		// Clamps to [0, 1].
+		None,
+		// x / (1 + x)
+		Reinhard,
+		// Narkowicz's fit of the ACES filmic curve.
+		ACES
+	};
+
+	// Maps RGBA32F pixels to RGBA8. Every channel is first transformed to value * scale[c] + offset[c],
+	// then red, green and blue go through the tone map operator. The result is clamped to [0, 1],
+	// NaN becomes 0, and with encodeSRGB the color channels are sRGB encoded on the way to 8 bits.
+	void toneMapRGBA32FToRGBA8(
+		float const* src,
+		std::uint64_t pixelCount,
+		float const* scale,
+		float const* offset,
+		ToneMapOperator toneMapOperator,
+		bool encodeSRGB,
+		unsigned char* dst) noexcept;
+
+	// Resamples a row of RGBA32F pixels with a precomputed filter, each output pixel being a weighted sum of
+	// tapCount consecutive input pixels: dst[i] = sum of weights[i * tapCount + k] * src[firstTaps[i] + k].
+	void resampleRowRGBA32F(
+		float const* src,
+		std::uint32_t const* firstTaps,
+		float const* weights,
+		std::uint32_t tapCount,
+		std::uint64_t dstCount,
+		float* dst) noexcept;
+
+	// Weighted sum of rowCount rows of RGBA32F pixels: dst = sum of weights[k] * rows[k].
+	void blendRowsRGBA32F(
+		float const* const* rows,
+		float const* weights,
+		std::uint32_t rowCount,
+		std::uint64_t pixelCount,
+		float* dst) noexcept;
+
+	// Adds the squared differences of two rows of RGBA32F pixels to sums, one double per channel.
+	// Differences are taken in floats, squared and summed in doubles, in the same order on every instruction set.
+	void sumSquaredErrorRGBA32F(
+		float const* a,
+		float const* b,
+		std::uint64_t pixelCount,
+		double* sums) noexcept;
+
+	// The sums SSIM is built from, for each 4x4 block of a strip of 4 rows of RGBA32F pixels, rowStride floats apart.
+	// Every block gets 16 floats: per channel the sums of a, of b, of a * a + b * b and of a * b, in that order.
+	void ssimBlockSumsRGBA32F(
+		float const* a,
+		float const* b,
+		std::uint64_t rowStride,
+		std::uint64_t blockCount,
+		float* sums) noexcept;
+
+	// Finds the per-channel min and max of tightly packed 8-bit pixels with 1 to 4 channels.
+	// Only the first channelCount entries of min and max are written.
+	void minMaxU8(
+		unsigned char const* src,
+		std::uint64_t pixelCount,
+		std::uint8_t channelCount,
+		std::uint8_t* min,
+		std::uint8_t* max) noexcept;
+}
+
+// Per instruction set implementations, only meant to be called through the dispatching functions above.
+namespace TexasGUI::Simd::Detail
+{
+	void expandRGB8ToRGBA8_Scalar(unsigned char const* src, std::uint64_t pixelCount, unsigned char* dst) noexcept;
+	void minMaxU8_Scalar(unsigned char const* src, std::uint64_t pixelCount, std::uint8_t channelCount, std::uint8_t* min, std::uint8_t* max) noexcept;
+	void expandRGB8ToRGBA8MinMax_Scalar(unsigned char const* src, std::uint64_t pixelCount, unsigned char* dst, std::uint8_t* min, std::uint8_t* max) noexcept;
+	void copyRGBA8MinMax_Scalar(unsigned char const* src, std::uint64_t pixelCount, unsigned char* dst, std::uint8_t* min, std::uint8_t* max) noexcept;
+	void halfToFloat_Scalar(std::uint16_t const* src, std::uint64_t count, float* dst) noexcept;
+	void floatToHalf_Scalar(float const* src, std::uint64_t count, std::uint16_t* dst) noexcept;
+	void swapRedBlue8_Scalar(unsigned char const* src, std::uint64_t pixelCount, unsigned char* dst) noexcept;
+	void unorm16ToUnorm8_Scalar(std::uint16_t const* src, std::uint64_t count, std::uint8_t* dst) noexcept;
+	void unorm8ToUnorm16_Scalar(std::uint8_t const* src, std::uint64_t count, std::uint16_t* dst) noexcept;
+	void decodeSRGBRGBA32F_Scalar(float* rgba, std::uint64_t pixelCount) noexcept;
+	void encodeSRGBRGBA32F_Scalar(float* rgba, std::uint64_t pixelCount) noexcept;
+	void decodeSRGBRGBA8ToRGBA32F_Scalar(unsigned char const* src, std::uint64_t pixelCount, float* dst) noexcept;
+	void encodeSRGBRGBA32FToRGBA8_Scalar(float const* src, std::uint64_t pixelCount, unsigned char* dst) noexcept;
+	void toneMapRGBA32FToRGBA8_Scalar(float const* src, std::uint64_t pixelCount, float const* scale, float const* offset, ToneMapOperator toneMapOperator, bool encodeSRGB, unsigned char* dst) noexcept;
+	void resampleRowRGBA32F_Scalar(float const* src, std::uint32_t const* firstTaps, float const* weights, std::uint32_t tapCount, std::uint64_t dstCount, float* dst) noexcept;
+	void blendRowsRGBA32F_Scalar(float const* const* rows, float const* weights, std::uint32_t rowCount, std::uint64_t pixelCount, float* dst) noexcept;
+	void sumSquaredErrorRGBA32F_Scalar(float const* a, float const* b, std::uint64_t pixelCount, double* sums) noexcept;
+	void ssimBlockSumsRGBA32F_Scalar(float const* a, float const* b, std::uint64_t rowStride, std::uint64_t blockCount, float* sums) noexcept;
+
+#ifdef TEXASGUI_SIMD_X86
+	void minMaxU8_SSE2(unsigned char const* src, std::uint64_t pixelCount, std::uint8_t channelCount, std::uint8_t* min, std::uint8_t* max) noexcept;
+	void copyRGBA8MinMax_SSE2(unsigned char const* src, std::uint64_t pixelCount, unsigned char* dst, std::uint8_t* min, std::uint8_t* max) noexcept;
+	void halfToFloat_SSE2(std::uint16_t const* src, std::uint64_t count, float* dst) noexcept;
+	void floatToHalf_SSE2(float const* src, std::uint64_t count, std::uint16_t* dst) noexcept;
+	void swapRedBlue8_SSE2(unsigned char const* src, std::uint64_t pixelCount, unsigned char* dst) noexcept;
+	void unorm16ToUnorm8_SSE2(std::uint16_t const* src, std::uint64_t count, std::uint8_t* dst) noexcept;
+	void unorm8ToUnorm16_SSE2(std::uint8_t const* src, std::uint64_t count, std::uint16_t* dst) noexcept;
+	void decodeSRGBRGBA32F_SSE2(float* rgba, std::uint64_t pixelCount) noexcept;
+	void encodeSRGBRGBA32F_SSE2(float* rgba, std::uint64_t pixelCount) noexcept;
+	// Without gathers the table lookups stay scalar, only the clamping and quantizing are vectorized.
+	void encodeSRGBRGBA32FToRGBA8_SSE2(float const* src, std::uint64_t pixelCount, unsigned char* dst) noexcept;
+	void toneMapRGBA32FToRGBA8_SSE2(float const* src, std::uint64_t pixelCount, float const* scale, float const* offset, ToneMapOperator toneMapOperator, bool encodeSRGB, unsigned char* dst) noexcept;
+	void resampleRowRGBA32F_SSE2(float const* src, std::uint32_t const* firstTaps, float const* weights, std::uint32_t tapCount, std::uint64_t dstCount, float* dst) noexcept;
+	void blendRowsRGBA32F_SSE2(float const* const* rows, float const* weights, std::uint32_t rowCount, std::uint64_t pixelCount, float* dst) noexcept;
+	void sumSquaredErrorRGBA32F_SSE2(float const* a, float const* b, std::uint64_t pixelCount, double* sums) noexcept;
+	void ssimBlockSumsRGBA32F_SSE2(float const* a, float const* b, std::uint64_t rowStride, std::uint64_t blockCount, float* sums) noexcept;
+
+	void expandRGB8ToRGBA8_SSSE3(unsigned char const* src, std::uint64_t pixelCount, unsigned char* dst) noexcept;
+	void expandRGB8ToRGBA8MinMax_SSSE3(unsigned char const* src, std::uint64_t pixelCount, unsigned char* dst, std::uint8_t* min, std::uint8_t* max) noexcept;
+	void swapRedBlue8_SSSE3(unsigned char const* src, std::uint64_t pixelCount, unsigned char* dst) noexcept;
+
+	void expandRGB8ToRGBA8_AVX2(unsigned char const* src, std::uint64_t pixelCount, unsigned char* dst) noexcept;
+	void minMaxU8_AVX2(unsigned char const* src, std::uint64_t pixelCount, std::uint8_t channelCount, std::uint8_t* min, std::uint8_t* max) noexcept;
+	void expandRGB8ToRGBA8MinMax_AVX2(unsigned char const* src, std::uint64_t pixelCount, unsigned char* dst, std::uint8_t* min, std::uint8_t* max) noexcept;
+	void copyRGBA8MinMax_AVX2(unsigned char const* src, std::uint64_t pixelCount, unsigned char* dst, std::uint8_t* min, std::uint8_t* max) noexcept;
+	// Uses F16C, which every AVX2 CPU has.
+	void halfToFloat_AVX2(std::uint16_t const* src, std::uint64_t count, float* dst) noexcept;
+	void floatToHalf_AVX2(float const* src, std::uint64_t count, std::uint16_t* dst) noexcept;
+	void swapRedBlue8_AVX2(unsigned char const* src, std::uint64_t pixelCount, unsigned char* dst) noexcept;
+	void unorm16ToUnorm8_AVX2(std::uint16_t const* src, std::uint64_t count, std::uint8_t* dst) noexcept;
+	void decodeSRGBRGBA32F_AVX2(float* rgba, std::uint64_t pixelCount) noexcept;
+	void encodeSRGBRGBA32F_AVX2(float* rgba, std::uint64_t pixelCount) noexcept;
+	void decodeSRGBRGBA8ToRGBA32F_AVX2(unsigned char const* src, std::uint64_t pixelCount, float* dst) noexcept;
+	void encodeSRGBRGBA32FToRGBA8_AVX2(float const* src, std::uint64_t pixelCount, unsigned char* dst) noexcept;
+	void blendRowsRGBA32F_AVX2(float const* const* rows, float const* weights, std::uint32_t rowCount, std::uint64_t pixelCount, float* dst) noexcept;
+	void sumSquaredErrorRGBA32F_AVX2(float const* a, float const* b, std::uint64_t pixelCount, double* sums) noexcept;
+	void ssimBlockSumsRGBA32F_AVX2(float const* a, float const* b, std::uint64_t rowStride, std::uint64_t blockCount, float* sums) noexcept;
+#endif
+}
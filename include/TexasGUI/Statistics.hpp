@@ -0,0 +1,118 @@
+#pragma once
+
+#include "TexasGUI/TextureKernels.hpp"
+
+#include <QFuture>
+#include <QList>
+#include <QMutex>
+
+#include "Texas/Texture.hpp"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace TexasGUI
+{
+	// Per-channel statistics of one (mip, layer) subresource, every depth slice included.
+	// Channels are in the order they are stored in. Values that aren't finite (NaN and infinity in the
+	// float formats) are only counted, nothing else sees them.
+	struct SubresourceStatistics
+	{
+		static constexpr int binCount = 256;
+
+		struct Channel
+		{
+			double min = 0;
+			double max = 0;
+			double mean = 0;
+			double stddev = 0;
+			std::uint64_t count = 0;
+			std::uint64_t nonFiniteCount = 0;
+			// Of the values decoded to linear light, only set for the color channels of sRGB encoded textures.
+			double linearMean = 0;
+			double linearStddev = 0;
+		};
+
+		std::uint8_t channelCount = 0;
+		// Everything else stays in stored values, min, max and the histogram included.
+		bool isSRGBEncoded = false;
+		Channel channels[4] = {};
+
+		// 8-bit formats get one bin per value starting at histogramMin[i], so their percentiles are exact.
+		// Everything else spreads the bins evenly across [min, max] of each channel.
+		bool binPerValue = false;
+		double histogramMin[4] = {};
+		double histogramMax[4] = {};
+		// binCount counts per channel, one channel after the other.
+		std::vector<std::uint32_t> histogram{};
+
+		[[nodiscard]] std::uint32_t const* channelHistogram(std::uint8_t channel) const noexcept;
+		// Estimated from the histogram by interpolating within the bin. fraction is in [0, 1].
+		[[nodiscard]] double percentile(std::uint8_t channel, double fraction) const noexcept;
+	};
+
+	// Computes the statistics of a single subresource, spread across the global thread pool.
+	// Block compressed formats are decoded first, to 8 bits, or floats for BC6H.
+	// Returns false if the format isn't supported or the computation was cancelled.
+	bool ComputeSubresourceStatistics(
+		Texas::TextureInfo const& texInfo,
+		Texas::ConstByteSpan byteSpan,
+		std::uint64_t mipIndex,
+		std::uint64_t layerIndex,
+		SubresourceStatistics& statistics,
+		KernelProgress* progress = nullptr,
+		int maxThreads = 0);
+
+	// Statistics of the subresources that have been looked at, each computed the first time it's asked for.
+	// Only the latest request is worked on, asking for another subresource cancels the one in flight,
+	// so flicking through layers never queues up work for the ones that were skipped past.
+	//
+	// The source buffer must outlive the cache.
+	class StatisticsCache
+	{
+	public:
+		StatisticsCache(Texas::TextureInfo const& texInfo, Texas::ConstByteSpan byteSpan);
+		~StatisticsCache();
+
+		StatisticsCache(StatisticsCache const&) = delete;
+		StatisticsCache& operator=(StatisticsCache const&) = delete;
+
+		// Null if they haven't been computed yet, or the format has none.
+		[[nodiscard]] std::shared_ptr<SubresourceStatistics const> find(std::uint64_t mipIndex, std::uint64_t layerIndex) const;
+
+		// Starts computing them on the thread pool, unless that has already been started.
+		// The future finishes once they are in the cache, or the request was cancelled.
+		QFuture<void> request(std::uint64_t mipIndex, std::uint64_t layerIndex);
+
+	private:
+		struct Key
+		{
+			std::uint64_t mipIndex;
+			std::uint64_t layerIndex;
+
+			[[nodiscard]] bool operator<(Key const& other) const
+			{
+				if (mipIndex != other.mipIndex)
+					return mipIndex < other.mipIndex;
+				return layerIndex < other.layerIndex;
+			}
+			[[nodiscard]] bool operator==(Key const& other) const
+			{
+				return mipIndex == other.mipIndex && layerIndex == other.layerIndex;
+			}
+		};
+
+		Texas::TextureInfo texInfo{};
+		Texas::ConstByteSpan byteSpan{};
+
+		mutable QMutex mutex;
+		std::map<Key, std::shared_ptr<SubresourceStatistics const>> entries;
+		Key activeKey{};
+		std::shared_ptr<KernelProgress> activeProgress{};
+		QFuture<void> active{};
+		// Cancelled requests still have to finish before the cache goes away.
+		QList<QFuture<void>> pending;
+	};
+}
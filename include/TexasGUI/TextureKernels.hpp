@@ -0,0 +1,103 @@
+#pragma once
+
+#include <QByteArray>
+
+#include "Texas/Texture.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace TexasGUI
+{
+	// Per-channel min/max of every (mip, layer) subresource.
+	// Only the channels the format has are stored, all in one array with the layers of a mip next to each other.
+	struct MinMaxData
+	{
+		enum class Type
+		{
+			Int,
+			UnsignedInt,
+			Float
+		};
+
+		// A single min or max, type says which member holds it.
+		union Value
+		{
+			std::int64_t int64;
+			std::uint64_t uint64;
+			double float64;
+		};
+
+		Type type{};
+		std::uint8_t channelCount = 0;
+		std::uint64_t mipCount = 0;
+		std::uint64_t layerCount = 0;
+		// channelCount mins followed by channelCount maxes, for each subresource.
+		std::vector<Value> values;
+
+		// Sizes the array for a texture and zeroes it.
+		void reset(Type type, std::uint8_t channelCount, std::uint64_t mipCount, std::uint64_t layerCount);
+
+		[[nodiscard]] bool isEmpty() const noexcept { return values.empty(); }
+
+		[[nodiscard]] Value* min(std::uint64_t mipIndex, std::uint64_t layerIndex) noexcept
+		{
+			return values.data() + (mipIndex * layerCount + layerIndex) * channelCount * 2;
+		}
+		[[nodiscard]] Value const* min(std::uint64_t mipIndex, std::uint64_t layerIndex) const noexcept
+		{
+			return values.data() + (mipIndex * layerCount + layerIndex) * channelCount * 2;
+		}
+		[[nodiscard]] Value* max(std::uint64_t mipIndex, std::uint64_t layerIndex) noexcept
+		{
+			return min(mipIndex, layerIndex) + channelCount;
+		}
+		[[nodiscard]] Value const* max(std::uint64_t mipIndex, std::uint64_t layerIndex) const noexcept
+		{
+			return min(mipIndex, layerIndex) + channelCount;
+		}
+	};
+
+	// Shared between a kernel running on a worker thread and whoever is waiting for it.
+	// Kernels count units of work as they finish them, what a unit is depends on the kernel, and stop early when cancelled is set.
+	struct KernelProgress
+	{
+		std::atomic<bool> cancelled{ false };
+		std::atomic<std::uint64_t> completedUnits{ 0 };
+		std::atomic<std::uint64_t> totalUnits{ 0 };
+	};
+
+	// Computes the min/max values of every (mip, layer) subresource, spread across the global thread pool.
+	// maxThreads limits how many threads take part, 0 means all of them.
+	void FindMinMaxValues(
+		Texas::TextureInfo texInfo,
+		Texas::ConstByteSpan byteSpan,
+		MinMaxData& minMaxData,
+		KernelProgress* progress = nullptr,
+		int maxThreads = 0);
+
+	// FindMinMaxValues that also converts one subresource into tightly packed RGBA8 in the same sweep,
+	// so those pixels are only read once instead of once for each.
+	// Returns false and leaves displayData empty if the format can't be displayed, or the subresource is too
+	// large for a QByteArray. The min/max values are computed either way.
+	bool FindMinMaxValuesAndBuildDisplayable(
+		Texas::TextureInfo texInfo,
+		Texas::ConstByteSpan byteSpan,
+		MinMaxData& minMaxData,
+		std::uint64_t displayMipIndex,
+		std::uint64_t displayLayerIndex,
+		QByteArray& displayData,
+		KernelProgress* progress = nullptr,
+		int maxThreads = 0);
+
+	// Converts a single (mip, layer) subresource into tightly packed RGBA8.
+	// Returns false and leaves byteArray empty if the format can't be displayed, or the subresource is too large
+	// for a QByteArray.
+	bool BuildDisplayableSubresource(
+		Texas::TextureInfo const& texInfo,
+		Texas::ConstByteSpan byteSpan,
+		std::uint64_t mipIndex,
+		std::uint64_t layerIndex,
+		QByteArray& byteArray);
+}
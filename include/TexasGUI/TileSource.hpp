@@ -0,0 +1,126 @@
+#pragma once
+
+#include "TexasGUI/FloatVisualization.hpp"
+#include "TexasGUI/ImageCompare.hpp"
+#include "TexasGUI/KTXReader.hpp"
+
+#include <QByteArray>
+
+#include "Texas/Texture.hpp"
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <utility>
+
+namespace TexasGUI
+{
+	class DisplayCache;
+
+	// Where a TextureViewport gets its pixels from, one rectangle at a time.
+	class TileSource
+	{
+	public:
+		virtual ~TileSource() = default;
+
+		[[nodiscard]] virtual Texas::TextureInfo const& textureInfo() const noexcept = 0;
+
+		// Fills rgba with exactly region of the first depth slice as tightly packed RGBA8.
+		// region is already clamped to the subresource. visualization is ignored unless the format is a float one.
+		// isPrefetch is set for tiles read ahead of the user, a source that caches must not let those push out
+		// what is on screen, and may fail them instead. Safe to call from any thread.
+		virtual bool readTile(
+			std::uint64_t mipIndex,
+			std::uint64_t layerIndex,
+			KTX::Region const& region,
+			FloatVisualization const& visualization,
+			bool isPrefetch,
+			QByteArray& rgba) = 0;
+
+	protected:
+		// Range of the first depth slice of a float subresource, computed the first time it's asked for.
+		[[nodiscard]] FloatRange floatRange(std::uint64_t mipIndex, std::uint64_t layerIndex);
+		virtual FloatRange computeFloatRange(std::uint64_t mipIndex, std::uint64_t layerIndex) = 0;
+
+	private:
+		std::mutex floatRangeMutex{};
+		std::map<std::pair<std::uint64_t, std::uint64_t>, FloatRange> floatRanges{};
+	};
+
+	// Crops tiles out of the subresources a DisplayCache converts, for textures that are loaded into memory.
+	// Float formats depend on the visualization, those tiles are converted straight from byteSpan instead.
+	// byteSpan must outlive the source.
+	class DisplayCacheTileSource : public TileSource
+	{
+	public:
+		DisplayCacheTileSource(Texas::TextureInfo const& texInfo, Texas::ConstByteSpan byteSpan, DisplayCache& displayCache);
+
+		[[nodiscard]] Texas::TextureInfo const& textureInfo() const noexcept override;
+		bool readTile(
+			std::uint64_t mipIndex,
+			std::uint64_t layerIndex,
+			KTX::Region const& region,
+			FloatVisualization const& visualization,
+			bool isPrefetch,
+			QByteArray& rgba) override;
+
+	protected:
+		FloatRange computeFloatRange(std::uint64_t mipIndex, std::uint64_t layerIndex) override;
+
+	private:
+		Texas::TextureInfo texInfo{};
+		Texas::ConstByteSpan byteSpan{};
+		DisplayCache* displayCache = nullptr;
+	};
+
+	// Reads every tile straight out of a KTX file, so only what is on screen is ever converted.
+	class KTXTileSource : public TileSource
+	{
+	public:
+		explicit KTXTileSource(KTX::TiledReader const& reader);
+
+		[[nodiscard]] Texas::TextureInfo const& textureInfo() const noexcept override;
+		bool readTile(
+			std::uint64_t mipIndex,
+			std::uint64_t layerIndex,
+			KTX::Region const& region,
+			FloatVisualization const& visualization,
+			bool isPrefetch,
+			QByteArray& rgba) override;
+
+	protected:
+		// Reads the subresource in strips, it's never all in memory at once.
+		FloatRange computeFloatRange(std::uint64_t mipIndex, std::uint64_t layerIndex) override;
+
+	private:
+		KTX::TiledReader const* reader = nullptr;
+	};
+
+	// Shows how far one texture is from another, see Compare::buildDiffHeatmap. The compared mips and layers
+	// of the pair become an RGBA8 texture the size of the first one. Both byte spans must outlive the source.
+	class DiffHeatmapTileSource : public TileSource
+	{
+	public:
+		// Errors of maxError and up are drawn at the hot end of the ramp.
+		DiffHeatmapTileSource(Compare::Input const& a, Compare::Input const& b, float maxError);
+
+		[[nodiscard]] Texas::TextureInfo const& textureInfo() const noexcept override;
+		bool readTile(
+			std::uint64_t mipIndex,
+			std::uint64_t layerIndex,
+			KTX::Region const& region,
+			FloatVisualization const& visualization,
+			bool isPrefetch,
+			QByteArray& rgba) override;
+
+	protected:
+		// The heatmap is never a float format.
+		FloatRange computeFloatRange(std::uint64_t mipIndex, std::uint64_t layerIndex) override;
+
+	private:
+		Compare::Input a{};
+		Compare::Input b{};
+		float maxError = 0;
+		Texas::TextureInfo texInfo{};
+	};
+}
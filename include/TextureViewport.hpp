@@ -0,0 +1,149 @@
+#pragma once
+
+#include "PresentationCache.hpp"
+#include "TileScheduler.hpp"
+#include "TexasGUI/FloatVisualization.hpp"
+
+#include <QAbstractScrollArea>
+#include <QCache>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QImage>
+#include <QPixmap>
+#include <QPoint>
+#include <QPointF>
+#include <QSizeF>
+
+#include "Texas/Texture.hpp"
+
+#include <cstdint>
+
+namespace TexasGUI
+{
+	class TileSource;
+
+	// Shows one subresource of a texture by painting only the tiles that are visible at the current zoom.
+	// Nothing the size of the whole image is allocated here, so 16K textures pan and zoom like small ones.
+	// Tiles are read by a TileScheduler off the GUI thread and painted as they arrive.
+	//
+	// Zoom is screen pixels per content pixel. Content pixels are base level pixels when scaling to base or
+	// picking mips automatically, otherwise pixels of the selected mip level. Picking automatically samples
+	// the smallest mip level that still has at least one texel per screen pixel.
+	class TextureViewport : public QAbstractScrollArea
+	{
+		Q_OBJECT
+
+	public:
+		static constexpr int tileSize = TileScheduler::tileSize;
+		static constexpr double minZoom = 1.0 / 64;
+		static constexpr double maxZoom = 64;
+
+		explicit TextureViewport(QWidget* parent = nullptr);
+
+		// The source must outlive the viewport, or be replaced before it is destroyed.
+		// Replacing it waits for the tiles that are still being read from it.
+		void setSource(TileSource* source);
+		void setSubresource(std::uint64_t mipIndex, std::uint64_t layerIndex);
+		void setScaleToBase(bool scaleToBase);
+		void setAutomaticMip(bool automaticMip);
+		// Only changes what float formats look like.
+		void setFloatVisualization(FloatVisualization const& visualization);
+
+		[[nodiscard]] double zoom() const;
+		[[nodiscard]] std::uint64_t displayedMip() const;
+
+		// Keeps the content under anchor, in viewport coordinates, where it is.
+		void setZoom(double zoom, QPoint anchor);
+		void fitToWindow();
+
+		// The tiles read from the source and the presented tiles are each capped at this.
+		void setTileCacheBudget(std::uint64_t bytes);
+
+	signals:
+		// Only emitted when automatic mip selection switches to another mip level.
+		void displayedMipChanged(int mipIndex);
+		void zoomChanged(double zoom);
+
+	private slots:
+		void tilesFinished();
+
+	protected:
+		void paintEvent(QPaintEvent* event) override;
+		void resizeEvent(QResizeEvent* event) override;
+		void scrollContentsBy(int dx, int dy) override;
+		void wheelEvent(QWheelEvent* event) override;
+		void mousePressEvent(QMouseEvent* event) override;
+		void mouseMoveEvent(QMouseEvent* event) override;
+		void mouseReleaseEvent(QMouseEvent* event) override;
+		void mouseDoubleClickEvent(QMouseEvent* event) override;
+		void keyPressEvent(QKeyEvent* event) override;
+
+	private:
+		// A tile as it comes out of the source, before it is scaled for the screen.
+		struct TileKey
+		{
+			std::uint64_t mipIndex;
+			std::uint64_t layerIndex;
+			std::uint32_t tileX;
+			std::uint32_t tileY;
+			int visualizationKey;
+
+			[[nodiscard]] bool operator==(TileKey const& other) const
+			{
+				return mipIndex == other.mipIndex && layerIndex == other.layerIndex &&
+					tileX == other.tileX && tileY == other.tileY && visualizationKey == other.visualizationKey;
+			}
+			[[nodiscard]] friend uint qHash(TileKey const& key, uint seed = 0)
+			{
+				return qHash(key.mipIndex, seed) ^ qHash(key.layerIndex, seed) ^
+					qHash((quint64(key.tileX) << 32) | key.tileY, seed) ^ qHash(key.visualizationKey, seed);
+			}
+		};
+
+		[[nodiscard]] QSizeF contentSize() const;
+		// Where the top left corner of the content is drawn, in viewport coordinates.
+		[[nodiscard]] QPointF contentOrigin() const;
+		void updateDisplayedMip();
+		void updateScrollBars();
+		// False if the source tile hasn't been read yet.
+		bool presentedTile(
+			std::uint64_t mipIndex,
+			std::uint64_t layerIndex,
+			int visualizationKey,
+			std::uint32_t tileX,
+			std::uint32_t tileY,
+			QSize size,
+			QPixmap& pixmap);
+
+		TileSource* source = nullptr;
+		std::uint64_t requestedMip = 0;
+		std::uint64_t displayedMipIndex = 0;
+		std::uint64_t layerIndex = 0;
+		bool scaleMipToBase = false;
+		bool automaticMip = false;
+		FloatVisualization visualization{};
+		double zoomFactor = 1.0;
+		bool sourceFailed = false;
+
+		// The last subresource that was painted without missing tiles.
+		bool hasShown = false;
+		std::uint64_t shownMip = 0;
+		std::uint64_t shownLayer = 0;
+		int shownVisualizationKey = 0;
+		// The subresource last handed to the scheduler.
+		bool hasRequested = false;
+		std::uint64_t requestedMipIndex = 0;
+		std::uint64_t requestedLayerIndex = 0;
+		int requestedVisualizationKey = 0;
+		// Since the viewport moved to something it hasn't painted in full yet, invalid once it has.
+		QElapsedTimer waitingSince{};
+
+		bool isPanning = false;
+		QPoint lastPanPosition{};
+
+		// Costs are in KiB, QCache counts in int.
+		QCache<TileKey, QImage> sourceTiles;
+		PresentationCache presentationCache;
+		TileScheduler* scheduler = nullptr;
+	};
+}
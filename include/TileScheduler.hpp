@@ -0,0 +1,113 @@
+#pragma once
+
+#include <QFutureWatcher>
+#include <QImage>
+#include <QMutex>
+#include <QObject>
+
+#include "TexasGUI/FloatVisualization.hpp"
+#include "TexasGUI/KTXReader.hpp"
+
+#include "Texas/Texture.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace TexasGUI
+{
+	class TileSource;
+
+	// Reads tiles for a TextureViewport on the global thread pool, so the GUI thread never waits on a conversion.
+	//
+	// Only the newest request matters. Making a request bumps a generation counter that the batch in flight
+	// checks before every tile, so stale work stops within a tile. Requests made in the meantime overwrite
+	// each other and only the last one starts once the old batch is gone, which is what keeps dragging a
+	// slider across a thousand layers from queueing a thousand conversions.
+	//
+	// Once the requested tiles are read, the visible tiles of the next subresources in the direction the
+	// user is moving (layers, or smaller mips if those changed instead) are read ahead of time.
+	class TileScheduler : public QObject
+	{
+		Q_OBJECT
+
+	public:
+		static constexpr int prefetchDepth = 2;
+
+		struct Request
+		{
+			std::uint64_t mipIndex = 0;
+			std::uint64_t layerIndex = 0;
+			FloatVisualization visualization{};
+			// Tile coordinates, in the order they should be read.
+			std::vector<std::pair<std::uint32_t, std::uint32_t>> tiles{};
+			// Everything on screen, cached or not, which is what gets read ahead for the neighbouring subresources.
+			std::vector<std::pair<std::uint32_t, std::uint32_t>> visibleTiles{};
+		};
+
+		struct Tile
+		{
+			std::uint64_t mipIndex = 0;
+			std::uint64_t layerIndex = 0;
+			// FloatVisualization::cacheKey of what it was read with.
+			int visualizationKey = 0;
+			std::uint32_t tileX = 0;
+			std::uint32_t tileY = 0;
+			// Null if the source couldn't read it.
+			QImage image{};
+			bool isPrefetch = false;
+		};
+
+		explicit TileScheduler(QObject* parent = nullptr);
+		~TileScheduler() override;
+
+		// Stops and waits for the batch in flight, nothing reads from the old source after this returns.
+		void setSource(TileSource* source);
+
+		// Replaces whatever was requested before. Requests for tiles that are already on their way are ignored.
+		void request(Request request);
+		void cancel();
+
+		// Tiles read since the last call, in the order they finished.
+		[[nodiscard]] std::vector<Tile> takeFinishedTiles();
+
+		// Where a tile lies in its mip level, clamped to the edges.
+		[[nodiscard]] static KTX::Region tileRegion(
+			Texas::TextureInfo const& texInfo,
+			std::uint64_t mipIndex,
+			std::uint32_t tileX,
+			std::uint32_t tileY);
+		static constexpr int tileSize = 256;
+
+	signals:
+		// Emitted from the worker thread, connect with a queued connection.
+		void tilesFinished();
+
+	private slots:
+		void batchFinished();
+
+	private:
+		struct Batch;
+
+		void startBatch();
+		void runBatch(std::shared_ptr<Batch> batch);
+
+		TileSource* source = nullptr;
+		std::atomic<std::uint64_t> generation{ 0 };
+
+		bool hasPending = false;
+		Request pending{};
+		// What the batch in flight was asked for, so repeated requests for it don't restart it.
+		Request active{};
+		bool isActive = false;
+		// Used to tell which way the user is moving.
+		std::uint64_t previousMip = 0;
+		std::uint64_t previousLayer = 0;
+
+		QFutureWatcher<void>* watcher = nullptr;
+
+		QMutex finishedMutex;
+		std::vector<Tile> finishedTiles{};
+	};
+}
@@ -0,0 +1,403 @@
+#include "ExportDialog.hpp"
+#include "ImageTab.hpp"
+#include "MainTexasWindow.hpp"
+#include "TexasGUI/LatencyRecorder.hpp"
+#include "TexasGUI/SimdKernels.hpp"
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QDialog>
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMessageBox>
+#include <QSysInfo>
+#include <QTemporaryDir>
+#include <QThreadPool>
+#include <QTimer>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	using TexasGUI::Latency::Stage;
+
+	struct HarnessOptions
+	{
+		int warmups = 1;
+		int runs = 5;
+		int timeoutMilliseconds = 60000;
+		int maxScrubSteps = 64;
+		bool scrub = true;
+		bool exportFiles = true;
+	};
+
+	// Turns the first paint of each file the harness opens into its whole open to first pixel latency.
+	// The viewport only paints on the GUI thread, which is also where files are opened from.
+	class HarnessRecorder : public TexasGUI::Latency::Recorder
+	{
+	public:
+		void startOpen()
+		{
+			this->openTimer.start();
+		}
+
+		void record(Stage stage, std::int64_t nanoseconds) override
+		{
+			Recorder::record(stage, nanoseconds);
+			if (stage == Stage::FirstPaint && this->openTimer.isValid())
+			{
+				Recorder::record(Stage::OpenToFirstPixel, this->openTimer.nsecsElapsed());
+				this->openTimer.invalidate();
+			}
+		}
+
+	private:
+		QElapsedTimer openTimer{};
+	};
+
+	// Nearest rank, in milliseconds.
+	struct Percentiles
+	{
+		std::size_t samples = 0;
+		double p50 = 0;
+		double p90 = 0;
+		double p99 = 0;
+		double max = 0;
+	};
+
+	[[nodiscard]] Percentiles percentiles(std::vector<std::int64_t> nanoseconds)
+	{
+		Percentiles result;
+		result.samples = nanoseconds.size();
+		if (nanoseconds.empty())
+			return result;
+		std::sort(nanoseconds.begin(), nanoseconds.end());
+		auto rank = [&](double fraction)
+		{
+			std::size_t const index = static_cast<std::size_t>(std::ceil(fraction * static_cast<double>(nanoseconds.size()))) - 1;
+			return static_cast<double>(nanoseconds[index]) / 1e6;
+		};
+		result.p50 = rank(0.5);
+		result.p90 = rank(0.9);
+		result.p99 = rank(0.99);
+		result.max = static_cast<double>(nanoseconds.back()) / 1e6;
+		return result;
+	}
+
+	// Every file given, and every PNG and KTX file in the directories given, sorted so runs are comparable.
+	[[nodiscard]] QStringList collectCorpus(QStringList const& paths)
+	{
+		QStringList corpus;
+		for (QString const& path : paths)
+		{
+			if (!QFileInfo(path).isDir())
+			{
+				corpus.append(path);
+				continue;
+			}
+			QStringList found;
+			QDirIterator iterator(path, { "*.png", "*.ktx" }, QDir::Files, QDirIterator::Subdirectories);
+			while (iterator.hasNext())
+				found.append(iterator.next());
+			found.sort();
+			corpus.append(found);
+		}
+		return corpus;
+	}
+
+	// Runs the event loop until done returns true or the time is up, and returns what done last returned.
+	// The GUI reports errors in modal message boxes, those are printed and closed so a bad file can't stall the run.
+	[[nodiscard]] bool waitFor(std::function<bool()> const& done, int timeoutMilliseconds)
+	{
+		if (done())
+			return true;
+
+		QElapsedTimer elapsed;
+		elapsed.start();
+		QEventLoop loop;
+		QTimer poll;
+		poll.setInterval(1);
+		// Also fires inside the event loop of a message box, which is what lets us close it.
+		QObject::connect(&poll, &QTimer::timeout, [&]()
+		{
+			if (QWidget* modal = QApplication::activeModalWidget())
+			{
+				QMessageBox* messageBox = qobject_cast<QMessageBox*>(modal);
+				std::fprintf(stderr, "  dismissed: %s\n", qPrintable(messageBox != nullptr ? messageBox->text() : modal->windowTitle()));
+				QDialog* dialog = qobject_cast<QDialog*>(modal);
+				if (dialog != nullptr)
+					dialog->reject();
+				else
+					modal->close();
+				return;
+			}
+			if (done() || elapsed.elapsed() > timeoutMilliseconds)
+				loop.quit();
+		});
+		poll.start();
+		loop.exec();
+		return done();
+	}
+
+	// Every mip of the first layer, then every layer of the first mip, like scrubbing the two sliders.
+	[[nodiscard]] std::vector<std::pair<std::uint64_t, std::uint64_t>> scrubSteps(Texas::TextureInfo const& texInfo, int maxSteps)
+	{
+		std::vector<std::pair<std::uint64_t, std::uint64_t>> steps;
+		for (std::uint64_t mipIndex = 1; mipIndex < texInfo.mipCount; mipIndex++)
+			steps.push_back({ mipIndex, 0 });
+		if (texInfo.mipCount > 1 && texInfo.layerCount > 1)
+			steps.push_back({ 0, 0 });
+		for (std::uint64_t layerIndex = 1; layerIndex < texInfo.layerCount; layerIndex++)
+			steps.push_back({ 0, layerIndex });
+		if (steps.size() > static_cast<std::size_t>(maxSteps))
+			steps.resize(static_cast<std::size_t>(maxSteps));
+		return steps;
+	}
+
+	// Opens the file, scrubs it and exports it, then closes its tab. Returns false if any of that failed or timed out.
+	[[nodiscard]] bool runFile(
+		TexasGUI::MainTexasWindow& window,
+		HarnessRecorder& recorder,
+		QString const& path,
+		QString const& exportPath,
+		HarnessOptions const& options)
+	{
+		std::size_t const paintsBefore = recorder.sampleCount(Stage::OpenToFirstPixel);
+		int const tabIndex = window.tabCount();
+		recorder.startOpen();
+		window.openPath(path);
+		// A file that fails to load takes its tab with it.
+		static_cast<void>(waitFor([&]()
+		{
+			return recorder.sampleCount(Stage::OpenToFirstPixel) > paintsBefore || window.tabWidget(tabIndex) == nullptr;
+		}, options.timeoutMilliseconds));
+		bool const opened = recorder.sampleCount(Stage::OpenToFirstPixel) > paintsBefore;
+		if (!opened)
+			std::fprintf(stderr, "  %s: never painted\n", qPrintable(path));
+
+		bool succeeded = opened;
+		TexasGUI::ImageTab* imageTab = qobject_cast<TexasGUI::ImageTab*>(window.tabWidget(tabIndex));
+		if (opened && imageTab != nullptr && options.scrub)
+		{
+			for (std::pair<std::uint64_t, std::uint64_t> const& step : scrubSteps(imageTab->textureInfo(), options.maxScrubSteps))
+			{
+				std::size_t const switchesBefore = recorder.sampleCount(Stage::SubresourceSwitch);
+				imageTab->showSubresource(step.first, step.second);
+				bool const shown = waitFor([&]()
+				{
+					return recorder.sampleCount(Stage::SubresourceSwitch) > switchesBefore;
+				}, options.timeoutMilliseconds);
+				if (!shown)
+				{
+					std::fprintf(stderr, "  %s: mip %llu layer %llu never painted\n", qPrintable(path),
+						static_cast<unsigned long long>(step.first), static_cast<unsigned long long>(step.second));
+					succeeded = false;
+					break;
+				}
+			}
+		}
+
+		// Streamed tabs have nothing to export.
+		std::shared_ptr<Texas::Texture const> texture = imageTab != nullptr ? imageTab->texture() : nullptr;
+		if (opened && texture != nullptr && options.exportFiles)
+		{
+			// The dialog is never shown, exporting with its default options saves the source format as is.
+			TexasGUI::ExportDialog dialog(*texture, imageTab);
+			bool finished = false;
+			bool exported = false;
+			QObject::connect(&dialog, &TexasGUI::ExportDialog::exportFinished, [&](bool exportSucceeded)
+			{
+				finished = true;
+				exported = exportSucceeded;
+			});
+			dialog.exportTo(exportPath);
+			if (!waitFor([&]() { return finished; }, options.timeoutMilliseconds) || !exported)
+			{
+				std::fprintf(stderr, "  %s: export failed\n", qPrintable(path));
+				succeeded = false;
+			}
+			QFile::remove(exportPath);
+		}
+
+		// Same as clicking the close button. Whatever the tab held is freed before the next file is opened.
+		if (window.tabWidget(tabIndex) != nullptr)
+			window.tabCloseRequested(tabIndex);
+		QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+		return succeeded;
+	}
+
+	void printReport(HarnessRecorder const& recorder)
+	{
+		std::printf("  %-20s %8s %10s %10s %10s %10s\n", "stage", "samples", "p50 ms", "p90 ms", "p99 ms", "max ms");
+		for (std::size_t i = 0; i < static_cast<std::size_t>(Stage::COUNT); i++)
+		{
+			Stage const stage = static_cast<Stage>(i);
+			Percentiles const result = percentiles(recorder.samples(stage));
+			if (result.samples == 0)
+				continue;
+			std::printf("  %-20s %8zu %10.2f %10.2f %10.2f %10.2f\n",
+				TexasGUI::Latency::toString(stage), result.samples, result.p50, result.p90, result.p99, result.max);
+		}
+	}
+
+	[[nodiscard]] bool writeJson(
+		QString const& path,
+		HarnessOptions const& options,
+		QStringList const& corpus,
+		QStringList const& failures,
+		HarnessRecorder const& recorder)
+	{
+		QJsonObject machine;
+		machine["os"] = QSysInfo::prettyProductName();
+		machine["cpuArchitecture"] = QSysInfo::currentCpuArchitecture();
+		machine["instructionSet"] = TexasGUI::Simd::toString(TexasGUI::Simd::detectInstructionSet());
+		machine["threads"] = QThreadPool::globalInstance()->maxThreadCount();
+		machine["qtVersion"] = qVersion();
+		machine["platform"] = QApplication::platformName();
+
+		QJsonObject stages;
+		for (std::size_t i = 0; i < static_cast<std::size_t>(Stage::COUNT); i++)
+		{
+			Stage const stage = static_cast<Stage>(i);
+			Percentiles const result = percentiles(recorder.samples(stage));
+			if (result.samples == 0)
+				continue;
+			QJsonObject timings;
+			timings["samples"] = static_cast<qint64>(result.samples);
+			timings["p50"] = result.p50;
+			timings["p90"] = result.p90;
+			timings["p99"] = result.p99;
+			timings["max"] = result.max;
+			stages[TexasGUI::Latency::toString(stage)] = timings;
+		}
+
+		QJsonObject root;
+		// Same as texas_bench, bumped whenever a field changes meaning.
+		root["schemaVersion"] = 1;
+		root["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+		root["machine"] = machine;
+		root["warmups"] = options.warmups;
+		root["runs"] = options.runs;
+		root["corpus"] = QJsonArray::fromStringList(corpus);
+		root["failures"] = QJsonArray::fromStringList(failures);
+		root["milliseconds"] = stages;
+
+		QFile file(path);
+		if (!file.open(QFile::WriteOnly | QFile::Truncate))
+			return false;
+		QByteArray const json = QJsonDocument(root).toJson(QJsonDocument::Indented);
+		return file.write(json) == json.size();
+	}
+}
+
+int main(int argc, char** argv)
+{
+	// Headless unless told otherwise, so it runs on build machines. Setting it to xcb shows the window.
+	if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+		qputenv("QT_QPA_PLATFORM", "offscreen");
+
+	QApplication app(argc, argv);
+	QApplication::setApplicationName("texas_latency");
+
+	QCommandLineParser parser;
+	parser.setApplicationDescription(
+		"Drives the main window through opening, scrubbing and exporting a corpus of files, "
+		"and reports the latency of every stage from opening a file to its first painted pixel.");
+	parser.addHelpOption();
+	parser.addPositionalArgument("paths", "Files to open, directories are searched for PNG and KTX files.", "paths...");
+	QCommandLineOption jsonOption("json", "Also write the results to this file as JSON.", "file");
+	QCommandLineOption warmupsOption("warmups", "Untimed passes over the corpus, these warm up the page cache.", "N", "1");
+	QCommandLineOption runsOption("runs", "Timed passes over the corpus.", "N", "5");
+	QCommandLineOption timeoutOption("timeout", "Milliseconds to wait for each step before counting it as failed.", "ms", "60000");
+	QCommandLineOption maxScrubStepsOption("max-scrub-steps", "Subresources to move through in each file at most.", "N", "64");
+	QCommandLineOption noScrubOption("no-scrub", "Don't move through the mips and layers.");
+	QCommandLineOption noExportOption("no-export", "Don't export the files.");
+	parser.addOptions({ jsonOption, warmupsOption, runsOption, timeoutOption, maxScrubStepsOption, noScrubOption, noExportOption });
+	parser.process(app);
+
+	HarnessOptions options;
+	bool warmupsValid = false;
+	options.warmups = parser.value(warmupsOption).toInt(&warmupsValid);
+	bool runsValid = false;
+	options.runs = parser.value(runsOption).toInt(&runsValid);
+	bool timeoutValid = false;
+	options.timeoutMilliseconds = parser.value(timeoutOption).toInt(&timeoutValid);
+	bool maxScrubStepsValid = false;
+	options.maxScrubSteps = parser.value(maxScrubStepsOption).toInt(&maxScrubStepsValid);
+	options.scrub = !parser.isSet(noScrubOption);
+	options.exportFiles = !parser.isSet(noExportOption);
+	if (!warmupsValid || options.warmups < 0 || !runsValid || options.runs < 1 ||
+		!timeoutValid || options.timeoutMilliseconds < 1 || !maxScrubStepsValid || options.maxScrubSteps < 0)
+	{
+		std::fprintf(stderr, "--warmups and --max-scrub-steps must be 0 or more, --runs and --timeout at least 1.\n");
+		return 1;
+	}
+
+	QStringList const corpus = collectCorpus(parser.positionalArguments());
+	if (corpus.isEmpty())
+	{
+		std::fprintf(stderr, "No files to open.\n");
+		parser.showHelp(1);
+	}
+
+	QTemporaryDir exportDir;
+	if (!exportDir.isValid())
+	{
+		std::fprintf(stderr, "Unable to create a directory to export to.\n");
+		return 1;
+	}
+	QString const exportPath = exportDir.filePath("export.ktx");
+
+	HarnessRecorder recorder;
+	TexasGUI::Latency::setRecorder(&recorder);
+
+	TexasGUI::MainTexasWindow* window = new TexasGUI::MainTexasWindow;
+	window->show();
+
+	QStringList failures;
+	for (int run = 0; run < options.warmups + options.runs; run++)
+	{
+		// Only the timed passes count.
+		if (run == options.warmups)
+			recorder.clear();
+		bool const timed = run >= options.warmups;
+		for (QString const& path : corpus)
+		{
+			if (!runFile(*window, recorder, path, exportPath, options) && timed && !failures.contains(path))
+				failures.append(path);
+		}
+	}
+
+	// Nothing reports after the window is gone.
+	delete window;
+	TexasGUI::Latency::setRecorder(nullptr);
+
+	std::printf("Open to first pixel, %d files, %d runs on %s\n", static_cast<int>(corpus.size()), options.runs, qPrintable(QApplication::platformName()));
+	printReport(recorder);
+	for (QString const& failure : failures)
+		std::printf("  failed: %s\n", qPrintable(failure));
+
+	if (parser.isSet(jsonOption) && !writeJson(parser.value(jsonOption), options, corpus, failures, recorder))
+	{
+		std::fprintf(stderr, "Unable to write %s\n", qPrintable(parser.value(jsonOption)));
+		return 1;
+	}
+	// So a regression job fails on files that stop opening, not just on slow ones.
+	return failures.isEmpty() ? 0 : 1;
+}
@@ -0,0 +1,905 @@
+#include "TexasGUI/BCnDecoder.hpp"
+
+#include "TexasGUI/FormatTraits.hpp"
+#include "TexasGUI/Parallel.hpp"
+
+#include "Texas/Tools.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace TexasGUI::BCn
+{
+	// Reads the bits of a 128-bit block from the least significant bit upwards.
+	class BitReader
+	{
+	public:
+		explicit BitReader(unsigned char const* block) noexcept
+		{
+			std::memcpy(words, block, 16);
+		}
+
+		// count is at most 32.
+		[[nodiscard]] std::uint32_t read(std::uint8_t count) noexcept
+		{
+			if (count == 0)
+				return 0;
+			std::uint64_t bits;
+			if (position >= 64)
+				bits = words[1] >> (position - 64);
+			else if (position == 0)
+				bits = words[0];
+			else
+				bits = (words[0] >> position) | (words[1] << (64 - position));
+			position = static_cast<std::uint8_t>(position + count);
+			return static_cast<std::uint32_t>(bits & ((std::uint64_t(1) << count) - 1));
+		}
+
+		[[nodiscard]] std::uint32_t readBit() noexcept
+		{
+			return read(1);
+		}
+
+	private:
+		std::uint64_t words[2]{};
+		std::uint8_t position = 0;
+	};
+
+	// Partition tables shared by BC6H and BC7, straight from the format specification.
+	// Bit i of a two subset entry is the subset of pixel i.
+	constexpr std::uint16_t partitions2[64] = {
+		0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80,
+		0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+		0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE,
+		0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C,
+		0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A,
+		0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660,
+		0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6, 0x639C,
+		0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22 };
+
+	constexpr std::uint8_t partitions3[64][16] = {
+		{ 0, 0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 1, 2, 2, 2, 2 },
+		{ 0, 0, 0, 1, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2, 2, 1 },
+		{ 0, 0, 0, 0, 2, 0, 0, 1, 2, 2, 1, 1, 2, 2, 1, 1 },
+		{ 0, 2, 2, 2, 0, 0, 2, 2, 0, 0, 1, 1, 0, 1, 1, 1 },
+		{ 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2 },
+		{ 0, 0, 1, 1, 0, 0, 1, 1, 0, 0, 2, 2, 0, 0, 2, 2 },
+		{ 0, 0, 2, 2, 0, 0, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1 },
+		{ 0, 0, 1, 1, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2, 1, 1 },
+		{ 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2 },
+		{ 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2 },
+		{ 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2, 2 },
+		{ 0, 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2 },
+		{ 0, 1, 1, 2, 0, 1, 1, 2, 0, 1, 1, 2, 0, 1, 1, 2 },
+		{ 0, 1, 2, 2, 0, 1, 2, 2, 0, 1, 2, 2, 0, 1, 2, 2 },
+		{ 0, 0, 1, 1, 0, 1, 1, 2, 1, 1, 2, 2, 1, 2, 2, 2 },
+		{ 0, 0, 1, 1, 2, 0, 0, 1, 2, 2, 0, 0, 2, 2, 2, 0 },
+		{ 0, 0, 0, 1, 0, 0, 1, 1, 0, 1, 1, 2, 1, 1, 2, 2 },
+		{ 0, 1, 1, 1, 0, 0, 1, 1, 2, 0, 0, 1, 2, 2, 0, 0 },
+		{ 0, 0, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2, 1, 1, 2, 2 },
+		{ 0, 0, 2, 2, 0, 0, 2, 2, 0, 0, 2, 2, 1, 1, 1, 1 },
+		{ 0, 1, 1, 1, 0, 1, 1, 1, 0, 2, 2, 2, 0, 2, 2, 2 },
+		{ 0, 0, 0, 1, 0, 0, 0, 1, 2, 2, 2, 1, 2, 2, 2, 1 },
+		{ 0, 0, 0, 0, 0, 0, 1, 1, 0, 1, 2, 2, 0, 1, 2, 2 },
+		{ 0, 0, 0, 0, 1, 1, 0, 0, 2, 2, 1, 0, 2, 2, 1, 0 },
+		{ 0, 1, 2, 2, 0, 1, 2, 2, 0, 0, 1, 1, 0, 0, 0, 0 },
+		{ 0, 0, 1, 2, 0, 0, 1, 2, 1, 1, 2, 2, 2, 2, 2, 2 },
+		{ 0, 1, 1, 0, 1, 2, 2, 1, 1, 2, 2, 1, 0, 1, 1, 0 },
+		{ 0, 0, 0, 0, 0, 1, 1, 0, 1, 2, 2, 1, 1, 2, 2, 1 },
+		{ 0, 0, 2, 2, 1, 1, 0, 2, 1, 1, 0, 2, 0, 0, 2, 2 },
+		{ 0, 1, 1, 0, 0, 1, 1, 0, 2, 0, 0, 2, 2, 2, 2, 2 },
+		{ 0, 0, 1, 1, 0, 1, 2, 2, 0, 1, 2, 2, 0, 0, 1, 1 },
+		{ 0, 0, 0, 0, 2, 0, 0, 0, 2, 2, 1, 1, 2, 2, 2, 1 },
+		{ 0, 0, 0, 0, 0, 0, 0, 2, 1, 1, 2, 2, 1, 2, 2, 2 },
+		{ 0, 2, 2, 2, 0, 0, 2, 2, 0, 0, 1, 2, 0, 0, 1, 1 },
+		{ 0, 0, 1, 1, 0, 0, 1, 2, 0, 0, 2, 2, 0, 2, 2, 2 },
+		{ 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2, 0 },
+		{ 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 0, 0, 0, 0 },
+		{ 0, 1, 2, 0, 1, 2, 0, 1, 2, 0, 1, 2, 0, 1, 2, 0 },
+		{ 0, 1, 2, 0, 2, 0, 1, 2, 1, 2, 0, 1, 0, 1, 2, 0 },
+		{ 0, 0, 1, 1, 2, 2, 0, 0, 1, 1, 2, 2, 0, 0, 1, 1 },
+		{ 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 0, 0, 0, 0, 1, 1 },
+		{ 0, 1, 0, 1, 0, 1, 0, 1, 2, 2, 2, 2, 2, 2, 2, 2 },
+		{ 0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 2, 1, 2, 1, 2, 1 },
+		{ 0, 0, 2, 2, 1, 1, 2, 2, 0, 0, 2, 2, 1, 1, 2, 2 },
+		{ 0, 0, 2, 2, 0, 0, 1, 1, 0, 0, 2, 2, 0, 0, 1, 1 },
+		{ 0, 2, 2, 0, 1, 2, 2, 1, 0, 2, 2, 0, 1, 2, 2, 1 },
+		{ 0, 1, 0, 1, 2, 2, 2, 2, 2, 2, 2, 2, 0, 1, 0, 1 },
+		{ 0, 0, 0, 0, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1 },
+		{ 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 2, 2, 2, 2 },
+		{ 0, 2, 2, 2, 0, 1, 1, 1, 0, 2, 2, 2, 0, 1, 1, 1 },
+		{ 0, 0, 0, 2, 1, 1, 1, 2, 0, 0, 0, 2, 1, 1, 1, 2 },
+		{ 0, 0, 0, 0, 2, 1, 1, 2, 2, 1, 1, 2, 2, 1, 1, 2 },
+		{ 0, 2, 2, 2, 0, 1, 1, 1, 0, 1, 1, 1, 0, 2, 2, 2 },
+		{ 0, 0, 0, 2, 1, 1, 1, 2, 1, 1, 1, 2, 0, 0, 0, 2 },
+		{ 0, 1, 1, 0, 0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 2, 2 },
+		{ 0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 1, 2, 2, 1, 1, 2 },
+		{ 0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 2, 2, 2, 2, 2, 2 },
+		{ 0, 0, 2, 2, 0, 0, 1, 1, 0, 0, 1, 1, 0, 0, 2, 2 },
+		{ 0, 0, 2, 2, 1, 1, 2, 2, 1, 1, 2, 2, 0, 0, 2, 2 },
+		{ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 1, 2 },
+		{ 0, 0, 0, 2, 0, 0, 0, 1, 0, 0, 0, 2, 0, 0, 0, 1 },
+		{ 0, 2, 2, 2, 1, 2, 2, 2, 0, 2, 2, 2, 1, 2, 2, 2 },
+		{ 0, 1, 0, 1, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2 },
+		{ 0, 1, 1, 1, 2, 0, 1, 1, 2, 2, 0, 1, 2, 2, 2, 0 } };
+
+	// Pixel whose index is stored with one bit less, for the second subset of a two subset partition.
+	constexpr std::uint8_t anchors2[64] = {
+		15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+		15,  2,  8,  2,  2,  8,  8, 15,  2,  8,  2,  2,  8,  8,  2,  2,
+		15, 15,  6,  8,  2,  8, 15, 15,  2,  8,  2,  2,  2, 15, 15,  6,
+		 6,  2,  6,  8, 15, 15,  2,  2, 15, 15, 15, 15, 15,  2,  2, 15 };
+
+	// Same for the second and third subsets of a three subset partition.
+	constexpr std::uint8_t anchors3[2][64] = {
+		{
+			 3,  3, 15, 15,  8,  3, 15, 15,  8,  8,  6,  6,  6,  5,  3,  3,
+			 3,  3,  8, 15,  3,  3,  6, 10,  5,  8,  8,  6,  8,  5, 15, 15,
+			 8, 15,  3,  5,  6, 10,  8, 15, 15,  3, 15,  5, 15, 15, 15, 15,
+			 3, 15,  5,  5,  5,  8,  5, 10,  5, 10,  8, 13, 15, 12,  3,  3 },
+		{
+			15,  8,  8,  3, 15, 15,  3,  8, 15, 15, 15, 15, 15, 15, 15,  8,
+			15,  8, 15,  3, 15,  8, 15,  8,  3, 15,  6, 10, 15, 15, 10,  8,
+			15,  3, 15, 10, 10,  8,  9, 10,  6, 15,  8, 15,  3,  6,  6,  8,
+			15,  3, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,  3, 15, 15,  8 } };
+
+	constexpr std::uint8_t weights2[4] = { 0, 21, 43, 64 };
+	constexpr std::uint8_t weights3[8] = { 0, 9, 18, 27, 37, 46, 55, 64 };
+	constexpr std::uint8_t weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	[[nodiscard]] static std::uint8_t const* weightsFor(std::uint8_t indexBits) noexcept
+	{
+		return indexBits == 2 ? weights2 : indexBits == 3 ? weights3 : weights4;
+	}
+
+	[[nodiscard]] static std::uint8_t subsetOf(std::uint8_t subsetCount, std::uint8_t partition, std::uint8_t pixel) noexcept
+	{
+		if (subsetCount == 2)
+			return (partitions2[partition] >> pixel) & 1;
+		if (subsetCount == 3)
+			return partitions3[partition][pixel];
+		return 0;
+	}
+
+	[[nodiscard]] static bool isAnchor(std::uint8_t subsetCount, std::uint8_t partition, std::uint8_t pixel) noexcept
+	{
+		if (pixel == 0)
+			return true;
+		if (subsetCount == 2)
+			return pixel == anchors2[partition];
+		if (subsetCount == 3)
+			return pixel == anchors3[0][partition] || pixel == anchors3[1][partition];
+		return false;
+	}
+
+	// --- BC1 to BC5 ---
+
+	static void decodeColorEndpoints(std::uint16_t color, unsigned char* rgb) noexcept
+	{
+		std::uint8_t r = (color >> 11) & 0x1F;
+		std::uint8_t g = (color >> 5) & 0x3F;
+		std::uint8_t b = color & 0x1F;
+		rgb[0] = static_cast<unsigned char>((r << 3) | (r >> 2));
+		rgb[1] = static_cast<unsigned char>((g << 2) | (g >> 4));
+		rgb[2] = static_cast<unsigned char>((b << 3) | (b >> 2));
+	}
+
+	// The color half shared by BC1, BC2 and BC3. BC2 and BC3 always use the four color mode.
+	static void decodeColorBlock(unsigned char const* block, unsigned char* dst, bool allowThreeColorMode, bool hasAlpha) noexcept
+	{
+		std::uint16_t color0 = static_cast<std::uint16_t>(block[0] | (block[1] << 8));
+		std::uint16_t color1 = static_cast<std::uint16_t>(block[2] | (block[3] << 8));
+		std::uint32_t indices = block[4] | (block[5] << 8) | (block[6] << 16) | (std::uint32_t(block[7]) << 24);
+
+		unsigned char palette[4][4]{};
+		decodeColorEndpoints(color0, palette[0]);
+		decodeColorEndpoints(color1, palette[1]);
+		palette[0][3] = 255;
+		palette[1][3] = 255;
+		palette[2][3] = 255;
+		palette[3][3] = 255;
+		if (color0 > color1 || !allowThreeColorMode)
+		{
+			for (std::uint8_t i = 0; i < 3; i++)
+			{
+				palette[2][i] = static_cast<unsigned char>((2 * palette[0][i] + palette[1][i] + 1) / 3);
+				palette[3][i] = static_cast<unsigned char>((palette[0][i] + 2 * palette[1][i] + 1) / 3);
+			}
+		}
+		else
+		{
+			for (std::uint8_t i = 0; i < 3; i++)
+				palette[2][i] = static_cast<unsigned char>((palette[0][i] + palette[1][i] + 1) / 2);
+			// palette[3] stays black, and transparent if the format has alpha.
+			if (hasAlpha)
+				palette[3][3] = 0;
+		}
+
+		for (std::uint8_t pixel = 0; pixel < 16; pixel++)
+			std::memcpy(dst + pixel * 4, palette[(indices >> (pixel * 2)) & 3], 4);
+	}
+
+	// The 8 byte single channel block used by BC3 alpha, BC4 and BC5.
+	// Writes one value per pixel, every stride bytes. Signed values are offset by 128 like the uncompressed SNORM formats.
+	static void decodeChannelBlock(unsigned char const* block, unsigned char* dst, std::uint8_t stride, bool isSigned) noexcept
+	{
+		int palette[8];
+		if (isSigned)
+		{
+			palette[0] = std::max<int>(static_cast<signed char>(block[0]), -127);
+			palette[1] = std::max<int>(static_cast<signed char>(block[1]), -127);
+		}
+		else
+		{
+			palette[0] = block[0];
+			palette[1] = block[1];
+		}
+
+		if (palette[0] > palette[1])
+		{
+			for (int i = 1; i < 7; i++)
+				palette[i + 1] = ((7 - i) * palette[0] + i * palette[1] + 3) / 7;
+		}
+		else
+		{
+			for (int i = 1; i < 5; i++)
+				palette[i + 1] = ((5 - i) * palette[0] + i * palette[1] + 2) / 5;
+			palette[6] = isSigned ? -127 : 0;
+			palette[7] = isSigned ? 127 : 255;
+		}
+
+		std::uint64_t indices = 0;
+		for (std::uint8_t i = 0; i < 6; i++)
+			indices |= std::uint64_t(block[2 + i]) << (i * 8);
+		for (std::uint8_t pixel = 0; pixel < 16; pixel++)
+		{
+			int value = palette[(indices >> (pixel * 3)) & 7];
+			dst[pixel * stride] = static_cast<unsigned char>(isSigned ? value + 128 : value);
+		}
+	}
+
+	void decodeBC1(unsigned char const* block, unsigned char* dst, bool hasAlpha) noexcept
+	{
+		decodeColorBlock(block, dst, true, hasAlpha);
+	}
+
+	void decodeBC2(unsigned char const* block, unsigned char* dst) noexcept
+	{
+		decodeColorBlock(block + 8, dst, false, false);
+		for (std::uint8_t pixel = 0; pixel < 16; pixel++)
+		{
+			std::uint8_t alpha = (block[pixel / 2] >> ((pixel & 1) * 4)) & 0xF;
+			dst[pixel * 4 + 3] = static_cast<unsigned char>(alpha * 17);
+		}
+	}
+
+	void decodeBC3(unsigned char const* block, unsigned char* dst) noexcept
+	{
+		decodeColorBlock(block + 8, dst, false, false);
+		decodeChannelBlock(block, dst + 3, 4, false);
+	}
+
+	void decodeBC4(unsigned char const* block, unsigned char* dst, bool isSigned) noexcept
+	{
+		decodeChannelBlock(block, dst, 4, isSigned);
+		for (std::uint8_t pixel = 0; pixel < 16; pixel++)
+		{
+			dst[pixel * 4 + 1] = dst[pixel * 4];
+			dst[pixel * 4 + 2] = dst[pixel * 4];
+			dst[pixel * 4 + 3] = 255;
+		}
+	}
+
+	void decodeBC5(unsigned char const* block, unsigned char* dst, bool isSigned) noexcept
+	{
+		decodeChannelBlock(block, dst, 4, isSigned);
+		decodeChannelBlock(block + 8, dst + 1, 4, isSigned);
+		for (std::uint8_t pixel = 0; pixel < 16; pixel++)
+		{
+			dst[pixel * 4 + 2] = 0;
+			dst[pixel * 4 + 3] = 255;
+		}
+	}
+
+	// --- BC7 ---
+
+	struct BC7Mode
+	{
+		std::uint8_t subsetCount;
+		std::uint8_t partitionBits;
+		std::uint8_t rotationBits;
+		std::uint8_t indexSelectionBits;
+		std::uint8_t colorBits;
+		std::uint8_t alphaBits;
+		std::uint8_t endpointPBits;
+		std::uint8_t sharedPBits;
+		std::uint8_t indexBits;
+		std::uint8_t secondaryIndexBits;
+	};
+
+	constexpr BC7Mode bc7Modes[8] = {
+		{ 3, 4, 0, 0, 4, 0, 1, 0, 3, 0 },
+		{ 2, 6, 0, 0, 6, 0, 0, 1, 3, 0 },
+		{ 3, 6, 0, 0, 5, 0, 0, 0, 2, 0 },
+		{ 2, 6, 0, 0, 7, 0, 1, 0, 2, 0 },
+		{ 1, 0, 2, 1, 5, 6, 0, 0, 2, 3 },
+		{ 1, 0, 2, 0, 7, 8, 0, 0, 2, 2 },
+		{ 1, 0, 0, 0, 7, 7, 1, 0, 4, 0 },
+		{ 2, 6, 0, 0, 5, 5, 1, 0, 2, 0 } };
+
+	[[nodiscard]] static std::uint8_t unquantize(std::uint32_t value, std::uint8_t precision) noexcept
+	{
+		value <<= 8 - precision;
+		return static_cast<std::uint8_t>(value | (value >> precision));
+	}
+
+	[[nodiscard]] static std::uint8_t interpolate(std::uint8_t a, std::uint8_t b, std::uint8_t weight) noexcept
+	{
+		return static_cast<std::uint8_t>(((64 - weight) * a + weight * b + 32) >> 6);
+	}
+
+	void decodeBC7(unsigned char const* block, unsigned char* dst) noexcept
+	{
+		std::uint8_t modeIndex = 0;
+		while (modeIndex < 8 && (block[0] & (1 << modeIndex)) == 0)
+			modeIndex++;
+		if (modeIndex == 8)
+		{
+			// Reserved, decodes to transparent black.
+			std::memset(dst, 0, 64);
+			return;
+		}
+		BC7Mode const& mode = bc7Modes[modeIndex];
+
+		BitReader reader(block);
+		(void)reader.read(modeIndex + 1);
+		std::uint8_t partition = static_cast<std::uint8_t>(reader.read(mode.partitionBits));
+		std::uint8_t rotation = static_cast<std::uint8_t>(reader.read(mode.rotationBits));
+		std::uint8_t indexSelection = static_cast<std::uint8_t>(reader.read(mode.indexSelectionBits));
+
+		// [subset * 2 + endpoint][channel]
+		std::uint32_t endpoints[6][4]{};
+		std::uint8_t const endpointCount = mode.subsetCount * 2;
+		for (std::uint8_t channel = 0; channel < 3; channel++)
+		{
+			for (std::uint8_t i = 0; i < endpointCount; i++)
+				endpoints[i][channel] = reader.read(mode.colorBits);
+		}
+		if (mode.alphaBits > 0)
+		{
+			for (std::uint8_t i = 0; i < endpointCount; i++)
+				endpoints[i][3] = reader.read(mode.alphaBits);
+		}
+
+		std::uint8_t colorPrecision = mode.colorBits;
+		std::uint8_t alphaPrecision = mode.alphaBits;
+		if (mode.endpointPBits || mode.sharedPBits)
+		{
+			std::uint32_t pBits[6]{};
+			if (mode.endpointPBits)
+			{
+				for (std::uint8_t i = 0; i < endpointCount; i++)
+					pBits[i] = reader.readBit();
+			}
+			else
+			{
+				for (std::uint8_t subset = 0; subset < mode.subsetCount; subset++)
+				{
+					std::uint32_t bit = reader.readBit();
+					pBits[subset * 2] = bit;
+					pBits[subset * 2 + 1] = bit;
+				}
+			}
+			for (std::uint8_t i = 0; i < endpointCount; i++)
+			{
+				for (std::uint8_t channel = 0; channel < 4; channel++)
+					endpoints[i][channel] = (endpoints[i][channel] << 1) | pBits[i];
+			}
+			colorPrecision++;
+			if (alphaPrecision > 0)
+				alphaPrecision++;
+		}
+
+		unsigned char colors[6][4];
+		for (std::uint8_t i = 0; i < endpointCount; i++)
+		{
+			for (std::uint8_t channel = 0; channel < 3; channel++)
+				colors[i][channel] = unquantize(endpoints[i][channel], colorPrecision);
+			colors[i][3] = alphaPrecision > 0 ? unquantize(endpoints[i][3], alphaPrecision) : 255;
+		}
+
+		std::uint8_t indices[16];
+		for (std::uint8_t pixel = 0; pixel < 16; pixel++)
+		{
+			bool anchor = isAnchor(mode.subsetCount, partition, pixel);
+			indices[pixel] = static_cast<std::uint8_t>(reader.read(mode.indexBits - (anchor ? 1 : 0)));
+		}
+		std::uint8_t secondaryIndices[16]{};
+		if (mode.secondaryIndexBits > 0)
+		{
+			for (std::uint8_t pixel = 0; pixel < 16; pixel++)
+				secondaryIndices[pixel] = static_cast<std::uint8_t>(reader.read(mode.secondaryIndexBits - (pixel == 0 ? 1 : 0)));
+		}
+
+		std::uint8_t const* colorWeights = weightsFor(mode.indexBits);
+		std::uint8_t const* alphaWeights = colorWeights;
+		if (mode.secondaryIndexBits > 0)
+		{
+			alphaWeights = weightsFor(mode.secondaryIndexBits);
+			if (indexSelection)
+				std::swap(colorWeights, alphaWeights);
+		}
+
+		for (std::uint8_t pixel = 0; pixel < 16; pixel++)
+		{
+			std::uint8_t subset = subsetOf(mode.subsetCount, partition, pixel);
+			unsigned char const* color0 = colors[subset * 2];
+			unsigned char const* color1 = colors[subset * 2 + 1];
+
+			std::uint8_t colorIndex = indices[pixel];
+			std::uint8_t alphaIndex = indices[pixel];
+			if (mode.secondaryIndexBits > 0)
+			{
+				alphaIndex = secondaryIndices[pixel];
+				if (indexSelection)
+					std::swap(colorIndex, alphaIndex);
+			}
+
+			unsigned char* out = dst + pixel * 4;
+			for (std::uint8_t channel = 0; channel < 3; channel++)
+				out[channel] = interpolate(color0[channel], color1[channel], colorWeights[colorIndex]);
+			out[3] = interpolate(color0[3], color1[3], alphaWeights[alphaIndex]);
+
+			if (rotation != 0)
+				std::swap(out[3], out[rotation - 1]);
+		}
+	}
+
+	// --- BC6H ---
+
+	enum class BC6HField : std::uint8_t
+	{
+		M, D, RW, RX, RY, RZ, GW, GX, GY, GZ, BW, BX, BY, BZ
+	};
+
+	// A run of bits belonging to one endpoint field, written field[high:low] like in the specification.
+	// The bits are stored starting from low, so a run with high < low is stored reversed.
+	struct BC6HRun
+	{
+		BC6HField field;
+		std::uint8_t high;
+		std::uint8_t low;
+	};
+
+	struct BC6HMode
+	{
+		std::uint8_t modeValue;
+		std::uint8_t modeBits;
+		bool isTransformed;
+		std::uint8_t regionCount;
+		std::uint8_t endpointBits;
+		std::uint8_t deltaBits[3];
+		BC6HRun runs[24];
+	};
+
+	using F = BC6HField;
+	constexpr BC6HMode bc6hModes[14] = {
+		{ 0x00, 2, true, 2, 10, { 5, 5, 5 }, {
+			{ F::GY, 4, 4 }, { F::BY, 4, 4 }, { F::BZ, 4, 4 }, { F::RW, 9, 0 }, { F::GW, 9, 0 }, { F::BW, 9, 0 },
+			{ F::RX, 4, 0 }, { F::GZ, 4, 4 }, { F::GY, 3, 0 }, { F::GX, 4, 0 }, { F::BZ, 0, 0 }, { F::GZ, 3, 0 },
+			{ F::BX, 4, 0 }, { F::BZ, 1, 1 }, { F::BY, 3, 0 }, { F::RY, 4, 0 }, { F::BZ, 2, 2 }, { F::RZ, 4, 0 },
+			{ F::BZ, 3, 3 } } },
+		{ 0x01, 2, true, 2, 7, { 6, 6, 6 }, {
+			{ F::GY, 5, 5 }, { F::GZ, 4, 4 }, { F::GZ, 5, 5 }, { F::RW, 6, 0 }, { F::BZ, 0, 0 }, { F::BZ, 1, 1 },
+			{ F::BY, 4, 4 }, { F::GW, 6, 0 }, { F::BY, 5, 5 }, { F::BZ, 2, 2 }, { F::GY, 4, 4 }, { F::BW, 6, 0 },
+			{ F::BZ, 3, 3 }, { F::BZ, 5, 5 }, { F::BZ, 4, 4 }, { F::RX, 5, 0 }, { F::GY, 3, 0 }, { F::GX, 5, 0 },
+			{ F::GZ, 3, 0 }, { F::BX, 5, 0 }, { F::BY, 3, 0 }, { F::RY, 5, 0 }, { F::RZ, 5, 0 } } },
+		{ 0x02, 5, true, 2, 11, { 5, 4, 4 }, {
+			{ F::RW, 9, 0 }, { F::GW, 9, 0 }, { F::BW, 9, 0 }, { F::RX, 4, 0 }, { F::RW, 10, 10 }, { F::GY, 3, 0 },
+			{ F::GX, 3, 0 }, { F::GW, 10, 10 }, { F::BZ, 0, 0 }, { F::GZ, 3, 0 }, { F::BX, 3, 0 }, { F::BW, 10, 10 },
+			{ F::BZ, 1, 1 }, { F::BY, 3, 0 }, { F::RY, 4, 0 }, { F::BZ, 2, 2 }, { F::RZ, 4, 0 }, { F::BZ, 3, 3 } } },
+		{ 0x06, 5, true, 2, 11, { 4, 5, 4 }, {
+			{ F::RW, 9, 0 }, { F::GW, 9, 0 }, { F::BW, 9, 0 }, { F::RX, 3, 0 }, { F::RW, 10, 10 }, { F::GZ, 4, 4 },
+			{ F::GY, 3, 0 }, { F::GX, 4, 0 }, { F::GW, 10, 10 }, { F::GZ, 3, 0 }, { F::BX, 3, 0 }, { F::BW, 10, 10 },
+			{ F::BZ, 1, 1 }, { F::BY, 3, 0 }, { F::RY, 3, 0 }, { F::BZ, 0, 0 }, { F::BZ, 2, 2 }, { F::RZ, 3, 0 },
+			{ F::GY, 4, 4 }, { F::BZ, 3, 3 } } },
+		{ 0x0A, 5, true, 2, 11, { 4, 4, 5 }, {
+			{ F::RW, 9, 0 }, { F::GW, 9, 0 }, { F::BW, 9, 0 }, { F::RX, 3, 0 }, { F::RW, 10, 10 }, { F::BY, 4, 4 },
+			{ F::GY, 3, 0 }, { F::GX, 3, 0 }, { F::GW, 10, 10 }, { F::BZ, 0, 0 }, { F::GZ, 3, 0 }, { F::BX, 4, 0 },
+			{ F::BW, 10, 10 }, { F::BY, 3, 0 }, { F::RY, 3, 0 }, { F::BZ, 1, 1 }, { F::BZ, 2, 2 }, { F::RZ, 3, 0 },
+			{ F::BZ, 4, 4 }, { F::BZ, 3, 3 } } },
+		{ 0x0E, 5, true, 2, 9, { 5, 5, 5 }, {
+			{ F::RW, 8, 0 }, { F::BY, 4, 4 }, { F::GW, 8, 0 }, { F::GY, 4, 4 }, { F::BW, 8, 0 }, { F::BZ, 4, 4 },
+			{ F::RX, 4, 0 }, { F::GZ, 4, 4 }, { F::GY, 3, 0 }, { F::GX, 4, 0 }, { F::BZ, 0, 0 }, { F::GZ, 3, 0 },
+			{ F::BX, 4, 0 }, { F::BZ, 1, 1 }, { F::BY, 3, 0 }, { F::RY, 4, 0 }, { F::BZ, 2, 2 }, { F::RZ, 4, 0 },
+			{ F::BZ, 3, 3 } } },
+		{ 0x12, 5, true, 2, 8, { 6, 5, 5 }, {
+			{ F::RW, 7, 0 }, { F::GZ, 4, 4 }, { F::BY, 4, 4 }, { F::GW, 7, 0 }, { F::BZ, 2, 2 }, { F::GY, 4, 4 },
+			{ F::BW, 7, 0 }, { F::BZ, 3, 3 }, { F::BZ, 4, 4 }, { F::RX, 5, 0 }, { F::GY, 3, 0 }, { F::GX, 4, 0 },
+			{ F::BZ, 0, 0 }, { F::GZ, 3, 0 }, { F::BX, 4, 0 }, { F::BZ, 1, 1 }, { F::BY, 3, 0 }, { F::RY, 5, 0 },
+			{ F::RZ, 5, 0 } } },
+		{ 0x16, 5, true, 2, 8, { 5, 6, 5 }, {
+			{ F::RW, 7, 0 }, { F::BZ, 0, 0 }, { F::BY, 4, 4 }, { F::GW, 7, 0 }, { F::GY, 5, 5 }, { F::GY, 4, 4 },
+			{ F::BW, 7, 0 }, { F::GZ, 5, 5 }, { F::BZ, 4, 4 }, { F::RX, 4, 0 }, { F::GZ, 4, 4 }, { F::GY, 3, 0 },
+			{ F::GX, 5, 0 }, { F::GZ, 3, 0 }, { F::BX, 4, 0 }, { F::BZ, 1, 1 }, { F::BY, 3, 0 }, { F::RY, 4, 0 },
+			{ F::BZ, 2, 2 }, { F::RZ, 4, 0 }, { F::BZ, 3, 3 } } },
+		{ 0x1A, 5, true, 2, 8, { 5, 5, 6 }, {
+			{ F::RW, 7, 0 }, { F::BZ, 1, 1 }, { F::BY, 4, 4 }, { F::GW, 7, 0 }, { F::BY, 5, 5 }, { F::GY, 4, 4 },
+			{ F::BW, 7, 0 }, { F::BZ, 5, 5 }, { F::BZ, 4, 4 }, { F::RX, 4, 0 }, { F::GZ, 4, 4 }, { F::GY, 3, 0 },
+			{ F::GX, 4, 0 }, { F::BZ, 0, 0 }, { F::GZ, 3, 0 }, { F::BX, 5, 0 }, { F::BY, 3, 0 }, { F::RY, 4, 0 },
+			{ F::BZ, 2, 2 }, { F::RZ, 4, 0 }, { F::BZ, 3, 3 } } },
+		{ 0x1E, 5, false, 2, 6, { 6, 6, 6 }, {
+			{ F::RW, 5, 0 }, { F::GZ, 4, 4 }, { F::BZ, 0, 0 }, { F::BZ, 1, 1 }, { F::BY, 4, 4 }, { F::GW, 5, 0 },
+			{ F::GY, 5, 5 }, { F::BY, 5, 5 }, { F::BZ, 2, 2 }, { F::GY, 4, 4 }, { F::BW, 5, 0 }, { F::GZ, 5, 5 },
+			{ F::BZ, 3, 3 }, { F::BZ, 5, 5 }, { F::BZ, 4, 4 }, { F::RX, 5, 0 }, { F::GY, 3, 0 }, { F::GX, 5, 0 },
+			{ F::GZ, 3, 0 }, { F::BX, 5, 0 }, { F::BY, 3, 0 }, { F::RY, 5, 0 }, { F::RZ, 5, 0 } } },
+		{ 0x03, 5, false, 1, 10, { 10, 10, 10 }, {
+			{ F::RW, 9, 0 }, { F::GW, 9, 0 }, { F::BW, 9, 0 }, { F::RX, 9, 0 }, { F::GX, 9, 0 }, { F::BX, 9, 0 } } },
+		{ 0x07, 5, true, 1, 11, { 9, 9, 9 }, {
+			{ F::RW, 9, 0 }, { F::GW, 9, 0 }, { F::BW, 9, 0 }, { F::RX, 8, 0 }, { F::RW, 10, 10 }, { F::GX, 8, 0 },
+			{ F::GW, 10, 10 }, { F::BX, 8, 0 }, { F::BW, 10, 10 } } },
+		{ 0x0B, 5, true, 1, 12, { 8, 8, 8 }, {
+			{ F::RW, 9, 0 }, { F::GW, 9, 0 }, { F::BW, 9, 0 }, { F::RX, 7, 0 }, { F::RW, 10, 11 }, { F::GX, 7, 0 },
+			{ F::GW, 10, 11 }, { F::BX, 7, 0 }, { F::BW, 10, 11 } } },
+		{ 0x0F, 5, true, 1, 16, { 4, 4, 4 }, {
+			{ F::RW, 9, 0 }, { F::GW, 9, 0 }, { F::BW, 9, 0 }, { F::RX, 3, 0 }, { F::RW, 10, 15 }, { F::GX, 3, 0 },
+			{ F::GW, 10, 15 }, { F::BX, 3, 0 }, { F::BW, 10, 15 } } } };
+
+	[[nodiscard]] static int signExtend(int value, std::uint8_t bits) noexcept
+	{
+		int const signBit = 1 << (bits - 1);
+		value &= (1 << bits) - 1;
+		return (value ^ signBit) - signBit;
+	}
+
+	[[nodiscard]] static int unquantizeBC6H(int value, std::uint8_t bits, bool isSigned) noexcept
+	{
+		if (!isSigned)
+		{
+			if (bits >= 15 || value == 0)
+				return value;
+			if (value == (1 << bits) - 1)
+				return 0xFFFF;
+			return ((value << 16) + 0x8000) >> bits;
+		}
+
+		if (bits >= 16)
+			return value;
+		bool negative = value < 0;
+		int magnitude = negative ? -value : value;
+		int result;
+		if (magnitude == 0)
+			result = 0;
+		else if (magnitude >= (1 << (bits - 1)) - 1)
+			result = 0x7FFF;
+		else
+			result = ((magnitude << 15) + 0x4000) >> (bits - 1);
+		return negative ? -result : result;
+	}
+
+	// Scales an interpolated value into the bit pattern of a half float.
+	[[nodiscard]] static float finishUnquantizeBC6H(int value, bool isSigned) noexcept
+	{
+		std::uint16_t half;
+		if (!isSigned)
+			half = static_cast<std::uint16_t>((value * 31) >> 6);
+		else if (value < 0)
+			half = static_cast<std::uint16_t>(0x8000 | (((-value) * 31) >> 5));
+		else
+			half = static_cast<std::uint16_t>((value * 31) >> 5);
+		return halfToFloat(half);
+	}
+
+	void decodeBC6H(unsigned char const* block, float* dst, bool isSigned) noexcept
+	{
+		BitReader reader(block);
+		std::uint8_t modeValue = static_cast<std::uint8_t>(reader.read(2));
+		if (modeValue > 1)
+			modeValue = static_cast<std::uint8_t>(modeValue | (reader.read(3) << 2));
+
+		BC6HMode const* mode = nullptr;
+		for (BC6HMode const& candidate : bc6hModes)
+		{
+			if (candidate.modeValue == modeValue)
+				mode = &candidate;
+		}
+		if (mode == nullptr)
+		{
+			// Reserved, decodes to black.
+			for (std::uint8_t pixel = 0; pixel < 16; pixel++)
+			{
+				dst[pixel * 4 + 0] = 0.f;
+				dst[pixel * 4 + 1] = 0.f;
+				dst[pixel * 4 + 2] = 0.f;
+				dst[pixel * 4 + 3] = 1.f;
+			}
+			return;
+		}
+
+		// Indexed by BC6HField, W X Y Z for each of R G B.
+		int fields[14]{};
+		for (BC6HRun const& run : mode->runs)
+		{
+			if (run.field == BC6HField::M)
+				break;
+			int& field = fields[static_cast<int>(run.field)];
+			if (run.high >= run.low)
+				field |= static_cast<int>(reader.read(run.high - run.low + 1)) << run.low;
+			else
+			{
+				for (int bit = run.low; bit >= run.high; bit--)
+					field |= static_cast<int>(reader.readBit()) << bit;
+			}
+		}
+		std::uint8_t partition = mode->regionCount == 2 ? static_cast<std::uint8_t>(reader.read(5)) : 0;
+
+		// [endpoint][channel], endpoints 0 and 1 are the first region, 2 and 3 the second.
+		int endpoints[4][3];
+		for (std::uint8_t channel = 0; channel < 3; channel++)
+		{
+			int const* channelFields = &fields[static_cast<int>(BC6HField::RW) + channel * 4];
+			for (std::uint8_t i = 0; i < 4; i++)
+				endpoints[i][channel] = channelFields[i];
+		}
+
+		std::uint8_t const endpointCount = mode->regionCount * 2;
+		for (std::uint8_t channel = 0; channel < 3; channel++)
+		{
+			if (isSigned)
+				endpoints[0][channel] = signExtend(endpoints[0][channel], mode->endpointBits);
+			for (std::uint8_t i = 1; i < endpointCount; i++)
+			{
+				if (mode->isTransformed)
+				{
+					int delta = signExtend(endpoints[i][channel], mode->deltaBits[channel]);
+					endpoints[i][channel] = (endpoints[0][channel] + delta) & ((1 << mode->endpointBits) - 1);
+					if (isSigned)
+						endpoints[i][channel] = signExtend(endpoints[i][channel], mode->endpointBits);
+				}
+				else if (isSigned)
+					endpoints[i][channel] = signExtend(endpoints[i][channel], mode->endpointBits);
+			}
+			for (std::uint8_t i = 0; i < endpointCount; i++)
+				endpoints[i][channel] = unquantizeBC6H(endpoints[i][channel], mode->endpointBits, isSigned);
+		}
+
+		std::uint8_t const indexBits = mode->regionCount == 2 ? 3 : 4;
+		std::uint8_t const* weights = weightsFor(indexBits);
+		for (std::uint8_t pixel = 0; pixel < 16; pixel++)
+		{
+			bool anchor = isAnchor(mode->regionCount, partition, pixel);
+			std::uint8_t index = static_cast<std::uint8_t>(reader.read(indexBits - (anchor ? 1 : 0)));
+			std::uint8_t region = subsetOf(mode->regionCount, partition, pixel);
+			int const* endpoint0 = endpoints[region * 2];
+			int const* endpoint1 = endpoints[region * 2 + 1];
+
+			float* out = dst + pixel * 4;
+			for (std::uint8_t channel = 0; channel < 3; channel++)
+			{
+				int value = ((64 - weights[index]) * endpoint0[channel] + weights[index] * endpoint1[channel] + 32) >> 6;
+				out[channel] = finishUnquantizeBC6H(value, isSigned);
+			}
+			out[3] = 1.f;
+		}
+	}
+
+	// --- Whole subresources ---
+
+	bool isBlockCompressed(Texas::PixelFormat pixelFormat) noexcept
+	{
+		return blockSize(pixelFormat) != 0;
+	}
+
+	std::uint8_t blockSize(Texas::PixelFormat pixelFormat) noexcept
+	{
+		switch (pixelFormat)
+		{
+		case Texas::PixelFormat::BC1_RGB:
+		case Texas::PixelFormat::BC1_RGBA:
+		case Texas::PixelFormat::BC4:
+			return 8;
+		case Texas::PixelFormat::BC2_RGBA:
+		case Texas::PixelFormat::BC3_RGBA:
+		case Texas::PixelFormat::BC5:
+		case Texas::PixelFormat::BC6H:
+		case Texas::PixelFormat::BC7_RGBA:
+			return 16;
+		default:
+			return 0;
+		}
+	}
+
+	// Each task decodes at least this many blocks, so tiny mips don't get spread across the whole pool.
+	constexpr std::uint64_t minBlocksPerTask = 1024;
+
+	// Decodes every block of a subresource with decodeBlock(block, decodedBlock) and copies
+	// the decoded 4x4 pixels into dst, cropping the blocks along the right and bottom edges.
+	template<typename Pixel, typename DecodeFunc>
+	static void decodeSubresource(
+		Texas::TextureInfo const& texInfo,
+		Texas::ConstByteSpan byteSpan,
+		std::uint64_t mipIndex,
+		std::uint64_t layerIndex,
+		Pixel* dst,
+		int maxThreads,
+		DecodeFunc const& decodeBlock)
+	{
+		Texas::Dimensions const mipDimensions = Texas::calculateMipDimensions(texInfo.baseDimensions, mipIndex);
+		std::uint64_t const blocksPerRow = (mipDimensions.width + 3) / 4;
+		std::uint64_t const blockRowsPerSlice = (mipDimensions.height + 3) / 4;
+		std::uint64_t const blockRowCount = blockRowsPerSlice * mipDimensions.depth;
+		std::uint8_t const bytesPerBlock = blockSize(texInfo.pixelFormat);
+		unsigned char const* srcData = (unsigned char const*)byteSpan.data() + Texas::calculateLayerOffset(texInfo, mipIndex, layerIndex);
+
+		std::uint64_t const rowsPerTask = std::max<std::uint64_t>(minBlocksPerTask / blocksPerRow, 1);
+		std::uint64_t const taskCount = (blockRowCount + rowsPerTask - 1) / rowsPerTask;
+		parallelFor(taskCount, [&](std::uint64_t taskIndex)
+		{
+			Pixel decoded[16 * 4];
+			std::uint64_t const lastBlockRow = std::min((taskIndex + 1) * rowsPerTask, blockRowCount);
+			for (std::uint64_t blockRow = taskIndex * rowsPerTask; blockRow < lastBlockRow; blockRow++)
+			{
+				std::uint64_t const slice = blockRow / blockRowsPerSlice;
+				std::uint64_t const firstY = (blockRow % blockRowsPerSlice) * 4;
+				std::uint64_t const rowCount = std::min<std::uint64_t>(4, mipDimensions.height - firstY);
+				Pixel* sliceDst = dst + slice * mipDimensions.width * mipDimensions.height * 4;
+
+				for (std::uint64_t blockX = 0; blockX < blocksPerRow; blockX++)
+				{
+					decodeBlock(srcData + (blockRow * blocksPerRow + blockX) * bytesPerBlock, decoded);
+
+					std::uint64_t const firstX = blockX * 4;
+					std::uint64_t const columnCount = std::min<std::uint64_t>(4, mipDimensions.width - firstX);
+					if (rowCount == 4 && columnCount == 4)
+					{
+						// Whole blocks are the common case, keep the copy size constant for them.
+						for (std::uint64_t y = 0; y < 4; y++)
+						{
+							std::memcpy(
+								sliceDst + ((firstY + y) * mipDimensions.width + firstX) * 4,
+								decoded + y * 16,
+								16 * sizeof(Pixel));
+						}
+						continue;
+					}
+					for (std::uint64_t y = 0; y < rowCount; y++)
+					{
+						std::memcpy(
+							sliceDst + ((firstY + y) * mipDimensions.width + firstX) * 4,
+							decoded + y * 16,
+							columnCount * 4 * sizeof(Pixel));
+					}
+				}
+			}
+		}, maxThreads);
+	}
+
+	bool decodeSubresourceToRGBA8(
+		Texas::TextureInfo const& texInfo,
+		Texas::ConstByteSpan byteSpan,
+		std::uint64_t mipIndex,
+		std::uint64_t layerIndex,
+		unsigned char* dst,
+		int maxThreads)
+	{
+		bool const isSignedNormalized = texInfo.channelType == Texas::ChannelType::SignedNormalized;
+		switch (texInfo.pixelFormat)
+		{
+		case Texas::PixelFormat::BC1_RGB:
+		case Texas::PixelFormat::BC1_RGBA:
+		{
+			bool hasAlpha = texInfo.pixelFormat == Texas::PixelFormat::BC1_RGBA;
+			decodeSubresource(texInfo, byteSpan, mipIndex, layerIndex, dst, maxThreads, [hasAlpha](unsigned char const* block, unsigned char* out)
+			{
+				decodeBC1(block, out, hasAlpha);
+			});
+			return true;
+		}
+		case Texas::PixelFormat::BC2_RGBA:
+			decodeSubresource(texInfo, byteSpan, mipIndex, layerIndex, dst, maxThreads, &decodeBC2);
+			return true;
+		case Texas::PixelFormat::BC3_RGBA:
+			decodeSubresource(texInfo, byteSpan, mipIndex, layerIndex, dst, maxThreads, &decodeBC3);
+			return true;
+		case Texas::PixelFormat::BC4:
+			decodeSubresource(texInfo, byteSpan, mipIndex, layerIndex, dst, maxThreads, [isSignedNormalized](unsigned char const* block, unsigned char* out)
+			{
+				decodeBC4(block, out, isSignedNormalized);
+			});
+			return true;
+		case Texas::PixelFormat::BC5:
+			decodeSubresource(texInfo, byteSpan, mipIndex, layerIndex, dst, maxThreads, [isSignedNormalized](unsigned char const* block, unsigned char* out)
+			{
+				decodeBC5(block, out, isSignedNormalized);
+			});
+			return true;
+		case Texas::PixelFormat::BC6H:
+		{
+			bool isSigned = texInfo.channelType == Texas::ChannelType::SignedFloat;
+			decodeSubresource(texInfo, byteSpan, mipIndex, layerIndex, dst, maxThreads, [isSigned](unsigned char const* block, unsigned char* out)
+			{
+				float decoded[16 * 4];
+				decodeBC6H(block, decoded, isSigned);
+				for (std::uint8_t i = 0; i < 16 * 4; i++)
+				{
+					float value = decoded[i];
+					out[i] = !(value > 0.f) ? 0 : value >= 1.f ? 255 : static_cast<unsigned char>(value * 255.f + 0.5f);
+				}
+			});
+			return true;
+		}
+		case Texas::PixelFormat::BC7_RGBA:
+			decodeSubresource(texInfo, byteSpan, mipIndex, layerIndex, dst, maxThreads, &decodeBC7);
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	void decodeBlockToRGBA32F(Texas::TextureInfo const& texInfo, unsigned char const* block, float* dst) noexcept
+	{
+		if (texInfo.pixelFormat == Texas::PixelFormat::BC6H)
+		{
+			decodeBC6H(block, dst, texInfo.channelType == Texas::ChannelType::SignedFloat);
+			return;
+		}
+
+		// Everything else decodes to 8 bits anyway, go through that and normalize.
+		bool const isSignedNormalized = texInfo.channelType == Texas::ChannelType::SignedNormalized;
+		bool const hasSignedChannels =
+			isSignedNormalized &&
+			(texInfo.pixelFormat == Texas::PixelFormat::BC4 || texInfo.pixelFormat == Texas::PixelFormat::BC5);
+		// BC4 copies red into green and blue, BC5 leaves blue at 0.
+		std::uint8_t const signedChannelCount = !hasSignedChannels ? 0 : texInfo.pixelFormat == Texas::PixelFormat::BC4 ? 3 : 2;
+		unsigned char decoded[16 * 4];
+		switch (texInfo.pixelFormat)
+		{
+		case Texas::PixelFormat::BC1_RGB:
+			decodeBC1(block, decoded, false);
+			break;
+		case Texas::PixelFormat::BC1_RGBA:
+			decodeBC1(block, decoded, true);
+			break;
+		case Texas::PixelFormat::BC2_RGBA:
+			decodeBC2(block, decoded);
+			break;
+		case Texas::PixelFormat::BC3_RGBA:
+			decodeBC3(block, decoded);
+			break;
+		case Texas::PixelFormat::BC4:
+			decodeBC4(block, decoded, hasSignedChannels);
+			break;
+		case Texas::PixelFormat::BC5:
+			decodeBC5(block, decoded, hasSignedChannels);
+			break;
+		default:
+			decodeBC7(block, decoded);
+			break;
+		}
+		for (std::uint8_t i = 0; i < 16 * 4; i++)
+		{
+			// Signed channels were offset by 128, alpha and the padding channels never are.
+			bool isSignedChannel = (i & 3) < signedChannelCount;
+			dst[i] = isSignedChannel ? std::max((decoded[i] - 128) / 127.f, -1.f) : decoded[i] / 255.f;
+		}
+	}
+
+	bool decodeSubresourceToRGBA32F(
+		Texas::TextureInfo const& texInfo,
+		Texas::ConstByteSpan byteSpan,
+		std::uint64_t mipIndex,
+		std::uint64_t layerIndex,
+		float* dst,
+		int maxThreads)
+	{
+		if (!isBlockCompressed(texInfo.pixelFormat))
+			return false;
+
+		Texas::TextureInfo const& info = texInfo;
+		decodeSubresource(texInfo, byteSpan, mipIndex, layerIndex, dst, maxThreads, [&info](unsigned char const* block, float* out)
+		{
+			decodeBlockToRGBA32F(info, block, out);
+		});
+		return true;
+	}
+}
@@ -0,0 +1,1214 @@
+#include "TexasGUI/BCnEncoder.hpp"
+
+#include "TexasGUI/BCnDecoder.hpp"
+#include "TexasGUI/ColorSpace.hpp"
+#include "TexasGUI/KTXFormat.hpp"
+#include "TexasGUI/Parallel.hpp"
+
+#include "Texas/Tools.hpp"
+
+#include <QByteArray>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace TexasGUI::BCn
+{
+	char const* toString(EncodeQuality quality) noexcept
+	{
+		switch (quality)
+		{
+		case EncodeQuality::Fast:
+			return "Fast";
+		case EncodeQuality::Normal:
+			return "Normal";
+		case EncodeQuality::High:
+			return "High";
+		case EncodeQuality::Exhaustive:
+			return "Exhaustive";
+		default:
+			return "Error";
+		}
+	}
+
+	bool canEncode(Texas::PixelFormat pixelFormat) noexcept
+	{
+		switch (pixelFormat)
+		{
+		case Texas::PixelFormat::BC1_RGB:
+		case Texas::PixelFormat::BC1_RGBA:
+		case Texas::PixelFormat::BC3_RGBA:
+		case Texas::PixelFormat::BC4:
+		case Texas::PixelFormat::BC5:
+		case Texas::PixelFormat::BC7_RGBA:
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	// Must match the partition tables in BCnDecoder.cpp.
+	constexpr std::uint16_t partitions2[64] = {
+		0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80,
+		0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+		0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE,
+		0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C,
+		0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A,
+		0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660,
+		0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6, 0x639C,
+		0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22 };
+
+	constexpr std::uint8_t anchors2[64] = {
+		15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+		15,  2,  8,  2,  2,  8,  8, 15,  2,  8,  2,  2,  8,  8,  2,  2,
+		15, 15,  6,  8,  2,  8, 15, 15,  2,  8,  2,  2,  2, 15, 15,  6,
+		 6,  2,  6,  8, 15, 15,  2,  2, 15, 15, 15, 15, 15,  2,  2, 15 };
+
+	constexpr std::uint8_t weights2[4] = { 0, 21, 43, 64 };
+	constexpr std::uint8_t weights3[8] = { 0, 9, 18, 27, 37, 46, 55, 64 };
+	constexpr std::uint8_t weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	// Writes bits into a 128-bit block from the least significant bit upwards.
+	class BitWriter
+	{
+	public:
+		void write(std::uint32_t value, std::uint8_t count) noexcept
+		{
+			for (std::uint8_t i = 0; i < count; i++, position++)
+			{
+				if ((value >> i) & 1)
+					bytes[position >> 3] |= static_cast<unsigned char>(1 << (position & 7));
+			}
+		}
+
+		void copyTo(unsigned char* block) const noexcept
+		{
+			std::memcpy(block, bytes, 16);
+		}
+
+	private:
+		unsigned char bytes[16]{};
+		std::uint8_t position = 0;
+	};
+
+	[[nodiscard]] static int refinementPasses(EncodeQuality quality) noexcept
+	{
+		switch (quality)
+		{
+		case EncodeQuality::Fast:
+			return 0;
+		case EncodeQuality::Normal:
+			return 1;
+		default:
+			return 3;
+		}
+	}
+
+	// Principal axis of a set of points, by power iteration on their covariance matrix.
+	// Only the first channelCount channels of each point are used, the rest of mean and axis is left at 0.
+	static void principalAxis(
+		float const (*points)[4],
+		std::uint8_t pointCount,
+		std::uint8_t channelCount,
+		float* mean,
+		float* axis) noexcept
+	{
+		for (std::uint8_t c = 0; c < 4; c++)
+		{
+			mean[c] = 0.f;
+			axis[c] = 0.f;
+		}
+		if (pointCount == 0)
+			return;
+		for (std::uint8_t i = 0; i < pointCount; i++)
+		{
+			for (std::uint8_t c = 0; c < channelCount; c++)
+				mean[c] += points[i][c];
+		}
+		for (std::uint8_t c = 0; c < channelCount; c++)
+			mean[c] /= pointCount;
+
+		float covariance[4][4]{};
+		for (std::uint8_t i = 0; i < pointCount; i++)
+		{
+			for (std::uint8_t a = 0; a < channelCount; a++)
+			{
+				for (std::uint8_t b = 0; b < channelCount; b++)
+					covariance[a][b] += (points[i][a] - mean[a]) * (points[i][b] - mean[b]);
+			}
+		}
+
+		// Start from the channel with the largest spread, that converges quickly for typical blocks.
+		std::uint8_t largest = 0;
+		for (std::uint8_t c = 1; c < channelCount; c++)
+		{
+			if (covariance[c][c] > covariance[largest][largest])
+				largest = c;
+		}
+		for (std::uint8_t c = 0; c < channelCount; c++)
+			axis[c] = covariance[largest][c];
+
+		for (int iteration = 0; iteration < 8; iteration++)
+		{
+			float next[4]{};
+			float length = 0.f;
+			for (std::uint8_t a = 0; a < channelCount; a++)
+			{
+				for (std::uint8_t b = 0; b < channelCount; b++)
+					next[a] += covariance[a][b] * axis[b];
+				length = std::max(length, std::abs(next[a]));
+			}
+			if (length == 0.f)
+				break;
+			for (std::uint8_t c = 0; c < channelCount; c++)
+				axis[c] = next[c] / length;
+		}
+	}
+
+	// Endpoints at the extremes of the points projected onto their principal axis,
+	// or at the corners of their bounding box for the fast tier.
+	static void fitEndpoints(
+		float const (*points)[4],
+		std::uint8_t pointCount,
+		std::uint8_t channelCount,
+		EncodeQuality quality,
+		float* endpoint0,
+		float* endpoint1) noexcept
+	{
+		if (quality == EncodeQuality::Fast)
+		{
+			for (std::uint8_t c = 0; c < channelCount; c++)
+			{
+				endpoint0[c] = 255.f;
+				endpoint1[c] = 0.f;
+			}
+			for (std::uint8_t i = 0; i < pointCount; i++)
+			{
+				for (std::uint8_t c = 0; c < channelCount; c++)
+				{
+					endpoint0[c] = std::min(endpoint0[c], points[i][c]);
+					endpoint1[c] = std::max(endpoint1[c], points[i][c]);
+				}
+			}
+			// The box has four diagonals, pick the one that follows the channels correlating with the first.
+			float mean[4]{};
+			for (std::uint8_t i = 0; i < pointCount; i++)
+			{
+				for (std::uint8_t c = 0; c < channelCount; c++)
+					mean[c] += points[i][c] / pointCount;
+			}
+			for (std::uint8_t c = 1; c < channelCount; c++)
+			{
+				float covariance = 0.f;
+				for (std::uint8_t i = 0; i < pointCount; i++)
+					covariance += (points[i][0] - mean[0]) * (points[i][c] - mean[c]);
+				if (covariance < 0.f)
+					std::swap(endpoint0[c], endpoint1[c]);
+			}
+			return;
+		}
+
+		float mean[4];
+		float axis[4];
+		principalAxis(points, pointCount, channelCount, mean, axis);
+		float minProjection = 0.f;
+		float maxProjection = 0.f;
+		for (std::uint8_t i = 0; i < pointCount; i++)
+		{
+			float projection = 0.f;
+			for (std::uint8_t c = 0; c < channelCount; c++)
+				projection += (points[i][c] - mean[c]) * axis[c];
+			minProjection = std::min(minProjection, projection);
+			maxProjection = std::max(maxProjection, projection);
+		}
+		float axisLengthSquared = 0.f;
+		for (std::uint8_t c = 0; c < channelCount; c++)
+			axisLengthSquared += axis[c] * axis[c];
+		if (axisLengthSquared > 0.f)
+		{
+			minProjection /= axisLengthSquared;
+			maxProjection /= axisLengthSquared;
+		}
+		for (std::uint8_t c = 0; c < channelCount; c++)
+		{
+			endpoint0[c] = std::clamp(mean[c] + axis[c] * minProjection, 0.f, 255.f);
+			endpoint1[c] = std::clamp(mean[c] + axis[c] * maxProjection, 0.f, 255.f);
+		}
+	}
+
+	// Least squares endpoints for a fixed assignment of points to interpolation weights.
+	// weights are in [0, 1] towards endpoint1. Leaves the endpoints alone if the system is degenerate.
+	static void refineEndpoints(
+		float const (*points)[4],
+		float const* weights,
+		std::uint8_t pointCount,
+		std::uint8_t channelCount,
+		float* endpoint0,
+		float* endpoint1) noexcept
+	{
+		float aa = 0.f;
+		float bb = 0.f;
+		float ab = 0.f;
+		float ax[4]{};
+		float bx[4]{};
+		for (std::uint8_t i = 0; i < pointCount; i++)
+		{
+			float b = weights[i];
+			float a = 1.f - b;
+			aa += a * a;
+			bb += b * b;
+			ab += a * b;
+			for (std::uint8_t c = 0; c < channelCount; c++)
+			{
+				ax[c] += a * points[i][c];
+				bx[c] += b * points[i][c];
+			}
+		}
+		float determinant = aa * bb - ab * ab;
+		if (std::abs(determinant) < 1e-6f)
+			return;
+		for (std::uint8_t c = 0; c < channelCount; c++)
+		{
+			endpoint0[c] = std::clamp((ax[c] * bb - bx[c] * ab) / determinant, 0.f, 255.f);
+			endpoint1[c] = std::clamp((bx[c] * aa - ax[c] * ab) / determinant, 0.f, 255.f);
+		}
+	}
+
+	// --- BC1 ---
+
+	[[nodiscard]] static std::uint16_t packColor565(float const* color) noexcept
+	{
+		int r = std::clamp(static_cast<int>(std::lround(color[0] * 31.f / 255.f)), 0, 31);
+		int g = std::clamp(static_cast<int>(std::lround(color[1] * 63.f / 255.f)), 0, 63);
+		int b = std::clamp(static_cast<int>(std::lround(color[2] * 31.f / 255.f)), 0, 31);
+		return static_cast<std::uint16_t>((r << 11) | (g << 5) | b);
+	}
+
+	static void unpackColor565(std::uint16_t color, int* rgb) noexcept
+	{
+		int r = (color >> 11) & 0x1F;
+		int g = (color >> 5) & 0x3F;
+		int b = color & 0x1F;
+		rgb[0] = (r << 3) | (r >> 2);
+		rgb[1] = (g << 2) | (g >> 4);
+		rgb[2] = (b << 3) | (b >> 2);
+	}
+
+	struct ColorBlock
+	{
+		std::uint16_t color0;
+		std::uint16_t color1;
+		std::uint8_t indices[16];
+		std::uint32_t error;
+	};
+
+	// Picks the closest palette entry for every pixel, with the palette built exactly like the decoder does.
+	// Pixels marked transparent always get index 3 in the three color mode.
+	static void evaluateColorBlock(
+		unsigned char const* src,
+		bool const* isTransparent,
+		bool threeColorMode,
+		ColorBlock& result) noexcept
+	{
+		int palette[4][3];
+		unpackColor565(result.color0, palette[0]);
+		unpackColor565(result.color1, palette[1]);
+		std::uint8_t paletteSize = threeColorMode ? 3 : 4;
+		for (std::uint8_t c = 0; c < 3; c++)
+		{
+			if (threeColorMode)
+			{
+				palette[2][c] = (palette[0][c] + palette[1][c] + 1) / 2;
+				palette[3][c] = 0;
+			}
+			else
+			{
+				palette[2][c] = (2 * palette[0][c] + palette[1][c] + 1) / 3;
+				palette[3][c] = (palette[0][c] + 2 * palette[1][c] + 1) / 3;
+			}
+		}
+
+		result.error = 0;
+		for (std::uint8_t pixel = 0; pixel < 16; pixel++)
+		{
+			if (isTransparent != nullptr && isTransparent[pixel])
+			{
+				result.indices[pixel] = 3;
+				continue;
+			}
+			unsigned char const* color = src + pixel * 4;
+			std::uint32_t bestError = ~std::uint32_t(0);
+			for (std::uint8_t i = 0; i < paletteSize; i++)
+			{
+				int dr = color[0] - palette[i][0];
+				int dg = color[1] - palette[i][1];
+				int db = color[2] - palette[i][2];
+				std::uint32_t error = static_cast<std::uint32_t>(dr * dr + dg * dg + db * db);
+				if (error < bestError)
+				{
+					bestError = error;
+					result.indices[pixel] = i;
+				}
+			}
+			result.error += bestError;
+		}
+	}
+
+	// Tries a pair of float endpoints in one of the modes. Only keeps them if they beat best.
+	static void tryColorEndpoints(
+		unsigned char const* src,
+		bool const* isTransparent,
+		bool threeColorMode,
+		float const* endpoint0,
+		float const* endpoint1,
+		ColorBlock& best) noexcept
+	{
+		ColorBlock candidate{};
+		candidate.color0 = packColor565(endpoint0);
+		candidate.color1 = packColor565(endpoint1);
+		evaluateColorBlock(src, isTransparent, threeColorMode, candidate);
+		if (candidate.error < best.error)
+			best = candidate;
+	}
+
+	// Orders the endpoints the way the decoder expects for the mode, remapping the indices to match.
+	static void writeColorBlock(ColorBlock block, bool threeColorMode, unsigned char* dst) noexcept
+	{
+		bool const needsSwap = threeColorMode ? block.color0 > block.color1 : block.color0 < block.color1;
+		if (needsSwap)
+		{
+			std::swap(block.color0, block.color1);
+			for (std::uint8_t& index : block.indices)
+			{
+				if (threeColorMode)
+					index = index == 0 ? 1 : index == 1 ? 0 : index;
+				else
+					index = static_cast<std::uint8_t>(index ^ 1);
+			}
+		}
+		if (!threeColorMode && block.color0 == block.color1)
+		{
+			// Equal endpoints always decode in the three color mode, where only index 0 is still the same color.
+			for (std::uint8_t& index : block.indices)
+				index = 0;
+		}
+
+		std::uint32_t indices = 0;
+		for (std::uint8_t pixel = 0; pixel < 16; pixel++)
+			indices |= std::uint32_t(block.indices[pixel]) << (pixel * 2);
+		dst[0] = static_cast<unsigned char>(block.color0);
+		dst[1] = static_cast<unsigned char>(block.color0 >> 8);
+		dst[2] = static_cast<unsigned char>(block.color1);
+		dst[3] = static_cast<unsigned char>(block.color1 >> 8);
+		dst[4] = static_cast<unsigned char>(indices);
+		dst[5] = static_cast<unsigned char>(indices >> 8);
+		dst[6] = static_cast<unsigned char>(indices >> 16);
+		dst[7] = static_cast<unsigned char>(indices >> 24);
+	}
+
+	// Nudges each 565 component of both endpoints by one step for as long as that lowers the error.
+	static void searchColorEndpoints(
+		unsigned char const* src,
+		bool const* isTransparent,
+		bool threeColorMode,
+		ColorBlock& best) noexcept
+	{
+		constexpr int componentShifts[3] = { 11, 5, 0 };
+		constexpr int componentMasks[3] = { 0x1F, 0x3F, 0x1F };
+		for (int round = 0; round < 8; round++)
+		{
+			bool improved = false;
+			for (int endpoint = 0; endpoint < 2; endpoint++)
+			{
+				for (int component = 0; component < 3; component++)
+				{
+					for (int step = -1; step <= 1; step += 2)
+					{
+						ColorBlock candidate = best;
+						std::uint16_t& color = endpoint == 0 ? candidate.color0 : candidate.color1;
+						int value = ((color >> componentShifts[component]) & componentMasks[component]) + step;
+						if (value < 0 || value > componentMasks[component])
+							continue;
+						color = static_cast<std::uint16_t>(
+							(color & ~(componentMasks[component] << componentShifts[component])) |
+							(value << componentShifts[component]));
+						evaluateColorBlock(src, isTransparent, threeColorMode, candidate);
+						if (candidate.error < best.error)
+						{
+							best = candidate;
+							improved = true;
+						}
+					}
+				}
+			}
+			if (!improved)
+				break;
+		}
+	}
+
+	// The color half of BC1 and BC3. BC3 can't use the three color mode, its decoder ignores the endpoint order.
+	static void encodeColorBlock(
+		unsigned char const* src,
+		unsigned char* dst,
+		bool allowThreeColorMode,
+		bool hasAlpha,
+		EncodeQuality quality) noexcept
+	{
+		bool isTransparent[16]{};
+		bool anyTransparent = false;
+		float points[16][4];
+		std::uint8_t pointCount = 0;
+		for (std::uint8_t pixel = 0; pixel < 16; pixel++)
+		{
+			unsigned char const* color = src + pixel * 4;
+			isTransparent[pixel] = hasAlpha && color[3] < 128;
+			anyTransparent |= isTransparent[pixel];
+			if (isTransparent[pixel])
+				continue;
+			for (std::uint8_t c = 0; c < 4; c++)
+				points[pointCount][c] = color[c];
+			pointCount++;
+		}
+
+		// Transparency is only possible in the three color mode.
+		bool const forceThreeColorMode = anyTransparent && allowThreeColorMode;
+		bool const* transparency = forceThreeColorMode ? isTransparent : nullptr;
+		if (pointCount == 0)
+		{
+			ColorBlock block{};
+			for (std::uint8_t& index : block.indices)
+				index = 3;
+			writeColorBlock(block, true, dst);
+			return;
+		}
+
+		float endpoint0[4];
+		float endpoint1[4];
+		fitEndpoints(points, pointCount, 3, quality, endpoint0, endpoint1);
+
+		ColorBlock best{};
+		best.error = ~std::uint32_t(0);
+		bool bestIsThreeColor = forceThreeColorMode;
+		tryColorEndpoints(src, transparency, bestIsThreeColor, endpoint0, endpoint1, best);
+
+		// Least squares on the weights the current indices imply.
+		for (int pass = 0; pass < refinementPasses(quality); pass++)
+		{
+			float weights[16];
+			std::uint8_t point = 0;
+			for (std::uint8_t pixel = 0; pixel < 16; pixel++)
+			{
+				if (isTransparent[pixel])
+					continue;
+				std::uint8_t index = best.indices[pixel];
+				if (bestIsThreeColor)
+					weights[point++] = index == 0 ? 0.f : index == 1 ? 1.f : 0.5f;
+				else
+					weights[point++] = index == 0 ? 0.f : index == 1 ? 1.f : index == 2 ? 1.f / 3.f : 2.f / 3.f;
+			}
+			std::uint32_t previousError = best.error;
+			refineEndpoints(points, weights, pointCount, 3, endpoint0, endpoint1);
+			tryColorEndpoints(src, transparency, bestIsThreeColor, endpoint0, endpoint1, best);
+			if (best.error == previousError)
+				break;
+		}
+
+		if (quality >= EncodeQuality::High && allowThreeColorMode && !forceThreeColorMode)
+		{
+			// The three color mode has a midpoint and black, which wins for some blocks.
+			ColorBlock threeColor{};
+			threeColor.error = ~std::uint32_t(0);
+			fitEndpoints(points, pointCount, 3, quality, endpoint0, endpoint1);
+			tryColorEndpoints(src, nullptr, true, endpoint0, endpoint1, threeColor);
+			if (threeColor.error < best.error)
+			{
+				best = threeColor;
+				bestIsThreeColor = true;
+			}
+		}
+
+		if (quality == EncodeQuality::Exhaustive)
+			searchColorEndpoints(src, transparency, bestIsThreeColor, best);
+
+		writeColorBlock(best, bestIsThreeColor, dst);
+	}
+
+	void encodeBC1(unsigned char const* src, unsigned char* block, bool hasAlpha, EncodeQuality quality) noexcept
+	{
+		encodeColorBlock(src, block, true, hasAlpha, quality);
+	}
+
+	// --- BC4 ---
+
+	struct ChannelBlock
+	{
+		std::uint8_t endpoint0;
+		std::uint8_t endpoint1;
+		std::uint8_t indices[16];
+		std::uint32_t error;
+	};
+
+	static void evaluateChannelBlock(std::uint8_t const* values, ChannelBlock& block) noexcept
+	{
+		int palette[8];
+		palette[0] = block.endpoint0;
+		palette[1] = block.endpoint1;
+		if (palette[0] > palette[1])
+		{
+			for (int i = 1; i < 7; i++)
+				palette[i + 1] = ((7 - i) * palette[0] + i * palette[1] + 3) / 7;
+		}
+		else
+		{
+			for (int i = 1; i < 5; i++)
+				palette[i + 1] = ((5 - i) * palette[0] + i * palette[1] + 2) / 5;
+			palette[6] = 0;
+			palette[7] = 255;
+		}
+
+		block.error = 0;
+		for (std::uint8_t pixel = 0; pixel < 16; pixel++)
+		{
+			std::uint32_t bestError = ~std::uint32_t(0);
+			for (std::uint8_t i = 0; i < 8; i++)
+			{
+				int difference = values[pixel] - palette[i];
+				std::uint32_t error = static_cast<std::uint32_t>(difference * difference);
+				if (error < bestError)
+				{
+					bestError = error;
+					block.indices[pixel] = i;
+				}
+			}
+			block.error += bestError;
+		}
+	}
+
+	static void tryChannelEndpoints(std::uint8_t const* values, int endpoint0, int endpoint1, ChannelBlock& best) noexcept
+	{
+		ChannelBlock candidate{};
+		candidate.endpoint0 = static_cast<std::uint8_t>(std::clamp(endpoint0, 0, 255));
+		candidate.endpoint1 = static_cast<std::uint8_t>(std::clamp(endpoint1, 0, 255));
+		evaluateChannelBlock(values, candidate);
+		if (candidate.error < best.error)
+			best = candidate;
+	}
+
+	// The 8 byte single channel block used by BC3 alpha, BC4 and BC5. Reads every stride bytes of src.
+	static void encodeChannelBlock(unsigned char const* src, std::uint8_t stride, unsigned char* dst, EncodeQuality quality) noexcept
+	{
+		std::uint8_t values[16];
+		int minValue = 255;
+		int maxValue = 0;
+		// Extremes without 0 and 255, which the six value mode gets for free.
+		int innerMin = 255;
+		int innerMax = 0;
+		for (std::uint8_t pixel = 0; pixel < 16; pixel++)
+		{
+			values[pixel] = src[pixel * stride];
+			minValue = std::min<int>(minValue, values[pixel]);
+			maxValue = std::max<int>(maxValue, values[pixel]);
+			if (values[pixel] != 0 && values[pixel] != 255)
+			{
+				innerMin = std::min<int>(innerMin, values[pixel]);
+				innerMax = std::max<int>(innerMax, values[pixel]);
+			}
+		}
+
+		ChannelBlock best{};
+		best.error = ~std::uint32_t(0);
+		// endpoint0 > endpoint1 selects the eight value mode.
+		tryChannelEndpoints(values, maxValue, minValue, best);
+
+		if (quality >= EncodeQuality::Normal && innerMin <= innerMax)
+			tryChannelEndpoints(values, innerMin, innerMax, best);
+
+		if (quality >= EncodeQuality::High)
+		{
+			int const radius = quality == EncodeQuality::Exhaustive ? std::max((maxValue - minValue) / 4, 2) : 2;
+			int const range = std::min(radius, 8);
+			ChannelBlock const start = best;
+			for (int d0 = -range; d0 <= range; d0++)
+			{
+				for (int d1 = -range; d1 <= range; d1++)
+				{
+					int endpoint0 = start.endpoint0 + d0;
+					int endpoint1 = start.endpoint1 + d1;
+					// Stay in the mode we started in.
+					if ((endpoint0 > endpoint1) != (start.endpoint0 > start.endpoint1))
+						continue;
+					tryChannelEndpoints(values, endpoint0, endpoint1, best);
+				}
+			}
+		}
+
+		std::uint64_t indices = 0;
+		for (std::uint8_t pixel = 0; pixel < 16; pixel++)
+			indices |= std::uint64_t(best.indices[pixel]) << (pixel * 3);
+		dst[0] = best.endpoint0;
+		dst[1] = best.endpoint1;
+		for (std::uint8_t i = 0; i < 6; i++)
+			dst[2 + i] = static_cast<unsigned char>(indices >> (i * 8));
+	}
+
+	void encodeBC3(unsigned char const* src, unsigned char* block, EncodeQuality quality) noexcept
+	{
+		encodeChannelBlock(src + 3, 4, block, quality);
+		encodeColorBlock(src, block + 8, false, false, quality);
+	}
+
+	void encodeBC4(unsigned char const* src, unsigned char* block, EncodeQuality quality) noexcept
+	{
+		encodeChannelBlock(src, 4, block, quality);
+	}
+
+	void encodeBC5(unsigned char const* src, unsigned char* block, EncodeQuality quality) noexcept
+	{
+		encodeChannelBlock(src, 4, block, quality);
+		encodeChannelBlock(src + 1, 4, block + 8, quality);
+	}
+
+	// --- BC7 ---
+
+	// The BC7 modes we encode, all without rotation or index selection:
+	//  6: one subset, RGBA 7.7.7.7 with a p-bit per endpoint, 4-bit indices.
+	//  1: two subsets, RGB 6.6.6 with a shared p-bit per subset, 3-bit indices. Opaque only.
+	//  3: two subsets, RGB 7.7.7 with a p-bit per endpoint, 2-bit indices. Opaque only.
+	struct BC7EncodeMode
+	{
+		std::uint8_t mode;
+		std::uint8_t subsetCount;
+		std::uint8_t channelCount;
+		std::uint8_t endpointBits;
+		bool sharedPBit;
+		std::uint8_t indexBits;
+	};
+
+	constexpr BC7EncodeMode bc7Mode6 = { 6, 1, 4, 7, false, 4 };
+	constexpr BC7EncodeMode bc7Mode1 = { 1, 2, 3, 6, true, 3 };
+	constexpr BC7EncodeMode bc7Mode3 = { 3, 2, 3, 7, false, 2 };
+
+	struct BC7Block
+	{
+		std::uint8_t partition;
+		// [subset * 2 + endpoint][channel], quantized without the p-bit.
+		std::uint8_t endpoints[4][4];
+		std::uint8_t pBits[4];
+		std::uint8_t indices[16];
+		std::uint32_t error;
+	};
+
+	[[nodiscard]] static std::uint8_t subsetOf(BC7EncodeMode const& mode, std::uint8_t partition, std::uint8_t pixel) noexcept
+	{
+		return mode.subsetCount == 2 ? (partitions2[partition] >> pixel) & 1 : 0;
+	}
+
+	[[nodiscard]] static std::uint8_t const* bc7Weights(std::uint8_t indexBits) noexcept
+	{
+		return indexBits == 2 ? weights2 : indexBits == 3 ? weights3 : weights4;
+	}
+
+	[[nodiscard]] static int unquantizeBC7(int value, std::uint8_t precision) noexcept
+	{
+		value <<= 8 - precision;
+		return value | (value >> precision);
+	}
+
+	// The color an endpoint decodes to.
+	static void decodeBC7Endpoint(BC7EncodeMode const& mode, BC7Block const& block, std::uint8_t endpoint, int* color) noexcept
+	{
+		std::uint8_t const precision = mode.endpointBits + 1;
+		for (std::uint8_t c = 0; c < 4; c++)
+		{
+			if (c < mode.channelCount)
+				color[c] = unquantizeBC7((block.endpoints[endpoint][c] << 1) | block.pBits[endpoint], precision);
+			else
+				color[c] = 255;
+		}
+	}
+
+	// Quantizes a float endpoint to endpointBits per channel plus a p-bit, returning the squared error.
+	// With forcedPBit >= 0 the p-bit is fixed, otherwise the better one is picked.
+	static std::uint32_t quantizeBC7Endpoint(
+		BC7EncodeMode const& mode,
+		float const* color,
+		int forcedPBit,
+		std::uint8_t* quantized,
+		std::uint8_t& pBit) noexcept
+	{
+		std::uint8_t const precision = mode.endpointBits + 1;
+		int const maxValue = (1 << mode.endpointBits) - 1;
+		std::uint32_t bestError = ~std::uint32_t(0);
+		for (int p = 0; p < 2; p++)
+		{
+			if (forcedPBit >= 0 && p != forcedPBit)
+				continue;
+			std::uint8_t candidate[4]{};
+			std::uint32_t error = 0;
+			for (std::uint8_t c = 0; c < mode.channelCount; c++)
+			{
+				// Try the two nearest quantized values, unquantization isn't linear enough to trust rounding.
+				float scaled = color[c] * ((1 << precision) - 1) / 255.f;
+				int base = std::clamp(static_cast<int>((scaled - p) / 2.f), 0, maxValue);
+				std::uint32_t channelError = ~std::uint32_t(0);
+				for (int q = base; q <= std::min(base + 1, maxValue); q++)
+				{
+					float difference = unquantizeBC7((q << 1) | p, precision) - color[c];
+					std::uint32_t e = static_cast<std::uint32_t>(difference * difference);
+					if (e < channelError)
+					{
+						channelError = e;
+						candidate[c] = static_cast<std::uint8_t>(q);
+					}
+				}
+				error += channelError;
+			}
+			if (error < bestError)
+			{
+				bestError = error;
+				std::memcpy(quantized, candidate, 4);
+				pBit = static_cast<std::uint8_t>(p);
+			}
+		}
+		return bestError;
+	}
+
+	// Assigns every pixel of a subset the closest interpolated color and adds up the error.
+	static void assignBC7Indices(
+		BC7EncodeMode const& mode,
+		unsigned char const* src,
+		BC7Block& block) noexcept
+	{
+		std::uint8_t const* weights = bc7Weights(mode.indexBits);
+		std::uint8_t const indexCount = static_cast<std::uint8_t>(1 << mode.indexBits);
+
+		int palettes[2][16][4];
+		for (std::uint8_t subset = 0; subset < mode.subsetCount; subset++)
+		{
+			int color0[4];
+			int color1[4];
+			decodeBC7Endpoint(mode, block, subset * 2, color0);
+			decodeBC7Endpoint(mode, block, subset * 2 + 1, color1);
+			for (std::uint8_t i = 0; i < indexCount; i++)
+			{
+				for (std::uint8_t c = 0; c < 4; c++)
+					palettes[subset][i][c] = ((64 - weights[i]) * color0[c] + weights[i] * color1[c] + 32) >> 6;
+			}
+		}
+
+		block.error = 0;
+		for (std::uint8_t pixel = 0; pixel < 16; pixel++)
+		{
+			unsigned char const* color = src + pixel * 4;
+			std::uint8_t subset = subsetOf(mode, block.partition, pixel);
+			std::uint32_t bestError = ~std::uint32_t(0);
+			for (std::uint8_t i = 0; i < indexCount; i++)
+			{
+				std::uint32_t error = 0;
+				for (std::uint8_t c = 0; c < 4; c++)
+				{
+					int difference = color[c] - palettes[subset][i][c];
+					error += static_cast<std::uint32_t>(difference * difference);
+				}
+				if (error < bestError)
+				{
+					bestError = error;
+					block.indices[pixel] = i;
+				}
+			}
+			block.error += bestError;
+		}
+	}
+
+	// Fits, quantizes and refines the endpoints of every subset for one mode and partition.
+	static void encodeBC7Candidate(
+		BC7EncodeMode const& mode,
+		std::uint8_t partition,
+		unsigned char const* src,
+		EncodeQuality quality,
+		BC7Block& result) noexcept
+	{
+		result.partition = partition;
+
+		float points[2][16][4];
+		std::uint8_t pointCounts[2]{};
+		for (std::uint8_t pixel = 0; pixel < 16; pixel++)
+		{
+			std::uint8_t subset = subsetOf(mode, partition, pixel);
+			for (std::uint8_t c = 0; c < 4; c++)
+				points[subset][pointCounts[subset]][c] = src[pixel * 4 + c];
+			pointCounts[subset]++;
+		}
+
+		float endpoints[4][4]{};
+		for (std::uint8_t subset = 0; subset < mode.subsetCount; subset++)
+			fitEndpoints(points[subset], pointCounts[subset], mode.channelCount, quality, endpoints[subset * 2], endpoints[subset * 2 + 1]);
+
+		auto quantize = [&](BC7Block& block)
+		{
+			for (std::uint8_t subset = 0; subset < mode.subsetCount; subset++)
+			{
+				std::uint8_t e0 = subset * 2;
+				std::uint8_t e1 = subset * 2 + 1;
+				if (!mode.sharedPBit)
+				{
+					quantizeBC7Endpoint(mode, endpoints[e0], -1, block.endpoints[e0], block.pBits[e0]);
+					quantizeBC7Endpoint(mode, endpoints[e1], -1, block.endpoints[e1], block.pBits[e1]);
+					continue;
+				}
+				std::uint32_t bestError = ~std::uint32_t(0);
+				for (int p = 0; p < 2; p++)
+				{
+					std::uint8_t q0[4];
+					std::uint8_t q1[4];
+					std::uint8_t pBit;
+					std::uint32_t error =
+						quantizeBC7Endpoint(mode, endpoints[e0], p, q0, pBit) +
+						quantizeBC7Endpoint(mode, endpoints[e1], p, q1, pBit);
+					if (error < bestError)
+					{
+						bestError = error;
+						std::memcpy(block.endpoints[e0], q0, 4);
+						std::memcpy(block.endpoints[e1], q1, 4);
+						block.pBits[e0] = static_cast<std::uint8_t>(p);
+						block.pBits[e1] = static_cast<std::uint8_t>(p);
+					}
+				}
+			}
+			assignBC7Indices(mode, src, block);
+		};
+
+		quantize(result);
+
+		std::uint8_t const* weights = bc7Weights(mode.indexBits);
+		for (int pass = 0; pass < refinementPasses(quality); pass++)
+		{
+			for (std::uint8_t subset = 0; subset < mode.subsetCount; subset++)
+			{
+				float subsetWeights[16];
+				std::uint8_t point = 0;
+				for (std::uint8_t pixel = 0; pixel < 16; pixel++)
+				{
+					if (subsetOf(mode, partition, pixel) == subset)
+						subsetWeights[point++] = weights[result.indices[pixel]] / 64.f;
+				}
+				refineEndpoints(points[subset], subsetWeights, pointCounts[subset], mode.channelCount, endpoints[subset * 2], endpoints[subset * 2 + 1]);
+			}
+			BC7Block refined = result;
+			quantize(refined);
+			if (refined.error >= result.error)
+				break;
+			result = refined;
+		}
+	}
+
+	static void writeBC7Block(BC7EncodeMode const& mode, BC7Block block, unsigned char* dst) noexcept
+	{
+		// The anchor pixel of each subset has its top index bit dropped, so it has to be 0.
+		// If it isn't, swap that subset's endpoints and flip its indices.
+		std::uint8_t const maxIndex = static_cast<std::uint8_t>((1 << mode.indexBits) - 1);
+		for (std::uint8_t subset = 0; subset < mode.subsetCount; subset++)
+		{
+			std::uint8_t anchor = subset == 0 ? 0 : anchors2[block.partition];
+			if (block.indices[anchor] <= maxIndex / 2)
+				continue;
+			for (std::uint8_t c = 0; c < 4; c++)
+				std::swap(block.endpoints[subset * 2][c], block.endpoints[subset * 2 + 1][c]);
+			std::swap(block.pBits[subset * 2], block.pBits[subset * 2 + 1]);
+			for (std::uint8_t pixel = 0; pixel < 16; pixel++)
+			{
+				if (subsetOf(mode, block.partition, pixel) == subset)
+					block.indices[pixel] = static_cast<std::uint8_t>(maxIndex - block.indices[pixel]);
+			}
+		}
+
+		BitWriter writer;
+		writer.write(1u << mode.mode, mode.mode + 1);
+		if (mode.subsetCount == 2)
+			writer.write(block.partition, 6);
+		std::uint8_t const endpointCount = mode.subsetCount * 2;
+		for (std::uint8_t c = 0; c < mode.channelCount; c++)
+		{
+			for (std::uint8_t i = 0; i < endpointCount; i++)
+				writer.write(block.endpoints[i][c], mode.endpointBits);
+		}
+		if (mode.sharedPBit)
+		{
+			for (std::uint8_t subset = 0; subset < mode.subsetCount; subset++)
+				writer.write(block.pBits[subset * 2], 1);
+		}
+		else
+		{
+			for (std::uint8_t i = 0; i < endpointCount; i++)
+				writer.write(block.pBits[i], 1);
+		}
+		for (std::uint8_t pixel = 0; pixel < 16; pixel++)
+		{
+			bool isAnchor = pixel == 0 || (mode.subsetCount == 2 && pixel == anchors2[block.partition]);
+			writer.write(block.indices[pixel], mode.indexBits - (isAnchor ? 1 : 0));
+		}
+		writer.copyTo(dst);
+	}
+
+	void encodeBC7(unsigned char const* src, unsigned char* block, EncodeQuality quality) noexcept
+	{
+		BC7EncodeMode const* bestMode = &bc7Mode6;
+		BC7Block best{};
+		encodeBC7Candidate(bc7Mode6, 0, src, quality, best);
+
+		bool isOpaque = true;
+		for (std::uint8_t pixel = 0; pixel < 16; pixel++)
+			isOpaque &= src[pixel * 4 + 3] == 255;
+
+		if (isOpaque && quality >= EncodeQuality::High)
+		{
+			BC7EncodeMode const* twoSubsetModes[2] = { &bc7Mode1, &bc7Mode3 };
+			std::uint8_t const modeCount = quality == EncodeQuality::Exhaustive ? 2 : 1;
+			// The full fit is only worth it for the partitions a fast fit already likes.
+			EncodeQuality const screeningQuality = quality == EncodeQuality::Exhaustive ? EncodeQuality::Normal : EncodeQuality::Fast;
+			for (std::uint8_t modeIndex = 0; modeIndex < modeCount; modeIndex++)
+			{
+				BC7EncodeMode const& mode = *twoSubsetModes[modeIndex];
+				std::uint8_t bestPartition = 0;
+				std::uint32_t bestPartitionError = ~std::uint32_t(0);
+				for (std::uint8_t partition = 0; partition < 64; partition++)
+				{
+					BC7Block candidate{};
+					encodeBC7Candidate(mode, partition, src, screeningQuality, candidate);
+					if (candidate.error < bestPartitionError)
+					{
+						bestPartitionError = candidate.error;
+						bestPartition = partition;
+					}
+				}
+				BC7Block candidate{};
+				encodeBC7Candidate(mode, bestPartition, src, quality, candidate);
+				if (candidate.error < best.error)
+				{
+					best = candidate;
+					bestMode = &mode;
+				}
+			}
+		}
+
+		writeBC7Block(*bestMode, best, block);
+	}
+
+	// --- Whole textures ---
+
+	// Each task encodes at least this many blocks, the better tiers are slow enough that this is plenty.
+	constexpr std::uint64_t minBlocksPerTile = 256;
+
+	Texas::TextureInfo encodedTextureInfo(Texas::TextureInfo const& srcInfo, Texas::PixelFormat targetFormat) noexcept
+	{
+		Texas::TextureInfo dstInfo = srcInfo;
+		dstInfo.pixelFormat = targetFormat;
+		bool const isColorFormat =
+			targetFormat == Texas::PixelFormat::BC1_RGB ||
+			targetFormat == Texas::PixelFormat::BC1_RGBA ||
+			targetFormat == Texas::PixelFormat::BC3_RGBA ||
+			targetFormat == Texas::PixelFormat::BC7_RGBA;
+		if (isColorFormat && ColorSpace::isSRGBEncoded(srcInfo))
+		{
+			dstInfo.channelType = Texas::ChannelType::sRGB;
+			dstInfo.colorSpace = Texas::ColorSpace::sRGB;
+		}
+		else
+		{
+			dstInfo.channelType = Texas::ChannelType::UnsignedNormalized;
+			dstInfo.colorSpace = Texas::ColorSpace::Linear;
+		}
+		return dstInfo;
+	}
+
+	// Encodes every layer of the mips in [firstMip, mipEnd) into dst, laid out like they are in the whole
+	// texture but starting at firstMip. Tiles from every subresource share one parallelFor, so small mips
+	// don't leave threads idle.
+	static bool encodeMipRange(
+		Texas::TextureInfo const& srcInfo,
+		Texas::ConstByteSpan srcData,
+		Texas::TextureInfo const& dstInfo,
+		EncodeQuality quality,
+		std::uint64_t firstMip,
+		std::uint64_t mipEnd,
+		unsigned char* dst,
+		KernelProgress* progress,
+		int maxThreads)
+	{
+		Texas::PixelFormat const targetFormat = dstInfo.pixelFormat;
+		std::uint64_t const dstBaseOffset = Texas::calculateMipOffset(dstInfo, firstMip);
+
+		struct Tile
+		{
+			std::uint64_t subresourceIndex;
+			std::uint64_t firstBlockRow;
+			std::uint64_t blockRowCount;
+		};
+		struct Subresource
+		{
+			Texas::Dimensions dimensions;
+			std::uint64_t blocksPerRow;
+			std::byte const* src;
+			// A row of blocks if the source is block compressed, else a row of pixels.
+			std::uint64_t srcRowSize;
+			unsigned char* dst;
+		};
+
+		std::vector<Subresource> subresources((mipEnd - firstMip) * srcInfo.layerCount);
+		std::vector<Tile> tiles;
+		for (std::uint64_t mipIndex = firstMip; mipIndex < mipEnd; mipIndex++)
+		{
+			Texas::Dimensions dimensions = Texas::calculateMipDimensions(srcInfo.baseDimensions, mipIndex);
+			std::uint64_t blocksPerRow = (dimensions.width + 3) / 4;
+			std::uint64_t blockRowCount = (dimensions.height + 3) / 4 * dimensions.depth;
+			std::uint64_t rowsPerTile = std::max<std::uint64_t>(minBlocksPerTile / blocksPerRow, 1);
+			for (std::uint64_t layerIndex = 0; layerIndex < srcInfo.layerCount; layerIndex++)
+			{
+				std::uint64_t subresourceIndex = (mipIndex - firstMip) * srcInfo.layerCount + layerIndex;
+				Subresource& subresource = subresources[subresourceIndex];
+				subresource.dimensions = dimensions;
+				subresource.blocksPerRow = blocksPerRow;
+				subresource.src = srcData.data() + Texas::calculateLayerOffset(srcInfo, mipIndex, layerIndex);
+				subresource.srcRowSize = KTX::packedRowSize(srcInfo.pixelFormat, dimensions.width);
+				subresource.dst = dst + (Texas::calculateLayerOffset(dstInfo, mipIndex, layerIndex) - dstBaseOffset);
+				for (std::uint64_t row = 0; row < blockRowCount; row += rowsPerTile)
+					tiles.push_back(Tile{ subresourceIndex, row, std::min(rowsPerTile, blockRowCount - row) });
+			}
+		}
+
+		if (progress != nullptr)
+			progress->totalUnits.store(tiles.size());
+
+		bool const srcIsBlockCompressed = isBlockCompressed(srcInfo.pixelFormat);
+		std::uint8_t const bytesPerBlock = blockSize(targetFormat);
+		std::atomic<bool> conversionFailed{ false };
+		parallelFor(tiles.size(), [&](std::uint64_t tileIndex)
+		{
+			if (conversionFailed.load(std::memory_order_relaxed))
+				return;
+			if (progress != nullptr && progress->cancelled.load(std::memory_order_relaxed))
+				return;
+
+			Tile const& tile = tiles[tileIndex];
+			Subresource& subresource = subresources[tile.subresourceIndex];
+			Texas::Dimensions const& dimensions = subresource.dimensions;
+			std::uint64_t const blockRowsPerSlice = (dimensions.height + 3) / 4;
+			std::uint64_t const tileEnd = tile.firstBlockRow + tile.blockRowCount;
+
+			// Only the rows under the tile are converted to RGBA8, the encoders only ever see that.
+			// The rows of one slice look just like a small 2D texture to the display kernels.
+			Texas::TextureInfo stripInfo = srcInfo;
+			stripInfo.textureType = Texas::TextureType::Texture2D;
+			stripInfo.mipCount = 1;
+			stripInfo.layerCount = 1;
+			QByteArray rgba;
+
+			unsigned char pixels[16 * 4];
+			for (std::uint64_t stripStart = tile.firstBlockRow; stripStart < tileEnd;)
+			{
+				std::uint64_t const slice = stripStart / blockRowsPerSlice;
+				std::uint64_t const stripEnd = std::min(tileEnd, (slice + 1) * blockRowsPerSlice);
+				std::uint64_t const stripY = (stripStart % blockRowsPerSlice) * 4;
+				std::uint64_t const stripHeight = std::min((stripEnd - stripStart) * 4, dimensions.height - stripY);
+				std::uint64_t const srcFirstRow = srcIsBlockCompressed ?
+					slice * blockRowsPerSlice + stripY / 4 :
+					slice * dimensions.height + stripY;
+				stripInfo.baseDimensions = Texas::Dimensions{ dimensions.width, stripHeight, 1 };
+				Texas::ConstByteSpan const stripData(subresource.src + srcFirstRow * subresource.srcRowSize, Texas::calculateTotalSize(stripInfo));
+				if (!BuildDisplayableSubresource(stripInfo, stripData, 0, 0, rgba))
+				{
+					conversionFailed.store(true);
+					return;
+				}
+				unsigned char const* stripPixels = (unsigned char const*)rgba.constData();
+
+				for (std::uint64_t blockRow = stripStart; blockRow < stripEnd; blockRow++)
+				{
+					std::uint64_t firstY = (blockRow - stripStart) * 4;
+					for (std::uint64_t blockX = 0; blockX < subresource.blocksPerRow; blockX++)
+					{
+						// Edge blocks repeat their last row and column, so the padding doesn't pull the endpoints around.
+						for (std::uint64_t y = 0; y < 4; y++)
+						{
+							std::uint64_t srcY = std::min(firstY + y, stripHeight - 1);
+							for (std::uint64_t x = 0; x < 4; x++)
+							{
+								std::uint64_t srcX = std::min(blockX * 4 + x, dimensions.width - 1);
+								std::memcpy(pixels + (y * 4 + x) * 4, stripPixels + (srcY * dimensions.width + srcX) * 4, 4);
+							}
+						}
+
+						unsigned char* block = subresource.dst + (blockRow * subresource.blocksPerRow + blockX) * bytesPerBlock;
+						switch (targetFormat)
+						{
+						case Texas::PixelFormat::BC1_RGB:
+							encodeBC1(pixels, block, false, quality);
+							break;
+						case Texas::PixelFormat::BC1_RGBA:
+							encodeBC1(pixels, block, true, quality);
+							break;
+						case Texas::PixelFormat::BC3_RGBA:
+							encodeBC3(pixels, block, quality);
+							break;
+						case Texas::PixelFormat::BC4:
+							encodeBC4(pixels, block, quality);
+							break;
+						case Texas::PixelFormat::BC5:
+							encodeBC5(pixels, block, quality);
+							break;
+						default:
+							encodeBC7(pixels, block, quality);
+							break;
+						}
+					}
+				}
+				stripStart = stripEnd;
+			}
+
+			if (progress != nullptr)
+				progress->completedUnits.fetch_add(1, std::memory_order_relaxed);
+		}, maxThreads);
+
+		if (conversionFailed.load())
+			return false;
+		return progress == nullptr || !progress->cancelled.load();
+	}
+
+	bool encodeTexture(
+		Texas::TextureInfo const& srcInfo,
+		Texas::ConstByteSpan srcData,
+		Texas::PixelFormat targetFormat,
+		EncodeQuality quality,
+		Texas::TextureInfo& dstInfo,
+		std::vector<std::byte>& dstData,
+		KernelProgress* progress,
+		int maxThreads)
+	{
+		if (!canEncode(targetFormat))
+			return false;
+
+		dstInfo = encodedTextureInfo(srcInfo, targetFormat);
+		dstData.resize(Texas::calculateTotalSize(dstInfo));
+		return encodeMipRange(srcInfo, srcData, dstInfo, quality, 0, srcInfo.mipCount, (unsigned char*)dstData.data(), progress, maxThreads);
+	}
+
+	bool encodeMipLevel(
+		Texas::TextureInfo const& srcInfo,
+		Texas::ConstByteSpan srcData,
+		std::uint64_t mipIndex,
+		Texas::PixelFormat targetFormat,
+		EncodeQuality quality,
+		std::vector<std::byte>& dstData,
+		int maxThreads)
+	{
+		if (!canEncode(targetFormat) || mipIndex >= srcInfo.mipCount)
+			return false;
+
+		Texas::TextureInfo const dstInfo = encodedTextureInfo(srcInfo, targetFormat);
+		std::uint64_t const mipOffset = Texas::calculateMipOffset(dstInfo, mipIndex);
+		std::uint64_t const mipEnd = mipIndex + 1 < dstInfo.mipCount ? Texas::calculateMipOffset(dstInfo, mipIndex + 1) : Texas::calculateTotalSize(dstInfo);
+		dstData.resize(mipEnd - mipOffset);
+		return encodeMipRange(srcInfo, srcData, dstInfo, quality, mipIndex, mipIndex + 1, (unsigned char*)dstData.data(), nullptr, maxThreads);
+	}
+}
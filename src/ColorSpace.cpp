@@ -0,0 +1,128 @@
+#include "TexasGUI/ColorSpace.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace TexasGUI::ColorSpace
+{
+	[[nodiscard]] static float fromBits(std::int32_t bits) noexcept
+	{
+		float value;
+		std::memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+
+	[[nodiscard]] static std::int32_t toBits(float value) noexcept
+	{
+		std::int32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		return bits;
+	}
+
+	// value^(-1/3) for positive values. Three steps take the first guess to full precision, without dividing.
+	[[nodiscard]] static float inverseCbrt(float value) noexcept
+	{
+		// Each step is result + result * (1 - value * result^3) / 3, spread out to shorten the chain of dependent operations.
+		float const valueThird = value * (1.f / 3.f);
+		float result = fromBits(Detail::inverseCbrtGuess - static_cast<std::int32_t>(static_cast<float>(toBits(value)) * (1.f / 3.f)));
+		for (int i = 0; i < 3; i++)
+		{
+			float const squared = result * result;
+			result = result + (result * (1.f / 3.f) - valueThird * (squared * squared));
+		}
+		return result;
+	}
+
+	// value^(-1/5) for positive values.
+	[[nodiscard]] static float inverseFifthRoot(float value) noexcept
+	{
+		float const valueFifth = value * 0.2f;
+		float result = fromBits(Detail::inverseFifthRootGuess - static_cast<std::int32_t>(static_cast<float>(toBits(value)) * 0.2f));
+		for (int i = 0; i < 3; i++)
+		{
+			float const squared = result * result;
+			result = result + (result * 0.2f - valueFifth * (squared * squared * squared));
+		}
+		return result;
+	}
+
+	bool isSRGBEncoded(Texas::TextureInfo const& texInfo) noexcept
+	{
+		if (texInfo.channelType == Texas::ChannelType::sRGB)
+			return true;
+		return texInfo.colorSpace == Texas::ColorSpace::sRGB && texInfo.channelType == Texas::ChannelType::UnsignedNormalized;
+	}
+
+	float linearToSRGB(float value) noexcept
+	{
+		value = value > 0.f ? value : 0.f;
+		// Infinity would turn the Newton steps into NaN.
+		value = value < std::numeric_limits<float>::max() ? value : std::numeric_limits<float>::max();
+		if (value <= 0.0031308f)
+			return value * 12.92f;
+		// x^(1/2.4) = x^(1/2) * x^(-1/12)
+		float const root = std::sqrt(value);
+		return 1.055f * (root * std::sqrt(inverseCbrt(root))) - 0.055f;
+	}
+
+	float srgbToLinear(float value) noexcept
+	{
+		if (value <= 0.04045f)
+			return value * (1.f / 12.92f);
+		float const base = (value + 0.055f) * (1.f / 1.055f);
+		// x^2.4 = (x^(4/5))^3
+		float const product = base * inverseFifthRoot(base);
+		return product * product * product;
+	}
+
+	float srgb8ToLinear(std::uint8_t code) noexcept
+	{
+		return Detail::srgb8Tables().toLinear[code];
+	}
+
+	std::uint8_t linearToSRGB8(float value) noexcept
+	{
+		Detail::SRGB8Tables const& tables = Detail::srgb8Tables();
+		value = value > 0.f ? (value < 1.f ? value : 1.f) : 0.f;
+		int code = tables.buckets[static_cast<int>(value * Detail::srgb8BucketCount)];
+		code += value >= tables.thresholds[code] ? 1 : 0;
+		return static_cast<std::uint8_t>(code);
+	}
+}
+
+TexasGUI::ColorSpace::Detail::SRGB8Tables const& TexasGUI::ColorSpace::Detail::srgb8Tables() noexcept
+{
+	// Built in doubles, the exact curve rounded once.
+	static SRGB8Tables const tables = []()
+	{
+		SRGB8Tables temp{};
+		for (int i = 0; i < 256; i++)
+		{
+			double const encoded = i / 255.0;
+			double const linear = encoded <= 0.04045 ? encoded / 12.92 : std::pow((encoded + 0.055) / 1.055, 2.4);
+			temp.toLinear[i] = static_cast<float>(linear);
+			temp.toLinear[256 + i] = static_cast<float>(encoded);
+		}
+		for (int i = 0; i < 255; i++)
+		{
+			double const encoded = (i + 0.5) / 255.0;
+			double const tie = encoded <= 0.04045 ? encoded / 12.92 : std::pow((encoded + 0.055) / 1.055, 2.4);
+			// Encoding compares in floats, so the threshold has to be the first float past the tie. Rounding
+			// to the nearest one can land just below it and send values under the tie to the code above.
+			float threshold = static_cast<float>(tie);
+			if (static_cast<double>(threshold) < tie)
+				threshold = std::nextafter(threshold, 2.f);
+			temp.thresholds[i] = threshold;
+		}
+		temp.thresholds[255] = 2.f;
+		for (int i = 0; i <= srgb8BucketCount; i++)
+		{
+			float const bottom = static_cast<float>(i) / srgb8BucketCount;
+			temp.buckets[i] = static_cast<std::uint8_t>(std::upper_bound(temp.thresholds, temp.thresholds + 255, bottom) - temp.thresholds);
+		}
+		return temp;
+	}();
+	return tables;
+}
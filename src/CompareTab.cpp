@@ -0,0 +1,301 @@
+#include "CompareTab.hpp"
+
+#include "TextureViewport.hpp"
+
+#include <QBoxLayout>
+#include <QDoubleSpinBox>
+#include <QGroupBox>
+#include <QLabel>
+#include <QProgressBar>
+#include <QSpinBox>
+#include <QTimer>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <cmath>
+#include <limits>
+
+namespace TexasGUI
+{
+	struct CompareJob
+	{
+		KernelProgress progress{};
+		Compare::Metrics metrics{};
+	};
+
+	// What the heatmap starts at, a bit under 8-bit precision shows up dark.
+	constexpr double defaultMaxError = 0.05;
+
+	[[nodiscard]] static QString toPSNRString(double psnr)
+	{
+		if (std::isinf(psnr))
+			return "identical";
+		return QString::number(psnr, 'f', 2) + " dB";
+	}
+}
+
+TexasGUI::CompareTab::CompareTab(
+	QString const& nameA,
+	std::shared_ptr<Texas::Texture const> textureA,
+	QString const& nameB,
+	std::shared_ptr<Texas::Texture const> textureB) :
+	QWidget(),
+	textureA(static_cast<std::shared_ptr<Texas::Texture const>&&>(textureA)),
+	textureB(static_cast<std::shared_ptr<Texas::Texture const>&&>(textureB)),
+	job(std::make_shared<CompareJob>())
+{
+	this->inputA = { this->textureA->textureInfo(), this->textureA->rawBufferSpan() };
+	this->inputB = { this->textureB->textureInfo(), this->textureB->rawBufferSpan() };
+
+	QHBoxLayout* outerLayout = new QHBoxLayout;
+	this->setLayout(outerLayout);
+
+	createLeftPanel(outerLayout, nameA, nameB);
+
+	this->viewport = new TextureViewport;
+	outerLayout->addWidget(this->viewport);
+	setHeatmapSource(static_cast<float>(defaultMaxError));
+
+	// The worker only touches atomics and its own job, so poll the progress like the loading tab does.
+	this->progressTimer = new QTimer(this);
+	this->progressTimer->setInterval(50);
+	QObject::connect(this->progressTimer, SIGNAL(timeout()), this, SLOT(updateProgress()));
+	this->progressTimer->start();
+
+	this->watcher = new QFutureWatcher<bool>(this);
+	QObject::connect(this->watcher, SIGNAL(finished()), this, SLOT(workerFinished()));
+	Compare::Input const a = this->inputA;
+	Compare::Input const b = this->inputB;
+	std::shared_ptr<CompareJob> currentJob = this->job;
+	this->watcher->setFuture(QtConcurrent::run([a, b, currentJob]()
+	{
+		return Compare::compareTextures(a, b, currentJob->metrics, &currentJob->progress);
+	}));
+}
+
+TexasGUI::CompareTab::~CompareTab()
+{
+	// The worker reads the textures, which only live as long as our references to them do.
+	this->job->progress.cancelled.store(true);
+	this->watcher->waitForFinished();
+	// Same as the ImageTab, the viewport outlives our members.
+	this->viewport->setSource(nullptr);
+}
+
+void TexasGUI::CompareTab::createLeftPanel(QLayout* parentLayout, QString const& nameA, QString const& nameB)
+{
+	QWidget* controlsWidget = new QWidget;
+	parentLayout->addWidget(controlsWidget);
+	controlsWidget->setMinimumWidth(250);
+	controlsWidget->setMaximumWidth(250);
+
+	QVBoxLayout* outerVLayout = new QVBoxLayout;
+	controlsWidget->setLayout(outerVLayout);
+	outerVLayout->setMargin(0);
+
+	Texas::TextureInfo const& texInfoA = this->inputA.texInfo;
+	Texas::TextureInfo const& texInfoB = this->inputB.texInfo;
+
+	// Textures
+	{
+		QGroupBox* box = new QGroupBox;
+		outerVLayout->addWidget(box);
+		box->setTitle("Textures");
+
+		QVBoxLayout* innerVLayout = new QVBoxLayout;
+		box->setLayout(innerVLayout);
+
+		QLabel* labelA = new QLabel;
+		innerVLayout->addWidget(labelA);
+		labelA->setText("A: " + nameA);
+		labelA->setWordWrap(true);
+
+		QLabel* labelB = new QLabel;
+		innerVLayout->addWidget(labelB);
+		labelB->setText("B: " + nameB);
+		labelB->setWordWrap(true);
+	}
+
+	// Subresource
+	{
+		QGroupBox* box = new QGroupBox;
+		outerVLayout->addWidget(box);
+		box->setTitle("Subresource");
+
+		QVBoxLayout* innerVLayout = new QVBoxLayout;
+		box->setLayout(innerVLayout);
+
+		QHBoxLayout* mipLayout = new QHBoxLayout;
+		innerVLayout->addLayout(mipLayout);
+		QLabel* mipLabel = new QLabel;
+		mipLayout->addWidget(mipLabel);
+		mipLabel->setText("Mip level: ");
+		this->mipSpinBox = new QSpinBox;
+		mipLayout->addWidget(this->mipSpinBox);
+		this->mipSpinBox->setAlignment(Qt::AlignRight | Qt::AlignVCenter);
+		this->mipSpinBox->setMaximum(static_cast<int>(Compare::comparedMipCount(texInfoA, texInfoB) - 1));
+		QObject::connect(this->mipSpinBox, SIGNAL(valueChanged(int)), this, SLOT(subresourceChanged()));
+
+		QHBoxLayout* layerLayout = new QHBoxLayout;
+		innerVLayout->addLayout(layerLayout);
+		QLabel* layerLabel = new QLabel;
+		layerLayout->addWidget(layerLabel);
+		layerLabel->setText("Layer: ");
+		this->layerSpinBox = new QSpinBox;
+		layerLayout->addWidget(this->layerSpinBox);
+		this->layerSpinBox->setAlignment(Qt::AlignRight | Qt::AlignVCenter);
+		this->layerSpinBox->setMaximum(static_cast<int>(Compare::comparedLayerCount(texInfoA, texInfoB) - 1));
+		QObject::connect(this->layerSpinBox, SIGNAL(valueChanged(int)), this, SLOT(subresourceChanged()));
+	}
+
+	// Heatmap
+	{
+		QGroupBox* box = new QGroupBox;
+		outerVLayout->addWidget(box);
+		box->setTitle("Heatmap");
+
+		QHBoxLayout* hLayout = new QHBoxLayout;
+		box->setLayout(hLayout);
+
+		QLabel* maxErrorLabel = new QLabel;
+		hLayout->addWidget(maxErrorLabel);
+		maxErrorLabel->setText("Max error");
+		maxErrorLabel->setToolTip("Differences of this much and more are drawn at the hot end of the ramp.");
+
+		this->maxErrorSpinBox = new QDoubleSpinBox;
+		hLayout->addWidget(this->maxErrorSpinBox);
+		this->maxErrorSpinBox->setRange(0.001, 1.0);
+		this->maxErrorSpinBox->setSingleStep(0.01);
+		this->maxErrorSpinBox->setDecimals(3);
+		this->maxErrorSpinBox->setValue(defaultMaxError);
+		QObject::connect(this->maxErrorSpinBox, SIGNAL(valueChanged(double)), this, SLOT(maxErrorChanged(double)));
+	}
+
+	// Metrics
+	{
+		QGroupBox* box = new QGroupBox;
+		outerVLayout->addWidget(box);
+		box->setTitle("Metrics");
+
+		QVBoxLayout* innerVLayout = new QVBoxLayout;
+		box->setLayout(innerVLayout);
+
+		this->progressBar = new QProgressBar;
+		innerVLayout->addWidget(this->progressBar);
+		this->progressBar->setRange(0, 100);
+		this->progressBar->setValue(0);
+
+		for (QLabel*& label : this->channelLabels)
+		{
+			label = new QLabel;
+			innerVLayout->addWidget(label);
+		}
+
+		this->worstLabel = new QLabel;
+		innerVLayout->addWidget(this->worstLabel);
+		this->worstLabel->setWordWrap(true);
+	}
+
+	QSpacerItem* endOfControlsSpacer = new QSpacerItem(20, 40, QSizePolicy::Minimum, QSizePolicy::Expanding);
+	outerVLayout->addSpacerItem(endOfControlsSpacer);
+}
+
+void TexasGUI::CompareTab::setHeatmapSource(float maxError)
+{
+	// The viewport stops reading from the old source before we let go of it.
+	std::unique_ptr<DiffHeatmapTileSource> source = std::make_unique<DiffHeatmapTileSource>(this->inputA, this->inputB, maxError);
+	this->viewport->setSource(source.get());
+	this->tileSource = static_cast<std::unique_ptr<DiffHeatmapTileSource>&&>(source);
+	// setSource goes back to the first subresource.
+	std::uint64_t const mipIndex = this->mipSpinBox->value();
+	std::uint64_t const layerIndex = this->layerSpinBox->value();
+	this->viewport->setSubresource(mipIndex, layerIndex);
+}
+
+void TexasGUI::CompareTab::subresourceChanged()
+{
+	std::uint64_t const mipIndex = this->mipSpinBox->value();
+	std::uint64_t const layerIndex = this->layerSpinBox->value();
+	this->viewport->setSubresource(mipIndex, layerIndex);
+	updateMetricLabels();
+}
+
+void TexasGUI::CompareTab::maxErrorChanged(double maxError)
+{
+	setHeatmapSource(static_cast<float>(maxError));
+}
+
+void TexasGUI::CompareTab::workerFinished()
+{
+	this->progressTimer->stop();
+	if (!this->watcher->result())
+		return;
+	this->progressBar->setValue(100);
+	this->progressBar->hide();
+	updateMetricLabels();
+}
+
+void TexasGUI::CompareTab::updateProgress()
+{
+	std::uint64_t totalUnits = this->job->progress.totalUnits.load();
+	if (totalUnits > 0)
+	{
+		std::uint64_t completedUnits = this->job->progress.completedUnits.load();
+		this->progressBar->setValue(static_cast<int>(completedUnits * 100 / totalUnits));
+	}
+}
+
+void TexasGUI::CompareTab::updateMetricLabels()
+{
+	// The metrics belong to the worker until it's done.
+	if (!this->watcher->isFinished() || !this->watcher->result())
+		return;
+
+	Compare::Metrics const& metrics = this->job->metrics;
+	Compare::SubresourceMetrics const* subresource = metrics.find(this->mipSpinBox->value(), this->layerSpinBox->value());
+	for (std::uint8_t i = 0; i < 4; i++)
+	{
+		if (subresource == nullptr || i >= metrics.channelCount)
+		{
+			this->channelLabels[i]->clear();
+			continue;
+		}
+
+		Compare::ChannelMetrics const& channel = subresource->channels[i];
+		this->channelLabels[i]->setText(QString::number(i) +
+			" PSNR: " + toPSNRString(channel.psnr) +
+			"  SSIM: " + QString::number(channel.ssim, 'f', 4) +
+			"\n   MSE: " + QString::number(channel.mse, 'g', 5));
+	}
+
+	// Across every subresource and channel, so one bad mip doesn't hide behind the one on screen.
+	Compare::SubresourceMetrics const* worstPSNR = nullptr;
+	Compare::SubresourceMetrics const* worstSSIM = nullptr;
+	double minPSNR = std::numeric_limits<double>::infinity();
+	double minSSIM = std::numeric_limits<double>::infinity();
+	for (Compare::SubresourceMetrics const& current : metrics.subresources)
+	{
+		for (std::uint8_t i = 0; i < metrics.channelCount; i++)
+		{
+			if (worstPSNR == nullptr || current.channels[i].psnr < minPSNR)
+			{
+				worstPSNR = &current;
+				minPSNR = current.channels[i].psnr;
+			}
+			if (worstSSIM == nullptr || current.channels[i].ssim < minSSIM)
+			{
+				worstSSIM = &current;
+				minSSIM = current.channels[i].ssim;
+			}
+		}
+	}
+	if (worstPSNR == nullptr)
+	{
+		this->worstLabel->clear();
+		return;
+	}
+	this->worstLabel->setText(
+		"Worst PSNR: " + toPSNRString(minPSNR) +
+		" (mip " + QString::number(worstPSNR->mipIndex) + ", layer " + QString::number(worstPSNR->layerIndex) + ")" +
+		"\nWorst SSIM: " + QString::number(minSSIM, 'f', 4) +
+		" (mip " + QString::number(worstSSIM->mipIndex) + ", layer " + QString::number(worstSSIM->layerIndex) + ")");
+}
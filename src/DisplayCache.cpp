@@ -0,0 +1,116 @@
+#include "TexasGUI/DisplayCache.hpp"
+
+#include "TexasGUI/LatencyRecorder.hpp"
+#include "TexasGUI/TextureKernels.hpp"
+
+#include "Texas/Tools.hpp"
+
+#include <QMutexLocker>
+
+TexasGUI::DisplayCache::DisplayCache(
+	Texas::TextureInfo const& texInfo,
+	Texas::ConstByteSpan byteSpan,
+	std::uint64_t memoryBudget) :
+	texInfo(texInfo),
+	byteSpan(byteSpan),
+	budget(memoryBudget)
+{
+}
+
+QByteArray TexasGUI::DisplayCache::get(std::uint64_t mipIndex, std::uint64_t layerIndex)
+{
+	Key key{ mipIndex, layerIndex };
+	{
+		QMutexLocker lock(&this->mutex);
+		this->lastRequested = key;
+		auto iter = this->entries.find(key);
+		if (iter != this->entries.end())
+		{
+			this->lruOrder.splice(this->lruOrder.begin(), this->lruOrder, iter->second.lruPosition);
+			return iter->second.data;
+		}
+	}
+
+	// Convert without holding the lock so prefetches can keep going.
+	QByteArray data;
+	Latency::ScopedStage conversionStage(Latency::Stage::DisplayConversion);
+	if (!BuildDisplayableSubresource(this->texInfo, this->byteSpan, mipIndex, layerIndex, data))
+	{
+		conversionStage.cancel();
+		return data;
+	}
+	conversionStage.finish();
+
+	QMutexLocker lock(&this->mutex);
+	this->insert_Locked(key, data);
+	return data;
+}
+
+QByteArray TexasGUI::DisplayCache::prefetch(std::uint64_t mipIndex, std::uint64_t layerIndex)
+{
+	Key key{ mipIndex, layerIndex };
+	Texas::Dimensions const mipDims = Texas::calculateMipDimensions(this->texInfo.baseDimensions, mipIndex);
+	std::uint64_t const size = mipDims.width * mipDims.height * mipDims.depth * 4;
+	{
+		QMutexLocker lock(&this->mutex);
+		auto iter = this->entries.find(key);
+		if (iter != this->entries.end())
+			return iter->second.data;
+		if (this->usage + size > this->budget)
+			return QByteArray();
+	}
+
+	QByteArray data;
+	if (!BuildDisplayableSubresource(this->texInfo, this->byteSpan, mipIndex, layerIndex, data))
+		return data;
+
+	QMutexLocker lock(&this->mutex);
+	this->insert_Locked(key, data, true);
+	return data;
+}
+
+void TexasGUI::DisplayCache::insert(std::uint64_t mipIndex, std::uint64_t layerIndex, QByteArray const& data)
+{
+	QMutexLocker lock(&this->mutex);
+	this->insert_Locked(Key{ mipIndex, layerIndex }, data);
+}
+
+void TexasGUI::DisplayCache::insert_Locked(Key key, QByteArray const& data, bool isPrefetch)
+{
+	auto iter = this->entries.find(key);
+	if (iter != this->entries.end())
+	{
+		// Someone else converted it in the meantime, just refresh it, unless this is only a prefetch.
+		if (!isPrefetch)
+			this->lruOrder.splice(this->lruOrder.begin(), this->lruOrder, iter->second.lruPosition);
+		return;
+	}
+
+	// A prefetch only gets to use spare room, it never pushes anything else out.
+	if (isPrefetch && this->usage + static_cast<std::uint64_t>(data.size()) > this->budget)
+		return;
+
+	this->lruOrder.push_front(key);
+	this->entries.emplace(key, Entry{ data, this->lruOrder.begin() });
+	this->usage += static_cast<std::uint64_t>(data.size());
+
+	if (!isPrefetch)
+		this->evict_Locked(key);
+}
+
+void TexasGUI::DisplayCache::evict_Locked(Key justInserted)
+{
+	auto iter = this->lruOrder.end();
+	while (this->usage > this->budget && iter != this->lruOrder.begin())
+	{
+		--iter;
+		// Never throw out what is on screen, or what we were asked for right now.
+		if (*iter == this->lastRequested || *iter == justInserted)
+			continue;
+
+		auto entry = this->entries.find(*iter);
+		this->usage -= static_cast<std::uint64_t>(entry->second.data.size());
+		this->entries.erase(entry);
+		iter = this->lruOrder.erase(iter);
+	}
+}
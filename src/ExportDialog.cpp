@@ -0,0 +1,354 @@
+#include "ExportDialog.hpp"
+
+#include "TexasGUI/BCnDecoder.hpp"
+#include "TexasGUI/BCnEncoder.hpp"
+#include "TexasGUI/FileOutputStream.hpp"
+#include "TexasGUI/FormatConverter.hpp"
+#include "TexasGUI/FormatTraits.hpp"
+#include "TexasGUI/KTXWriter.hpp"
+#include "TexasGUI/LatencyRecorder.hpp"
+#include "TexasGUI/MipGenerator.hpp"
+#include "TexasGUI/Utilities.hpp"
+
+#include <QBoxLayout>
+#include <QComboBox>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileDialog>
+#include <QFormLayout>
+#include <QLabel>
+#include <QLocale>
+#include <QProgressBar>
+#include <QPushButton>
+#include <QTimer>
+#include <QtConcurrent/QtConcurrentRun>
+
+
+#include <vector>
+
+namespace TexasGUI
+{
+	struct ExportJob
+	{
+		KernelProgress progress{};
+	};
+
+	struct ExportResult
+	{
+		std::uint64_t fileSize = 0;
+		qint64 mipMilliseconds = 0;
+		qint64 encodeMilliseconds = 0;
+
+		// Only set if the export failed.
+		QString errorTitle{};
+		QString errorDetails{};
+	};
+
+	// Listed in the format dropdown after the source format, followed by every uncompressed format the source converts to.
+	constexpr Texas::PixelFormat compressedExportFormats[] = {
+		Texas::PixelFormat::BC1_RGB,
+		Texas::PixelFormat::BC1_RGBA,
+		Texas::PixelFormat::BC3_RGBA,
+		Texas::PixelFormat::BC4,
+		Texas::PixelFormat::BC5,
+		Texas::PixelFormat::BC7_RGBA };
+
+	// Runs on the thread pool. Returns nullptr if the job was cancelled.
+	// Mips are generated first when asked for, and whatever comes out of that is what gets encoded or converted.
+	static std::shared_ptr<ExportResult> exportTexture(
+		Texas::Texture const* texture,
+		bool generateMips,
+		Mips::Filter mipFilter,
+		ExportTarget target,
+		BCn::EncodeQuality quality,
+		QString const& fileName,
+		std::shared_ptr<ExportJob> job)
+	{
+		std::shared_ptr<ExportResult> result = std::make_shared<ExportResult>();
+
+		Texas::TextureInfo dstInfo = texture->textureInfo();
+		Texas::ConstByteSpan dstSpan = texture->rawBufferSpan();
+		Texas::TextureInfo mipInfo;
+		std::vector<std::byte> mipData;
+		if (generateMips)
+		{
+			QElapsedTimer mipTimer;
+			mipTimer.start();
+			bool generated = Mips::generateMipChain(
+				texture->textureInfo(),
+				texture->rawBufferSpan(),
+				mipFilter,
+				mipInfo,
+				mipData,
+				&job->progress);
+			if (job->progress.cancelled.load())
+				return nullptr;
+			if (!generated)
+			{
+				result->errorTitle = "Unable to generate mipmaps for this texture.";
+				return result;
+			}
+			result->mipMilliseconds = mipTimer.elapsed();
+			dstInfo = mipInfo;
+			dstSpan = Texas::ConstByteSpan(mipData.data(), mipData.size());
+			// The encoder counts its own units from the start.
+			job->progress.completedUnits.store(0);
+		}
+
+		std::vector<std::byte> encodedData;
+		if (BCn::isBlockCompressed(target.pixelFormat))
+		{
+			QElapsedTimer encodeTimer;
+			encodeTimer.start();
+			bool encoded = BCn::encodeTexture(
+				dstInfo,
+				dstSpan,
+				target.pixelFormat,
+				quality,
+				dstInfo,
+				encodedData,
+				&job->progress);
+			if (job->progress.cancelled.load())
+				return nullptr;
+			if (!encoded)
+			{
+				result->errorTitle = "Unable to encode this texture.";
+				return result;
+			}
+			result->encodeMilliseconds = encodeTimer.elapsed();
+			dstSpan = Texas::ConstByteSpan(encodedData.data(), encodedData.size());
+		}
+
+		// Uncompressed targets are converted a mip level at a time while saving, so they're never held as a whole.
+		bool const convert = target.pixelFormat != Texas::PixelFormat::Invalid && !BCn::isBlockCompressed(target.pixelFormat);
+		Texas::TextureInfo const saveInfo = convert ? Convert::convertedTextureInfo(dstInfo, target.pixelFormat, target.channelType) : dstInfo;
+		Texas::Result canSave = KTX::canSave(saveInfo);
+		if (!canSave.isSuccessful())
+		{
+			result->errorTitle = "Unable to save this format as KTX.";
+			result->errorDetails = canSave.errorMessage();
+			return result;
+		}
+
+		FileOutputStream fileStream;
+		Texas::Result writeResult = fileStream.open(fileName);
+		if (!writeResult.isSuccessful())
+		{
+			result->errorTitle = "Unable to open file for writing.";
+			result->errorDetails = writeResult.errorMessage();
+			return result;
+		}
+
+		if (convert)
+		{
+			QElapsedTimer convertTimer;
+			convertTimer.start();
+			writeResult = Convert::saveToStream(dstInfo, dstSpan, target.pixelFormat, target.channelType, fileStream, &job->progress);
+			if (job->progress.cancelled.load())
+			{
+				// Nobody wants half a file.
+				static_cast<void>(fileStream.close());
+				QFile::remove(fileName);
+				return nullptr;
+			}
+			result->encodeMilliseconds = convertTimer.elapsed();
+		}
+		else
+			writeResult = KTX::saveToStream(dstInfo, dstSpan, fileStream);
+		if (writeResult.isSuccessful())
+			writeResult = fileStream.close();
+		if (!writeResult.isSuccessful())
+		{
+			// Nor half a file that only looks like it was saved.
+			static_cast<void>(fileStream.close());
+			QFile::remove(fileName);
+			result->errorTitle = "Unable to save file.";
+			result->errorDetails = writeResult.errorMessage();
+			return result;
+		}
+		result->fileSize = fileStream.bytesWritten();
+		return result;
+	}
+}
+
+TexasGUI::ExportDialog::ExportDialog(Texas::Texture const& texture, QWidget* parent) :
+	QDialog(parent),
+	sourceTexture(texture),
+	job(std::make_shared<ExportJob>())
+{
+	this->setWindowTitle("Export as KTX");
+
+	QVBoxLayout* outerLayout = new QVBoxLayout;
+	this->setLayout(outerLayout);
+
+	QFormLayout* optionsLayout = new QFormLayout;
+	outerLayout->addLayout(optionsLayout);
+
+	this->formatDropdown = new QComboBox;
+	optionsLayout->addRow("Format:", this->formatDropdown);
+	this->exportTargets.push_back({ Texas::PixelFormat::Invalid, texture.channelType() });
+	this->formatDropdown->addItem("Source (" + Utils::toString(texture.pixelFormat()) + ", " + Utils::toString(texture.channelType()) + ")");
+	for (Texas::PixelFormat pixelFormat : compressedExportFormats)
+	{
+		this->exportTargets.push_back({ pixelFormat, Texas::ChannelType::UnsignedNormalized });
+		this->formatDropdown->addItem(Utils::toString(pixelFormat));
+	}
+	// Every uncompressed pair the source converts to that KTX can also store.
+	Texas::TextureInfo const& texInfo = texture.textureInfo();
+	for (Texas::PixelFormat pixelFormat : uncompressedPixelFormats)
+	{
+		for (Texas::ChannelType channelType : allChannelTypes)
+		{
+			if (pixelFormat == texInfo.pixelFormat && channelType == texInfo.channelType)
+				continue;
+			if (!Convert::canConvert(texInfo, pixelFormat, channelType))
+				continue;
+			if (!KTX::canSave(Convert::convertedTextureInfo(texInfo, pixelFormat, channelType)).isSuccessful())
+				continue;
+			this->exportTargets.push_back({ pixelFormat, channelType });
+			this->formatDropdown->addItem(Utils::toString(pixelFormat) + ", " + Utils::toString(channelType));
+		}
+	}
+	QObject::connect(this->formatDropdown, SIGNAL(currentIndexChanged(int)), this, SLOT(formatChanged(int)));
+
+	this->qualityDropdown = new QComboBox;
+	optionsLayout->addRow("Quality:", this->qualityDropdown);
+	// Add the quality tiers, in the order they are defined
+	for (std::size_t i = 0; i < static_cast<std::size_t>(BCn::EncodeQuality::COUNT); i += 1)
+		this->qualityDropdown->addItem(BCn::toString(static_cast<BCn::EncodeQuality>(i)));
+	this->qualityDropdown->setCurrentIndex(static_cast<int>(BCn::EncodeQuality::Normal));
+	formatChanged(this->formatDropdown->currentIndex());
+
+	this->mipDropdown = new QComboBox;
+	optionsLayout->addRow("Mipmaps:", this->mipDropdown);
+	// Index 0 keeps the source's mips, the rest are the filters in the order they are defined
+	this->mipDropdown->addItem("Source (" + QString::number(texture.mipCount()) + " levels)");
+	for (std::size_t i = 0; i < static_cast<std::size_t>(Mips::Filter::COUNT); i += 1)
+		this->mipDropdown->addItem(QString("Generate, ") + Mips::toString(static_cast<Mips::Filter>(i)));
+	if (!Mips::canGenerate(texture.textureInfo()))
+	{
+		this->mipDropdown->setEnabled(false);
+		this->mipDropdown->setToolTip("Mipmaps can only be generated for uncompressed formats with normalized or float channels.");
+	}
+
+	this->progressBar = new QProgressBar;
+	outerLayout->addWidget(this->progressBar);
+	this->progressBar->setMinimumWidth(300);
+	this->progressBar->setRange(0, 100);
+	this->progressBar->setValue(0);
+
+	this->statusLabel = new QLabel;
+	outerLayout->addWidget(this->statusLabel);
+
+	this->exportButton = new QPushButton;
+	outerLayout->addWidget(this->exportButton);
+	this->exportButton->setText("Export...");
+	QObject::connect(this->exportButton, SIGNAL(clicked()), this, SLOT(startExport()));
+
+	// Same as the loading tab, the worker only touches atomics so we poll them.
+	this->progressTimer = new QTimer(this);
+	this->progressTimer->setInterval(50);
+	QObject::connect(this->progressTimer, SIGNAL(timeout()), this, SLOT(updateProgress()));
+
+	this->watcher = new QFutureWatcher<std::shared_ptr<ExportResult>>(this);
+	QObject::connect(this->watcher, SIGNAL(finished()), this, SLOT(workerFinished()));
+}
+
+TexasGUI::ExportDialog::~ExportDialog()
+{
+	// Unlike the loading tab, the worker reads the texture we were given, so wait for it to let go.
+	this->job->progress.cancelled.store(true);
+	this->watcher->waitForFinished();
+}
+
+void TexasGUI::ExportDialog::formatChanged(int index)
+{
+	// Only the block compressed formats have a quality to pick.
+	this->qualityDropdown->setEnabled(index >= 0 && BCn::isBlockCompressed(this->exportTargets[index].pixelFormat));
+}
+
+void TexasGUI::ExportDialog::startExport()
+{
+	QString fileName = QFileDialog::getSaveFileName(this, "Save file as KTX", "", "KTX Image (*.ktx)");
+	if (fileName.isEmpty())
+		return;
+	exportTo(fileName);
+}
+
+void TexasGUI::ExportDialog::exportTo(QString const& fileName)
+{
+	ExportTarget target = this->exportTargets[this->formatDropdown->currentIndex()];
+	BCn::EncodeQuality quality = static_cast<BCn::EncodeQuality>(this->qualityDropdown->currentIndex());
+	int mipIndex = this->mipDropdown->currentIndex();
+	bool generateMips = mipIndex != 0;
+	Mips::Filter mipFilter = generateMips ? static_cast<Mips::Filter>(mipIndex - 1) : Mips::Filter::Box;
+
+	this->formatDropdown->setEnabled(false);
+	this->qualityDropdown->setEnabled(false);
+	this->mipDropdown->setEnabled(false);
+	this->exportButton->setEnabled(false);
+	if (generateMips)
+		this->statusLabel->setText("Generating mipmaps...");
+	else if (BCn::isBlockCompressed(target.pixelFormat))
+		this->statusLabel->setText("Encoding...");
+	else
+		this->statusLabel->setText(target.pixelFormat == Texas::PixelFormat::Invalid ? "Saving..." : "Converting...");
+	this->progressBar->setValue(0);
+
+	this->job = std::make_shared<ExportJob>();
+	this->exportTimer.start();
+	this->progressTimer->start();
+	// More arguments than QtConcurrent::run forwards to a plain function.
+	Texas::Texture const* texture = &this->sourceTexture;
+	std::shared_ptr<ExportJob> currentJob = this->job;
+	this->watcher->setFuture(QtConcurrent::run([texture, generateMips, mipFilter, target, quality, fileName, currentJob]()
+	{
+		return exportTexture(texture, generateMips, mipFilter, target, quality, fileName, currentJob);
+	}));
+}
+
+void TexasGUI::ExportDialog::workerFinished()
+{
+	this->progressTimer->stop();
+	this->formatDropdown->setEnabled(true);
+	formatChanged(this->formatDropdown->currentIndex());
+	this->mipDropdown->setEnabled(Mips::canGenerate(this->sourceTexture.textureInfo()));
+	this->exportButton->setEnabled(true);
+
+	std::shared_ptr<ExportResult> result = this->watcher->result();
+	if (result == nullptr)
+	{
+		emit exportFinished(false);
+		return;
+	}
+	if (!result->errorTitle.isEmpty())
+	{
+		this->statusLabel->setText(QString());
+		Utils::displayErrorBox(result->errorTitle, result->errorDetails);
+		emit exportFinished(false);
+		return;
+	}
+
+	Latency::record(Latency::Stage::Export, this->exportTimer.nsecsElapsed());
+	this->progressBar->setValue(100);
+	QString status = "Saved " + QLocale().formattedDataSize(static_cast<qint64>(result->fileSize));
+	if (this->mipDropdown->currentIndex() != 0)
+		status += ", mipmaps generated in " + QString::number(result->mipMilliseconds) + " ms";
+	Texas::PixelFormat targetFormat = this->exportTargets[this->formatDropdown->currentIndex()].pixelFormat;
+	if (BCn::isBlockCompressed(targetFormat))
+		status += ", encoded in " + QString::number(result->encodeMilliseconds) + " ms";
+	else if (targetFormat != Texas::PixelFormat::Invalid)
+		status += ", converted in " + QString::number(result->encodeMilliseconds) + " ms";
+	this->statusLabel->setText(status);
+	emit exportFinished(true);
+}
+
+void TexasGUI::ExportDialog::updateProgress()
+{
+	std::uint64_t totalUnits = this->job->progress.totalUnits.load();
+	if (totalUnits > 0)
+	{
+		std::uint64_t completedUnits = this->job->progress.completedUnits.load();
+		this->progressBar->setValue(static_cast<int>(completedUnits * 100 / totalUnits));
+	}
+}
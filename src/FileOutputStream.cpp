@@ -0,0 +1,215 @@
+#include "TexasGUI/FileOutputStream.hpp"
+
+#include <QFile>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <new>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define TEXAS_GUI_POSIX_FILE_IO
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace TexasGUI
+{
+	// Page aligned, so the staging buffer never straddles more pages than it has to.
+	constexpr std::size_t stagingBufferAlignment = 4096;
+
+	// Largest single call into the OS. Some platforms reject or truncate anything bigger than this.
+	constexpr std::uint64_t maxWriteSize = std::uint64_t(1) << 30;
+}
+
+void TexasGUI::FileOutputStream::AlignedDeleter::operator()(char* pointer) const noexcept
+{
+	::operator delete(pointer, std::align_val_t(stagingBufferAlignment));
+}
+
+TexasGUI::FileOutputStream::FileOutputStream(std::size_t bufferSize) :
+	buffer(static_cast<char*>(::operator new(std::max<std::size_t>(bufferSize, 1), std::align_val_t(stagingBufferAlignment)))),
+	bufferCapacity(std::max<std::size_t>(bufferSize, 1))
+{
+}
+
+TexasGUI::FileOutputStream::~FileOutputStream()
+{
+	static_cast<void>(close());
+}
+
+Texas::Result TexasGUI::FileOutputStream::open(QString const& path)
+{
+	static_cast<void>(close());
+	bufferUsed = 0;
+	totalWritten = 0;
+	error = Texas::Result(Texas::ResultType::Success, nullptr);
+
+#ifdef TEXAS_GUI_POSIX_FILE_IO
+	QByteArray const nativePath = QFile::encodeName(path);
+	do
+	{
+		fileDescriptor = ::open(nativePath.constData(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	} while (fileDescriptor < 0 && errno == EINTR);
+	if (fileDescriptor < 0)
+		return fail("Unable to open file for writing.", std::strerror(errno));
+#else
+	file = std::make_unique<QFile>(path);
+	if (!file->open(QIODevice::WriteOnly | QIODevice::Truncate))
+	{
+		QString const reason = file->errorString();
+		file.reset();
+		return fail("Unable to open file for writing.", qPrintable(reason));
+	}
+#endif
+	return { Texas::ResultType::Success, nullptr };
+}
+
+Texas::Result TexasGUI::FileOutputStream::close() noexcept
+{
+	if (!isOpen())
+		return error;
+
+	flushBuffer();
+
+#ifdef TEXAS_GUI_POSIX_FILE_IO
+	if (::close(fileDescriptor) != 0 && error.isSuccessful())
+		fail("Unable to finish writing the file.", std::strerror(errno));
+	fileDescriptor = -1;
+#else
+	file->close();
+	if (file->error() != QFileDevice::NoError && error.isSuccessful())
+		fail("Unable to finish writing the file.", qPrintable(file->errorString()));
+	file.reset();
+#endif
+	return error;
+}
+
+Texas::Result TexasGUI::FileOutputStream::write(char const* data, std::uint64_t size) noexcept
+{
+	if (!error.isSuccessful())
+		return error;
+	if (!isOpen())
+		return { Texas::ResultType::InvalidInputParameter, "Tried writing to a file that isn't open." };
+
+	if (size <= bufferCapacity - bufferUsed)
+	{
+		std::memcpy(buffer.get() + bufferUsed, data, static_cast<std::size_t>(size));
+		bufferUsed += static_cast<std::size_t>(size);
+		totalWritten += size;
+		return { Texas::ResultType::Success, nullptr };
+	}
+
+	if (size < bufferCapacity)
+	{
+		Texas::Result result = flushBuffer();
+		if (!result.isSuccessful())
+			return result;
+		std::memcpy(buffer.get(), data, static_cast<std::size_t>(size));
+		bufferUsed = static_cast<std::size_t>(size);
+		totalWritten += size;
+		return { Texas::ResultType::Success, nullptr };
+	}
+
+	// Too big to be worth copying, send it along with what's buffered.
+	Texas::Result result = writeToFile(buffer.get(), bufferUsed, data, size);
+	bufferUsed = 0;
+	if (result.isSuccessful())
+		totalWritten += size;
+	return result;
+}
+
+bool TexasGUI::FileOutputStream::isOpen() const noexcept
+{
+	return fileDescriptor >= 0 || file != nullptr;
+}
+
+std::uint64_t TexasGUI::FileOutputStream::bytesWritten() const noexcept
+{
+	return totalWritten;
+}
+
+Texas::Result TexasGUI::FileOutputStream::flushBuffer() noexcept
+{
+	if (!error.isSuccessful() || bufferUsed == 0)
+		return error;
+	Texas::Result result = writeToFile(buffer.get(), bufferUsed, nullptr, 0);
+	bufferUsed = 0;
+	return result;
+}
+
+Texas::Result TexasGUI::FileOutputStream::writeToFile(char const* a, std::uint64_t aSize, char const* b, std::uint64_t bSize) noexcept
+{
+#ifdef TEXAS_GUI_POSIX_FILE_IO
+	iovec parts[2] = {
+		{ const_cast<char*>(a), static_cast<std::size_t>(aSize) },
+		{ const_cast<char*>(b), static_cast<std::size_t>(bSize) } };
+	int first = parts[0].iov_len == 0 ? 1 : 0;
+	while (first < 2 && parts[first].iov_len > 0)
+	{
+		// If the first part has to be split, the second one can't go in the same call.
+		iovec call[2] = { parts[first], {} };
+		int callCount = 1;
+		if (call[0].iov_len > maxWriteSize)
+			call[0].iov_len = maxWriteSize;
+		else if (first == 0 && parts[1].iov_len > 0)
+		{
+			call[1] = parts[1];
+			call[1].iov_len = std::min<std::size_t>(call[1].iov_len, maxWriteSize - call[0].iov_len);
+			callCount = call[1].iov_len > 0 ? 2 : 1;
+		}
+
+		ssize_t written = ::writev(fileDescriptor, call, callCount);
+		if (written < 0 && errno == EINTR)
+			continue;
+		if (written < 0)
+			return fail("Unable to write to file.", std::strerror(errno));
+		if (written == 0)
+			return fail("Unable to write to file.");
+
+		std::size_t remaining = static_cast<std::size_t>(written);
+		while (first < 2 && remaining > 0)
+		{
+			std::size_t consumed = std::min(remaining, parts[first].iov_len);
+			parts[first].iov_base = static_cast<char*>(parts[first].iov_base) + consumed;
+			parts[first].iov_len -= consumed;
+			remaining -= consumed;
+			if (parts[first].iov_len == 0)
+				first++;
+		}
+	}
+#else
+	char const* parts[2] = { a, b };
+	std::uint64_t sizes[2] = { aSize, bSize };
+	for (int i = 0; i < 2; i++)
+	{
+		std::uint64_t offset = 0;
+		while (offset < sizes[i])
+		{
+			qint64 chunk = static_cast<qint64>(std::min(sizes[i] - offset, maxWriteSize));
+			qint64 written = file->write(parts[i] + offset, chunk);
+			if (written <= 0)
+				return fail("Unable to write to file.", qPrintable(file->errorString()));
+			offset += static_cast<std::uint64_t>(written);
+		}
+	}
+#endif
+	return { Texas::ResultType::Success, nullptr };
+}
+
+Texas::Result TexasGUI::FileOutputStream::fail(char const* message, char const* reason) noexcept
+{
+	if (!error.isSuccessful())
+		return error;
+	if (reason == nullptr)
+	{
+		error = Texas::Result(Texas::ResultType::FailedToOpenFile, message);
+		return error;
+	}
+	// Failed writes share the result type of failed opens, the message is what says what actually went wrong.
+	std::snprintf(errorMessage, sizeof(errorMessage), "%s %s.", message, reason);
+	error = Texas::Result(Texas::ResultType::FailedToOpenFile, errorMessage);
+	return error;
+}
@@ -0,0 +1,295 @@
+#include "TexasGUI/FloatVisualization.hpp"
+
+#include "TexasGUI/BCnDecoder.hpp"
+#include "TexasGUI/SimdKernels.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace TexasGUI
+{
+	char const* toString(FloatVisualizationMode mode) noexcept
+	{
+		switch (mode)
+		{
+		case FloatVisualizationMode::Remap:
+			return "Remap";
+		case FloatVisualizationMode::Clamp:
+			return "Clamp";
+		case FloatVisualizationMode::Exposure:
+			return "Exposure";
+		case FloatVisualizationMode::Reinhard:
+			return "Reinhard";
+		case FloatVisualizationMode::ACES:
+			return "ACES";
+		default:
+			return "Error";
+		}
+	}
+
+	// How many channels an uncompressed float format has and how wide they are. BC6H counts as 3 floats.
+	struct FloatLayout
+	{
+		std::uint8_t channelCount = 0;
+		std::uint8_t bytesPerChannel = 0;
+	};
+
+	[[nodiscard]] static bool toFloatLayout(Texas::TextureInfo const& texInfo, FloatLayout& layout) noexcept
+	{
+		if (texInfo.pixelFormat == Texas::PixelFormat::BC6H)
+		{
+			layout = { 3, 4 };
+			return true;
+		}
+		if (texInfo.channelType != Texas::ChannelType::SignedFloat && texInfo.channelType != Texas::ChannelType::UnsignedFloat)
+			return false;
+
+		switch (texInfo.pixelFormat)
+		{
+		case Texas::PixelFormat::R_16:
+			layout = { 1, 2 };
+			return true;
+		case Texas::PixelFormat::RG_16:
+			layout = { 2, 2 };
+			return true;
+		case Texas::PixelFormat::RGB_16:
+			layout = { 3, 2 };
+			return true;
+		case Texas::PixelFormat::RGBA_16:
+			layout = { 4, 2 };
+			return true;
+		case Texas::PixelFormat::R_32:
+			layout = { 1, 4 };
+			return true;
+		case Texas::PixelFormat::RG_32:
+			layout = { 2, 4 };
+			return true;
+		case Texas::PixelFormat::RGB_32:
+			layout = { 3, 4 };
+			return true;
+		case Texas::PixelFormat::RGBA_32:
+			layout = { 4, 4 };
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	// Calls rowFunc(rgba, width) for every row of region in turn, with the row converted to RGBA floats.
+	// Missing channels are filled in the same way as for display, single channel formats are copied into green and blue.
+	template<typename RowFunc>
+	[[nodiscard]] static bool forEachFloatRow(
+		Texas::TextureInfo const& texInfo,
+		std::byte const* slice,
+		std::uint64_t rowPitch,
+		KTX::Region const& region,
+		RowFunc const& rowFunc)
+	{
+		FloatLayout layout;
+		if (!toFloatLayout(texInfo, layout) || region.width == 0 || region.height == 0)
+			return false;
+
+		std::vector<float> rgba(region.width * 4);
+
+		if (texInfo.pixelFormat == Texas::PixelFormat::BC6H)
+		{
+			bool const isSigned = texInfo.channelType == Texas::ChannelType::SignedFloat;
+			std::uint64_t const firstBlockX = region.x / 4;
+			std::uint64_t const blockColumnCount = (region.x + region.width + 3) / 4 - firstBlockX;
+			std::uint64_t const decodedWidth = blockColumnCount * 4;
+			// One row of blocks, decoded into 4 rows of pixels.
+			std::vector<float> decoded(decodedWidth * 4 * 4);
+			float block[16 * 4];
+
+			std::uint64_t y = region.y;
+			std::uint64_t const endY = region.y + region.height;
+			while (y < endY)
+			{
+				std::uint64_t const blockY = y / 4;
+				unsigned char const* blockRow = reinterpret_cast<unsigned char const*>(slice) + blockY * rowPitch + firstBlockX * 16;
+				for (std::uint64_t blockX = 0; blockX < blockColumnCount; blockX++)
+				{
+					BCn::decodeBC6H(blockRow + blockX * 16, block, isSigned);
+					for (std::uint64_t row = 0; row < 4; row++)
+						std::memcpy(&decoded[(row * decodedWidth + blockX * 4) * 4], block + row * 16, 16 * sizeof(float));
+				}
+
+				std::uint64_t const blockEndY = std::min((blockY + 1) * 4, endY);
+				for (; y < blockEndY; y++)
+					rowFunc(&decoded[((y % 4) * decodedWidth + region.x - firstBlockX * 4) * 4], region.width);
+			}
+			return true;
+		}
+
+		std::uint64_t const pixelSize = std::uint64_t(layout.channelCount) * layout.bytesPerChannel;
+		std::vector<float> channels(layout.channelCount == 4 ? 0 : region.width * layout.channelCount);
+		for (std::uint64_t row = 0; row < region.height; row++)
+		{
+			std::byte const* src = slice + (region.y + row) * rowPitch + region.x * pixelSize;
+
+			// RGBA rows are already in the right layout, the rest are widened first and spread out afterwards.
+			float* widened = layout.channelCount == 4 ? rgba.data() : channels.data();
+			std::uint64_t const valueCount = region.width * layout.channelCount;
+			if (layout.bytesPerChannel == 2)
+				Simd::halfToFloat(reinterpret_cast<std::uint16_t const*>(src), valueCount, widened);
+			else if (layout.channelCount == 4)
+			{
+				// Already RGBA floats, nothing to convert.
+				rowFunc(reinterpret_cast<float const*>(src), region.width);
+				continue;
+			}
+			else
+				std::memcpy(widened, src, valueCount * sizeof(float));
+
+			if (layout.channelCount != 4)
+			{
+				for (std::uint64_t x = 0; x < region.width; x++)
+				{
+					float* dst = &rgba[x * 4];
+					float const* srcPixel = &channels[x * layout.channelCount];
+					dst[0] = srcPixel[0];
+					dst[1] = layout.channelCount == 1 ? srcPixel[0] : srcPixel[1];
+					dst[2] = layout.channelCount == 1 ? srcPixel[0] : layout.channelCount == 3 ? srcPixel[2] : 0.f;
+					dst[3] = 1.f;
+				}
+			}
+			rowFunc(rgba.data(), region.width);
+		}
+		return true;
+	}
+}
+
+bool TexasGUI::FloatVisualization::usesExposure() const noexcept
+{
+	return
+		this->mode == FloatVisualizationMode::Exposure ||
+		this->mode == FloatVisualizationMode::Reinhard ||
+		this->mode == FloatVisualizationMode::ACES;
+}
+
+int TexasGUI::FloatVisualization::cacheKey() const noexcept
+{
+	// Exposure comes in steps far coarser than 1/64 of a stop.
+	int const exposureKey = usesExposure() ? static_cast<int>(std::lround(this->exposure * 64.f)) : 0;
+	return exposureKey * static_cast<int>(FloatVisualizationMode::COUNT) + static_cast<int>(this->mode);
+}
+
+bool TexasGUI::FloatVisualization::operator==(FloatVisualization const& other) const noexcept
+{
+	return cacheKey() == other.cacheKey();
+}
+
+bool TexasGUI::FloatVisualization::operator!=(FloatVisualization const& other) const noexcept
+{
+	return !(*this == other);
+}
+
+bool TexasGUI::isFloatFormat(Texas::TextureInfo const& texInfo) noexcept
+{
+	FloatLayout layout;
+	return toFloatLayout(texInfo, layout);
+}
+
+bool TexasGUI::findFloatRange(
+	Texas::TextureInfo const& texInfo,
+	std::byte const* slice,
+	std::uint64_t rowPitch,
+	KTX::Region const& region,
+	FloatRange& range)
+{
+	FloatLayout layout;
+	if (!toFloatLayout(texInfo, layout))
+		return false;
+
+	std::uint8_t const channelCount = layout.channelCount;
+	return forEachFloatRow(texInfo, slice, rowPitch, region, [&range, channelCount](float const* rgba, std::uint64_t width)
+	{
+		for (std::uint64_t x = 0; x < width; x++)
+		{
+			for (std::uint8_t i = 0; i < channelCount; i++)
+			{
+				float const value = rgba[x * 4 + i];
+				if (!std::isfinite(value))
+					continue;
+				range.min[i] = std::min(range.min[i], value);
+				range.max[i] = std::max(range.max[i], value);
+			}
+		}
+	});
+}
+
+bool TexasGUI::visualizeFloatRegion(
+	Texas::TextureInfo const& texInfo,
+	std::byte const* slice,
+	std::uint64_t rowPitch,
+	KTX::Region const& region,
+	FloatVisualization const& visualization,
+	FloatRange const& range,
+	QByteArray& rgba)
+{
+	FloatLayout layout;
+	if (!toFloatLayout(texInfo, layout))
+		return false;
+
+	float scale[4] = { 1.f, 1.f, 1.f, 1.f };
+	float offset[4] = { 0.f, 0.f, 0.f, 0.f };
+	Simd::ToneMapOperator toneMapOperator = Simd::ToneMapOperator::None;
+	bool encodeSRGB = false;
+	switch (visualization.mode)
+	{
+	case FloatVisualizationMode::Remap:
+		// Alpha is left at scale 1, so it passes through clamped to [0, 1] like in the other modes.
+		for (std::uint8_t i = 0; i < std::min<std::uint8_t>(layout.channelCount, 3); i++)
+		{
+			// Flat channels, and ones without a single finite value, are shown as they are.
+			if (range.max[i] > range.min[i])
+			{
+				scale[i] = 1.f / (range.max[i] - range.min[i]);
+				offset[i] = -range.min[i] * scale[i];
+			}
+		}
+		if (layout.channelCount == 1)
+		{
+			for (std::uint8_t i = 1; i < 3; i++)
+			{
+				scale[i] = scale[0];
+				offset[i] = offset[0];
+			}
+		}
+		break;
+	case FloatVisualizationMode::Exposure:
+	case FloatVisualizationMode::Reinhard:
+	case FloatVisualizationMode::ACES:
+	{
+		float exposureScale = std::exp2(visualization.exposure);
+		if (visualization.mode == FloatVisualizationMode::Reinhard)
+			toneMapOperator = Simd::ToneMapOperator::Reinhard;
+		else if (visualization.mode == FloatVisualizationMode::ACES)
+		{
+			// The ACES fit expects its input scaled down like this, otherwise everything comes out too bright.
+			toneMapOperator = Simd::ToneMapOperator::ACES;
+			exposureScale *= 0.6f;
+		}
+		for (std::uint8_t i = 0; i < 3; i++)
+			scale[i] = exposureScale;
+		encodeSRGB = true;
+		break;
+	}
+	default:
+		break;
+	}
+
+	rgba = QByteArray(static_cast<int>(region.width * region.height * 4), Qt::Initialization::Uninitialized);
+	unsigned char* dst = reinterpret_cast<unsigned char*>(rgba.data());
+	std::uint64_t row = 0;
+	bool const result = forEachFloatRow(texInfo, slice, rowPitch, region, [&](float const* src, std::uint64_t width)
+	{
+		Simd::toneMapRGBA32FToRGBA8(src, width, scale, offset, toneMapOperator, encodeSRGB, dst + row * width * 4);
+		row++;
+	});
+	if (!result)
+		rgba.clear();
+	return result;
+}
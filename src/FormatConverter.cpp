@@ -0,0 +1,559 @@
+#include "TexasGUI/FormatConverter.hpp"
+
+#include "TexasGUI/ColorSpace.hpp"
+#include "TexasGUI/FormatTraits.hpp"
+#include "TexasGUI/KTXWriter.hpp"
+#include "TexasGUI/Parallel.hpp"
+#include "TexasGUI/SimdKernels.hpp"
+
+#include "Texas/Tools.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+namespace TexasGUI::Convert
+{
+	[[nodiscard]] constexpr bool isNormalizedOrFloat(Texas::ChannelType channelType) noexcept
+	{
+		return
+			channelType == Texas::ChannelType::UnsignedNormalized ||
+			channelType == Texas::ChannelType::SignedNormalized ||
+			channelType == Texas::ChannelType::sRGB ||
+			channelType == Texas::ChannelType::UnsignedFloat ||
+			channelType == Texas::ChannelType::SignedFloat;
+	}
+
+	[[nodiscard]] constexpr bool isUnsignedNormalized(Texas::ChannelType channelType) noexcept
+	{
+		return channelType == Texas::ChannelType::UnsignedNormalized || channelType == Texas::ChannelType::sRGB;
+	}
+
+	template<typename Traits>
+	[[nodiscard]] static float toNormalized(typename Traits::Value value) noexcept
+	{
+		using Value = typename Traits::Value;
+		if constexpr (Traits::channelClass == ChannelClass::Float)
+			return value;
+		else if constexpr (Traits::channelClass == ChannelClass::Signed)
+			return std::max(static_cast<float>(double(value) / std::numeric_limits<Value>::max()), -1.f);
+		else
+			return static_cast<float>(double(value) / std::numeric_limits<Value>::max());
+	}
+
+	template<typename Traits>
+	[[nodiscard]] static typename Traits::Storage fromNormalized(float value) noexcept
+	{
+		using Storage = typename Traits::Storage;
+		if constexpr (Traits::isHalf)
+			return floatToHalf(value);
+		else if constexpr (Traits::channelClass == ChannelClass::Float)
+			return value;
+		else if constexpr (Traits::channelClass == ChannelClass::Signed)
+		{
+			value = value > -1.f ? (value < 1.f ? value : 1.f) : -1.f;
+			return static_cast<Storage>(std::lround(double(value) * std::numeric_limits<Storage>::max()));
+		}
+		else
+		{
+			value = value > 0.f ? (value < 1.f ? value : 1.f) : 0.f;
+			return static_cast<Storage>(double(value) * std::numeric_limits<Storage>::max() + 0.5);
+		}
+	}
+
+	template<Texas::PixelFormat pixelFormat, Texas::ChannelType channelType>
+	static void loadRow(unsigned char const* src, std::uint64_t pixelCount, bool decodeSRGB, float* dst) noexcept
+	{
+		using Traits = FormatTraits<pixelFormat, channelType>;
+		constexpr std::uint8_t channelCount = Traits::channelCount;
+		// Alpha is never sRGB encoded.
+		constexpr std::uint8_t colorCount = channelCount < 3 ? channelCount : 3;
+		constexpr bool isByteFormat = std::is_same_v<typename Traits::Storage, std::uint8_t>;
+
+		if constexpr (pixelFormat == Texas::PixelFormat::RGBA_32 && Traits::channelClass == ChannelClass::Float)
+		{
+			std::memcpy(dst, src, pixelCount * 16);
+			return;
+		}
+		else if constexpr (pixelFormat == Texas::PixelFormat::RGBA_16 && Traits::isHalf)
+		{
+			Simd::halfToFloat(reinterpret_cast<std::uint16_t const*>(src), pixelCount * 4, dst);
+			return;
+		}
+		else if constexpr (pixelFormat == Texas::PixelFormat::RGBA_8 && isUnsignedNormalized(channelType))
+		{
+			if (decodeSRGB)
+			{
+				Simd::decodeSRGBRGBA8ToRGBA32F(src, pixelCount, dst);
+				return;
+			}
+		}
+
+		// 8-bit channels are only ever looked up, the second half of the table is the one without sRGB.
+		[[maybe_unused]] float const* alphaTable = ColorSpace::Detail::srgb8Tables().toLinear + 256;
+		[[maybe_unused]] float const* colorTable = decodeSRGB ? alphaTable - 256 : alphaTable;
+		for (std::uint64_t pixelIndex = 0; pixelIndex < pixelCount; pixelIndex++)
+		{
+			unsigned char const* srcPixel = src + pixelIndex * Traits::bytesPerPixel;
+			float rgba[4] = { 0.f, 0.f, 0.f, 1.f };
+			for (std::uint8_t i = 0; i < channelCount; i++)
+			{
+				if constexpr (isByteFormat)
+					rgba[i] = (i < colorCount ? colorTable : alphaTable)[srcPixel[i]];
+				else
+					rgba[i] = toNormalized<Traits>(loadChannel<Traits>(srcPixel + i * Traits::bytesPerChannel));
+			}
+			if constexpr (Traits::isBGR)
+				std::swap(rgba[0], rgba[2]);
+			std::memcpy(dst + pixelIndex * 4, rgba, sizeof(rgba));
+		}
+		// Missing color channels are 0, which decodes to 0 again.
+		if constexpr (!isByteFormat)
+		{
+			if (decodeSRGB)
+				Simd::decodeSRGBRGBA32F(dst, pixelCount);
+		}
+	}
+
+	// Pixels that go through RGBA at a time, small enough for the stack and to stay in L1.
+	constexpr std::uint64_t chunkPixels = 256;
+
+	template<Texas::PixelFormat pixelFormat, Texas::ChannelType channelType>
+	static void storeRow(float const* src, std::uint64_t pixelCount, bool encodeSRGB, unsigned char* dst) noexcept
+	{
+		using Traits = FormatTraits<pixelFormat, channelType>;
+		using Storage = typename Traits::Storage;
+		constexpr std::uint8_t channelCount = Traits::channelCount;
+		constexpr bool isByteFormat = std::is_same_v<Storage, std::uint8_t>;
+
+		if constexpr (pixelFormat == Texas::PixelFormat::RGBA_32 && Traits::channelClass == ChannelClass::Float)
+		{
+			std::memcpy(dst, src, pixelCount * 16);
+			return;
+		}
+		else if constexpr (pixelFormat == Texas::PixelFormat::RGBA_16 && Traits::isHalf)
+		{
+			Simd::floatToHalf(src, pixelCount * 4, reinterpret_cast<std::uint16_t*>(dst));
+			return;
+		}
+
+		auto storeValues = [](float const* values, std::uint64_t count, unsigned char* out)
+		{
+			for (std::uint64_t pixelIndex = 0; pixelIndex < count; pixelIndex++)
+			{
+				float rgba[4];
+				std::memcpy(rgba, values + pixelIndex * 4, sizeof(rgba));
+				if constexpr (Traits::isBGR)
+					std::swap(rgba[0], rgba[2]);
+
+				unsigned char* outPixel = out + pixelIndex * Traits::bytesPerPixel;
+				for (std::uint8_t i = 0; i < channelCount; i++)
+				{
+					Storage const stored = fromNormalized<Traits>(rgba[i]);
+					std::memcpy(outPixel + i * Traits::bytesPerChannel, &stored, sizeof(stored));
+				}
+			}
+		};
+
+		if (!encodeSRGB)
+		{
+			storeValues(src, pixelCount, dst);
+			return;
+		}
+
+		// 8 bits are rounded to the nearest sRGB code straight from linear, wider channels are encoded as floats first.
+		if constexpr (pixelFormat == Texas::PixelFormat::RGBA_8)
+			Simd::encodeSRGBRGBA32FToRGBA8(src, pixelCount, dst);
+		else if constexpr (pixelFormat == Texas::PixelFormat::BGRA_8)
+		{
+			Simd::encodeSRGBRGBA32FToRGBA8(src, pixelCount, dst);
+			Simd::swapRedBlue8(dst, pixelCount, dst);
+		}
+		else if constexpr (isByteFormat)
+		{
+			unsigned char encoded[chunkPixels * 4];
+			for (std::uint64_t first = 0; first < pixelCount; first += chunkPixels)
+			{
+				std::uint64_t const count = std::min(chunkPixels, pixelCount - first);
+				Simd::encodeSRGBRGBA32FToRGBA8(src + first * 4, count, encoded);
+				for (std::uint64_t pixelIndex = 0; pixelIndex < count; pixelIndex++)
+				{
+					unsigned char* dstPixel = dst + (first + pixelIndex) * Traits::bytesPerPixel;
+					std::memcpy(dstPixel, encoded + pixelIndex * 4, channelCount);
+					if constexpr (Traits::isBGR)
+						std::swap(dstPixel[0], dstPixel[2]);
+				}
+			}
+		}
+		else
+		{
+			float encoded[chunkPixels * 4];
+			for (std::uint64_t first = 0; first < pixelCount; first += chunkPixels)
+			{
+				std::uint64_t const count = std::min(chunkPixels, pixelCount - first);
+				std::memcpy(encoded, src + first * 4, count * 16);
+				Simd::encodeSRGBRGBA32F(encoded, count);
+				storeValues(encoded, count, dst + first * Traits::bytesPerPixel);
+			}
+		}
+	}
+
+	// Integer channels keep their values, missing channels are 0 and alpha 1 like a GPU reads them.
+	template<Texas::PixelFormat pixelFormat, Texas::ChannelType channelType>
+	static void loadIntegerRow(unsigned char const* src, std::uint64_t pixelCount, std::int64_t* dst) noexcept
+	{
+		using Traits = FormatTraits<pixelFormat, channelType>;
+		for (std::uint64_t pixelIndex = 0; pixelIndex < pixelCount; pixelIndex++)
+		{
+			unsigned char const* srcPixel = src + pixelIndex * Traits::bytesPerPixel;
+			std::int64_t rgba[4] = { 0, 0, 0, 1 };
+			for (std::uint8_t i = 0; i < Traits::channelCount; i++)
+				rgba[i] = loadChannel<Traits>(srcPixel + i * Traits::bytesPerChannel);
+			if constexpr (Traits::isBGR)
+				std::swap(rgba[0], rgba[2]);
+			std::memcpy(dst + pixelIndex * 4, rgba, sizeof(rgba));
+		}
+	}
+
+	template<Texas::PixelFormat pixelFormat, Texas::ChannelType channelType>
+	static void storeIntegerRow(std::int64_t const* src, std::uint64_t pixelCount, unsigned char* dst) noexcept
+	{
+		using Traits = FormatTraits<pixelFormat, channelType>;
+		using Storage = typename Traits::Storage;
+		for (std::uint64_t pixelIndex = 0; pixelIndex < pixelCount; pixelIndex++)
+		{
+			std::int64_t rgba[4];
+			std::memcpy(rgba, src + pixelIndex * 4, sizeof(rgba));
+			if constexpr (Traits::isBGR)
+				std::swap(rgba[0], rgba[2]);
+
+			unsigned char* dstPixel = dst + pixelIndex * Traits::bytesPerPixel;
+			for (std::uint8_t i = 0; i < Traits::channelCount; i++)
+			{
+				Storage const stored = static_cast<Storage>(std::clamp<std::int64_t>(
+					rgba[i],
+					std::numeric_limits<Storage>::min(),
+					std::numeric_limits<Storage>::max()));
+				std::memcpy(dstPixel + i * Traits::bytesPerChannel, &stored, sizeof(stored));
+			}
+		}
+	}
+
+	using LoadIntegerRowFunc = void(*)(unsigned char const*, std::uint64_t, std::int64_t*) noexcept;
+	using StoreIntegerRowFunc = void(*)(std::int64_t const*, std::uint64_t, unsigned char*) noexcept;
+
+	// One entry per format/channel type pair. Normalized and float pairs have row functions,
+	// integer ones have integer row functions, and pairs without a layout have neither.
+	struct FormatEntry
+	{
+		Texas::PixelFormat pixelFormat;
+		Texas::ChannelType channelType;
+		std::uint8_t channelCount;
+		std::uint8_t bytesPerChannel;
+		bool isBGR;
+		RowFunctions rowFunctions;
+		LoadIntegerRowFunc loadIntegerRow;
+		StoreIntegerRowFunc storeIntegerRow;
+	};
+
+	template<Texas::PixelFormat pixelFormat, Texas::ChannelType channelType>
+	constexpr FormatEntry makeFormatEntry()
+	{
+		using Traits = FormatTraits<pixelFormat, channelType>;
+		FormatEntry entry{ pixelFormat, channelType, 0, 0, false, { 0, false, nullptr, nullptr }, nullptr, nullptr };
+		if constexpr (Traits::isSupported)
+		{
+			entry.channelCount = Traits::channelCount;
+			entry.bytesPerChannel = Traits::bytesPerChannel;
+			entry.isBGR = Traits::isBGR;
+			entry.rowFunctions.bytesPerPixel = Traits::bytesPerPixel;
+			entry.rowFunctions.isFloat = Traits::channelClass == ChannelClass::Float;
+			if constexpr (isNormalizedOrFloat(channelType))
+			{
+				entry.rowFunctions.loadRow = &loadRow<pixelFormat, channelType>;
+				entry.rowFunctions.storeRow = &storeRow<pixelFormat, channelType>;
+			}
+			else
+			{
+				entry.loadIntegerRow = &loadIntegerRow<pixelFormat, channelType>;
+				entry.storeIntegerRow = &storeIntegerRow<pixelFormat, channelType>;
+			}
+		}
+		return entry;
+	}
+
+	constexpr std::size_t channelTypeCount = sizeof(allChannelTypes) / sizeof(allChannelTypes[0]);
+
+	template<std::size_t... indices>
+	constexpr std::array<FormatEntry, sizeof...(indices)> makeFormatTable(std::index_sequence<indices...>)
+	{
+		return { { makeFormatEntry<uncompressedPixelFormats[indices / channelTypeCount], allChannelTypes[indices % channelTypeCount]>()... } };
+	}
+
+	constexpr auto formatTable = makeFormatTable(
+		std::make_index_sequence<sizeof(uncompressedPixelFormats) / sizeof(uncompressedPixelFormats[0]) * channelTypeCount>());
+
+	[[nodiscard]] static FormatEntry const* findFormatEntry(Texas::PixelFormat pixelFormat, Texas::ChannelType channelType) noexcept
+	{
+		for (FormatEntry const& entry : formatTable)
+		{
+			if (entry.pixelFormat == pixelFormat && entry.channelType == channelType)
+				return entry.channelCount != 0 ? &entry : nullptr;
+		}
+		return nullptr;
+	}
+
+	// Pairs that don't need to go through RGBA, each a single vectorized kernel.
+	enum class FastPath
+	{
+		None,
+		Copy,
+		ExpandRGB8,
+		SwapRedBlue8,
+		Unorm16ToUnorm8,
+		Unorm8ToUnorm16,
+		FloatToHalf,
+		HalfToFloat
+	};
+
+	struct Conversion
+	{
+		FormatEntry const* src = nullptr;
+		FormatEntry const* dst = nullptr;
+		FastPath fastPath = FastPath::None;
+		bool decodeSRGB = false;
+		bool encodeSRGB = false;
+	};
+
+	// Same bits, only read differently, like sRGB and unsigned normalized. Only asked once both sides are known
+	// to hold the same encoding.
+	[[nodiscard]] static bool haveSameValues(Texas::ChannelType a, Texas::ChannelType b) noexcept
+	{
+		return a == b || (isUnsignedNormalized(a) && isUnsignedNormalized(b));
+	}
+
+	[[nodiscard]] static FastPath findFastPath(FormatEntry const& src, FormatEntry const& dst) noexcept
+	{
+		bool const sameValues = haveSameValues(src.channelType, dst.channelType);
+		if (src.pixelFormat == dst.pixelFormat && sameValues)
+			return FastPath::Copy;
+
+		if (src.bytesPerChannel == 1 && dst.bytesPerChannel == 1)
+		{
+			bool const unorm = isUnsignedNormalized(src.channelType) && isUnsignedNormalized(dst.channelType);
+			if (src.channelCount == 3 && dst.channelCount == 4 && src.isBGR == dst.isBGR && unorm)
+				return FastPath::ExpandRGB8;
+			if (src.channelCount == 4 && dst.channelCount == 4 && src.isBGR != dst.isBGR && sameValues)
+				return FastPath::SwapRedBlue8;
+		}
+
+		// The rest convert every channel on its own.
+		if (src.channelCount != dst.channelCount || src.isBGR != dst.isBGR)
+			return FastPath::None;
+		if (isUnsignedNormalized(src.channelType) && isUnsignedNormalized(dst.channelType))
+		{
+			if (src.bytesPerChannel == 2 && dst.bytesPerChannel == 1)
+				return FastPath::Unorm16ToUnorm8;
+			if (src.bytesPerChannel == 1 && dst.bytesPerChannel == 2)
+				return FastPath::Unorm8ToUnorm16;
+		}
+		if (src.rowFunctions.isFloat && dst.rowFunctions.isFloat)
+		{
+			if (src.bytesPerChannel == 4 && dst.bytesPerChannel == 2)
+				return FastPath::FloatToHalf;
+			if (src.bytesPerChannel == 2 && dst.bytesPerChannel == 4)
+				return FastPath::HalfToFloat;
+		}
+		return FastPath::None;
+	}
+
+	[[nodiscard]] static bool makeConversion(
+		Texas::TextureInfo const& srcInfo,
+		Texas::PixelFormat pixelFormat,
+		Texas::ChannelType channelType,
+		Conversion& conversion) noexcept
+	{
+		conversion.src = findFormatEntry(srcInfo.pixelFormat, srcInfo.channelType);
+		conversion.dst = findFormatEntry(pixelFormat, channelType);
+		if (conversion.src == nullptr || conversion.dst == nullptr)
+			return false;
+		if ((conversion.src->rowFunctions.loadRow != nullptr) != (conversion.dst->rowFunctions.loadRow != nullptr))
+			return false;
+
+		// Floats are always linear, same as everywhere else in the viewer. KTX only stores sRGB in formats with
+		// sRGB channels, anything else is read back as linear, so that's what the target holds.
+		bool const srcIsSRGB = ColorSpace::isSRGBEncoded(srcInfo);
+		bool const dstIsSRGB = channelType == Texas::ChannelType::sRGB;
+		conversion.decodeSRGB = srcIsSRGB && !dstIsSRGB;
+		conversion.encodeSRGB = dstIsSRGB && !srcIsSRGB;
+		// The fast paths move values as they are, which is only right when both sides are encoded the same.
+		bool const sameEncoding = !conversion.decodeSRGB && !conversion.encodeSRGB;
+		conversion.fastPath = sameEncoding ? findFastPath(*conversion.src, *conversion.dst) : FastPath::None;
+		return true;
+	}
+
+	static void convertPixels(
+		Conversion const& conversion,
+		unsigned char const* src,
+		std::uint64_t pixelCount,
+		unsigned char* dst) noexcept
+	{
+		FormatEntry const& srcEntry = *conversion.src;
+		FormatEntry const& dstEntry = *conversion.dst;
+		std::uint64_t const valueCount = pixelCount * srcEntry.channelCount;
+		switch (conversion.fastPath)
+		{
+		case FastPath::Copy:
+			std::memcpy(dst, src, pixelCount * srcEntry.rowFunctions.bytesPerPixel);
+			return;
+		case FastPath::ExpandRGB8:
+			Simd::expandRGB8ToRGBA8(src, pixelCount, dst);
+			return;
+		case FastPath::SwapRedBlue8:
+			Simd::swapRedBlue8(src, pixelCount, dst);
+			return;
+		case FastPath::Unorm16ToUnorm8:
+			Simd::unorm16ToUnorm8(reinterpret_cast<std::uint16_t const*>(src), valueCount, dst);
+			return;
+		case FastPath::Unorm8ToUnorm16:
+			Simd::unorm8ToUnorm16(src, valueCount, reinterpret_cast<std::uint16_t*>(dst));
+			return;
+		case FastPath::FloatToHalf:
+			Simd::floatToHalf(reinterpret_cast<float const*>(src), valueCount, reinterpret_cast<std::uint16_t*>(dst));
+			return;
+		case FastPath::HalfToFloat:
+			Simd::halfToFloat(reinterpret_cast<std::uint16_t const*>(src), valueCount, reinterpret_cast<float*>(dst));
+			return;
+		default:
+			break;
+		}
+
+		std::uint64_t const srcPixelSize = srcEntry.rowFunctions.bytesPerPixel;
+		std::uint64_t const dstPixelSize = dstEntry.rowFunctions.bytesPerPixel;
+		if (srcEntry.rowFunctions.loadRow != nullptr)
+		{
+			float rgba[chunkPixels * 4];
+			for (std::uint64_t first = 0; first < pixelCount; first += chunkPixels)
+			{
+				std::uint64_t const count = std::min(chunkPixels, pixelCount - first);
+				srcEntry.rowFunctions.loadRow(src + first * srcPixelSize, count, conversion.decodeSRGB, rgba);
+				dstEntry.rowFunctions.storeRow(rgba, count, conversion.encodeSRGB, dst + first * dstPixelSize);
+			}
+		}
+		else
+		{
+			std::int64_t rgba[chunkPixels * 4];
+			for (std::uint64_t first = 0; first < pixelCount; first += chunkPixels)
+			{
+				std::uint64_t const count = std::min(chunkPixels, pixelCount - first);
+				srcEntry.loadIntegerRow(src + first * srcPixelSize, count, rgba);
+				dstEntry.storeIntegerRow(rgba, count, dst + first * dstPixelSize);
+			}
+		}
+	}
+}
+
+TexasGUI::Convert::RowFunctions const* TexasGUI::Convert::findRowFunctions(Texas::PixelFormat pixelFormat, Texas::ChannelType channelType) noexcept
+{
+	FormatEntry const* entry = findFormatEntry(pixelFormat, channelType);
+	return entry != nullptr && entry->rowFunctions.loadRow != nullptr ? &entry->rowFunctions : nullptr;
+}
+
+bool TexasGUI::Convert::canConvert(
+	Texas::TextureInfo const& srcInfo,
+	Texas::PixelFormat pixelFormat,
+	Texas::ChannelType channelType) noexcept
+{
+	Conversion conversion;
+	return makeConversion(srcInfo, pixelFormat, channelType, conversion);
+}
+
+Texas::TextureInfo TexasGUI::Convert::convertedTextureInfo(
+	Texas::TextureInfo const& srcInfo,
+	Texas::PixelFormat pixelFormat,
+	Texas::ChannelType channelType) noexcept
+{
+	Texas::TextureInfo dstInfo = srcInfo;
+	dstInfo.pixelFormat = pixelFormat;
+	dstInfo.channelType = channelType;
+
+	Conversion conversion;
+	if (!makeConversion(srcInfo, pixelFormat, channelType, conversion))
+		return dstInfo;
+	dstInfo.colorSpace = channelType == Texas::ChannelType::sRGB ? Texas::ColorSpace::sRGB : Texas::ColorSpace::Linear;
+	return dstInfo;
+}
+
+bool TexasGUI::Convert::convertMipLevel(
+	Texas::TextureInfo const& srcInfo,
+	Texas::ConstByteSpan srcData,
+	std::uint64_t mipIndex,
+	Texas::PixelFormat pixelFormat,
+	Texas::ChannelType channelType,
+	std::vector<std::byte>& dstData,
+	KernelProgress* progress,
+	int maxThreads)
+{
+	Conversion conversion;
+	if (!makeConversion(srcInfo, pixelFormat, channelType, conversion) || mipIndex >= srcInfo.mipCount)
+		return false;
+
+	Texas::Dimensions const dimensions = Texas::calculateMipDimensions(srcInfo.baseDimensions, mipIndex);
+	std::uint64_t const pixelCount = dimensions.width * dimensions.height * dimensions.depth * srcInfo.layerCount;
+	std::uint64_t const srcPixelSize = conversion.src->rowFunctions.bytesPerPixel;
+	std::uint64_t const dstPixelSize = conversion.dst->rowFunctions.bytesPerPixel;
+	dstData.resize(pixelCount * dstPixelSize);
+
+	// Every layer of a level is stored back to back without padding, so the whole level is one long run of
+	// pixels. Splitting it evenly keeps every thread busy no matter how the level is shaped.
+	unsigned char const* src = reinterpret_cast<unsigned char const*>(srcData.data()) + Texas::calculateMipOffset(srcInfo, mipIndex);
+	unsigned char* dst = reinterpret_cast<unsigned char*>(dstData.data());
+	constexpr std::uint64_t pixelsPerRange = 16384;
+	std::uint64_t const rangeCount = (pixelCount + pixelsPerRange - 1) / pixelsPerRange;
+	parallelFor(rangeCount, [&](std::uint64_t rangeIndex)
+	{
+		if (progress != nullptr && progress->cancelled.load(std::memory_order_relaxed))
+			return;
+		std::uint64_t const first = rangeIndex * pixelsPerRange;
+		convertPixels(conversion, src + first * srcPixelSize, std::min(pixelsPerRange, pixelCount - first), dst + first * dstPixelSize);
+	}, maxThreads);
+
+	return progress == nullptr || !progress->cancelled.load(std::memory_order_relaxed);
+}
+
+Texas::Result TexasGUI::Convert::saveToStream(
+	Texas::TextureInfo const& srcInfo,
+	Texas::ConstByteSpan srcData,
+	Texas::PixelFormat pixelFormat,
+	Texas::ChannelType channelType,
+	Texas::OutputStream& stream,
+	KernelProgress* progress,
+	int maxThreads)
+{
+	if (!canConvert(srcInfo, pixelFormat, channelType))
+		return { Texas::ResultType::InvalidInputParameter, "Texture can't be converted to this format." };
+	if (srcData.size() < Texas::calculateTotalSize(srcInfo))
+		return { Texas::ResultType::InvalidInputParameter, "Texture data is smaller than the texture." };
+
+	KTX::StreamingWriter writer;
+	Texas::Result result = writer.begin(convertedTextureInfo(srcInfo, pixelFormat, channelType), stream);
+	if (progress != nullptr)
+		progress->totalUnits.store(srcInfo.mipCount);
+
+	std::vector<std::byte> mipData;
+	for (std::uint64_t mipIndex = 0; mipIndex < srcInfo.mipCount && result.isSuccessful(); mipIndex++)
+	{
+		if (!convertMipLevel(srcInfo, srcData, mipIndex, pixelFormat, channelType, mipData, progress, maxThreads))
+			return { Texas::ResultType::InvalidInputParameter, "Conversion was cancelled." };
+		result = writer.writeMipLevel(Texas::ConstByteSpan(mipData.data(), mipData.size()));
+		if (progress != nullptr)
+			progress->completedUnits.fetch_add(1, std::memory_order_relaxed);
+	}
+	if (result.isSuccessful())
+		result = writer.finish();
+	return result;
+}
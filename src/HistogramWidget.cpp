@@ -0,0 +1,60 @@
+#include "HistogramWidget.hpp"
+
+#include <QPainter>
+#include <QPainterPath>
+
+#include <algorithm>
+#include <cmath>
+
+TexasGUI::HistogramWidget::HistogramWidget(QWidget* parent) :
+	QWidget(parent)
+{
+	this->setMinimumHeight(80);
+	this->setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Fixed);
+}
+
+void TexasGUI::HistogramWidget::setStatistics(std::shared_ptr<SubresourceStatistics const> statistics)
+{
+	this->statistics = static_cast<std::shared_ptr<SubresourceStatistics const>&&>(statistics);
+	this->update();
+}
+
+void TexasGUI::HistogramWidget::paintEvent(QPaintEvent*)
+{
+	QPainter painter(this);
+	painter.fillRect(this->rect(), this->palette().base());
+	if (this->statistics == nullptr)
+		return;
+
+	SubresourceStatistics const& stats = *this->statistics;
+	constexpr int binCount = SubresourceStatistics::binCount;
+
+	// Every channel is scaled to its own tallest bin, otherwise a flat alpha channel flattens all the others.
+	// The square root keeps the small bins visible next to a large spike.
+	QColor const channelColors[4] = { QColor(220, 50, 50), QColor(50, 180, 50), QColor(60, 90, 230), QColor(128, 128, 128) };
+	double const width = this->width();
+	double const height = this->height();
+	painter.setRenderHint(QPainter::Antialiasing);
+	for (std::uint8_t channel = 0; channel < stats.channelCount; channel++)
+	{
+		std::uint32_t const* bins = stats.channelHistogram(channel);
+		std::uint32_t const tallest = *std::max_element(bins, bins + binCount);
+		if (tallest == 0)
+			continue;
+
+		QPainterPath path;
+		path.moveTo(0, height);
+		for (int bin = 0; bin < binCount; bin++)
+		{
+			double const barHeight = std::sqrt(double(bins[bin]) / tallest) * height;
+			path.lineTo(bin * width / binCount, height - barHeight);
+			path.lineTo((bin + 1) * width / binCount, height - barHeight);
+		}
+		path.lineTo(width, height);
+		path.closeSubpath();
+
+		QColor color = stats.channelCount == 1 ? channelColors[3] : channelColors[channel];
+		color.setAlpha(110);
+		painter.fillPath(path, color);
+	}
+}
@@ -0,0 +1,453 @@
+#include "TexasGUI/ImageCompare.hpp"
+
+#include "TexasGUI/BCnDecoder.hpp"
+#include "TexasGUI/ColorSpace.hpp"
+#include "TexasGUI/FormatConverter.hpp"
+#include "TexasGUI/FormatTraits.hpp"
+#include "TexasGUI/Parallel.hpp"
+#include "TexasGUI/SimdKernels.hpp"
+
+#include "Texas/Tools.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+namespace TexasGUI::Compare
+{
+	// Each strip holds about this many pixels of both textures as floats, 1 MiB each.
+	constexpr std::uint64_t pixelsPerStrip = 1 << 16;
+
+	// (0.01 * L)^2 and (0.03 * L)^2 with a peak L of 1.
+	constexpr double ssimC1 = 0.0001;
+	constexpr double ssimC2 = 0.0009;
+
+	template<std::size_t... indices>
+	constexpr std::array<std::uint8_t, sizeof...(indices)> makeChannelCountTable(std::index_sequence<indices...>)
+	{
+		return { { PixelFormatTraits<uncompressedPixelFormats[indices]>::channelCount... } };
+	}
+
+	constexpr std::size_t uncompressedFormatCount = sizeof(uncompressedPixelFormats) / sizeof(uncompressedPixelFormats[0]);
+	constexpr auto uncompressedChannelCounts = makeChannelCountTable(std::make_index_sequence<uncompressedFormatCount>());
+
+	// Channels that carry data once loaded as RGBA, the loaders fill in the rest.
+	[[nodiscard]] static std::uint8_t channelCount(Texas::PixelFormat pixelFormat) noexcept
+	{
+		switch (pixelFormat)
+		{
+		case Texas::PixelFormat::BC4:
+			return 1;
+		case Texas::PixelFormat::BC5:
+			return 2;
+		case Texas::PixelFormat::BC1_RGB:
+		case Texas::PixelFormat::BC6H:
+			return 3;
+		default:
+			break;
+		}
+		if (BCn::isBlockCompressed(pixelFormat))
+			return 4;
+		for (std::size_t i = 0; i < uncompressedFormatCount; i++)
+		{
+			if (uncompressedPixelFormats[i] == pixelFormat)
+				return uncompressedChannelCounts[i];
+		}
+		return 0;
+	}
+
+	[[nodiscard]] static bool isReadable(Texas::TextureInfo const& texInfo) noexcept
+	{
+		return BCn::isBlockCompressed(texInfo.pixelFormat) || Convert::findRowFunctions(texInfo.pixelFormat, texInfo.channelType) != nullptr;
+	}
+
+	// Loads regions of one of the textures as RGBA floats.
+	struct Reader
+	{
+		Texas::TextureInfo const* texInfo = nullptr;
+		unsigned char const* data = nullptr;
+		Convert::LoadRowFunc loadRow = nullptr;
+		std::uint8_t bytesPerPixel = 0;
+		bool decodeSRGB = false;
+
+		Reader(Input const& input, bool decodeSRGB) noexcept :
+			texInfo(&input.texInfo),
+			data(reinterpret_cast<unsigned char const*>(input.byteSpan.data())),
+			decodeSRGB(decodeSRGB)
+		{
+			if (Convert::RowFunctions const* rowFunctions = Convert::findRowFunctions(input.texInfo.pixelFormat, input.texInfo.channelType))
+			{
+				this->loadRow = rowFunctions->loadRow;
+				this->bytesPerPixel = rowFunctions->bytesPerPixel;
+			}
+		}
+
+		// Fills dst with region.height rows of region.width pixels out of depth slice region.z.
+		void load(std::uint64_t mipIndex, std::uint64_t layerIndex, KTX::Region const& region, float* dst) const noexcept
+		{
+			Texas::Dimensions const mipDims = Texas::calculateMipDimensions(this->texInfo->baseDimensions, mipIndex);
+			unsigned char const* layer = this->data + Texas::calculateLayerOffset(*this->texInfo, mipIndex, layerIndex);
+			if (this->loadRow != nullptr)
+			{
+				unsigned char const* slice = layer + region.z * mipDims.width * mipDims.height * this->bytesPerPixel;
+				for (std::uint64_t row = 0; row < region.height; row++)
+				{
+					this->loadRow(
+						slice + ((region.y + row) * mipDims.width + region.x) * this->bytesPerPixel,
+						region.width,
+						this->decodeSRGB,
+						dst + row * region.width * 4);
+				}
+				return;
+			}
+
+			std::uint64_t const blocksPerRow = (mipDims.width + 3) / 4;
+			std::uint64_t const blockRowsPerSlice = (mipDims.height + 3) / 4;
+			std::uint8_t const bytesPerBlock = BCn::blockSize(this->texInfo->pixelFormat);
+			unsigned char const* slice = layer + region.z * blockRowsPerSlice * blocksPerRow * bytesPerBlock;
+			float decoded[16 * 4];
+			for (std::uint64_t blockY = region.y / 4; blockY * 4 < region.y + region.height; blockY++)
+			{
+				std::uint64_t const firstY = std::max(blockY * 4, region.y);
+				std::uint64_t const lastY = std::min(blockY * 4 + 4, region.y + region.height);
+				for (std::uint64_t blockX = region.x / 4; blockX * 4 < region.x + region.width; blockX++)
+				{
+					BCn::decodeBlockToRGBA32F(*this->texInfo, slice + (blockY * blocksPerRow + blockX) * bytesPerBlock, decoded);
+
+					// Only the part of the block inside region.
+					std::uint64_t const firstX = std::max(blockX * 4, region.x);
+					std::uint64_t const lastX = std::min(blockX * 4 + 4, region.x + region.width);
+					for (std::uint64_t y = firstY; y < lastY; y++)
+					{
+						std::memcpy(
+							dst + ((y - region.y) * region.width + firstX - region.x) * 4,
+							decoded + ((y - blockY * 4) * 4 + firstX - blockX * 4) * 4,
+							(lastX - firstX) * 4 * sizeof(float));
+					}
+				}
+			}
+			if (this->decodeSRGB)
+				Simd::decodeSRGBRGBA32F(dst, region.width * region.height);
+		}
+	};
+
+	// Textures that only differ in encoding are compared in linear, otherwise as they are.
+	[[nodiscard]] static std::pair<bool, bool> decodeSRGB(Input const& a, Input const& b) noexcept
+	{
+		bool const isSRGBA = ColorSpace::isSRGBEncoded(a.texInfo);
+		bool const isSRGBB = ColorSpace::isSRGBEncoded(b.texInfo);
+		return { isSRGBA && !isSRGBB, isSRGBB && !isSRGBA };
+	}
+
+	[[nodiscard]] static double ssimFromSums(double sumA, double sumB, double sumSquares, double sumProducts, double count) noexcept
+	{
+		double const meanA = sumA / count;
+		double const meanB = sumB / count;
+		double const variances = sumSquares / count - meanA * meanA - meanB * meanB;
+		double const covariance = sumProducts / count - meanA * meanB;
+		return ((2.0 * meanA * meanB + ssimC1) * (2.0 * covariance + ssimC2)) /
+			((meanA * meanA + meanB * meanB + ssimC1) * (variances + ssimC2));
+	}
+
+	// A range of rows of one depth slice. Windows start in the strip's block rows and reach one block row past them.
+	struct Strip
+	{
+		std::uint64_t subresourceIndex = 0;
+		std::uint64_t slice = 0;
+		std::uint64_t firstBlockRow = 0;
+		std::uint64_t blockRowCount = 0;
+		// The whole of a slice that's too small for a window, measured as one.
+		bool isSingleWindow = false;
+	};
+
+	struct StripSums
+	{
+		double squaredError[4] = {};
+		double ssim[4] = {};
+		std::uint64_t windowCount = 0;
+	};
+
+	static void measureStrip(
+		Reader const& readerA,
+		Reader const& readerB,
+		SubresourceMetrics const& subresource,
+		Strip const& strip,
+		StripSums& sums)
+	{
+		Texas::Dimensions const mipDims = Texas::calculateMipDimensions(readerA.texInfo->baseDimensions, subresource.mipIndex);
+		std::uint64_t const width = mipDims.width;
+		std::uint64_t const firstRow = strip.firstBlockRow * 4;
+		std::uint64_t const endRow = std::min((strip.firstBlockRow + strip.blockRowCount) * 4, mipDims.height);
+
+		KTX::Region region{};
+		region.y = firstRow;
+		region.z = strip.slice;
+		region.width = width;
+		// One more block row for the windows that start in the last one.
+		region.height = std::min(endRow + 4, mipDims.height) - firstRow;
+		std::vector<float> pixelsA(region.width * region.height * 4);
+		std::vector<float> pixelsB(pixelsA.size());
+		readerA.load(subresource.mipIndex, subresource.layerIndex, region, pixelsA.data());
+		readerB.load(subresource.mipIndex, subresource.layerIndex, region, pixelsB.data());
+
+		Simd::sumSquaredErrorRGBA32F(pixelsA.data(), pixelsB.data(), (endRow - firstRow) * width, sums.squaredError);
+
+		if (strip.isSingleWindow)
+		{
+			double sumA[4] = {};
+			double sumB[4] = {};
+			double sumSquares[4] = {};
+			double sumProducts[4] = {};
+			for (std::uint64_t i = 0; i < pixelsA.size(); i++)
+			{
+				double const valueA = pixelsA[i];
+				double const valueB = pixelsB[i];
+				sumA[i & 3] += valueA;
+				sumB[i & 3] += valueB;
+				sumSquares[i & 3] += valueA * valueA + valueB * valueB;
+				sumProducts[i & 3] += valueA * valueB;
+			}
+			double const count = static_cast<double>(pixelsA.size() / 4);
+			for (int c = 0; c < 4; c++)
+				sums.ssim[c] += ssimFromSums(sumA[c], sumB[c], sumSquares[c], sumProducts[c], count);
+			sums.windowCount++;
+			return;
+		}
+
+		// Partial blocks along the right and bottom edges are left out of the windows.
+		std::uint64_t const blocksPerRow = width / 4;
+		std::uint64_t const windowRowEnd = std::min(strip.firstBlockRow + strip.blockRowCount, mipDims.height / 4 - 1);
+		if (windowRowEnd <= strip.firstBlockRow)
+			return;
+		std::uint64_t const blockRowCount = windowRowEnd - strip.firstBlockRow + 1;
+		std::vector<float> blockSums(blockRowCount * blocksPerRow * 16);
+		for (std::uint64_t blockRow = 0; blockRow < blockRowCount; blockRow++)
+		{
+			Simd::ssimBlockSumsRGBA32F(
+				pixelsA.data() + blockRow * 4 * width * 4,
+				pixelsB.data() + blockRow * 4 * width * 4,
+				width * 4,
+				blocksPerRow,
+				blockSums.data() + blockRow * blocksPerRow * 16);
+		}
+
+		for (std::uint64_t windowRow = 0; windowRow + 1 < blockRowCount; windowRow++)
+		{
+			float const* top = blockSums.data() + windowRow * blocksPerRow * 16;
+			float const* bottom = top + blocksPerRow * 16;
+			for (std::uint64_t windowX = 0; windowX + 1 < blocksPerRow; windowX++)
+			{
+				float const* blocks[4] = { top + windowX * 16, top + windowX * 16 + 16, bottom + windowX * 16, bottom + windowX * 16 + 16 };
+				for (int c = 0; c < 4; c++)
+				{
+					double windowSums[4] = {};
+					for (float const* block : blocks)
+					{
+						for (int k = 0; k < 4; k++)
+							windowSums[k] += block[k * 4 + c];
+					}
+					sums.ssim[c] += ssimFromSums(windowSums[0], windowSums[1], windowSums[2], windowSums[3], 64.0);
+				}
+				sums.windowCount++;
+			}
+		}
+	}
+
+	// Dark to hot, close to matplotlib's inferno.
+	[[nodiscard]] static std::array<std::array<unsigned char, 4>, 256> const& heatmapRamp() noexcept
+	{
+		static std::array<std::array<unsigned char, 4>, 256> const ramp = []()
+		{
+			constexpr float stops[5][3] = {
+				{ 0.f, 0.f, 4.f },
+				{ 87.f, 16.f, 110.f },
+				{ 188.f, 55.f, 84.f },
+				{ 249.f, 142.f, 9.f },
+				{ 252.f, 255.f, 164.f } };
+			std::array<std::array<unsigned char, 4>, 256> temp{};
+			for (int i = 0; i < 256; i++)
+			{
+				float const position = i / 255.f * 4.f;
+				int const stop = std::min(static_cast<int>(position), 3);
+				float const t = position - stop;
+				for (int c = 0; c < 3; c++)
+					temp[i][c] = static_cast<unsigned char>(stops[stop][c] + (stops[stop + 1][c] - stops[stop][c]) * t + 0.5f);
+				temp[i][3] = 255;
+			}
+			return temp;
+		}();
+		return ramp;
+	}
+}
+
+TexasGUI::Compare::SubresourceMetrics const* TexasGUI::Compare::Metrics::find(std::uint64_t mipIndex, std::uint64_t layerIndex) const noexcept
+{
+	for (SubresourceMetrics const& subresource : this->subresources)
+	{
+		if (subresource.mipIndex == mipIndex && subresource.layerIndex == layerIndex)
+			return &subresource;
+	}
+	return nullptr;
+}
+
+bool TexasGUI::Compare::canCompare(Texas::TextureInfo const& a, Texas::TextureInfo const& b) noexcept
+{
+	return
+		isReadable(a) &&
+		isReadable(b) &&
+		a.baseDimensions.width == b.baseDimensions.width &&
+		a.baseDimensions.height == b.baseDimensions.height &&
+		a.baseDimensions.depth == b.baseDimensions.depth &&
+		comparedMipCount(a, b) > 0 &&
+		comparedLayerCount(a, b) > 0 &&
+		std::min(channelCount(a.pixelFormat), channelCount(b.pixelFormat)) > 0;
+}
+
+std::uint64_t TexasGUI::Compare::comparedMipCount(Texas::TextureInfo const& a, Texas::TextureInfo const& b) noexcept
+{
+	return std::min(a.mipCount, b.mipCount);
+}
+
+std::uint64_t TexasGUI::Compare::comparedLayerCount(Texas::TextureInfo const& a, Texas::TextureInfo const& b) noexcept
+{
+	return std::min(a.layerCount, b.layerCount);
+}
+
+bool TexasGUI::Compare::compareTextures(
+	Input const& a,
+	Input const& b,
+	Metrics& metrics,
+	KernelProgress* progress,
+	int maxThreads)
+{
+	if (!canCompare(a.texInfo, b.texInfo))
+		return false;
+
+	std::pair<bool, bool> const decode = decodeSRGB(a, b);
+	Reader const readerA(a, decode.first);
+	Reader const readerB(b, decode.second);
+
+	std::uint64_t const mipCount = comparedMipCount(a.texInfo, b.texInfo);
+	std::uint64_t const layerCount = comparedLayerCount(a.texInfo, b.texInfo);
+	metrics = Metrics{};
+	metrics.channelCount = std::min(channelCount(a.texInfo.pixelFormat), channelCount(b.texInfo.pixelFormat));
+	metrics.subresources.resize(mipCount * layerCount);
+
+	// Every subresource is cut into strips up front, so small mips and layers share the pool with big ones.
+	std::vector<Strip> strips;
+	for (std::uint64_t mipIndex = 0; mipIndex < mipCount; mipIndex++)
+	{
+		Texas::Dimensions const mipDims = Texas::calculateMipDimensions(a.texInfo.baseDimensions, mipIndex);
+		bool const isSingleWindow = mipDims.width < 8 || mipDims.height < 8;
+		std::uint64_t const blockRowsPerSlice = (mipDims.height + 3) / 4;
+		std::uint64_t const blockRowsPerStrip = isSingleWindow ?
+			blockRowsPerSlice :
+			std::max<std::uint64_t>(pixelsPerStrip / (mipDims.width * 4), 1);
+		for (std::uint64_t layerIndex = 0; layerIndex < layerCount; layerIndex++)
+		{
+			std::uint64_t const subresourceIndex = mipIndex * layerCount + layerIndex;
+			metrics.subresources[subresourceIndex].mipIndex = mipIndex;
+			metrics.subresources[subresourceIndex].layerIndex = layerIndex;
+			for (std::uint64_t slice = 0; slice < mipDims.depth; slice++)
+			{
+				for (std::uint64_t blockRow = 0; blockRow < blockRowsPerSlice; blockRow += blockRowsPerStrip)
+				{
+					Strip strip;
+					strip.subresourceIndex = subresourceIndex;
+					strip.slice = slice;
+					strip.firstBlockRow = blockRow;
+					strip.blockRowCount = std::min(blockRowsPerStrip, blockRowsPerSlice - blockRow);
+					strip.isSingleWindow = isSingleWindow;
+					strips.push_back(strip);
+				}
+			}
+		}
+	}
+	if (progress != nullptr)
+		progress->totalUnits.fetch_add(strips.size(), std::memory_order_relaxed);
+
+	std::vector<StripSums> stripSums(strips.size());
+	parallelFor(strips.size(), [&](std::uint64_t stripIndex)
+	{
+		if (progress != nullptr && progress->cancelled.load(std::memory_order_relaxed))
+			return;
+		Strip const& strip = strips[stripIndex];
+		measureStrip(readerA, readerB, metrics.subresources[strip.subresourceIndex], strip, stripSums[stripIndex]);
+		if (progress != nullptr)
+			progress->completedUnits.fetch_add(1, std::memory_order_relaxed);
+	}, maxThreads);
+
+	if (progress != nullptr && progress->cancelled.load(std::memory_order_relaxed))
+		return false;
+
+	// Merged in strip order, so the results don't depend on scheduling.
+	std::vector<StripSums> subresourceSums(metrics.subresources.size());
+	for (std::size_t i = 0; i < strips.size(); i++)
+	{
+		StripSums& total = subresourceSums[strips[i].subresourceIndex];
+		for (int c = 0; c < 4; c++)
+		{
+			total.squaredError[c] += stripSums[i].squaredError[c];
+			total.ssim[c] += stripSums[i].ssim[c];
+		}
+		total.windowCount += stripSums[i].windowCount;
+	}
+	for (std::size_t i = 0; i < metrics.subresources.size(); i++)
+	{
+		SubresourceMetrics& subresource = metrics.subresources[i];
+		Texas::Dimensions const mipDims = Texas::calculateMipDimensions(a.texInfo.baseDimensions, subresource.mipIndex);
+		double const pixelCount = static_cast<double>(mipDims.width * mipDims.height * mipDims.depth);
+		for (std::uint8_t c = 0; c < metrics.channelCount; c++)
+		{
+			ChannelMetrics& channel = subresource.channels[c];
+			channel.mse = subresourceSums[i].squaredError[c] / pixelCount;
+			channel.psnr = channel.mse > 0.0 ? 10.0 * std::log10(1.0 / channel.mse) : std::numeric_limits<double>::infinity();
+			channel.ssim = subresourceSums[i].ssim[c] / static_cast<double>(subresourceSums[i].windowCount);
+		}
+	}
+	return true;
+}
+
+bool TexasGUI::Compare::buildDiffHeatmap(
+	Input const& a,
+	Input const& b,
+	std::uint64_t mipIndex,
+	std::uint64_t layerIndex,
+	KTX::Region const& region,
+	float maxError,
+	QByteArray& rgba)
+{
+	if (!canCompare(a.texInfo, b.texInfo))
+		return false;
+
+	std::pair<bool, bool> const decode = decodeSRGB(a, b);
+	KTX::Region sliceRegion = region;
+	sliceRegion.z = 0;
+	std::uint64_t const pixelCount = region.width * region.height;
+	std::vector<float> pixelsA(pixelCount * 4);
+	std::vector<float> pixelsB(pixelCount * 4);
+	Reader(a, decode.first).load(mipIndex, layerIndex, sliceRegion, pixelsA.data());
+	Reader(b, decode.second).load(mipIndex, layerIndex, sliceRegion, pixelsB.data());
+
+	std::uint8_t const compared = std::min(channelCount(a.texInfo.pixelFormat), channelCount(b.texInfo.pixelFormat));
+	std::array<std::array<unsigned char, 4>, 256> const& ramp = heatmapRamp();
+	float const scale = maxError > 0.f ? 255.f / maxError : 0.f;
+	rgba = QByteArray(static_cast<int>(pixelCount * 4), Qt::Initialization::Uninitialized);
+	for (std::uint64_t pixelIndex = 0; pixelIndex < pixelCount; pixelIndex++)
+	{
+		float sum = 0.f;
+		for (std::uint8_t c = 0; c < compared; c++)
+		{
+			float const difference = pixelsA[pixelIndex * 4 + c] - pixelsB[pixelIndex * 4 + c];
+			sum += difference * difference;
+		}
+		// NaN and infinity end up hot as well.
+		float const position = std::sqrt(sum / compared) * scale;
+		int const index = position < 255.f ? static_cast<int>(position + 0.5f) : 255;
+		std::memcpy(rgba.data() + pixelIndex * 4, ramp[index].data(), 4);
+	}
+	return true;
+}
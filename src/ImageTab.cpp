@@ -1,18 +1,22 @@
 #include "ImageTab.hpp"
 
+#include "ExportDialog.hpp"
+#include "HistogramWidget.hpp"
+#include "TextureViewport.hpp"
+#include "TexasGUI/LatencyRecorder.hpp"
 #include "TexasGUI/Utilities.hpp"
 
 #include <QBoxLayout>
 #include <QGroupBox>
-#include <QScrollArea>
 #include <QLabel>
 #include <QSpinBox>
+#include <QDoubleSpinBox>
 #include <QCheckBox>
 #include <QtMath>
 #include <QSlider>
 #include <QComboBox>
 #include <QPushButton>
-#include <QFileDialog>
+#include <QSignalBlocker>
 
 #include <tuple>
 #include <cstring>
@@ -20,305 +24,75 @@
 #include "Texas/Tools.hpp"
 #include "Texas/Texas.hpp"
 
-namespace TexasGUI
+TexasGUI::ImageTab::ImageTab(
+	QString const& fullPath,
+	Texas::Texture&& texture,
+	MinMaxData&& minMaxData,
+	QByteArray const& baseDisplayData) :
+	QWidget(),
+	minMaxData(static_cast<MinMaxData&&>(minMaxData)),
+	sourceTexture(std::make_shared<Texas::Texture>(static_cast<Texas::Texture&&>(texture)))
 {
-	struct TexasFileStream : Texas::OutputStream
-	{
-		QFile file;
-		QDataStream stream;
-
-		virtual Texas::Result write(char const* data, std::uint64_t size) noexcept override
-		{
-			stream.writeRawData(data, static_cast<int>(size));
-
-			return { Texas::ResultType::Success, nullptr };
-		}
-	};
-
-	enum class FloatVisualizationMode
-	{
-		Remap,
-		Clamp,
-		COUNT
-	};
-
-	[[nodiscard]] QString toString(FloatVisualizationMode mode)
-	{
-		switch (mode)
-		{
-		case FloatVisualizationMode::Remap:
-			return "Remap";
-		case FloatVisualizationMode::Clamp:
-			return "Clamp";
-		default:
-			return "Error";
-		}
-	}
-
-	template<Texas::PixelFormat pixelFormat, Texas::ChannelType channelType>
-	void FindMinMaxValues_Internal(
-		Texas::TextureInfo texInfo,
-		Texas::ConstByteSpan byteSpan,
-		MinMaxData& minMaxData) = delete;
-
-	template<Texas::PixelFormat pixelFormat, Texas::ChannelType channelType>
-	void BuildDisplayableTexture_Internal(
-		Texas::TextureInfo texInfo,
-		Texas::ConstByteSpan byteSpan,
-		QByteArray& byteArray) = delete;
-
-	template<>
-	void FindMinMaxValues_Internal<Texas::PixelFormat::RGB_8, Texas::ChannelType::UnsignedNormalized>(
-		Texas::TextureInfo texInfo,
-		Texas::ConstByteSpan byteSpan,
-		MinMaxData& minMaxData)
-	{
-		minMaxData.mipLevels.resize(texInfo.mipCount);
-		for (auto& mipLevel : minMaxData.mipLevels)
-			mipLevel.layers.resize(texInfo.layerCount);
-		for (uint8_t mipIndex = 0; mipIndex < texInfo.mipCount; mipIndex++)
-		{
-			auto& mipLevel = minMaxData.mipLevels[mipIndex];
-
-			Texas::Dimensions mipDimensions = Texas::calculateMipDimensions(texInfo.baseDimensions, mipIndex);
-			uint64_t pixelCount = mipDimensions.width * mipDimensions.height * mipDimensions.depth;
-			uint64_t mipMemoryOffset = Texas::calculateMipOffset(texInfo, mipIndex);
-
-			for (uint8_t layerIndex = 0; layerIndex < texInfo.layerCount; layerIndex++)
-			{
-				auto& layer = mipLevel.layers[layerIndex];
-				uint64_t layerMemoryOffset = Texas::calculateLayerOffset(texInfo, mipIndex, layerIndex);
-
-				for (uint8_t i = 0; i < 3; i++)
-				{
-					layer.min_uint64[i] = std::numeric_limits<uint64_t>::max();
-					layer.max_uint64[i] = std::numeric_limits<uint64_t>::min();
-				}
-				layer.min_uint64[3] = 0;
-				layer.max_uint64[3] = 0;
-
-				for (uint64_t pixelIndex = 0; pixelIndex < pixelCount; pixelIndex++)
-				{
-					unsigned char const* srcPixel = (unsigned char const*)byteSpan.data() + mipMemoryOffset + layerMemoryOffset + pixelIndex * 3;
-					for (size_t i = 0; i < 3; i++)
-					{
-						layer.min_uint64[i] = std::min(layer.min_uint64[i], (uint64_t)srcPixel[i]);
-						layer.max_uint64[i] = std::max(layer.min_uint64[i], (uint64_t)srcPixel[i]);
-					}
-				}
-			}
-		}
-	}
-
-	template<>
-	void BuildDisplayableTexture_Internal<Texas::PixelFormat::RGB_8, Texas::ChannelType::UnsignedNormalized>(
-		Texas::TextureInfo texInfo,
-		Texas::ConstByteSpan byteSpan, 
-		QByteArray& byteArray)
-	{
-		Texas::TextureInfo dstTexInfo = texInfo;
-		dstTexInfo.pixelFormat = Texas::PixelFormat::RGBA_8;
-		dstTexInfo.channelType = Texas::ChannelType::UnsignedNormalized;
-		byteArray = QByteArray(Texas::calculateTotalSize(dstTexInfo), Qt::Initialization::Uninitialized);
-		
-		size_t linearLength = texInfo.baseDimensions.width * texInfo.baseDimensions.height;
-		// Copy the three first channels
-		for (size_t pixelIndex = 0; pixelIndex < linearLength; pixelIndex++)
-		{
-			unsigned char const* srcPixel = (unsigned char const*)byteSpan.data() + pixelIndex * 3;
-			unsigned char* dstPixel = (unsigned char*)byteArray.data() + pixelIndex * 4;
-			
-			dstPixel[0] = srcPixel[0];
-			dstPixel[1] = srcPixel[1];
-			dstPixel[2] = srcPixel[2];
-			dstPixel[3] = 255;
-		}
-	}
-
-	template<>
-	void FindMinMaxValues_Internal<Texas::PixelFormat::RGBA_8, Texas::ChannelType::UnsignedNormalized>(
-		Texas::TextureInfo texInfo,
-		Texas::ConstByteSpan byteSpan,
-		MinMaxData& minMaxData)
-	{
-		minMaxData.mipLevels.resize(texInfo.mipCount);
-		for (auto& mipLevel : minMaxData.mipLevels)
-			mipLevel.layers.resize(texInfo.layerCount);
-		for (uint8_t mipIndex = 0; mipIndex < texInfo.mipCount; mipIndex++)
-		{
-			auto& mipLevel = minMaxData.mipLevels[mipIndex];
-
-			Texas::Dimensions mipDimensions = Texas::calculateMipDimensions(texInfo.baseDimensions, mipIndex);
-			uint64_t pixelCount = mipDimensions.width * mipDimensions.height * mipDimensions.depth;
-
-			for (uint8_t layerIndex = 0; layerIndex < texInfo.layerCount; layerIndex++)
-			{
-				auto& layer = mipLevel.layers[layerIndex];
-				uint64_t layerMemoryOffset = Texas::calculateLayerOffset(texInfo, mipIndex, layerIndex);
-
-				for (uint8_t i = 0; i < 4; i++)
-				{
-					layer.min_uint64[i] = std::numeric_limits<uint64_t>::max();
-					layer.max_uint64[i] = std::numeric_limits<uint64_t>::min();
-				}
-
-				for (uint64_t pixelIndex = 0; pixelIndex < pixelCount; pixelIndex++)
-				{
-					unsigned char const* srcPixel = (unsigned char const*)byteSpan.data() + layerMemoryOffset + pixelIndex * 4;
-					for (size_t i = 0; i < 4; i++)
-					{
-						layer.min_uint64[i] = std::min(layer.min_uint64[i], (uint64_t)srcPixel[i]);
-						layer.max_uint64[i] = std::max(layer.max_uint64[i], (uint64_t)srcPixel[i]);
-					}
-				}
-			}
-		}
-	}
-
-	template<>
-	void BuildDisplayableTexture_Internal<Texas::PixelFormat::RGBA_8, Texas::ChannelType::UnsignedNormalized>(
-		Texas::TextureInfo texInfo,
-		Texas::ConstByteSpan byteSpan,
-		QByteArray& byteArray)
-	{
-		Texas::TextureInfo dstTexInfo = texInfo;
-		dstTexInfo.pixelFormat = Texas::PixelFormat::RGBA_8;
-		dstTexInfo.channelType = Texas::ChannelType::UnsignedNormalized;
-		byteArray = QByteArray(Texas::calculateTotalSize(dstTexInfo), Qt::Initialization::Uninitialized);
-
-		for (uint8_t mipIndex = 0; mipIndex < texInfo.mipCount; mipIndex++)
-		{
-			Texas::Dimensions mipDimensions = Texas::calculateMipDimensions(texInfo.baseDimensions, mipIndex);
-			uint64_t pixelCount = mipDimensions.width * mipDimensions.height * mipDimensions.depth;
-
-			for (uint8_t layerIndex = 0; layerIndex < texInfo.layerCount; layerIndex++)
-			{
-				uint64_t srcLayerMemoryOffset = Texas::calculateLayerOffset(texInfo, mipIndex, layerIndex);
-				uint64_t dstLayerMemoryOffset = Texas::calculateLayerOffset(dstTexInfo, mipIndex, layerIndex);
-				for (size_t pixelIndex = 0; pixelIndex < pixelCount; pixelIndex++)
-				{
-					unsigned char const* srcPixel = (unsigned char const*)byteSpan.data() + srcLayerMemoryOffset + pixelIndex * 4;
-					unsigned char* dstPixel = (unsigned char*)byteArray.data() + dstLayerMemoryOffset + pixelIndex * 4;
-
-					dstPixel[0] = srcPixel[0];
-					dstPixel[1] = srcPixel[1];
-					dstPixel[2] = srcPixel[2];
-					dstPixel[3] = srcPixel[3];
-				}
-			}
-		}
-	}
-
-	void FindMinMaxValues(
-		Texas::TextureInfo texInfo,
-		Texas::ConstByteSpan byteSpan,
-		MinMaxData& minMaxData)
-	{
-		switch (texInfo.pixelFormat)
-		{
-		case Texas::PixelFormat::RGB_8:
-		{
-			switch (texInfo.channelType)
-			{
-			case Texas::ChannelType::UnsignedNormalized:
-				FindMinMaxValues_Internal<Texas::PixelFormat::RGB_8, Texas::ChannelType::UnsignedNormalized>(
-					texInfo,
-					byteSpan,
-					minMaxData);
-			}
-			break;
-		}
-		case Texas::PixelFormat::RGBA_8:
-		{
-			switch (texInfo.channelType)
-			{
-			case Texas::ChannelType::UnsignedNormalized:
-				FindMinMaxValues_Internal<Texas::PixelFormat::RGBA_8, Texas::ChannelType::UnsignedNormalized>(
-					texInfo,
-					byteSpan,
-					minMaxData);
-			}
-			break;
-		}
-		break;
-		}
-	}
-
-	void BuildDisplayableTexture(
-		Texas::TextureInfo texInfo,
-		Texas::ConstByteSpan byteSpan,
-		QByteArray& byteArray)
-	{
-		switch (texInfo.pixelFormat)
-		{
-		case Texas::PixelFormat::RGB_8:
-		{
-			switch (texInfo.channelType)
-			{
-			case Texas::ChannelType::UnsignedNormalized:
-				BuildDisplayableTexture_Internal<Texas::PixelFormat::RGB_8, Texas::ChannelType::UnsignedNormalized>(
-					texInfo,
-					byteSpan,
-					byteArray);
-			}
-			break;
-		}
-		case Texas::PixelFormat::RGBA_8:
-		{
-			switch (texInfo.channelType)
-			{
-			case Texas::ChannelType::UnsignedNormalized:
-				BuildDisplayableTexture_Internal<Texas::PixelFormat::RGBA_8, Texas::ChannelType::UnsignedNormalized>(
-					texInfo,
-					byteSpan,
-					byteArray);
-			}
-			break;
-		}
-		break;
-		}
-	}
+	Latency::ScopedStage stage(Latency::Stage::ImageTab);
+	this->texInfo = this->sourceTexture->textureInfo();
+
+	// Subresources are converted to something displayable the first time they are viewed.
+	// The loader has already done the one we show first.
+	this->displayCache = std::make_unique<DisplayCache>(
+		this->texInfo,
+		this->sourceTexture->rawBufferSpan());
+	if (!baseDisplayData.isEmpty())
+		this->displayCache->insert(0, 0, baseDisplayData);
+	// Statistics are only computed for the subresources that are looked at.
+	this->statisticsCache = std::make_unique<StatisticsCache>(
+		this->texInfo,
+		this->sourceTexture->rawBufferSpan());
+	this->tileSource = std::make_unique<DisplayCacheTileSource>(
+		this->texInfo,
+		this->sourceTexture->rawBufferSpan(),
+		*this->displayCache);
+
+	createLayout(fullPath, true);
 }
 
 TexasGUI::ImageTab::ImageTab(
 	QString const& fullPath,
-	Texas::Texture&& texture) :
+	std::shared_ptr<KTX::TiledReader> tiledReader) :
 	QWidget(),
-	sourceTexture(static_cast<Texas::Texture&&>(texture))
+	tiledReader(static_cast<std::shared_ptr<KTX::TiledReader>&&>(tiledReader))
 {
-	QHBoxLayout* outerLayout = new QHBoxLayout;
-	this->setLayout(outerLayout);
+	Latency::ScopedStage stage(Latency::Stage::ImageTab);
+	this->texInfo = this->tiledReader->textureInfo();
+	this->tileSource = std::make_unique<KTXTileSource>(*this->tiledReader);
 
-	FindMinMaxValues(
-		this->sourceTexture.textureInfo(),
-		this->sourceTexture.rawBufferSpan(),
-		this->minMaxData);
-	BuildDisplayableTexture(
-		this->sourceTexture.textureInfo(),
-		this->sourceTexture.rawBufferSpan(),
-		this->customImgData);
+	createLayout(fullPath, true);
+}
 
-	this->createLeftPanel(outerLayout, fullPath, true);
+TexasGUI::ImageTab::~ImageTab()
+{
+	// The viewport is destroyed with the other children, after our members. Its scheduler must stop
+	// reading from the tile source before that goes away.
+	this->viewport->setSource(nullptr);
+}
+
+void TexasGUI::ImageTab::createLayout(QString const& fullPath, bool enableControls)
+{
+	QHBoxLayout* outerLayout = new QHBoxLayout;
+	this->setLayout(outerLayout);
 
-	QScrollArea* imageScrollArea = new QScrollArea;
-	outerLayout->addWidget(imageScrollArea);
+	this->createLeftPanel(outerLayout, fullPath, enableControls);
 
-	this->imgLabel = new QLabel;
-	imageScrollArea->setWidget(this->imgLabel);
+	this->viewport = new TextureViewport;
+	outerLayout->addWidget(this->viewport);
+	this->viewport->setSource(this->tileSource.get());
+	QObject::connect(this->viewport, SIGNAL(displayedMipChanged(int)), this, SLOT(viewportMipChanged(int)));
 
-	if (true)
-	{
-		updateImage(0, 0, false);
-	}
-	else
-	{
-		this->imgLabel->setText("Unable to display this texture.");
-		this->imgLabel->adjustSize();
-	}
+	updateImage(0, 0, false);
 }
 
 void TexasGUI::ImageTab::createLeftPanel(QLayout* parentLayout, QString const& fullPath, bool enableControls)
 {
+	Latency::ScopedStage stage(Latency::Stage::LeftPanel);
 	QWidget* controlsWidget = new QWidget;
 	parentLayout->addWidget(controlsWidget);
 	controlsWidget->setMinimumWidth(250);
@@ -330,16 +104,17 @@ void TexasGUI::ImageTab::createLeftPanel(QLayout* parentLayout, QString const& f
 
 	if (enableControls)
 	{
-		if (this->sourceTexture.channelType() == Texas::ChannelType::SignedFloat)
+		if (isFloatFormat(this->texInfo))
 			createFloatVisualizationControls(outerVLayout);
 
-		if (this->sourceTexture.mipCount() > 1)
+		if (this->texInfo.mipCount > 1)
 			createMipControls(outerVLayout);
 
-		if (this->sourceTexture.layerCount() > 1)
+		if (this->texInfo.layerCount > 1)
 			createArrayControls(outerVLayout);
 
 		createMinMaxBox(outerVLayout);
+		createStatisticsBox(outerVLayout);
 	}
 
 	
@@ -347,22 +122,18 @@ void TexasGUI::ImageTab::createLeftPanel(QLayout* parentLayout, QString const& f
 	createDetailsBox(outerVLayout);
 
 
+	// The dialog checks whether the chosen target format can be saved, compressing or converting makes most textures saveable.
 	QPushButton* button = new QPushButton;
 	outerVLayout->addWidget(button);
-	button->setText("Export to KTX");
-	button->setEnabled(false);
-
-	Texas::Result canSaveTextureAsKTX = Texas::KTX::canSave(this->sourceTexture.textureInfo());
-	if (Texas::KTX::canSave(this->sourceTexture.textureInfo()).isSuccessful())
+	button->setText("Export as...");
+	QObject::connect(button, SIGNAL(clicked()), this, SLOT(exportAsKTX()));
+	// Streamed textures are never in memory as a whole, so there's nothing to hand to the encoder.
+	if (this->tiledReader != nullptr)
 	{
-		button->setEnabled(true);
-		// Connect button
-		QObject::connect(button, SIGNAL(clicked()), this, SLOT(exportAsKTX()));
+		button->setEnabled(false);
+		button->setToolTip("This texture is too large to load, it is streamed from disk.");
 	}
 
-
-
-
 	QSpacerItem* endOfControlsSpacer = new QSpacerItem(20, 40, QSizePolicy::Minimum, QSizePolicy::Expanding);
 	outerVLayout->addSpacerItem(endOfControlsSpacer);
 }
@@ -385,6 +156,24 @@ void TexasGUI::ImageTab::createFloatVisualizationControls(QLayout* parentLayout)
 
 	QObject::connect(modeDropdown, SIGNAL(currentIndexChanged(int)), this, SLOT(floatVisualizationModeChanged(int)));
 
+	// Exposure line
+	{
+		QHBoxLayout* hLayout = new QHBoxLayout;
+		innerVLayout->addLayout(hLayout);
+
+		QLabel* exposureLabel = new QLabel;
+		hLayout->addWidget(exposureLabel);
+		exposureLabel->setText("Exposure (stops)");
+
+		this->exposureSpinBox = new QDoubleSpinBox;
+		hLayout->addWidget(this->exposureSpinBox);
+		this->exposureSpinBox->setRange(-10.0, 10.0);
+		this->exposureSpinBox->setSingleStep(0.5);
+		this->exposureSpinBox->setDecimals(1);
+		this->exposureSpinBox->setValue(this->floatVisualization.exposure);
+		this->exposureSpinBox->setEnabled(this->floatVisualization.usesExposure());
+		QObject::connect(this->exposureSpinBox, SIGNAL(valueChanged(double)), this, SLOT(exposureChanged(double)));
+	}
 }
 
 void TexasGUI::ImageTab::createMipControls(QLayout* parentLayout)
@@ -411,24 +200,24 @@ void TexasGUI::ImageTab::createMipControls(QLayout* parentLayout)
 		this->mipSelectorSpinBox = new QSpinBox;
 		levelSelectorLayout->addWidget(this->mipSelectorSpinBox);
 		this->mipSelectorSpinBox->setAlignment(Qt::AlignRight | Qt::AlignVCenter);
-		this->mipSelectorSpinBox->setMaximum(this->sourceTexture.mipCount() - 1);
+		this->mipSelectorSpinBox->setMaximum(this->texInfo.mipCount - 1);
 		QObject::connect(this->mipSelectorSpinBox, SIGNAL(valueChanged(int)), this, SLOT(mipLevelSpinBoxChanged(int)));
 
 		QLabel* maxMipTextLabel = new QLabel;
 		levelSelectorLayout->addWidget(maxMipTextLabel);
-		maxMipTextLabel->setText(QString("/ ") + QString::number(this->sourceTexture.mipCount() - 1));
+		maxMipTextLabel->setText(QString("/ ") + QString::number(this->texInfo.mipCount - 1));
 	}
 
 	// Make the mip slider
 	this->mipSelectorSlider = new QSlider;
 	innerVLayout->addWidget(this->mipSelectorSlider);
-	this->mipSelectorSlider->setMaximum(this->sourceTexture.mipCount() - 1);
+	this->mipSelectorSlider->setMaximum(this->texInfo.mipCount - 1);
 	this->mipSelectorSlider->setPageStep(1);
 	this->mipSelectorSlider->setOrientation(Qt::Horizontal);
 	this->mipSelectorSlider->setTickPosition(QSlider::TicksBelow);
 	QObject::connect(this->mipSelectorSlider, SIGNAL(valueChanged(int)), this, SLOT(mipLevelSliderChanged(int)));
 
-	Texas::Dimensions mipDims = Texas::calculateMipDimensions(this->sourceTexture.baseDimensions(), 0);
+	Texas::Dimensions mipDims = Texas::calculateMipDimensions(this->texInfo.baseDimensions, 0);
 
 	this->mipWidthLabel = new QLabel;
 	innerVLayout->addWidget(this->mipWidthLabel);
@@ -459,6 +248,24 @@ void TexasGUI::ImageTab::createMipControls(QLayout* parentLayout)
 		this->scaleMipToBaseCheckBox->setLayoutDirection(Qt::LeftToRight);
 		QObject::connect(this->scaleMipToBaseCheckBox, SIGNAL(stateChanged(int)), this, SLOT(scaleToMipChanged(int)));
 	}
+
+	// Make the "Pick by zoom" line
+	{
+		QWidget* automaticMipContainer = new QWidget;
+		innerVLayout->addWidget(automaticMipContainer);
+		QHBoxLayout* automaticMipLayout = new QHBoxLayout;
+		automaticMipContainer->setLayout(automaticMipLayout);
+		automaticMipLayout->setMargin(0);
+
+		QLabel* automaticMipLabel = new QLabel;
+		automaticMipLayout->addWidget(automaticMipLabel);
+		automaticMipLabel->setText("Pick by zoom: ");
+
+		this->automaticMipCheckBox = new QCheckBox;
+		automaticMipLayout->addWidget(this->automaticMipCheckBox);
+		this->automaticMipCheckBox->setLayoutDirection(Qt::LeftToRight);
+		QObject::connect(this->automaticMipCheckBox, SIGNAL(stateChanged(int)), this, SLOT(automaticMipChanged(int)));
+	}
 }
 
 void TexasGUI::ImageTab::createArrayControls(QLayout* parentLayout)
@@ -484,17 +291,17 @@ void TexasGUI::ImageTab::createArrayControls(QLayout* parentLayout)
 		this->arraySelectorSpinBox = new QSpinBox;
 		levelSelectorLayout->addWidget(this->arraySelectorSpinBox);
 		this->arraySelectorSpinBox->setAlignment(Qt::AlignRight | Qt::AlignVCenter);
-		this->arraySelectorSpinBox->setMaximum(this->sourceTexture.layerCount() - 1);
+		this->arraySelectorSpinBox->setMaximum(this->texInfo.layerCount - 1);
 		QObject::connect(this->arraySelectorSpinBox, SIGNAL(valueChanged(int)), this, SLOT(arrayLayerSpinBoxChanged(int)));
 
 		QLabel* maxMipTextLabel = new QLabel;
 		levelSelectorLayout->addWidget(maxMipTextLabel);
-		maxMipTextLabel->setText(QString("/ ") + QString::number(this->sourceTexture.layerCount() - 1));
+		maxMipTextLabel->setText(QString("/ ") + QString::number(this->texInfo.layerCount - 1));
 	}
 
 	this->arraySelectorSlider = new QSlider;
 	innerVLayout->addWidget(this->arraySelectorSlider);
-	this->arraySelectorSlider->setMaximum(this->sourceTexture.layerCount() - 1);
+	this->arraySelectorSlider->setMaximum(this->texInfo.layerCount - 1);
 	this->arraySelectorSlider->setPageStep(1);
 	this->arraySelectorSlider->setOrientation(Qt::Horizontal);
 	this->arraySelectorSlider->setTickPosition(QSlider::TicksBelow);
@@ -503,18 +310,22 @@ void TexasGUI::ImageTab::createArrayControls(QLayout* parentLayout)
 
 void TexasGUI::ImageTab::createMinMaxBox(QLayout* parentLayout)
 {
+	// No statistics are gathered for block compressed formats.
+	if (this->minMaxData.isEmpty())
+		return;
+
 	QGroupBox* box = new QGroupBox;
 	parentLayout->addWidget(box);
 	box->setTitle("Min/Max");
 
 	QVBoxLayout* innerLayout = new QVBoxLayout;
 	box->setLayout(innerLayout);
-	for (uint8_t i = 0; i < 4; i++)
+	for (uint8_t i = 0; i < this->minMaxData.channelCount; i++)
 	{
 		this->minMaxLabels.min[i] = new QLabel;
 		innerLayout->addWidget(this->minMaxLabels.min[i]);
 	}
-	for (uint8_t i = 0; i < 4; i++)
+	for (uint8_t i = 0; i < this->minMaxData.channelCount; i++)
 	{
 		this->minMaxLabels.max[i] = new QLabel;
 		innerLayout->addWidget(this->minMaxLabels.max[i]);
@@ -522,6 +333,31 @@ void TexasGUI::ImageTab::createMinMaxBox(QLayout* parentLayout)
 	updateMinMaxLabels(0, 0);
 }
 
+void TexasGUI::ImageTab::createStatisticsBox(QLayout* parentLayout)
+{
+	if (this->statisticsCache == nullptr)
+		return;
+
+	QGroupBox* box = new QGroupBox;
+	parentLayout->addWidget(box);
+	box->setTitle("Statistics");
+
+	QVBoxLayout* innerLayout = new QVBoxLayout;
+	box->setLayout(innerLayout);
+
+	this->histogramWidget = new HistogramWidget;
+	innerLayout->addWidget(this->histogramWidget);
+	for (uint8_t i = 0; i < 4; i++)
+	{
+		this->statisticsLabels[i] = new QLabel;
+		innerLayout->addWidget(this->statisticsLabels[i]);
+	}
+
+	this->statisticsWatcher = new QFutureWatcher<void>(this);
+	QObject::connect(this->statisticsWatcher, SIGNAL(finished()), this, SLOT(statisticsFinished()));
+	updateStatistics(0, 0);
+}
+
 void TexasGUI::ImageTab::createDetailsBox(QLayout* parentLayout)
 {
 	QGroupBox* detailsBox = new QGroupBox;
@@ -533,71 +369,77 @@ void TexasGUI::ImageTab::createDetailsBox(QLayout* parentLayout)
 
 	QLabel* textureTypeLabel = new QLabel;
 	vLayout->addWidget(textureTypeLabel);
-	textureTypeLabel->setText("Type: " + TexasGUI::Utils::toString(this->sourceTexture.textureType()));
+	textureTypeLabel->setText("Type: " + TexasGUI::Utils::toString(this->texInfo.textureType));
 
 	QLabel* formatLabel = new QLabel;
 	vLayout->addWidget(formatLabel);
-	formatLabel->setText("Format: " + TexasGUI::Utils::toString(this->sourceTexture.pixelFormat()));
+	formatLabel->setText("Format: " + TexasGUI::Utils::toString(this->texInfo.pixelFormat));
 
 	QLabel* channelTypeLabel = new QLabel;
 	vLayout->addWidget(channelTypeLabel);
-	channelTypeLabel->setText("Channel type: " + TexasGUI::Utils::toString(this->sourceTexture.channelType()));
+	channelTypeLabel->setText("Channel type: " + TexasGUI::Utils::toString(this->texInfo.channelType));
 
 	QLabel* colorSpaceLabel = new QLabel;
 	vLayout->addWidget(colorSpaceLabel);
-	colorSpaceLabel->setText("Color space: " + TexasGUI::Utils::toString(this->sourceTexture.colorSpace()));
+	colorSpaceLabel->setText("Color space: " + TexasGUI::Utils::toString(this->texInfo.colorSpace));
 
 	QLabel* widthLabel = new QLabel;
 	vLayout->addWidget(widthLabel);
-	widthLabel->setText("Width: " + QString::number(this->sourceTexture.baseDimensions().width));
+	widthLabel->setText("Width: " + QString::number(this->texInfo.baseDimensions.width));
 
 	QLabel* heightLabel = new QLabel;
 	vLayout->addWidget(heightLabel);
-	heightLabel->setText("Height: " + QString::number(this->sourceTexture.baseDimensions().height));
+	heightLabel->setText("Height: " + QString::number(this->texInfo.baseDimensions.height));
 
 	QLabel* depthLabel = new QLabel;
 	vLayout->addWidget(depthLabel);
-	depthLabel->setText("Depth: " + QString::number(this->sourceTexture.baseDimensions().depth));
+	depthLabel->setText("Depth: " + QString::number(this->texInfo.baseDimensions.depth));
 
 	QLabel* mipCountLabel = new QLabel;
 	vLayout->addWidget(mipCountLabel);
-	mipCountLabel->setText("Mip levels: " + QString::number(this->sourceTexture.mipCount()));
+	mipCountLabel->setText("Mip levels: " + QString::number(this->texInfo.mipCount));
 
 	QLabel* arrayLayerLabel = new QLabel;
 	vLayout->addWidget(arrayLayerLabel);
-	arrayLayerLabel->setText("Array layers: " + QString::number(this->sourceTexture.layerCount()));
+	arrayLayerLabel->setText("Array layers: " + QString::number(this->texInfo.layerCount));
 
 	QLabel* srcFileFormatLabel = new QLabel;
 	vLayout->addWidget(srcFileFormatLabel);
-	srcFileFormatLabel->setText("File-format: " + TexasGUI::Utils::toString(this->sourceTexture.fileFormat()));
+	srcFileFormatLabel->setText("File-format: " + TexasGUI::Utils::toString(this->texInfo.fileFormat));
+
+	if (this->tiledReader != nullptr)
+	{
+		QLabel* streamedLabel = new QLabel;
+		vLayout->addWidget(streamedLabel);
+		streamedLabel->setText("Streamed from disk");
+	}
 }
 
 void TexasGUI::ImageTab::floatVisualizationModeChanged(int i)
 {
-	FloatVisualizationMode newMode = static_cast<FloatVisualizationMode>(i);
-
-	unsigned int mipLevel = getCurrentMipLevel();
-	bool scaleMipToBase = getScaleMipToBase();
-	unsigned int arrayIndex = getCurrentArrayLayer();
+	this->floatVisualization.mode = static_cast<FloatVisualizationMode>(i);
+	this->exposureSpinBox->setEnabled(this->floatVisualization.usesExposure());
+	// Tiles are cached per visualization, so switching back and forth only converts each tile once.
+	this->viewport->setFloatVisualization(this->floatVisualization);
+}
 
-	updateImage(mipLevel, arrayIndex, scaleMipToBase);
+void TexasGUI::ImageTab::exposureChanged(double stops)
+{
+	this->floatVisualization.exposure = static_cast<float>(stops);
+	this->viewport->setFloatVisualization(this->floatVisualization);
 }
 
 void TexasGUI::ImageTab::mipLevelSpinBoxChanged(int i)
 {
 	this->mipSelectorSlider->setValue(i);
-
-	const Texas::Dimensions mipDims = Texas::calculateMipDimensions(this->sourceTexture.baseDimensions(), i);
-
-	this->mipWidthLabel->setText(QString("Width: ") + QString::number(mipDims.width));
-	this->mipHeightLabel->setText(QString("Height: ") + QString::number(mipDims.height));
-	this->mipDepthLabel->setText(QString("Depth: ") + QString::number(mipDims.depth));
+	updateMipLabels(i);
 
 	unsigned int arrayIndex = getCurrentArrayLayer();
 	bool scaleMipToBase = getScaleMipToBase();
 
 	updateImage(i, arrayIndex, scaleMipToBase);
 	updateMinMaxLabels(i, arrayIndex);
+	updateStatistics(i, arrayIndex);
 }
 
 void TexasGUI::ImageTab::mipLevelSliderChanged(int i)
@@ -614,8 +456,41 @@ void TexasGUI::ImageTab::scaleToMipChanged(int i)
 	Qt::CheckState scaleMipToBaseState = static_cast<Qt::CheckState>(i);
 	bool scaleMipToBase = scaleMipToBaseState == Qt::Checked ? true : false;
 
+	// Same subresource, so the min/max labels stay as they are.
 	updateImage(mipLevel, arrayIndex, scaleMipToBase);
-	updateMinMaxLabels(mipLevel, arrayIndex);
+}
+
+void TexasGUI::ImageTab::automaticMipChanged(int i)
+{
+	bool automaticMip = static_cast<Qt::CheckState>(i) == Qt::Checked;
+
+	// The viewport picks the mip level now, the controls only show which one.
+	this->mipSelectorSpinBox->setEnabled(!automaticMip);
+	this->mipSelectorSlider->setEnabled(!automaticMip);
+	this->scaleMipToBaseCheckBox->setEnabled(!automaticMip);
+
+	this->viewport->setAutomaticMip(automaticMip);
+	if (automaticMip)
+		viewportMipChanged(static_cast<int>(this->viewport->displayedMip()));
+	else
+		updateImage(getCurrentMipLevel(), getCurrentArrayLayer(), getScaleMipToBase());
+}
+
+void TexasGUI::ImageTab::viewportMipChanged(int i)
+{
+	if (this->mipSelectorSpinBox == nullptr)
+		return;
+	{
+		QSignalBlocker spinBoxBlocker(this->mipSelectorSpinBox);
+		QSignalBlocker sliderBlocker(this->mipSelectorSlider);
+		this->mipSelectorSpinBox->setValue(i);
+		this->mipSelectorSlider->setValue(i);
+	}
+	updateMipLabels(i);
+
+	unsigned int arrayIndex = getCurrentArrayLayer();
+	updateMinMaxLabels(i, arrayIndex);
+	updateStatistics(i, arrayIndex);
 }
 
 void TexasGUI::ImageTab::arrayLayerSpinBoxChanged(int i)
@@ -624,6 +499,8 @@ void TexasGUI::ImageTab::arrayLayerSpinBoxChanged(int i)
 	bool scaleMipToBase = getScaleMipToBase();
 
 	updateImage(mipLevel, i, scaleMipToBase);
+	updateMinMaxLabels(mipLevel, i);
+	updateStatistics(mipLevel, i);
 }
 
 void TexasGUI::ImageTab::arrayLayerSliderChanged(int i)
@@ -631,27 +508,41 @@ void TexasGUI::ImageTab::arrayLayerSliderChanged(int i)
 	this->arraySelectorSpinBox->setValue(i);
 }
 
+std::shared_ptr<Texas::Texture const> TexasGUI::ImageTab::texture() const
+{
+	return this->sourceTexture;
+}
+
+Texas::TextureInfo const& TexasGUI::ImageTab::textureInfo() const
+{
+	return this->texInfo;
+}
+
+void TexasGUI::ImageTab::showSubresource(std::uint64_t mipIndex, std::uint64_t layerIndex)
+{
+	// Through the controls, so everything a click on them sets off happens here too.
+	if (this->arraySelectorSpinBox != nullptr)
+		this->arraySelectorSpinBox->setValue(static_cast<int>(layerIndex));
+	if (this->mipSelectorSpinBox != nullptr)
+		this->mipSelectorSpinBox->setValue(static_cast<int>(mipIndex));
+}
+
 void TexasGUI::ImageTab::exportAsKTX()
 {
-	QString fileName = QFileDialog::getSaveFileName(this, "Save file as KTX", "", "KTX Image (*.ktx)");
-	if (!fileName.isEmpty())
-	{
-		TexasFileStream fileStream;
-		fileStream.file.setFileName(fileName);
-		fileStream.file.open(QIODevice::OpenModeFlag::WriteOnly);
-		if (fileStream.file.isOpen())
-		{
-			fileStream.stream.setDevice(&fileStream.file);
-			fileStream.stream.setByteOrder(QDataStream::LittleEndian);
-
-			Texas::Result writeResult = Texas::KTX::saveToStream(this->sourceTexture, fileStream);
-			if (!writeResult.isSuccessful())
-			{
-				// Do some error handling.
-				Utils::displayErrorBox("Unable to save file.", writeResult.errorMessage());
-			}
-		}
-	}
+	if (this->sourceTexture == nullptr)
+		return;
+	ExportDialog dialog(*this->sourceTexture, this);
+	dialog.exec();
+}
+
+void TexasGUI::ImageTab::statisticsFinished()
+{
+	// Requests are only cancelled by newer ones, which the watcher has switched to, so nothing here means there is nothing to show.
+	std::shared_ptr<SubresourceStatistics const> statistics = this->statisticsCache->find(getCurrentMipLevel(), getCurrentArrayLayer());
+	if (statistics != nullptr)
+		showStatistics(statistics);
+	else
+		this->statisticsLabels[0]->setText("Not available for this format");
 }
 
 unsigned int TexasGUI::ImageTab::getCurrentMipLevel() const
@@ -678,45 +569,98 @@ unsigned int TexasGUI::ImageTab::getCurrentArrayLayer() const
 	return arrayIndex;
 }
 
+void TexasGUI::ImageTab::updateMipLabels(unsigned int mipIndex)
+{
+	const Texas::Dimensions mipDims = Texas::calculateMipDimensions(this->texInfo.baseDimensions, mipIndex);
+
+	this->mipWidthLabel->setText(QString("Width: ") + QString::number(mipDims.width));
+	this->mipHeightLabel->setText(QString("Height: ") + QString::number(mipDims.height));
+	this->mipDepthLabel->setText(QString("Depth: ") + QString::number(mipDims.depth));
+}
+
 void TexasGUI::ImageTab::updateMinMaxLabels(uint8_t mipIndex, uint64_t layerIndex)
 {
-	auto& layer = this->minMaxData.mipLevels[mipIndex].layers[layerIndex];
+	if (this->minMaxLabels.min[0] == nullptr)
+		return;
 
-	for (uint8_t i = 0; i < 4; i++)
+	MinMaxData::Value const* min = this->minMaxData.min(mipIndex, layerIndex);
+	MinMaxData::Value const* max = this->minMaxData.max(mipIndex, layerIndex);
+
+	for (uint8_t i = 0; i < this->minMaxData.channelCount; i++)
 	{
-		std::string text = std::to_string(i) + " " + "Min: " + std::to_string(layer.min_uint64[i]);
-		this->minMaxLabels.min[i]->setText(QString::fromStdString(text));
-		text = std::to_string(i) + " " + "Max: " + std::to_string(layer.max_uint64[i]);
-		this->minMaxLabels.max[i]->setText(QString::fromStdString(text));
+		QString minText;
+		QString maxText;
+		switch (this->minMaxData.type)
+		{
+		case MinMaxData::Type::Int:
+			minText = QString::number(min[i].int64);
+			maxText = QString::number(max[i].int64);
+			break;
+		case MinMaxData::Type::Float:
+			minText = QString::number(min[i].float64);
+			maxText = QString::number(max[i].float64);
+			break;
+		default:
+			minText = QString::number(min[i].uint64);
+			maxText = QString::number(max[i].uint64);
+			break;
+		}
+		this->minMaxLabels.min[i]->setText(QString::number(i) + " Min: " + minText);
+		this->minMaxLabels.max[i]->setText(QString::number(i) + " Max: " + maxText);
 	}
 
 }
 
 void TexasGUI::ImageTab::updateImage(std::uint8_t mipIndex, std::uint64_t arrayIndex, bool scaleMipToBase)
 {
-	QImage imageToDisplay{};
+	// Cheap enough to call for every slider tick. The viewport only schedules the tiles of whatever
+	// it ends up painting, reads them off the GUI thread and reads ahead in the direction of travel.
+	this->viewport->setScaleToBase(scaleMipToBase);
+	this->viewport->setSubresource(mipIndex, arrayIndex);
+}
 
-	Texas::Dimensions const mipDims = Texas::calculateMipDimensions(this->sourceTexture.baseDimensions(), mipIndex);
+void TexasGUI::ImageTab::updateStatistics(std::uint64_t mipIndex, std::uint64_t layerIndex)
+{
+	if (this->statisticsWatcher == nullptr)
+		return;
 
-	QPixmap tempPixMap = QPixmap::fromImage(imageToDisplay);
+	std::shared_ptr<SubresourceStatistics const> statistics = this->statisticsCache->find(mipIndex, layerIndex);
+	if (statistics != nullptr)
+	{
+		showStatistics(statistics);
+		return;
+	}
 
-	uint64_t imgDataMemoryOffset = Texas::calculateLayerOffset(
-		this->sourceTexture.baseDimensions(), 
-		Texas::PixelFormat::RGBA_8, mipIndex,
-		this->sourceTexture.layerCount(), 
-		arrayIndex);
-	uchar const* imgData = (uchar const*)this->customImgData.constData() + imgDataMemoryOffset;
-	imageToDisplay = QImage(imgData, mipDims.width, mipDims.height, QImage::Format::Format_RGBA8888);
-	tempPixMap = QPixmap::fromImage(imageToDisplay);
+	showStatistics(nullptr);
+	this->statisticsLabels[0]->setText("Computing...");
+	this->statisticsWatcher->setFuture(this->statisticsCache->request(mipIndex, layerIndex));
+}
 
-	if (scaleMipToBase && mipIndex != 0)
+void TexasGUI::ImageTab::showStatistics(std::shared_ptr<SubresourceStatistics const> const& statistics)
+{
+	this->histogramWidget->setStatistics(statistics);
+	for (uint8_t i = 0; i < 4; i++)
 	{
-		// Scale the image
-		QSize size = qPow(2, mipIndex) * tempPixMap.size();
-		//tempPixMap = tempPixMap.scaled(size, Qt::IgnoreAspectRatio, Qt::TransformationMode::SmoothTransformation);
-		tempPixMap = tempPixMap.scaled(size, Qt::IgnoreAspectRatio, Qt::TransformationMode::FastTransformation);
-	}
+		if (statistics == nullptr || i >= statistics->channelCount)
+		{
+			this->statisticsLabels[i]->clear();
+			continue;
+		}
 
-	this->imgLabel->setPixmap(tempPixMap);
-	this->imgLabel->adjustSize();
+		SubresourceStatistics::Channel const& channel = statistics->channels[i];
+		QString text = QString::number(i) +
+			" Mean: " + QString::number(channel.mean, 'g', 5) +
+			"  Std dev: " + QString::number(channel.stddev, 'g', 5) +
+			"\n   1%: " + QString::number(statistics->percentile(i, 0.01), 'g', 5) +
+			"  50%: " + QString::number(statistics->percentile(i, 0.5), 'g', 5) +
+			"  99%: " + QString::number(statistics->percentile(i, 0.99), 'g', 5);
+		if (statistics->isSRGBEncoded && i < 3)
+		{
+			text += "\n   Linear mean: " + QString::number(channel.linearMean, 'g', 5) +
+				"  Std dev: " + QString::number(channel.linearStddev, 'g', 5);
+		}
+		if (channel.nonFiniteCount > 0)
+			text += "\n   NaN/Inf: " + QString::number(channel.nonFiniteCount);
+		this->statisticsLabels[i]->setText(text);
+	}
 }
@@ -0,0 +1,247 @@
+#include "TexasGUI/KTXFormat.hpp"
+
+#include "TexasGUI/BCnDecoder.hpp"
+
+#include "Texas/Tools.hpp"
+
+namespace TexasGUI::KTX
+{
+	namespace GL
+	{
+		constexpr std::uint32_t BYTE = 0x1400;
+		constexpr std::uint32_t UNSIGNED_BYTE = 0x1401;
+		constexpr std::uint32_t SHORT = 0x1402;
+		constexpr std::uint32_t UNSIGNED_SHORT = 0x1403;
+		constexpr std::uint32_t INT = 0x1404;
+		constexpr std::uint32_t UNSIGNED_INT = 0x1405;
+		constexpr std::uint32_t FLOAT = 0x1406;
+		constexpr std::uint32_t HALF_FLOAT = 0x140B;
+
+		constexpr std::uint32_t RED = 0x1903;
+		constexpr std::uint32_t RG = 0x8227;
+		constexpr std::uint32_t RGB = 0x1907;
+		constexpr std::uint32_t RGBA = 0x1908;
+		constexpr std::uint32_t BGR = 0x80E0;
+		constexpr std::uint32_t BGRA = 0x80E1;
+		constexpr std::uint32_t RED_INTEGER = 0x8D94;
+		constexpr std::uint32_t RG_INTEGER = 0x8228;
+		constexpr std::uint32_t RGB_INTEGER = 0x8D98;
+		constexpr std::uint32_t RGBA_INTEGER = 0x8D99;
+		constexpr std::uint32_t BGR_INTEGER = 0x8D9A;
+		constexpr std::uint32_t BGRA_INTEGER = 0x8D9B;
+	}
+
+	struct FormatEntry
+	{
+		Texas::PixelFormat pixelFormat;
+		Texas::ChannelType channelType;
+		std::uint32_t glInternalFormat;
+		// 0 for the compressed formats.
+		std::uint32_t glType;
+		std::uint32_t glFormat;
+		std::uint32_t glBaseInternalFormat;
+	};
+
+	using PF = Texas::PixelFormat;
+	using CT = Texas::ChannelType;
+
+	constexpr FormatEntry formatTable[] = {
+		{ PF::R_8, CT::UnsignedNormalized, 0x8229, GL::UNSIGNED_BYTE, GL::RED, GL::RED },
+		{ PF::R_8, CT::SignedNormalized, 0x8F94, GL::BYTE, GL::RED, GL::RED },
+		{ PF::R_8, CT::UnsignedInteger, 0x8232, GL::UNSIGNED_BYTE, GL::RED_INTEGER, GL::RED },
+		{ PF::R_8, CT::SignedInteger, 0x8231, GL::BYTE, GL::RED_INTEGER, GL::RED },
+		{ PF::RG_8, CT::UnsignedNormalized, 0x822B, GL::UNSIGNED_BYTE, GL::RG, GL::RG },
+		{ PF::RG_8, CT::SignedNormalized, 0x8F95, GL::BYTE, GL::RG, GL::RG },
+		{ PF::RG_8, CT::UnsignedInteger, 0x8238, GL::UNSIGNED_BYTE, GL::RG_INTEGER, GL::RG },
+		{ PF::RG_8, CT::SignedInteger, 0x8237, GL::BYTE, GL::RG_INTEGER, GL::RG },
+		{ PF::RGB_8, CT::UnsignedNormalized, 0x8051, GL::UNSIGNED_BYTE, GL::RGB, GL::RGB },
+		{ PF::RGB_8, CT::sRGB, 0x8C41, GL::UNSIGNED_BYTE, GL::RGB, GL::RGB },
+		{ PF::RGB_8, CT::SignedNormalized, 0x8F96, GL::BYTE, GL::RGB, GL::RGB },
+		{ PF::RGB_8, CT::UnsignedInteger, 0x8D7D, GL::UNSIGNED_BYTE, GL::RGB_INTEGER, GL::RGB },
+		{ PF::RGB_8, CT::SignedInteger, 0x8D8F, GL::BYTE, GL::RGB_INTEGER, GL::RGB },
+		{ PF::BGR_8, CT::UnsignedNormalized, 0x8051, GL::UNSIGNED_BYTE, GL::BGR, GL::RGB },
+		{ PF::BGR_8, CT::sRGB, 0x8C41, GL::UNSIGNED_BYTE, GL::BGR, GL::RGB },
+		{ PF::BGR_8, CT::UnsignedInteger, 0x8D7D, GL::UNSIGNED_BYTE, GL::BGR_INTEGER, GL::RGB },
+		{ PF::BGR_8, CT::SignedInteger, 0x8D8F, GL::BYTE, GL::BGR_INTEGER, GL::RGB },
+		{ PF::RGBA_8, CT::UnsignedNormalized, 0x8058, GL::UNSIGNED_BYTE, GL::RGBA, GL::RGBA },
+		{ PF::RGBA_8, CT::sRGB, 0x8C43, GL::UNSIGNED_BYTE, GL::RGBA, GL::RGBA },
+		{ PF::RGBA_8, CT::SignedNormalized, 0x8F97, GL::BYTE, GL::RGBA, GL::RGBA },
+		{ PF::RGBA_8, CT::UnsignedInteger, 0x8D7C, GL::UNSIGNED_BYTE, GL::RGBA_INTEGER, GL::RGBA },
+		{ PF::RGBA_8, CT::SignedInteger, 0x8D8E, GL::BYTE, GL::RGBA_INTEGER, GL::RGBA },
+		{ PF::BGRA_8, CT::UnsignedNormalized, 0x8058, GL::UNSIGNED_BYTE, GL::BGRA, GL::RGBA },
+		{ PF::BGRA_8, CT::sRGB, 0x8C43, GL::UNSIGNED_BYTE, GL::BGRA, GL::RGBA },
+		{ PF::BGRA_8, CT::UnsignedInteger, 0x8D7C, GL::UNSIGNED_BYTE, GL::BGRA_INTEGER, GL::RGBA },
+		{ PF::BGRA_8, CT::SignedInteger, 0x8D8E, GL::BYTE, GL::BGRA_INTEGER, GL::RGBA },
+
+		{ PF::R_16, CT::UnsignedNormalized, 0x822A, GL::UNSIGNED_SHORT, GL::RED, GL::RED },
+		{ PF::R_16, CT::SignedNormalized, 0x8F98, GL::SHORT, GL::RED, GL::RED },
+		{ PF::R_16, CT::UnsignedInteger, 0x8234, GL::UNSIGNED_SHORT, GL::RED_INTEGER, GL::RED },
+		{ PF::R_16, CT::SignedInteger, 0x8233, GL::SHORT, GL::RED_INTEGER, GL::RED },
+		{ PF::R_16, CT::SignedFloat, 0x822D, GL::HALF_FLOAT, GL::RED, GL::RED },
+		{ PF::RG_16, CT::UnsignedNormalized, 0x822C, GL::UNSIGNED_SHORT, GL::RG, GL::RG },
+		{ PF::RG_16, CT::SignedNormalized, 0x8F99, GL::SHORT, GL::RG, GL::RG },
+		{ PF::RG_16, CT::UnsignedInteger, 0x823A, GL::UNSIGNED_SHORT, GL::RG_INTEGER, GL::RG },
+		{ PF::RG_16, CT::SignedInteger, 0x8239, GL::SHORT, GL::RG_INTEGER, GL::RG },
+		{ PF::RG_16, CT::SignedFloat, 0x822F, GL::HALF_FLOAT, GL::RG, GL::RG },
+		{ PF::RGB_16, CT::UnsignedNormalized, 0x8054, GL::UNSIGNED_SHORT, GL::RGB, GL::RGB },
+		{ PF::RGB_16, CT::SignedNormalized, 0x8F9A, GL::SHORT, GL::RGB, GL::RGB },
+		{ PF::RGB_16, CT::UnsignedInteger, 0x8D77, GL::UNSIGNED_SHORT, GL::RGB_INTEGER, GL::RGB },
+		{ PF::RGB_16, CT::SignedInteger, 0x8D89, GL::SHORT, GL::RGB_INTEGER, GL::RGB },
+		{ PF::RGB_16, CT::SignedFloat, 0x881B, GL::HALF_FLOAT, GL::RGB, GL::RGB },
+		{ PF::RGBA_16, CT::UnsignedNormalized, 0x805B, GL::UNSIGNED_SHORT, GL::RGBA, GL::RGBA },
+		{ PF::RGBA_16, CT::SignedNormalized, 0x8F9B, GL::SHORT, GL::RGBA, GL::RGBA },
+		{ PF::RGBA_16, CT::UnsignedInteger, 0x8D76, GL::UNSIGNED_SHORT, GL::RGBA_INTEGER, GL::RGBA },
+		{ PF::RGBA_16, CT::SignedInteger, 0x8D88, GL::SHORT, GL::RGBA_INTEGER, GL::RGBA },
+		{ PF::RGBA_16, CT::SignedFloat, 0x881A, GL::HALF_FLOAT, GL::RGBA, GL::RGBA },
+
+		{ PF::R_32, CT::UnsignedInteger, 0x8236, GL::UNSIGNED_INT, GL::RED_INTEGER, GL::RED },
+		{ PF::R_32, CT::SignedInteger, 0x8235, GL::INT, GL::RED_INTEGER, GL::RED },
+		{ PF::R_32, CT::SignedFloat, 0x822E, GL::FLOAT, GL::RED, GL::RED },
+		{ PF::RG_32, CT::UnsignedInteger, 0x823C, GL::UNSIGNED_INT, GL::RG_INTEGER, GL::RG },
+		{ PF::RG_32, CT::SignedInteger, 0x823B, GL::INT, GL::RG_INTEGER, GL::RG },
+		{ PF::RG_32, CT::SignedFloat, 0x8230, GL::FLOAT, GL::RG, GL::RG },
+		{ PF::RGB_32, CT::UnsignedInteger, 0x8D71, GL::UNSIGNED_INT, GL::RGB_INTEGER, GL::RGB },
+		{ PF::RGB_32, CT::SignedInteger, 0x8D83, GL::INT, GL::RGB_INTEGER, GL::RGB },
+		{ PF::RGB_32, CT::SignedFloat, 0x8815, GL::FLOAT, GL::RGB, GL::RGB },
+		{ PF::RGBA_32, CT::UnsignedInteger, 0x8D70, GL::UNSIGNED_INT, GL::RGBA_INTEGER, GL::RGBA },
+		{ PF::RGBA_32, CT::SignedInteger, 0x8D82, GL::INT, GL::RGBA_INTEGER, GL::RGBA },
+		{ PF::RGBA_32, CT::SignedFloat, 0x8814, GL::FLOAT, GL::RGBA, GL::RGBA },
+
+		{ PF::BC1_RGB, CT::UnsignedNormalized, 0x83F0, 0, 0, GL::RGB },
+		{ PF::BC1_RGB, CT::sRGB, 0x8C4C, 0, 0, GL::RGB },
+		{ PF::BC1_RGBA, CT::UnsignedNormalized, 0x83F1, 0, 0, GL::RGBA },
+		{ PF::BC1_RGBA, CT::sRGB, 0x8C4D, 0, 0, GL::RGBA },
+		{ PF::BC2_RGBA, CT::UnsignedNormalized, 0x83F2, 0, 0, GL::RGBA },
+		{ PF::BC2_RGBA, CT::sRGB, 0x8C4E, 0, 0, GL::RGBA },
+		{ PF::BC3_RGBA, CT::UnsignedNormalized, 0x83F3, 0, 0, GL::RGBA },
+		{ PF::BC3_RGBA, CT::sRGB, 0x8C4F, 0, 0, GL::RGBA },
+		{ PF::BC4, CT::UnsignedNormalized, 0x8DBB, 0, 0, GL::RED },
+		{ PF::BC4, CT::SignedNormalized, 0x8DBC, 0, 0, GL::RED },
+		{ PF::BC5, CT::UnsignedNormalized, 0x8DBD, 0, 0, GL::RG },
+		{ PF::BC5, CT::SignedNormalized, 0x8DBE, 0, 0, GL::RG },
+		{ PF::BC6H, CT::SignedFloat, 0x8E8E, 0, 0, GL::RGB },
+		{ PF::BC6H, CT::UnsignedFloat, 0x8E8F, 0, 0, GL::RGB },
+		{ PF::BC7_RGBA, CT::UnsignedNormalized, 0x8E8C, 0, 0, GL::RGBA },
+		{ PF::BC7_RGBA, CT::sRGB, 0x8E8D, 0, 0, GL::RGBA } };
+
+	[[nodiscard]] static std::uint32_t glTypeSize(std::uint32_t glType) noexcept
+	{
+		switch (glType)
+		{
+		case GL::SHORT:
+		case GL::UNSIGNED_SHORT:
+		case GL::HALF_FLOAT:
+			return 2;
+		case GL::INT:
+		case GL::UNSIGNED_INT:
+		case GL::FLOAT:
+			return 4;
+		default:
+			// Also what KTX wants for compressed formats.
+			return 1;
+		}
+	}
+
+	bool toGLFormat(Texas::PixelFormat pixelFormat, Texas::ChannelType channelType, GLFormat& glFormat) noexcept
+	{
+		for (FormatEntry const& entry : formatTable)
+		{
+			if (entry.pixelFormat != pixelFormat || entry.channelType != channelType)
+				continue;
+			glFormat.glType = entry.glType;
+			glFormat.glTypeSize = glTypeSize(entry.glType);
+			glFormat.glFormat = entry.glFormat;
+			glFormat.glInternalFormat = entry.glInternalFormat;
+			glFormat.glBaseInternalFormat = entry.glBaseInternalFormat;
+			return true;
+		}
+		return false;
+	}
+
+	bool fromGLFormat(GLFormat const& glFormat, Texas::PixelFormat& pixelFormat, Texas::ChannelType& channelType) noexcept
+	{
+		for (FormatEntry const& entry : formatTable)
+		{
+			if (entry.glInternalFormat != glFormat.glInternalFormat || entry.glType != glFormat.glType || entry.glFormat != glFormat.glFormat)
+				continue;
+			pixelFormat = entry.pixelFormat;
+			channelType = entry.channelType;
+			return true;
+		}
+		return false;
+	}
+
+	std::uint8_t bytesPerPixel(Texas::PixelFormat pixelFormat) noexcept
+	{
+		switch (pixelFormat)
+		{
+		case PF::R_8:
+			return 1;
+		case PF::RG_8:
+		case PF::R_16:
+			return 2;
+		case PF::RGB_8:
+		case PF::BGR_8:
+			return 3;
+		case PF::RGBA_8:
+		case PF::BGRA_8:
+		case PF::RG_16:
+		case PF::R_32:
+			return 4;
+		case PF::RGB_16:
+			return 6;
+		case PF::RGBA_16:
+		case PF::RG_32:
+			return 8;
+		case PF::RGB_32:
+			return 12;
+		case PF::RGBA_32:
+			return 16;
+		default:
+			return 0;
+		}
+	}
+
+	std::uint64_t packedRowSize(Texas::PixelFormat pixelFormat, std::uint64_t width) noexcept
+	{
+		if (BCn::isBlockCompressed(pixelFormat))
+			return (width + 3) / 4 * BCn::blockSize(pixelFormat);
+		return width * bytesPerPixel(pixelFormat);
+	}
+
+	SubresourceLayout subresourceLayout(Texas::TextureInfo const& texInfo, std::uint64_t mipIndex) noexcept
+	{
+		Texas::Dimensions const dimensions = Texas::calculateMipDimensions(texInfo.baseDimensions, mipIndex);
+		SubresourceLayout layout;
+		if (BCn::isBlockCompressed(texInfo.pixelFormat))
+		{
+			// A row of blocks is always a multiple of 8 bytes, so it never needs padding.
+			layout.rowCount = (dimensions.height + 3) / 4 * dimensions.depth;
+			layout.rowSize = packedRowSize(texInfo.pixelFormat, dimensions.width);
+			layout.rowPitch = layout.rowSize;
+		}
+		else
+		{
+			layout.rowCount = dimensions.height * dimensions.depth;
+			layout.rowSize = packedRowSize(texInfo.pixelFormat, dimensions.width);
+			layout.rowPitch = (layout.rowSize + 3) / 4 * 4;
+		}
+		layout.fileSize = layout.rowCount * layout.rowPitch;
+		layout.packedSize = layout.rowCount * layout.rowSize;
+		return layout;
+	}
+
+	bool isCubemap(Texas::TextureType textureType) noexcept
+	{
+		return textureType == Texas::TextureType::Cubemap || textureType == Texas::TextureType::ArrayCubemap;
+	}
+
+	bool isArray(Texas::TextureType textureType) noexcept
+	{
+		return
+			textureType == Texas::TextureType::Array1D ||
+			textureType == Texas::TextureType::Array2D ||
+			textureType == Texas::TextureType::Array3D ||
+			textureType == Texas::TextureType::ArrayCubemap;
+	}
+}
@@ -0,0 +1,323 @@
+#include "TexasGUI/KTXReader.hpp"
+
+#include "TexasGUI/BCnDecoder.hpp"
+#include "TexasGUI/MipGenerator.hpp"
+#include "TexasGUI/TextureKernels.hpp"
+
+#include "Texas/Tools.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace TexasGUI::KTX
+{
+	[[nodiscard]] static std::uint64_t alignTo4(std::uint64_t value) noexcept
+	{
+		return (value + 3) / 4 * 4;
+	}
+
+	// Distance between two layers of the same mip level. Faces of non-array cubemaps are padded individually.
+	[[nodiscard]] static std::uint64_t layerStride(Texas::TextureInfo const& texInfo, SubresourceLayout const& layout) noexcept
+	{
+		if (texInfo.textureType == Texas::TextureType::Cubemap)
+			return alignTo4(layout.fileSize);
+		return layout.fileSize;
+	}
+
+	// False if a * b doesn't fit in 64 bits.
+	[[nodiscard]] static bool checkedMultiply(std::uint64_t a, std::uint64_t b, std::uint64_t& result) noexcept
+	{
+		if (a != 0 && b > std::numeric_limits<std::uint64_t>::max() / a)
+			return false;
+		result = a * b;
+		return true;
+	}
+}
+
+TexasGUI::KTX::TiledReader::~TiledReader()
+{
+	close();
+}
+
+Texas::Result TexasGUI::KTX::TiledReader::open(QString const& path)
+{
+	close();
+
+	this->file.setFileName(path);
+	if (!this->file.open(QIODevice::ReadOnly))
+		return { Texas::ResultType::FailedToOpenFile, "Unable to open file." };
+	this->fileSize = static_cast<std::uint64_t>(this->file.size());
+
+	unsigned char header[headerSize];
+	if (!readBytes(0, headerSize, reinterpret_cast<std::byte*>(header)))
+	{
+		close();
+		return { Texas::ResultType::PrematureEndOfFile, "File is too small to be a KTX file." };
+	}
+	if (std::memcmp(header, identifier, sizeof(identifier)) != 0)
+	{
+		close();
+		return { Texas::ResultType::FileNotSupported, "Not a KTX 1 file." };
+	}
+
+	std::uint32_t fields[13];
+	std::memcpy(fields, header + sizeof(identifier), sizeof(fields));
+	if (fields[0] != endiannessReference)
+	{
+		close();
+		return { Texas::ResultType::FileNotSupported, "KTX files written on big endian machines aren't supported." };
+	}
+
+	GLFormat glFormat;
+	glFormat.glType = fields[1];
+	glFormat.glTypeSize = fields[2];
+	glFormat.glFormat = fields[3];
+	glFormat.glInternalFormat = fields[4];
+	glFormat.glBaseInternalFormat = fields[5];
+	Texas::TextureInfo info{};
+	if (!fromGLFormat(glFormat, info.pixelFormat, info.channelType))
+	{
+		close();
+		return { Texas::ResultType::FileNotSupported, "KTX file has a pixel format we don't support." };
+	}
+
+	std::uint32_t const width = fields[6];
+	std::uint32_t const height = fields[7];
+	std::uint32_t const depth = fields[8];
+	std::uint32_t const arrayElementCount = fields[9];
+	std::uint32_t const faceCount = fields[10];
+	bool const isArrayTexture = arrayElementCount > 0;
+	if (width == 0 || (faceCount != 1 && faceCount != 6) || (faceCount == 6 && depth > 0))
+	{
+		close();
+		return { Texas::ResultType::CorruptFileData, "KTX header describes an impossible texture." };
+	}
+
+	info.fileFormat = Texas::FileFormat::KTX;
+	info.colorSpace = info.channelType == Texas::ChannelType::sRGB ? Texas::ColorSpace::sRGB : Texas::ColorSpace::Linear;
+	info.baseDimensions = Texas::Dimensions{ width, std::max<std::uint64_t>(height, 1), std::max<std::uint64_t>(depth, 1) };
+	// Checked before anything is sized by it, a hostile count would otherwise ask for tens of GiB.
+	if (fields[11] > Mips::fullMipCount(info.baseDimensions))
+	{
+		close();
+		return { Texas::ResultType::CorruptFileData, "KTX header has more mip levels than its dimensions allow." };
+	}
+	// 0 asks the loader to generate mips, there's still only the base level in the file.
+	info.mipCount = std::max<std::uint32_t>(fields[11], 1);
+	info.layerCount = std::uint64_t(std::max<std::uint32_t>(arrayElementCount, 1)) * faceCount;
+	if (faceCount == 6)
+		info.textureType = isArrayTexture ? Texas::TextureType::ArrayCubemap : Texas::TextureType::Cubemap;
+	else if (depth > 0)
+		info.textureType = isArrayTexture ? Texas::TextureType::Array3D : Texas::TextureType::Texture3D;
+	else if (height > 0)
+		info.textureType = isArrayTexture ? Texas::TextureType::Array2D : Texas::TextureType::Texture2D;
+	else
+		info.textureType = isArrayTexture ? Texas::TextureType::Array1D : Texas::TextureType::Texture1D;
+
+	// Walk the mip levels, each one is its imageSize followed by every layer.
+	std::uint64_t offset = headerSize + fields[12];
+	this->mipOffsets.resize(info.mipCount);
+	this->mipLayouts.resize(info.mipCount);
+	for (std::uint64_t mipIndex = 0; mipIndex < info.mipCount; mipIndex++)
+	{
+		// Every format takes at least half a byte per texel, so dimensions too large for what's left of the file
+		// are rejected before their sizes are computed, those could overflow.
+		Texas::Dimensions const mipDims = Texas::calculateMipDimensions(info.baseDimensions, mipIndex);
+		std::uint64_t const remaining = offset + sizeof(std::uint32_t) <= this->fileSize ? this->fileSize - offset - sizeof(std::uint32_t) : 0;
+		std::uint64_t texelCount = 0;
+		bool fits =
+			checkedMultiply(mipDims.width, mipDims.height, texelCount) &&
+			checkedMultiply(texelCount, mipDims.depth, texelCount) &&
+			checkedMultiply(texelCount, info.layerCount, texelCount) &&
+			texelCount / 2 <= remaining;
+
+		SubresourceLayout layout{};
+		std::uint64_t mipSize = 0;
+		if (fits)
+		{
+			layout = subresourceLayout(info, mipIndex);
+			fits = checkedMultiply(layerStride(info, layout), info.layerCount, mipSize) && mipSize <= remaining;
+		}
+		std::uint64_t const expectedImageSize = info.textureType == Texas::TextureType::Cubemap ? layout.fileSize : mipSize;
+
+		std::uint32_t imageSize = 0;
+		if (!fits || !readBytes(offset, sizeof(imageSize), reinterpret_cast<std::byte*>(&imageSize)))
+		{
+			close();
+			return { Texas::ResultType::PrematureEndOfFile, "KTX file ends before its last mip level." };
+		}
+		if (imageSize != expectedImageSize)
+		{
+			close();
+			return { Texas::ResultType::CorruptFileData, "KTX mip level has the wrong size for its dimensions." };
+		}
+
+		this->mipOffsets[mipIndex] = offset + sizeof(imageSize);
+		this->mipLayouts[mipIndex] = layout;
+		offset = alignTo4(offset + sizeof(imageSize) + mipSize);
+	}
+	this->texInfo = info;
+
+	// Mapping only reserves address space, pages are read in as regions touch them.
+	// If it fails (32-bit builds, odd file systems) we fall back to reading.
+	this->mappedData = this->file.map(0, this->file.size());
+	return { Texas::ResultType::Success, nullptr };
+}
+
+void TexasGUI::KTX::TiledReader::close()
+{
+	if (this->mappedData != nullptr)
+		this->file.unmap(const_cast<uchar*>(this->mappedData));
+	this->mappedData = nullptr;
+	this->file.close();
+	this->fileSize = 0;
+	this->texInfo = Texas::TextureInfo{};
+	this->mipOffsets.clear();
+	this->mipLayouts.clear();
+}
+
+Texas::TextureInfo const& TexasGUI::KTX::TiledReader::textureInfo() const noexcept
+{
+	return this->texInfo;
+}
+
+bool TexasGUI::KTX::TiledReader::isMapped() const noexcept
+{
+	return this->mappedData != nullptr;
+}
+
+std::uint64_t TexasGUI::KTX::TiledReader::subresourceOffset(std::uint64_t mipIndex, std::uint64_t layerIndex) const noexcept
+{
+	return this->mipOffsets[mipIndex] + layerIndex * layerStride(this->texInfo, this->mipLayouts[mipIndex]);
+}
+
+TexasGUI::KTX::SubresourceLayout const& TexasGUI::KTX::TiledReader::layout(std::uint64_t mipIndex) const noexcept
+{
+	return this->mipLayouts[mipIndex];
+}
+
+bool TexasGUI::KTX::TiledReader::readRegion(
+	std::uint64_t mipIndex,
+	std::uint64_t layerIndex,
+	Region& region,
+	std::vector<std::byte>& dst) const
+{
+	if (mipIndex >= this->texInfo.mipCount || layerIndex >= this->texInfo.layerCount)
+		return false;
+	Texas::Dimensions const dimensions = Texas::calculateMipDimensions(this->texInfo.baseDimensions, mipIndex);
+	if (region.x >= dimensions.width || region.y >= dimensions.height || region.z >= dimensions.depth || region.width == 0 || region.height == 0)
+		return false;
+
+	std::uint64_t x0 = region.x;
+	std::uint64_t y0 = region.y;
+	std::uint64_t x1 = std::min(region.x + region.width, dimensions.width);
+	std::uint64_t y1 = std::min(region.y + region.height, dimensions.height);
+
+	SubresourceLayout const& layout = this->mipLayouts[mipIndex];
+	std::uint64_t const subresourceStart = subresourceOffset(mipIndex, layerIndex);
+
+	// What one row of the region is in the file: a row of pixels, or a row of blocks.
+	std::uint64_t firstRow;
+	std::uint64_t rowCount;
+	std::uint64_t rowOffset;
+	std::uint64_t rowSize;
+	if (BCn::isBlockCompressed(this->texInfo.pixelFormat))
+	{
+		x0 = x0 / 4 * 4;
+		y0 = y0 / 4 * 4;
+		x1 = std::min(alignTo4(x1), dimensions.width);
+		y1 = std::min(alignTo4(y1), dimensions.height);
+		std::uint64_t const blockRowsPerSlice = (dimensions.height + 3) / 4;
+		std::uint8_t const bytesPerBlock = BCn::blockSize(this->texInfo.pixelFormat);
+		firstRow = region.z * blockRowsPerSlice + y0 / 4;
+		rowCount = (y1 - y0 + 3) / 4;
+		rowOffset = x0 / 4 * bytesPerBlock;
+		rowSize = (x1 - x0 + 3) / 4 * bytesPerBlock;
+	}
+	else
+	{
+		std::uint8_t const pixelSize = bytesPerPixel(this->texInfo.pixelFormat);
+		firstRow = region.z * dimensions.height + y0;
+		rowCount = y1 - y0;
+		rowOffset = x0 * pixelSize;
+		rowSize = (x1 - x0) * pixelSize;
+	}
+
+	dst.resize(rowCount * rowSize);
+	// Full width regions are contiguous in the file unless rows are padded.
+	if (rowSize == layout.rowPitch)
+	{
+		if (!readBytes(subresourceStart + firstRow * layout.rowPitch, rowCount * rowSize, dst.data()))
+			return false;
+	}
+	else
+	{
+		for (std::uint64_t row = 0; row < rowCount; row++)
+		{
+			if (!readBytes(subresourceStart + (firstRow + row) * layout.rowPitch + rowOffset, rowSize, dst.data() + row * rowSize))
+				return false;
+		}
+	}
+
+	region.x = x0;
+	region.y = y0;
+	region.width = x1 - x0;
+	region.height = y1 - y0;
+	return true;
+}
+
+bool TexasGUI::KTX::TiledReader::readDisplayRegion(
+	std::uint64_t mipIndex,
+	std::uint64_t layerIndex,
+	Region const& region,
+	QByteArray& rgba) const
+{
+	Region readArea = region;
+	std::vector<std::byte> data;
+	if (!readRegion(mipIndex, layerIndex, readArea, data))
+		return false;
+
+	// The region on its own looks just like a single subresource texture to the display kernels.
+	Texas::TextureInfo regionInfo = this->texInfo;
+	regionInfo.textureType = Texas::TextureType::Texture2D;
+	regionInfo.baseDimensions = Texas::Dimensions{ readArea.width, readArea.height, 1 };
+	regionInfo.mipCount = 1;
+	regionInfo.layerCount = 1;
+	QByteArray decoded;
+	if (!BuildDisplayableSubresource(regionInfo, Texas::ConstByteSpan(data.data(), data.size()), 0, 0, decoded))
+		return false;
+
+	Texas::Dimensions const dimensions = Texas::calculateMipDimensions(this->texInfo.baseDimensions, mipIndex);
+	std::uint64_t const width = std::min(region.x + region.width, dimensions.width) - region.x;
+	std::uint64_t const height = std::min(region.y + region.height, dimensions.height) - region.y;
+	if (readArea.x == region.x && readArea.y == region.y && readArea.width == width && readArea.height == height)
+	{
+		rgba = decoded;
+		return true;
+	}
+
+	rgba = QByteArray(static_cast<int>(width * height * 4), Qt::Initialization::Uninitialized);
+	for (std::uint64_t row = 0; row < height; row++)
+	{
+		std::uint64_t srcOffset = ((region.y - readArea.y + row) * readArea.width + (region.x - readArea.x)) * 4;
+		std::memcpy(rgba.data() + row * width * 4, decoded.constData() + srcOffset, width * 4);
+	}
+	return true;
+}
+
+bool TexasGUI::KTX::TiledReader::readBytes(std::uint64_t offset, std::uint64_t size, std::byte* dst) const
+{
+	if (offset + size > this->fileSize)
+		return false;
+	if (this->mappedData != nullptr)
+	{
+		std::memcpy(dst, this->mappedData + offset, static_cast<std::size_t>(size));
+		return true;
+	}
+
+	std::lock_guard<std::mutex> lock(this->fileMutex);
+	if (!this->file.seek(static_cast<qint64>(offset)))
+		return false;
+	return this->file.read(reinterpret_cast<char*>(dst), static_cast<qint64>(size)) == static_cast<qint64>(size);
+}
@@ -0,0 +1,192 @@
+#include "TexasGUI/KTXWriter.hpp"
+
+#include "Texas/Tools.hpp"
+
+#include <cstring>
+#include <limits>
+
+namespace TexasGUI::KTX
+{
+	[[nodiscard]] static std::uint32_t faceCount(Texas::TextureInfo const& texInfo) noexcept
+	{
+		return isCubemap(texInfo.textureType) ? 6 : 1;
+	}
+
+	// Non-array cubemaps store the size of a single face, everything else the size of the whole mip level.
+	[[nodiscard]] static std::uint64_t imageSize(Texas::TextureInfo const& texInfo, SubresourceLayout const& layout) noexcept
+	{
+		if (texInfo.textureType == Texas::TextureType::Cubemap)
+			return layout.fileSize;
+		return layout.fileSize * texInfo.layerCount;
+	}
+
+	[[nodiscard]] static Texas::Result success() noexcept
+	{
+		return { Texas::ResultType::Success, nullptr };
+	}
+
+	[[nodiscard]] static Texas::Result writePadding(Texas::OutputStream& stream, std::uint64_t size)
+	{
+		constexpr char zeroes[4] = {};
+		if (size % 4 == 0)
+			return success();
+		return stream.write(zeroes, 4 - size % 4);
+	}
+}
+
+Texas::Result TexasGUI::KTX::canSave(Texas::TextureInfo const& texInfo) noexcept
+{
+	GLFormat glFormat;
+	if (!toGLFormat(texInfo.pixelFormat, texInfo.channelType, glFormat))
+		return { Texas::ResultType::InvalidInputParameter, "KTX has no equivalent of this pixel format and channel type." };
+	if (texInfo.mipCount == 0 || texInfo.layerCount == 0)
+		return { Texas::ResultType::InvalidInputParameter, "Texture has no subresources." };
+	if (isCubemap(texInfo.textureType) && texInfo.layerCount % 6 != 0)
+		return { Texas::ResultType::InvalidInputParameter, "Cubemap layer count isn't a multiple of 6." };
+	if (!isArray(texInfo.textureType) && texInfo.layerCount != faceCount(texInfo))
+		return { Texas::ResultType::InvalidInputParameter, "Texture has layers but isn't an array." };
+	if (imageSize(texInfo, subresourceLayout(texInfo, 0)) > std::numeric_limits<std::uint32_t>::max())
+		return { Texas::ResultType::InvalidInputParameter, "Mip level is too large for KTX's 32-bit image size." };
+	return success();
+}
+
+Texas::Result TexasGUI::KTX::saveToStream(Texas::TextureInfo const& texInfo, Texas::ConstByteSpan data, Texas::OutputStream& stream)
+{
+	if (data.size() < Texas::calculateTotalSize(texInfo))
+		return { Texas::ResultType::InvalidInputParameter, "Texture data is smaller than the texture." };
+
+	StreamingWriter writer;
+	Texas::Result result = writer.begin(texInfo, stream);
+	for (std::uint64_t mipIndex = 0; mipIndex < texInfo.mipCount && result.isSuccessful(); mipIndex++)
+	{
+		std::uint64_t mipOffset = Texas::calculateMipOffset(texInfo, mipIndex);
+		std::uint64_t mipSize = subresourceLayout(texInfo, mipIndex).packedSize * texInfo.layerCount;
+		result = writer.writeMipLevel(Texas::ConstByteSpan(data.data() + mipOffset, static_cast<std::size_t>(mipSize)));
+	}
+	if (result.isSuccessful())
+		result = writer.finish();
+	return result;
+}
+
+Texas::Result TexasGUI::KTX::StreamingWriter::begin(Texas::TextureInfo const& texInfo, Texas::OutputStream& stream)
+{
+	Texas::Result result = canSave(texInfo);
+	if (!result.isSuccessful())
+		return result;
+
+	this->texInfo = texInfo;
+	this->stream = &stream;
+	this->mipIndex = 0;
+	this->layerIndex = 0;
+
+	GLFormat glFormat;
+	static_cast<void>(toGLFormat(texInfo.pixelFormat, texInfo.channelType, glFormat));
+
+	bool const is1D = texInfo.textureType == Texas::TextureType::Texture1D || texInfo.textureType == Texas::TextureType::Array1D;
+	bool const is3D = texInfo.textureType == Texas::TextureType::Texture3D || texInfo.textureType == Texas::TextureType::Array3D;
+	std::uint32_t const fields[13] = {
+		endiannessReference,
+		glFormat.glType,
+		glFormat.glTypeSize,
+		glFormat.glFormat,
+		glFormat.glInternalFormat,
+		glFormat.glBaseInternalFormat,
+		static_cast<std::uint32_t>(texInfo.baseDimensions.width),
+		is1D ? 0 : static_cast<std::uint32_t>(texInfo.baseDimensions.height),
+		is3D ? static_cast<std::uint32_t>(texInfo.baseDimensions.depth) : 0,
+		isArray(texInfo.textureType) ? static_cast<std::uint32_t>(texInfo.layerCount / faceCount(texInfo)) : 0,
+		faceCount(texInfo),
+		static_cast<std::uint32_t>(texInfo.mipCount),
+		// No key/value data.
+		0 };
+
+	// KTX is written in the byte order of the machine writing it, the reference field tells readers which one that was.
+	unsigned char header[headerSize];
+	std::memcpy(header, identifier, sizeof(identifier));
+	std::memcpy(header + sizeof(identifier), fields, sizeof(fields));
+	return stream.write(reinterpret_cast<char const*>(header), headerSize);
+}
+
+Texas::Result TexasGUI::KTX::StreamingWriter::writeSubresource(Texas::ConstByteSpan data)
+{
+	if (this->stream == nullptr || this->mipIndex >= this->texInfo.mipCount)
+		return { Texas::ResultType::InvalidInputParameter, "Wrote more subresources than the texture has." };
+
+	SubresourceLayout const layout = subresourceLayout(this->texInfo, this->mipIndex);
+	if (data.size() != layout.packedSize)
+		return { Texas::ResultType::InvalidInputParameter, "Subresource data has the wrong size." };
+
+	Texas::Result result = success();
+	if (this->layerIndex == 0)
+	{
+		std::uint32_t const size = static_cast<std::uint32_t>(imageSize(this->texInfo, layout));
+		result = this->stream->write(reinterpret_cast<char const*>(&size), sizeof(size));
+		if (!result.isSuccessful())
+			return result;
+	}
+
+	result = writePadded(reinterpret_cast<unsigned char const*>(data.data()), layout);
+	if (!result.isSuccessful())
+		return result;
+	// Faces of non-array cubemaps are padded individually, everything else once per mip level.
+	if (this->texInfo.textureType == Texas::TextureType::Cubemap)
+		result = writePadding(*this->stream, layout.fileSize);
+
+	this->layerIndex++;
+	if (this->layerIndex == this->texInfo.layerCount)
+	{
+		if (result.isSuccessful() && this->texInfo.textureType != Texas::TextureType::Cubemap)
+			result = writePadding(*this->stream, imageSize(this->texInfo, layout));
+		this->layerIndex = 0;
+		this->mipIndex++;
+	}
+	return result;
+}
+
+Texas::Result TexasGUI::KTX::StreamingWriter::writeMipLevel(Texas::ConstByteSpan data)
+{
+	if (this->layerIndex != 0)
+		return { Texas::ResultType::InvalidInputParameter, "Can't write a whole mip level in the middle of one." };
+	if (this->mipIndex >= this->texInfo.mipCount)
+		return { Texas::ResultType::InvalidInputParameter, "Wrote more subresources than the texture has." };
+
+	std::uint64_t const layerSize = subresourceLayout(this->texInfo, this->mipIndex).packedSize;
+	if (data.size() != layerSize * this->texInfo.layerCount)
+		return { Texas::ResultType::InvalidInputParameter, "Mip level data has the wrong size." };
+
+	Texas::Result result = success();
+	for (std::uint64_t layer = 0; layer < this->texInfo.layerCount && result.isSuccessful(); layer++)
+		result = writeSubresource(Texas::ConstByteSpan(data.data() + layer * layerSize, static_cast<std::size_t>(layerSize)));
+	return result;
+}
+
+Texas::Result TexasGUI::KTX::StreamingWriter::finish()
+{
+	if (this->stream == nullptr || this->mipIndex != this->texInfo.mipCount)
+		return { Texas::ResultType::InvalidInputParameter, "Not every subresource was written." };
+	this->stream = nullptr;
+	return success();
+}
+
+std::uint64_t TexasGUI::KTX::StreamingWriter::nextMipIndex() const noexcept
+{
+	return this->mipIndex;
+}
+
+Texas::Result TexasGUI::KTX::StreamingWriter::writePadded(unsigned char const* data, SubresourceLayout const& layout)
+{
+	if (layout.rowPitch == layout.rowSize)
+		return this->stream->write(reinterpret_cast<char const*>(data), layout.packedSize);
+
+	// The output stream is buffered, so row sized writes are cheap.
+	constexpr char zeroes[4] = {};
+	for (std::uint64_t row = 0; row < layout.rowCount; row++)
+	{
+		Texas::Result result = this->stream->write(reinterpret_cast<char const*>(data + row * layout.rowSize), layout.rowSize);
+		if (result.isSuccessful())
+			result = this->stream->write(zeroes, layout.rowPitch - layout.rowSize);
+		if (!result.isSuccessful())
+			return result;
+	}
+	return success();
+}
@@ -0,0 +1,110 @@
+#include "TexasGUI/LatencyRecorder.hpp"
+
+#include <QMutexLocker>
+
+#include <atomic>
+
+namespace TexasGUI::Latency
+{
+	static std::atomic<Recorder*> installedRecorder{ nullptr };
+}
+
+char const* TexasGUI::Latency::toString(Stage stage) noexcept
+{
+	switch (stage)
+	{
+	case Stage::FileIO:
+		return "fileIO";
+	case Stage::Parse:
+		return "parse";
+	case Stage::Statistics:
+		return "statistics";
+	case Stage::ImageTab:
+		return "imageTab";
+	case Stage::LeftPanel:
+		return "leftPanel";
+	case Stage::FirstPaint:
+		return "firstPaint";
+	case Stage::OpenToFirstPixel:
+		return "openToFirstPixel";
+	case Stage::DisplayConversion:
+		return "displayConversion";
+	case Stage::Paint:
+		return "paint";
+	case Stage::SubresourceSwitch:
+		return "subresourceSwitch";
+	case Stage::Export:
+		return "export";
+	default:
+		return "unknown";
+	}
+}
+
+TexasGUI::Latency::Recorder::~Recorder() = default;
+
+void TexasGUI::Latency::Recorder::record(Stage stage, std::int64_t nanoseconds)
+{
+	QMutexLocker lock(&this->mutex);
+	this->stageSamples[static_cast<std::size_t>(stage)].push_back(nanoseconds);
+}
+
+std::size_t TexasGUI::Latency::Recorder::sampleCount(Stage stage) const
+{
+	QMutexLocker lock(&this->mutex);
+	return this->stageSamples[static_cast<std::size_t>(stage)].size();
+}
+
+std::vector<std::int64_t> TexasGUI::Latency::Recorder::samples(Stage stage) const
+{
+	QMutexLocker lock(&this->mutex);
+	return this->stageSamples[static_cast<std::size_t>(stage)];
+}
+
+void TexasGUI::Latency::Recorder::clear()
+{
+	QMutexLocker lock(&this->mutex);
+	for (std::vector<std::int64_t>& current : this->stageSamples)
+		current.clear();
+}
+
+void TexasGUI::Latency::setRecorder(Recorder* recorder) noexcept
+{
+	installedRecorder.store(recorder);
+}
+
+TexasGUI::Latency::Recorder* TexasGUI::Latency::recorder() noexcept
+{
+	return installedRecorder.load(std::memory_order_acquire);
+}
+
+void TexasGUI::Latency::record(Stage stage, std::int64_t nanoseconds)
+{
+	Recorder* current = recorder();
+	if (current != nullptr)
+		current->record(stage, nanoseconds);
+}
+
+TexasGUI::Latency::ScopedStage::ScopedStage(Stage stage) noexcept :
+	stage(stage)
+{
+	if (recorder() != nullptr)
+		this->timer.start();
+}
+
+TexasGUI::Latency::ScopedStage::~ScopedStage()
+{
+	finish();
+}
+
+void TexasGUI::Latency::ScopedStage::finish()
+{
+	if (!this->timer.isValid())
+		return;
+	record(this->stage, this->timer.nsecsElapsed());
+	this->timer.invalidate();
+}
+
+void TexasGUI::Latency::ScopedStage::cancel() noexcept
+{
+	this->timer.invalidate();
+}
@@ -0,0 +1,209 @@
+#include "LoadingTab.hpp"
+
+#include "TexasGUI/LatencyRecorder.hpp"
+#include "TexasGUI/Utilities.hpp"
+
+#include <QBoxLayout>
+#include <QFile>
+#include <QFileInfo>
+#include <QLabel>
+#include <QProgressBar>
+#include <QTimer>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include "Texas/Texas.hpp"
+
+#include <atomic>
+#include <cstddef>
+
+namespace TexasGUI
+{
+	enum class LoadStage : int
+	{
+		Reading,
+		Statistics,
+		Done
+	};
+
+	struct LoadJob
+	{
+		KernelProgress progress{};
+		std::atomic<LoadStage> stage{ LoadStage::Reading };
+	};
+
+	[[nodiscard]] static QString toString(LoadStage stage)
+	{
+		switch (stage)
+		{
+		case LoadStage::Reading:
+			return "Reading file...";
+		case LoadStage::Statistics:
+			return "Computing min/max values...";
+		case LoadStage::Done:
+			return "Done";
+		default:
+			return "Error";
+		}
+	}
+
+	// KTX files at least this large are streamed from disk rather than loaded.
+	constexpr qint64 streamingThreshold = 2ll * 1024 * 1024 * 1024;
+
+	// Runs on the thread pool. Returns nullptr if the job was cancelled.
+	static std::shared_ptr<LoadedTexture> loadTexture(QString const& fullPath, std::shared_ptr<LoadJob> job)
+	{
+		std::shared_ptr<LoadedTexture> result = std::make_shared<LoadedTexture>();
+
+		QFileInfo fileInfo(fullPath);
+		if (fileInfo.size() >= streamingThreshold && fileInfo.suffix().compare("ktx", Qt::CaseInsensitive) == 0)
+		{
+			std::shared_ptr<KTX::TiledReader> tiledReader = std::make_shared<KTX::TiledReader>();
+			if (tiledReader->open(fullPath).isSuccessful())
+			{
+				result->tiledReader = static_cast<std::shared_ptr<KTX::TiledReader>&&>(tiledReader);
+				job->stage.store(LoadStage::Done);
+				return result;
+			}
+			// Texas understands more of KTX than the reader does, let it have a go.
+		}
+
+		Latency::ScopedStage fileStage(Latency::Stage::FileIO);
+		QFile file(fullPath);
+		file.open(QFile::ReadOnly);
+		if (!file.isOpen())
+		{
+			fileStage.cancel();
+			result->errorTitle = "Unable to open this file.";
+			return result;
+		}
+
+		// Map the file once and let Texas parse straight out of the mapping.
+		// The mapping only needs to outlive the load, Texas copies the image data into the Texture.
+		uchar const* mappedFile = file.map(0, file.size());
+		if (mappedFile == nullptr)
+		{
+			fileStage.cancel();
+			result->errorTitle = "Unable to open this file.";
+			return result;
+		}
+		fileStage.finish();
+		Texas::ConstByteSpan fileSpan = Texas::ConstByteSpan(
+			reinterpret_cast<std::byte const*>(mappedFile),
+			static_cast<std::size_t>(file.size()));
+		Latency::ScopedStage parseStage(Latency::Stage::Parse);
+		Texas::ResultValue<Texas::Texture> loadResult = Texas::loadFromBuffer(fileSpan);
+		file.unmap(const_cast<uchar*>(mappedFile));
+		file.close();
+
+		if (!loadResult.isSuccessful())
+		{
+			parseStage.cancel();
+			result->errorTitle = "Unable to load this file.";
+			result->errorDetails = loadResult.errorMessage();
+			return result;
+		}
+		parseStage.finish();
+		result->texture = static_cast<Texas::Texture&&>(loadResult.value());
+
+		if (job->progress.cancelled.load())
+			return nullptr;
+
+		Texas::TextureInfo const& texInfo = result->texture.textureInfo();
+		// One unit per subresource.
+		job->progress.totalUnits.store(texInfo.mipCount * texInfo.layerCount);
+
+		// The first displayed subresource is converted during the min/max sweep, so it's only read once.
+		job->stage.store(LoadStage::Statistics);
+		Latency::ScopedStage statisticsStage(Latency::Stage::Statistics);
+		bool const isDisplayable = FindMinMaxValuesAndBuildDisplayable(
+			texInfo,
+			result->texture.rawBufferSpan(),
+			result->minMaxData,
+			0,
+			0,
+			result->baseDisplayData,
+			&job->progress);
+		if (job->progress.cancelled.load())
+		{
+			statisticsStage.cancel();
+			return nullptr;
+		}
+		// Nothing was converted for display, so it's not a sample of how long statistics take.
+		if (!isDisplayable)
+			statisticsStage.cancel();
+		statisticsStage.finish();
+
+		job->stage.store(LoadStage::Done);
+		return result;
+	}
+}
+
+TexasGUI::LoadingTab::LoadingTab(QString const& fullPath) :
+	QWidget(),
+	path(fullPath),
+	job(std::make_shared<LoadJob>())
+{
+	QVBoxLayout* outerLayout = new QVBoxLayout;
+	this->setLayout(outerLayout);
+	outerLayout->addStretch();
+
+	this->stageLabel = new QLabel;
+	outerLayout->addWidget(this->stageLabel, 0, Qt::AlignHCenter);
+	this->stageLabel->setText(toString(LoadStage::Reading));
+
+	this->progressBar = new QProgressBar;
+	outerLayout->addWidget(this->progressBar, 0, Qt::AlignHCenter);
+	this->progressBar->setMinimumWidth(300);
+	// Busy indicator until we know how much work there is.
+	this->progressBar->setRange(0, 0);
+
+	outerLayout->addStretch();
+
+	// The worker only touches atomics, so poll them rather than signalling from the pool thread.
+	this->progressTimer = new QTimer(this);
+	this->progressTimer->setInterval(50);
+	QObject::connect(this->progressTimer, SIGNAL(timeout()), this, SLOT(updateProgress()));
+	this->progressTimer->start();
+
+	this->watcher = new QFutureWatcher<std::shared_ptr<LoadedTexture>>(this);
+	QObject::connect(this->watcher, SIGNAL(finished()), this, SLOT(workerFinished()));
+	this->watcher->setFuture(QtConcurrent::run(&loadTexture, this->path, this->job));
+}
+
+TexasGUI::LoadingTab::~LoadingTab()
+{
+	// The worker holds its own reference to the job, it will see this at its next check and bail out.
+	this->job->progress.cancelled.store(true);
+}
+
+QString const& TexasGUI::LoadingTab::fullPath() const
+{
+	return this->path;
+}
+
+std::shared_ptr<TexasGUI::LoadedTexture> TexasGUI::LoadingTab::takeResult()
+{
+	return static_cast<std::shared_ptr<LoadedTexture>&&>(this->result);
+}
+
+void TexasGUI::LoadingTab::workerFinished()
+{
+	this->progressTimer->stop();
+	this->result = this->watcher->result();
+	if (this->result != nullptr)
+		emit loadFinished(this);
+}
+
+void TexasGUI::LoadingTab::updateProgress()
+{
+	LoadStage stage = this->job->stage.load();
+	this->stageLabel->setText(toString(stage));
+
+	std::uint64_t totalUnits = this->job->progress.totalUnits.load();
+	if (totalUnits > 0)
+	{
+		std::uint64_t completedUnits = this->job->progress.completedUnits.load();
+		this->progressBar->setRange(0, 100);
+		this->progressBar->setValue(static_cast<int>(completedUnits * 100 / totalUnits));
+	}
+}
@@ -1,10 +1,10 @@
 #include "MainTexasWindow.hpp"
 
+#include "CompareTab.hpp"
 #include "ImageTab.hpp"
+#include "LoadingTab.hpp"
 #include "TexasGUI/Utilities.hpp"
 
-#include "Texas/Texas.hpp"
-#include "Texas/Tools.hpp"
 
 #include <QBoxLayout>
 #include <QMenuBar>
@@ -13,6 +13,10 @@
 #include <QFile>
 #include <QFileInfo>
 #include <QMessageBox>
+#include <QComboBox>
+#include <QDialog>
+#include <QDialogButtonBox>
+#include <QFormLayout>
 #include <QDebug>
 #include <QGroupBox>
 #include <QScrollArea>
@@ -32,6 +36,7 @@ TexasGUI::MainTexasWindow::MainTexasWindow()
     fileMenu->setTitle("File");
     QAction* openAct = fileMenu->addAction("Open file", this, &MainTexasWindow::openFile);
     openAct->setShortcut(QKeySequence::Open);
+    fileMenu->addAction("Compare tabs...", this, &MainTexasWindow::compareTabs);
     QAction* quitAct = fileMenu->addAction("Quit", this, &MainTexasWindow::clickedMenuQuit);
     quitAct->setShortcut(QKeySequence::Quit);
 
@@ -102,42 +107,123 @@ void TexasGUI::MainTexasWindow::openFile()
     int dialogResult = fileDialog.exec();
 
     if (dialogResult == QDialog::Accepted)
+        openPath(fileDialog.selectedFiles().first());
+}
+
+void TexasGUI::MainTexasWindow::openPath(QString const& fileName)
+{
+    // Show a placeholder straight away, it gets swapped for the ImageTab once the loading is done.
+    TexasGUI::LoadingTab* loadingTab = new TexasGUI::LoadingTab(fileName);
+    QObject::connect(loadingTab, &LoadingTab::loadFinished, this, &MainTexasWindow::loadFinished);
+
+    int newIndex = this->tabsStackLayout->addWidget(loadingTab);
+
+    QFileInfo fileInfo = QFileInfo(fileName);
+    tabBar->addTab(fileInfo.fileName());
+    this->tabsStackLayout->setCurrentIndex(newIndex);
+    this->tabBar->setCurrentIndex(newIndex);
+}
+
+int TexasGUI::MainTexasWindow::tabCount() const
+{
+    return this->tabsStackLayout->count();
+}
+
+QWidget* TexasGUI::MainTexasWindow::tabWidget(int index) const
+{
+    return this->tabsStackLayout->widget(index);
+}
+
+void TexasGUI::MainTexasWindow::compareTabs()
+{
+    // Only tabs with the whole texture in memory, streamed ones have nothing to compare.
+    QStringList names;
+    QList<std::shared_ptr<Texas::Texture const>> textures;
+    for (int i = 0; i < this->tabsStackLayout->count(); i++)
+    {
+        ImageTab* imageTab = qobject_cast<ImageTab*>(this->tabsStackLayout->widget(i));
+        if (imageTab == nullptr || imageTab->texture() == nullptr)
+            continue;
+        names.append(this->tabBar->tabText(i));
+        textures.append(imageTab->texture());
+    }
+    if (textures.size() < 2)
     {
-        QString fileName = fileDialog.selectedFiles().first();
-        QFile file = QFile(fileName);
-        file.open(QFile::ReadOnly);
-        if (!file.isOpen())
-        {
-            QMessageBox msgBox;
-            msgBox.setText("Unable to open this file.");
-            msgBox.exec();
-            return;
-        }
-
-        QByteArray fileBuffer = file.readAll();
-        file.close();
-
-        std::string tempFilePath = fileDialog.selectedFiles().first().toStdString();
-        Texas::ResultValue<Texas::Texture> loadResult = Texas::loadFromPath(tempFilePath.c_str());
-        if (!loadResult.isSuccessful())
-        {
-            // We couldnt load this file
-            TexasGUI::Utils::displayErrorBox("Unable to load this file.", loadResult.errorMessage());
-            return;
-        }
-        
-        Texas::Texture texture = static_cast<Texas::Texture&&>(loadResult.value());
-
-        //TexasGUI::ImageTab* imageTabWidget = new TexasGUI::ImageTab(file.fileName(), static_cast<Texas::Texture&&>(texture));
-        TexasGUI::ImageTab* imageTabWidget = new TexasGUI::ImageTab("test file name", static_cast<Texas::Texture&&>(texture));
-
-        int newIndex = this->tabsStackLayout->addWidget(imageTabWidget);
-
-        QFileInfo fileInfo = QFileInfo(file);
-        tabBar->addTab(fileInfo.fileName());
-        this->tabsStackLayout->setCurrentIndex(newIndex);
-        this->tabBar->setCurrentIndex(newIndex);
+        TexasGUI::Utils::displayErrorBox("Open at least two textures to compare them.", QString());
+        return;
     }
+
+    QDialog dialog(this);
+    dialog.setWindowTitle("Compare tabs");
+    QFormLayout* formLayout = new QFormLayout;
+    dialog.setLayout(formLayout);
+    QComboBox* dropdownA = new QComboBox;
+    formLayout->addRow("A:", dropdownA);
+    dropdownA->addItems(names);
+    QComboBox* dropdownB = new QComboBox;
+    formLayout->addRow("B:", dropdownB);
+    dropdownB->addItems(names);
+    dropdownB->setCurrentIndex(1);
+    QDialogButtonBox* buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel);
+    formLayout->addRow(buttons);
+    QObject::connect(buttons, SIGNAL(accepted()), &dialog, SLOT(accept()));
+    QObject::connect(buttons, SIGNAL(rejected()), &dialog, SLOT(reject()));
+    if (dialog.exec() != QDialog::Accepted)
+        return;
+
+    int indexA = dropdownA->currentIndex();
+    int indexB = dropdownB->currentIndex();
+    if (!Compare::canCompare(textures[indexA]->textureInfo(), textures[indexB]->textureInfo()))
+    {
+        TexasGUI::Utils::displayErrorBox(
+            "These textures can't be compared.",
+            "Both need the same dimensions, and normalized, float or block compressed channels.");
+        return;
+    }
+
+    TexasGUI::CompareTab* compareTab = new TexasGUI::CompareTab(names[indexA], textures[indexA], names[indexB], textures[indexB]);
+    int newIndex = this->tabsStackLayout->addWidget(compareTab);
+    tabBar->addTab(names[indexA] + " vs " + names[indexB]);
+    this->tabsStackLayout->setCurrentIndex(newIndex);
+    this->tabBar->setCurrentIndex(newIndex);
+}
+
+void TexasGUI::MainTexasWindow::loadFinished(LoadingTab* loadingTab)
+{
+    int index = this->tabsStackLayout->indexOf(loadingTab);
+    if (index < 0)
+        return;
+
+    std::shared_ptr<LoadedTexture> loadedTexture = loadingTab->takeResult();
+    if (!loadedTexture->errorTitle.isEmpty())
+    {
+        this->tabsStackLayout->removeWidget(loadingTab);
+        this->tabBar->removeTab(index);
+        loadingTab->deleteLater();
+        TexasGUI::Utils::displayErrorBox(loadedTexture->errorTitle, loadedTexture->errorDetails);
+        return;
+    }
+
+    TexasGUI::ImageTab* imageTabWidget = nullptr;
+    if (loadedTexture->tiledReader != nullptr)
+    {
+        imageTabWidget = new TexasGUI::ImageTab(
+            loadingTab->fullPath(),
+            loadedTexture->tiledReader);
+    }
+    else
+    {
+        imageTabWidget = new TexasGUI::ImageTab(
+            loadingTab->fullPath(),
+            static_cast<Texas::Texture&&>(loadedTexture->texture),
+            static_cast<MinMaxData&&>(loadedTexture->minMaxData),
+            loadedTexture->baseDisplayData);
+    }
+
+    this->tabsStackLayout->insertWidget(index, imageTabWidget);
+    this->tabsStackLayout->removeWidget(loadingTab);
+    loadingTab->deleteLater();
+    this->tabsStackLayout->setCurrentIndex(this->tabBar->currentIndex());
 }
 
 void TexasGUI::MainTexasWindow::clickedMenuQuit()
@@ -147,8 +233,11 @@ void TexasGUI::MainTexasWindow::clickedMenuQuit()
 
 void TexasGUI::MainTexasWindow::tabCloseRequested(int index)
 {
-    this->tabsStackLayout->removeItem(this->tabsStackLayout->itemAt(index));
+    // Deleting the widget also cancels any load still in flight for a LoadingTab.
+    QWidget* tabWidget = this->tabsStackLayout->widget(index);
+    this->tabsStackLayout->removeWidget(tabWidget);
     this->tabBar->removeTab(index);
+    tabWidget->deleteLater();
 }
 
 void TexasGUI::MainTexasWindow::tabSelectedChanged(int index)
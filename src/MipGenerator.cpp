@@ -0,0 +1,581 @@
+#include "TexasGUI/MipGenerator.hpp"
+
+#include "TexasGUI/ColorSpace.hpp"
+#include "TexasGUI/FormatConverter.hpp"
+#include "TexasGUI/Parallel.hpp"
+#include "TexasGUI/SimdKernels.hpp"
+
+#include "Texas/Tools.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace TexasGUI::Mips
+{
+	char const* toString(Filter filter) noexcept
+	{
+		switch (filter)
+		{
+		case Filter::Box:
+			return "Box";
+		case Filter::Kaiser:
+			return "Kaiser";
+		case Filter::Lanczos:
+			return "Lanczos";
+		default:
+			return "Error";
+		}
+	}
+
+	constexpr double pi = 3.14159265358979323846;
+
+	[[nodiscard]] static double sinc(double x) noexcept
+	{
+		if (std::abs(x) < 1e-9)
+			return 1.0;
+		x *= pi;
+		return std::sin(x) / x;
+	}
+
+	// Modified Bessel function of the first kind, order 0. The series converges quickly for the arguments a window uses.
+	[[nodiscard]] static double besselI0(double x) noexcept
+	{
+		double sum = 1.0;
+		double term = 1.0;
+		double const quarterSquare = x * x / 4.0;
+		for (int k = 1; k < 32; k++)
+		{
+			term *= quarterSquare / (double(k) * double(k));
+			sum += term;
+			if (term < sum * 1e-12)
+				break;
+		}
+		return sum;
+	}
+
+	// Distances are in destination pixels, the filters are zero from radius onwards.
+	struct FilterShape
+	{
+		double radius;
+		double(*evaluate)(double x);
+	};
+
+	[[nodiscard]] static FilterShape toFilterShape(Filter filter) noexcept
+	{
+		switch (filter)
+		{
+		case Filter::Kaiser:
+			// Same width and alpha as NVTT uses for its mips.
+			return { 3.0, [](double x)
+			{
+				constexpr double width = 3.0;
+				constexpr double alpha = 4.0;
+				double const t = x / width;
+				if (t * t >= 1.0)
+					return 0.0;
+				return sinc(x) * besselI0(alpha * std::sqrt(1.0 - t * t)) / besselI0(alpha);
+			} };
+		case Filter::Lanczos:
+			return { 3.0, [](double x)
+			{
+				if (std::abs(x) >= 3.0)
+					return 0.0;
+				return sinc(x) * sinc(x / 3.0);
+			} };
+		default:
+			return { 0.5, [](double x)
+			{
+				x = std::abs(x);
+				return x < 0.5 ? 1.0 : x == 0.5 ? 0.5 : 0.0;
+			} };
+		}
+	}
+
+	// Weights for resampling one axis from srcSize to dstSize pixels, every output pixel reading tapCount
+	// consecutive input pixels. Taps past the edges are folded onto the edge pixel, like clamp to edge addressing.
+	struct AxisFilter
+	{
+		std::uint32_t tapCount = 0;
+		std::vector<std::uint32_t> firstTaps;
+		std::vector<float> weights;
+	};
+
+	[[nodiscard]] static AxisFilter makeAxisFilter(Filter filter, std::uint64_t srcSize, std::uint64_t dstSize)
+	{
+		FilterShape const shape = toFilterShape(filter);
+		double const scale = double(srcSize) / double(dstSize);
+		double const support = shape.radius * scale;
+
+		// Input pixel j is centered on j + 0.5, the ones within support of an output center are read.
+		auto firstInput = [&](std::uint64_t i) { return static_cast<std::int64_t>(std::ceil((i + 0.5) * scale - support - 0.5)); };
+		auto lastInput = [&](std::uint64_t i) { return static_cast<std::int64_t>(std::floor((i + 0.5) * scale + support - 0.5)); };
+
+		AxisFilter result;
+		std::int64_t tapCount = 1;
+		for (std::uint64_t i = 0; i < dstSize; i++)
+			tapCount = std::max(tapCount, lastInput(i) - firstInput(i) + 1);
+		tapCount = std::min(tapCount, static_cast<std::int64_t>(srcSize));
+		result.tapCount = static_cast<std::uint32_t>(tapCount);
+		result.firstTaps.resize(dstSize);
+		result.weights.assign(dstSize * result.tapCount, 0.f);
+
+		std::int64_t const lastIndex = static_cast<std::int64_t>(srcSize) - 1;
+		std::vector<double> weights(result.tapCount);
+		for (std::uint64_t i = 0; i < dstSize; i++)
+		{
+			double const center = (i + 0.5) * scale;
+			std::int64_t const first = firstInput(i);
+			// Keeping the window inside the input means every clamped tap lands within it.
+			std::int64_t const windowStart = std::clamp<std::int64_t>(first, 0, static_cast<std::int64_t>(srcSize) - tapCount);
+			result.firstTaps[i] = static_cast<std::uint32_t>(windowStart);
+
+			std::fill(weights.begin(), weights.end(), 0.0);
+			double sum = 0.0;
+			for (std::int64_t j = first; j <= lastInput(i); j++)
+			{
+				double const weight = shape.evaluate((j + 0.5 - center) / scale);
+				weights[std::clamp<std::int64_t>(j, 0, lastIndex) - windowStart] += weight;
+				sum += weight;
+			}
+			for (std::int64_t k = 0; k < tapCount; k++)
+				result.weights[i * result.tapCount + k] = static_cast<float>(weights[k] / sum);
+		}
+		return result;
+	}
+
+	// Calls func(first, count) on consecutive ranges of [0, itemCount) across the thread pool, with enough
+	// items in each range to be worth handing out. Every item is itemPixels pixels of work.
+	template<typename Func>
+	static void parallelForRanges(
+		std::uint64_t itemCount,
+		std::uint64_t itemPixels,
+		Func const& func,
+		KernelProgress* progress,
+		int maxThreads)
+	{
+		constexpr std::uint64_t pixelsPerRange = 16384;
+		std::uint64_t const itemsPerRange = std::max<std::uint64_t>(pixelsPerRange / std::max<std::uint64_t>(itemPixels, 1), 1);
+		std::uint64_t const rangeCount = (itemCount + itemsPerRange - 1) / itemsPerRange;
+		parallelFor(rangeCount, [&](std::uint64_t rangeIndex)
+		{
+			if (progress != nullptr && progress->cancelled.load(std::memory_order_relaxed))
+				return;
+			std::uint64_t const first = rangeIndex * itemsPerRange;
+			func(first, std::min(itemsPerRange, itemCount - first));
+		}, maxThreads);
+	}
+
+	// Resamples rowCount rows of RGBA floats from srcWidth to dstWidth pixels.
+	static void resampleRows(
+		float const* src,
+		std::uint64_t rowCount,
+		std::uint64_t srcWidth,
+		std::uint64_t dstWidth,
+		Filter filter,
+		float* dst,
+		KernelProgress* progress,
+		int maxThreads)
+	{
+		AxisFilter const axisFilter = makeAxisFilter(filter, srcWidth, dstWidth);
+		parallelForRanges(rowCount, srcWidth, [&](std::uint64_t firstRow, std::uint64_t count)
+		{
+			for (std::uint64_t row = firstRow; row < firstRow + count; row++)
+			{
+				Simd::resampleRowRGBA32F(
+					src + row * srcWidth * 4,
+					axisFilter.firstTaps.data(),
+					axisFilter.weights.data(),
+					axisFilter.tapCount,
+					dstWidth,
+					dst + row * dstWidth * 4);
+			}
+		}, progress, maxThreads);
+	}
+
+	// Resamples along an axis further out than the rows, where the data is outerCount groups of srcSize
+	// runs of innerPixels pixels each. Rows along height and slices along depth both look like this.
+	static void resampleRuns(
+		float const* src,
+		std::uint64_t outerCount,
+		std::uint64_t srcSize,
+		std::uint64_t dstSize,
+		std::uint64_t innerPixels,
+		Filter filter,
+		float* dst,
+		KernelProgress* progress,
+		int maxThreads)
+	{
+		AxisFilter const axisFilter = makeAxisFilter(filter, srcSize, dstSize);
+		parallelForRanges(outerCount * dstSize, innerPixels * axisFilter.tapCount, [&](std::uint64_t firstRun, std::uint64_t count)
+		{
+			std::vector<float const*> runs(axisFilter.tapCount);
+			for (std::uint64_t run = firstRun; run < firstRun + count; run++)
+			{
+				std::uint64_t const outerIndex = run / dstSize;
+				std::uint64_t const dstIndex = run % dstSize;
+				std::uint64_t const firstTap = outerIndex * srcSize + axisFilter.firstTaps[dstIndex];
+				for (std::uint32_t k = 0; k < axisFilter.tapCount; k++)
+					runs[k] = src + (firstTap + k) * innerPixels * 4;
+				Simd::blendRowsRGBA32F(
+					runs.data(),
+					axisFilter.weights.data() + dstIndex * axisFilter.tapCount,
+					axisFilter.tapCount,
+					innerPixels,
+					dst + run * innerPixels * 4);
+			}
+		}, progress, maxThreads);
+	}
+
+	// A level and the one being made from it are both held as RGBA floats, for every layer being worked on at once.
+	constexpr std::uint64_t workingSetBudget = std::uint64_t(512) << 20;
+
+	// Reads every pixel as it is, for axes a level doesn't shrink along.
+	[[nodiscard]] static AxisFilter makeIdentityFilter(std::uint64_t size)
+	{
+		AxisFilter result;
+		result.tapCount = 1;
+		result.firstTaps.resize(size);
+		for (std::uint64_t i = 0; i < size; i++)
+			result.firstTaps[i] = static_cast<std::uint32_t>(i);
+		result.weights.assign(size, 1.f);
+		return result;
+	}
+
+	// Makes one layer of a level from the same layer of the level above, as stored in the texture, a band of rows
+	// at a time, so that neither is ever held as floats in full. For levels where a single layer is over the budget.
+	// Every pixel goes through the same arithmetic as when the whole layer is filtered at once.
+	// With levelFloats the result is also left there as RGBA floats.
+	// Returns false if not even one row fits in the budget, or the job was cancelled.
+	static bool resampleLayerInBands(
+		Convert::RowFunctions const& rowFunctions,
+		bool isSRGB,
+		unsigned char const* src,
+		Texas::Dimensions srcDimensions,
+		unsigned char* dst,
+		Texas::Dimensions dstDimensions,
+		Filter filter,
+		float* levelFloats,
+		KernelProgress* progress,
+		int maxThreads)
+	{
+		std::uint64_t const bytesPerPixel = rowFunctions.bytesPerPixel;
+		std::uint64_t const srcWidth = srcDimensions.width;
+		std::uint64_t const srcHeight = srcDimensions.height;
+		std::uint64_t const dstWidth = dstDimensions.width;
+		std::uint64_t const dstHeight = dstDimensions.height;
+		AxisFilter const heightFilter = dstHeight != srcHeight ? makeAxisFilter(filter, srcHeight, dstHeight) : makeIdentityFilter(dstHeight);
+		AxisFilter const depthFilter = dstDimensions.depth != srcDimensions.depth ?
+			makeAxisFilter(filter, srcDimensions.depth, dstDimensions.depth) :
+			makeIdentityFilter(dstDimensions.depth);
+		std::uint32_t const sliceTaps = depthFilter.tapCount;
+
+		// Each destination row of a band reads at most rowStep more source rows, from every slice it blends,
+		// and a band also reads the taps hanging over its last row.
+		std::uint64_t const rowStep = (srcHeight + dstHeight - 1) / dstHeight;
+		std::uint64_t const rowBytes = (sliceTaps * rowStep * (srcWidth + dstWidth) + sliceTaps * dstWidth + dstWidth) * 16;
+		std::uint64_t const bandOverhead = sliceTaps * heightFilter.tapCount * (srcWidth + dstWidth) * 16;
+		// The other half is for the floats of the first level that is made whole.
+		constexpr std::uint64_t bandBudget = workingSetBudget / 2;
+		if (rowBytes + bandOverhead > bandBudget)
+			return false;
+		std::uint64_t const bandRows = std::clamp<std::uint64_t>((bandBudget - bandOverhead) / rowBytes, 1, dstHeight);
+
+		std::vector<float> loaded;
+		std::vector<float> narrowed;
+		std::vector<float> shortened;
+		std::vector<float> thinned;
+		for (std::uint64_t z = 0; z < dstDimensions.depth; z++)
+		{
+			std::uint64_t const firstSlice = depthFilter.firstTaps[z];
+			for (std::uint64_t firstRow = 0; firstRow < dstHeight; firstRow += bandRows)
+			{
+				if (progress != nullptr && progress->cancelled.load(std::memory_order_relaxed))
+					return false;
+
+				std::uint64_t const rowCount = std::min(bandRows, dstHeight - firstRow);
+				std::uint64_t const firstSrcRow = heightFilter.firstTaps[firstRow];
+				std::uint64_t const srcRowCount = heightFilter.firstTaps[firstRow + rowCount - 1] + heightFilter.tapCount - firstSrcRow;
+
+				// The source rows of the band, from every slice it blends, one after the other.
+				loaded.resize(sliceTaps * srcRowCount * srcWidth * 4);
+				parallelForRanges(sliceTaps * srcRowCount, srcWidth, [&](std::uint64_t first, std::uint64_t count)
+				{
+					for (std::uint64_t row = first; row < first + count; row++)
+					{
+						std::uint64_t const srcRow = (firstSlice + row / srcRowCount) * srcHeight + firstSrcRow + row % srcRowCount;
+						rowFunctions.loadRow(
+							src + srcRow * srcWidth * bytesPerPixel,
+							srcWidth,
+							isSRGB,
+							loaded.data() + row * srcWidth * 4);
+					}
+				}, progress, maxThreads);
+				float const* current = loaded.data();
+
+				if (dstWidth != srcWidth)
+				{
+					narrowed.resize(sliceTaps * srcRowCount * dstWidth * 4);
+					resampleRows(current, sliceTaps * srcRowCount, srcWidth, dstWidth, filter, narrowed.data(), progress, maxThreads);
+					current = narrowed.data();
+				}
+
+				if (dstHeight != srcHeight)
+				{
+					shortened.resize(sliceTaps * rowCount * dstWidth * 4);
+					parallelForRanges(sliceTaps * rowCount, dstWidth * heightFilter.tapCount, [&](std::uint64_t first, std::uint64_t count)
+					{
+						std::vector<float const*> runs(heightFilter.tapCount);
+						for (std::uint64_t item = first; item < first + count; item++)
+						{
+							std::uint64_t const slice = item / rowCount;
+							std::uint64_t const dstRow = firstRow + item % rowCount;
+							std::uint64_t const firstTap = slice * srcRowCount + heightFilter.firstTaps[dstRow] - firstSrcRow;
+							for (std::uint32_t k = 0; k < heightFilter.tapCount; k++)
+								runs[k] = current + (firstTap + k) * dstWidth * 4;
+							Simd::blendRowsRGBA32F(
+								runs.data(),
+								heightFilter.weights.data() + dstRow * heightFilter.tapCount,
+								heightFilter.tapCount,
+								dstWidth,
+								shortened.data() + item * dstWidth * 4);
+						}
+					}, progress, maxThreads);
+					current = shortened.data();
+				}
+
+				if (dstDimensions.depth != srcDimensions.depth)
+				{
+					thinned.resize(rowCount * dstWidth * 4);
+					parallelForRanges(rowCount, dstWidth * sliceTaps, [&](std::uint64_t first, std::uint64_t count)
+					{
+						std::vector<float const*> runs(sliceTaps);
+						for (std::uint32_t k = 0; k < sliceTaps; k++)
+							runs[k] = current + (k * rowCount + first) * dstWidth * 4;
+						Simd::blendRowsRGBA32F(
+							runs.data(),
+							depthFilter.weights.data() + z * sliceTaps,
+							sliceTaps,
+							count * dstWidth,
+							thinned.data() + first * dstWidth * 4);
+					}, progress, maxThreads);
+					current = thinned.data();
+				}
+
+				parallelForRanges(rowCount, dstWidth, [&](std::uint64_t first, std::uint64_t count)
+				{
+					for (std::uint64_t row = first; row < first + count; row++)
+					{
+						std::uint64_t const dstRow = z * dstHeight + firstRow + row;
+						rowFunctions.storeRow(
+							current + row * dstWidth * 4,
+							dstWidth,
+							isSRGB,
+							dst + dstRow * dstWidth * bytesPerPixel);
+						if (levelFloats != nullptr)
+							std::memcpy(levelFloats + dstRow * dstWidth * 4, current + row * dstWidth * 4, dstWidth * 16);
+					}
+				}, progress, maxThreads);
+			}
+		}
+		return progress == nullptr || !progress->cancelled.load(std::memory_order_relaxed);
+	}
+}
+
+std::uint64_t TexasGUI::Mips::fullMipCount(Texas::Dimensions baseDimensions) noexcept
+{
+	std::uint64_t largest = std::max({ baseDimensions.width, baseDimensions.height, baseDimensions.depth });
+	std::uint64_t count = 1;
+	while (largest > 1)
+	{
+		largest >>= 1;
+		count++;
+	}
+	return count;
+}
+
+bool TexasGUI::Mips::canGenerate(Texas::TextureInfo const& texInfo) noexcept
+{
+	return Convert::findRowFunctions(texInfo.pixelFormat, texInfo.channelType) != nullptr;
+}
+
+bool TexasGUI::Mips::generateMipChain(
+	Texas::TextureInfo const& srcInfo,
+	Texas::ConstByteSpan srcData,
+	Filter filter,
+	Texas::TextureInfo& dstInfo,
+	std::vector<std::byte>& dstData,
+	KernelProgress* progress,
+	int maxThreads)
+{
+	Convert::RowFunctions const* rowFunctions = Convert::findRowFunctions(srcInfo.pixelFormat, srcInfo.channelType);
+	if (rowFunctions == nullptr || srcInfo.mipCount == 0 || srcInfo.layerCount == 0)
+		return false;
+
+	dstInfo = srcInfo;
+	dstInfo.mipCount = fullMipCount(srcInfo.baseDimensions);
+	dstData.resize(Texas::calculateTotalSize(dstInfo));
+
+	bool const isSRGB = !rowFunctions->isFloat && ColorSpace::isSRGBEncoded(srcInfo);
+	Texas::Dimensions const baseDimensions = srcInfo.baseDimensions;
+	std::uint64_t const basePixelCount = baseDimensions.width * baseDimensions.height * baseDimensions.depth;
+	std::uint64_t const bytesPerPixel = rowFunctions->bytesPerPixel;
+
+	// The base level is kept exactly as it was, every layer of it in one go.
+	std::memcpy(
+		dstData.data() + Texas::calculateMipOffset(dstInfo, 0),
+		srcData.data() + Texas::calculateMipOffset(srcInfo, 0),
+		basePixelCount * bytesPerPixel * srcInfo.layerCount);
+
+	// Huge arrays are split into batches of layers so the levels being worked on stay within the budget.
+	// The first levels of layers too large for it on their own are made in bands of rows, each from the level
+	// above as stored, so past the first of them 8-bit formats get rounded once more along the way.
+	auto layerWorkingSet = [&baseDimensions](std::uint64_t mipIndex)
+	{
+		Texas::Dimensions const dimensions = Texas::calculateMipDimensions(baseDimensions, mipIndex);
+		return dimensions.width * dimensions.height * dimensions.depth * 16 * 2;
+	};
+	std::uint64_t firstWholeLevel = 0;
+	while (layerWorkingSet(firstWholeLevel) > workingSetBudget)
+		firstWholeLevel++;
+	Texas::Dimensions const wholeDimensions = Texas::calculateMipDimensions(baseDimensions, firstWholeLevel);
+	std::uint64_t const wholePixelCount = wholeDimensions.width * wholeDimensions.height * wholeDimensions.depth;
+	std::uint64_t const batchSize = std::clamp<std::uint64_t>(workingSetBudget / layerWorkingSet(firstWholeLevel), 1, srcInfo.layerCount);
+	std::uint64_t const batchCount = (srcInfo.layerCount + batchSize - 1) / batchSize;
+	if (progress != nullptr)
+		progress->totalUnits.store((dstInfo.mipCount - 1) * batchCount);
+
+	// Each pass reads one buffer and writes the other.
+	std::vector<float> buffers[2];
+	unsigned char* dstBytes = reinterpret_cast<unsigned char*>(dstData.data());
+	for (std::uint64_t batchIndex = 0; batchIndex < batchCount; batchIndex++)
+	{
+		std::uint64_t const firstLayer = batchIndex * batchSize;
+		std::uint64_t const layerCount = std::min(batchSize, srcInfo.layerCount - firstLayer);
+
+		int current = 0;
+		buffers[current].resize(wholePixelCount * layerCount * 4);
+		if (firstWholeLevel == 0)
+		{
+			// Layers of a level are next to each other, so their rows can be treated as one long run of rows.
+			unsigned char const* srcBase = reinterpret_cast<unsigned char const*>(srcData.data()) +
+				Texas::calculateLayerOffset(srcInfo, 0, firstLayer);
+			parallelForRanges(layerCount * baseDimensions.depth * baseDimensions.height, baseDimensions.width,
+				[&](std::uint64_t firstRow, std::uint64_t count)
+			{
+				for (std::uint64_t row = firstRow; row < firstRow + count; row++)
+				{
+					rowFunctions->loadRow(
+						srcBase + row * baseDimensions.width * bytesPerPixel,
+						baseDimensions.width,
+						isSRGB,
+						buffers[current].data() + row * baseDimensions.width * 4);
+				}
+			}, progress, maxThreads);
+		}
+		else
+		{
+			// Left over from the previous batch, and not needed until the bands are done.
+			buffers[1 - current] = std::vector<float>();
+		}
+		for (std::uint64_t mipIndex = 1; mipIndex <= firstWholeLevel; mipIndex++)
+		{
+			for (std::uint64_t layerIndex = firstLayer; layerIndex < firstLayer + layerCount; layerIndex++)
+			{
+				bool const generated = resampleLayerInBands(
+					*rowFunctions,
+					isSRGB,
+					dstBytes + Texas::calculateLayerOffset(dstInfo, mipIndex - 1, layerIndex),
+					Texas::calculateMipDimensions(baseDimensions, mipIndex - 1),
+					dstBytes + Texas::calculateLayerOffset(dstInfo, mipIndex, layerIndex),
+					Texas::calculateMipDimensions(baseDimensions, mipIndex),
+					filter,
+					mipIndex == firstWholeLevel ? buffers[current].data() + (layerIndex - firstLayer) * wholePixelCount * 4 : nullptr,
+					progress,
+					maxThreads);
+				if (!generated)
+					return false;
+			}
+			if (progress != nullptr)
+				progress->completedUnits.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		Texas::Dimensions srcDimensions = wholeDimensions;
+		for (std::uint64_t mipIndex = firstWholeLevel + 1; mipIndex < dstInfo.mipCount; mipIndex++)
+		{
+			if (progress != nullptr && progress->cancelled.load(std::memory_order_relaxed))
+				return false;
+
+			Texas::Dimensions const dstDimensions = Texas::calculateMipDimensions(baseDimensions, mipIndex);
+			// Separable, so one axis at a time, narrowest result first.
+			Texas::Dimensions dimensions = srcDimensions;
+			if (dstDimensions.width != dimensions.width)
+			{
+				buffers[1 - current].resize(layerCount * dimensions.depth * dimensions.height * dstDimensions.width * 4);
+				resampleRows(
+					buffers[current].data(),
+					layerCount * dimensions.depth * dimensions.height,
+					dimensions.width,
+					dstDimensions.width,
+					filter,
+					buffers[1 - current].data(),
+					progress,
+					maxThreads);
+				dimensions.width = dstDimensions.width;
+				current = 1 - current;
+			}
+			if (dstDimensions.height != dimensions.height)
+			{
+				buffers[1 - current].resize(layerCount * dimensions.depth * dstDimensions.height * dimensions.width * 4);
+				resampleRuns(
+					buffers[current].data(),
+					layerCount * dimensions.depth,
+					dimensions.height,
+					dstDimensions.height,
+					dimensions.width,
+					filter,
+					buffers[1 - current].data(),
+					progress,
+					maxThreads);
+				dimensions.height = dstDimensions.height;
+				current = 1 - current;
+			}
+			if (dstDimensions.depth != dimensions.depth)
+			{
+				buffers[1 - current].resize(layerCount * dstDimensions.depth * dimensions.height * dimensions.width * 4);
+				resampleRuns(
+					buffers[current].data(),
+					layerCount,
+					dimensions.depth,
+					dstDimensions.depth,
+					dimensions.height * dimensions.width,
+					filter,
+					buffers[1 - current].data(),
+					progress,
+					maxThreads);
+				dimensions.depth = dstDimensions.depth;
+				current = 1 - current;
+			}
+
+			unsigned char* dstBase = dstBytes + Texas::calculateLayerOffset(dstInfo, mipIndex, firstLayer);
+			parallelForRanges(layerCount * dstDimensions.depth * dstDimensions.height, dstDimensions.width,
+				[&](std::uint64_t firstRow, std::uint64_t count)
+			{
+				for (std::uint64_t row = firstRow; row < firstRow + count; row++)
+				{
+					rowFunctions->storeRow(
+						buffers[current].data() + row * dstDimensions.width * 4,
+						dstDimensions.width,
+						isSRGB,
+						dstBase + row * dstDimensions.width * bytesPerPixel);
+				}
+			}, progress, maxThreads);
+
+			srcDimensions = dstDimensions;
+			if (progress != nullptr)
+				progress->completedUnits.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	return progress == nullptr || !progress->cancelled.load(std::memory_order_relaxed);
+}
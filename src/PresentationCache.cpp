@@ -0,0 +1,44 @@
+#include "PresentationCache.hpp"
+
+#include <algorithm>
+#include <climits>
+
+TexasGUI::PresentationCache::PresentationCache(std::uint64_t memoryBudget)
+{
+	setMemoryBudget(memoryBudget);
+}
+
+bool TexasGUI::PresentationCache::find(PresentationKey const& key, QPixmap& pixmap)
+{
+	QPixmap const* cached = this->pixmaps.object(key);
+	if (cached == nullptr)
+		return false;
+	pixmap = *cached;
+	return true;
+}
+
+void TexasGUI::PresentationCache::insert(PresentationKey const& key, QPixmap const& pixmap)
+{
+	int const cost = std::max(1, static_cast<int>(std::int64_t(pixmap.width()) * pixmap.height() * 4 / 1024));
+	this->pixmaps.insert(key, new QPixmap(pixmap), cost);
+}
+
+void TexasGUI::PresentationCache::clear()
+{
+	this->pixmaps.clear();
+}
+
+void TexasGUI::PresentationCache::setMemoryBudget(std::uint64_t memoryBudget)
+{
+	this->pixmaps.setMaxCost(static_cast<int>(std::min<std::uint64_t>(memoryBudget / 1024, INT_MAX)));
+}
+
+std::uint64_t TexasGUI::PresentationCache::memoryBudget() const
+{
+	return std::uint64_t(this->pixmaps.maxCost()) * 1024;
+}
+
+std::uint64_t TexasGUI::PresentationCache::memoryUsage() const
+{
+	return std::uint64_t(this->pixmaps.totalCost()) * 1024;
+}
@@ -0,0 +1,1448 @@
+#include "TexasGUI/SimdKernels.hpp"
+
+#include "TexasGUI/ColorSpace.hpp"
+#include "TexasGUI/FormatTraits.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#ifdef TEXASGUI_SIMD_X86
+#	include <emmintrin.h>
+#	ifdef _MSC_VER
+#		include <intrin.h>
+#	else
+#		include <cpuid.h>
+#	endif
+#endif
+
+namespace TexasGUI::Simd
+{
+	[[nodiscard]] static InstructionSet detectHardware() noexcept
+	{
+#ifdef TEXASGUI_SIMD_X86
+		unsigned int leaf1[4] = {};
+		unsigned int leaf7[4] = {};
+#	ifdef _MSC_VER
+		int regs[4] = {};
+		__cpuid(regs, 1);
+		for (int i = 0; i < 4; i += 1)
+			leaf1[i] = static_cast<unsigned int>(regs[i]);
+		__cpuidex(regs, 7, 0);
+		for (int i = 0; i < 4; i += 1)
+			leaf7[i] = static_cast<unsigned int>(regs[i]);
+#	else
+		__get_cpuid(1, &leaf1[0], &leaf1[1], &leaf1[2], &leaf1[3]);
+		__get_cpuid_count(7, 0, &leaf7[0], &leaf7[1], &leaf7[2], &leaf7[3]);
+#	endif
+
+		bool const hasSSSE3 = (leaf1[2] & (1u << 9)) != 0;
+		bool const hasOSXSAVE = (leaf1[2] & (1u << 27)) != 0;
+		bool const hasAVX = (leaf1[2] & (1u << 28)) != 0;
+		bool const hasF16C = (leaf1[2] & (1u << 29)) != 0;
+		bool const hasAVX2 = (leaf7[1] & (1u << 5)) != 0;
+
+		// The CPU supporting AVX isn't enough, the OS also has to save the YMM registers.
+		bool osSavesYMM = false;
+		if (hasOSXSAVE)
+		{
+#	ifdef _MSC_VER
+			unsigned long long xcr0 = _xgetbv(0);
+#	else
+			unsigned int xcr0Low = 0;
+			unsigned int xcr0High = 0;
+			__asm__ volatile("xgetbv" : "=a"(xcr0Low), "=d"(xcr0High) : "c"(0));
+			unsigned long long xcr0 = (static_cast<unsigned long long>(xcr0High) << 32) | xcr0Low;
+#	endif
+			osSavesYMM = (xcr0 & 0x6) == 0x6;
+		}
+
+		// The AVX2 tier also converts halves with F16C, every CPU with AVX2 has it.
+		if (hasAVX && hasAVX2 && hasF16C && osSavesYMM)
+			return InstructionSet::AVX2;
+		if (hasSSSE3)
+			return InstructionSet::SSSE3;
+		// SSE2 is part of x86-64.
+		return InstructionSet::SSE2;
+#else
+		return InstructionSet::Scalar;
+#endif
+	}
+
+	[[nodiscard]] static std::atomic<InstructionSet>& activeInstructionSet() noexcept
+	{
+		static std::atomic<InstructionSet> active{ detectInstructionSet() };
+		return active;
+	}
+
+	InstructionSet detectInstructionSet() noexcept
+	{
+		static InstructionSet const hardware = detectHardware();
+		return hardware;
+	}
+
+	char const* toString(InstructionSet instructionSet) noexcept
+	{
+		switch (instructionSet)
+		{
+		case InstructionSet::Scalar:
+			return "Scalar";
+		case InstructionSet::SSE2:
+			return "SSE2";
+		case InstructionSet::SSSE3:
+			return "SSSE3";
+		case InstructionSet::AVX2:
+			return "AVX2";
+		default:
+			return "Error";
+		}
+	}
+
+	void forceInstructionSet(InstructionSet instructionSet) noexcept
+	{
+		InstructionSet hardware = detectInstructionSet();
+		if (static_cast<int>(instructionSet) > static_cast<int>(hardware))
+			instructionSet = hardware;
+		activeInstructionSet().store(instructionSet);
+	}
+
+	void expandRGB8ToRGBA8(
+		unsigned char const* src,
+		std::uint64_t pixelCount,
+		unsigned char* dst) noexcept
+	{
+		switch (activeInstructionSet().load(std::memory_order_relaxed))
+		{
+#ifdef TEXASGUI_SIMD_X86
+		case InstructionSet::AVX2:
+			Detail::expandRGB8ToRGBA8_AVX2(src, pixelCount, dst);
+			return;
+		case InstructionSet::SSSE3:
+			Detail::expandRGB8ToRGBA8_SSSE3(src, pixelCount, dst);
+			return;
+#endif
+		default:
+			Detail::expandRGB8ToRGBA8_Scalar(src, pixelCount, dst);
+			return;
+		}
+	}
+
+	void expandRGB8ToRGBA8MinMax(
+		unsigned char const* src,
+		std::uint64_t pixelCount,
+		unsigned char* dst,
+		std::uint8_t* min,
+		std::uint8_t* max) noexcept
+	{
+		switch (activeInstructionSet().load(std::memory_order_relaxed))
+		{
+#ifdef TEXASGUI_SIMD_X86
+		case InstructionSet::AVX2:
+			Detail::expandRGB8ToRGBA8MinMax_AVX2(src, pixelCount, dst, min, max);
+			return;
+		case InstructionSet::SSSE3:
+			Detail::expandRGB8ToRGBA8MinMax_SSSE3(src, pixelCount, dst, min, max);
+			return;
+#endif
+		default:
+			Detail::expandRGB8ToRGBA8MinMax_Scalar(src, pixelCount, dst, min, max);
+			return;
+		}
+	}
+
+	void copyRGBA8MinMax(
+		unsigned char const* src,
+		std::uint64_t pixelCount,
+		unsigned char* dst,
+		std::uint8_t* min,
+		std::uint8_t* max) noexcept
+	{
+		switch (activeInstructionSet().load(std::memory_order_relaxed))
+		{
+#ifdef TEXASGUI_SIMD_X86
+		case InstructionSet::AVX2:
+			Detail::copyRGBA8MinMax_AVX2(src, pixelCount, dst, min, max);
+			return;
+		case InstructionSet::SSSE3:
+		case InstructionSet::SSE2:
+			Detail::copyRGBA8MinMax_SSE2(src, pixelCount, dst, min, max);
+			return;
+#endif
+		default:
+			Detail::copyRGBA8MinMax_Scalar(src, pixelCount, dst, min, max);
+			return;
+		}
+	}
+
+	void minMaxU8(
+		unsigned char const* src,
+		std::uint64_t pixelCount,
+		std::uint8_t channelCount,
+		std::uint8_t* min,
+		std::uint8_t* max) noexcept
+	{
+		switch (activeInstructionSet().load(std::memory_order_relaxed))
+		{
+#ifdef TEXASGUI_SIMD_X86
+		case InstructionSet::AVX2:
+			Detail::minMaxU8_AVX2(src, pixelCount, channelCount, min, max);
+			return;
+		case InstructionSet::SSSE3:
+		case InstructionSet::SSE2:
+			Detail::minMaxU8_SSE2(src, pixelCount, channelCount, min, max);
+			return;
+#endif
+		default:
+			Detail::minMaxU8_Scalar(src, pixelCount, channelCount, min, max);
+			return;
+		}
+	}
+
+	void halfToFloat(
+		std::uint16_t const* src,
+		std::uint64_t count,
+		float* dst) noexcept
+	{
+		switch (activeInstructionSet().load(std::memory_order_relaxed))
+		{
+#ifdef TEXASGUI_SIMD_X86
+		case InstructionSet::AVX2:
+			Detail::halfToFloat_AVX2(src, count, dst);
+			return;
+		case InstructionSet::SSSE3:
+		case InstructionSet::SSE2:
+			Detail::halfToFloat_SSE2(src, count, dst);
+			return;
+#endif
+		default:
+			Detail::halfToFloat_Scalar(src, count, dst);
+			return;
+		}
+	}
+
+	void floatToHalf(
+		float const* src,
+		std::uint64_t count,
+		std::uint16_t* dst) noexcept
+	{
+		switch (activeInstructionSet().load(std::memory_order_relaxed))
+		{
+#ifdef TEXASGUI_SIMD_X86
+		case InstructionSet::AVX2:
+			Detail::floatToHalf_AVX2(src, count, dst);
+			return;
+		case InstructionSet::SSSE3:
+		case InstructionSet::SSE2:
+			Detail::floatToHalf_SSE2(src, count, dst);
+			return;
+#endif
+		default:
+			Detail::floatToHalf_Scalar(src, count, dst);
+			return;
+		}
+	}
+
+	void swapRedBlue8(
+		unsigned char const* src,
+		std::uint64_t pixelCount,
+		unsigned char* dst) noexcept
+	{
+		switch (activeInstructionSet().load(std::memory_order_relaxed))
+		{
+#ifdef TEXASGUI_SIMD_X86
+		case InstructionSet::AVX2:
+			Detail::swapRedBlue8_AVX2(src, pixelCount, dst);
+			return;
+		case InstructionSet::SSSE3:
+			Detail::swapRedBlue8_SSSE3(src, pixelCount, dst);
+			return;
+		case InstructionSet::SSE2:
+			Detail::swapRedBlue8_SSE2(src, pixelCount, dst);
+			return;
+#endif
+		default:
+			Detail::swapRedBlue8_Scalar(src, pixelCount, dst);
+			return;
+		}
+	}
+
+	void unorm16ToUnorm8(
+		std::uint16_t const* src,
+		std::uint64_t count,
+		std::uint8_t* dst) noexcept
+	{
+		switch (activeInstructionSet().load(std::memory_order_relaxed))
+		{
+#ifdef TEXASGUI_SIMD_X86
+		case InstructionSet::AVX2:
+			Detail::unorm16ToUnorm8_AVX2(src, count, dst);
+			return;
+		case InstructionSet::SSSE3:
+		case InstructionSet::SSE2:
+			Detail::unorm16ToUnorm8_SSE2(src, count, dst);
+			return;
+#endif
+		default:
+			Detail::unorm16ToUnorm8_Scalar(src, count, dst);
+			return;
+		}
+	}
+
+	void unorm8ToUnorm16(
+		std::uint8_t const* src,
+		std::uint64_t count,
+		std::uint16_t* dst) noexcept
+	{
+		switch (activeInstructionSet().load(std::memory_order_relaxed))
+		{
+#ifdef TEXASGUI_SIMD_X86
+		// Memory bound, wider vectors don't buy anything.
+		case InstructionSet::AVX2:
+		case InstructionSet::SSSE3:
+		case InstructionSet::SSE2:
+			Detail::unorm8ToUnorm16_SSE2(src, count, dst);
+			return;
+#endif
+		default:
+			Detail::unorm8ToUnorm16_Scalar(src, count, dst);
+			return;
+		}
+	}
+
+	void decodeSRGBRGBA32F(
+		float* rgba,
+		std::uint64_t pixelCount) noexcept
+	{
+		switch (activeInstructionSet().load(std::memory_order_relaxed))
+		{
+#ifdef TEXASGUI_SIMD_X86
+		case InstructionSet::AVX2:
+			Detail::decodeSRGBRGBA32F_AVX2(rgba, pixelCount);
+			return;
+		case InstructionSet::SSSE3:
+		case InstructionSet::SSE2:
+			Detail::decodeSRGBRGBA32F_SSE2(rgba, pixelCount);
+			return;
+#endif
+		default:
+			Detail::decodeSRGBRGBA32F_Scalar(rgba, pixelCount);
+			return;
+		}
+	}
+
+	void encodeSRGBRGBA32F(
+		float* rgba,
+		std::uint64_t pixelCount) noexcept
+	{
+		switch (activeInstructionSet().load(std::memory_order_relaxed))
+		{
+#ifdef TEXASGUI_SIMD_X86
+		case InstructionSet::AVX2:
+			Detail::encodeSRGBRGBA32F_AVX2(rgba, pixelCount);
+			return;
+		case InstructionSet::SSSE3:
+		case InstructionSet::SSE2:
+			Detail::encodeSRGBRGBA32F_SSE2(rgba, pixelCount);
+			return;
+#endif
+		default:
+			Detail::encodeSRGBRGBA32F_Scalar(rgba, pixelCount);
+			return;
+		}
+	}
+
+	void decodeSRGBRGBA8ToRGBA32F(
+		unsigned char const* src,
+		std::uint64_t pixelCount,
+		float* dst) noexcept
+	{
+		switch (activeInstructionSet().load(std::memory_order_relaxed))
+		{
+#ifdef TEXASGUI_SIMD_X86
+		// Only gathers help with table lookups, SSE2 has nothing over scalar code.
+		case InstructionSet::AVX2:
+			Detail::decodeSRGBRGBA8ToRGBA32F_AVX2(src, pixelCount, dst);
+			return;
+#endif
+		default:
+			Detail::decodeSRGBRGBA8ToRGBA32F_Scalar(src, pixelCount, dst);
+			return;
+		}
+	}
+
+	void encodeSRGBRGBA32FToRGBA8(
+		float const* src,
+		std::uint64_t pixelCount,
+		unsigned char* dst) noexcept
+	{
+		switch (activeInstructionSet().load(std::memory_order_relaxed))
+		{
+#ifdef TEXASGUI_SIMD_X86
+		case InstructionSet::AVX2:
+			Detail::encodeSRGBRGBA32FToRGBA8_AVX2(src, pixelCount, dst);
+			return;
+		case InstructionSet::SSSE3:
+		case InstructionSet::SSE2:
+			Detail::encodeSRGBRGBA32FToRGBA8_SSE2(src, pixelCount, dst);
+			return;
+#endif
+		default:
+			Detail::encodeSRGBRGBA32FToRGBA8_Scalar(src, pixelCount, dst);
+			return;
+		}
+	}
+
+	void toneMapRGBA32FToRGBA8(
+		float const* src,
+		std::uint64_t pixelCount,
+		float const* scale,
+		float const* offset,
+		ToneMapOperator toneMapOperator,
+		bool encodeSRGB,
+		unsigned char* dst) noexcept
+	{
+		switch (activeInstructionSet().load(std::memory_order_relaxed))
+		{
+#ifdef TEXASGUI_SIMD_X86
+		case InstructionSet::AVX2:
+		case InstructionSet::SSSE3:
+		case InstructionSet::SSE2:
+			Detail::toneMapRGBA32FToRGBA8_SSE2(src, pixelCount, scale, offset, toneMapOperator, encodeSRGB, dst);
+			return;
+#endif
+		default:
+			Detail::toneMapRGBA32FToRGBA8_Scalar(src, pixelCount, scale, offset, toneMapOperator, encodeSRGB, dst);
+			return;
+		}
+	}
+
+	void resampleRowRGBA32F(
+		float const* src,
+		std::uint32_t const* firstTaps,
+		float const* weights,
+		std::uint32_t tapCount,
+		std::uint64_t dstCount,
+		float* dst) noexcept
+	{
+		switch (activeInstructionSet().load(std::memory_order_relaxed))
+		{
+#ifdef TEXASGUI_SIMD_X86
+		// A pixel is exactly one SSE vector, wider vectors don't help with gathering the taps.
+		case InstructionSet::AVX2:
+		case InstructionSet::SSSE3:
+		case InstructionSet::SSE2:
+			Detail::resampleRowRGBA32F_SSE2(src, firstTaps, weights, tapCount, dstCount, dst);
+			return;
+#endif
+		default:
+			Detail::resampleRowRGBA32F_Scalar(src, firstTaps, weights, tapCount, dstCount, dst);
+			return;
+		}
+	}
+
+	void blendRowsRGBA32F(
+		float const* const* rows,
+		float const* weights,
+		std::uint32_t rowCount,
+		std::uint64_t pixelCount,
+		float* dst) noexcept
+	{
+		switch (activeInstructionSet().load(std::memory_order_relaxed))
+		{
+#ifdef TEXASGUI_SIMD_X86
+		case InstructionSet::AVX2:
+			Detail::blendRowsRGBA32F_AVX2(rows, weights, rowCount, pixelCount, dst);
+			return;
+		case InstructionSet::SSSE3:
+		case InstructionSet::SSE2:
+			Detail::blendRowsRGBA32F_SSE2(rows, weights, rowCount, pixelCount, dst);
+			return;
+#endif
+		default:
+			Detail::blendRowsRGBA32F_Scalar(rows, weights, rowCount, pixelCount, dst);
+			return;
+		}
+	}
+
+	void sumSquaredErrorRGBA32F(
+		float const* a,
+		float const* b,
+		std::uint64_t pixelCount,
+		double* sums) noexcept
+	{
+		switch (activeInstructionSet().load(std::memory_order_relaxed))
+		{
+#ifdef TEXASGUI_SIMD_X86
+		case InstructionSet::AVX2:
+			Detail::sumSquaredErrorRGBA32F_AVX2(a, b, pixelCount, sums);
+			return;
+		case InstructionSet::SSSE3:
+		case InstructionSet::SSE2:
+			Detail::sumSquaredErrorRGBA32F_SSE2(a, b, pixelCount, sums);
+			return;
+#endif
+		default:
+			Detail::sumSquaredErrorRGBA32F_Scalar(a, b, pixelCount, sums);
+			return;
+		}
+	}
+
+	void ssimBlockSumsRGBA32F(
+		float const* a,
+		float const* b,
+		std::uint64_t rowStride,
+		std::uint64_t blockCount,
+		float* sums) noexcept
+	{
+		switch (activeInstructionSet().load(std::memory_order_relaxed))
+		{
+#ifdef TEXASGUI_SIMD_X86
+		case InstructionSet::AVX2:
+			Detail::ssimBlockSumsRGBA32F_AVX2(a, b, rowStride, blockCount, sums);
+			return;
+		case InstructionSet::SSSE3:
+		case InstructionSet::SSE2:
+			Detail::ssimBlockSumsRGBA32F_SSE2(a, b, rowStride, blockCount, sums);
+			return;
+#endif
+		default:
+			Detail::ssimBlockSumsRGBA32F_Scalar(a, b, rowStride, blockCount, sums);
+			return;
+		}
+	}
+}
+
+namespace TexasGUI::Simd::Detail
+{
+	// ColorSpace::linearToSRGB8 with the tables already at hand, value has to be clamped to [0, 1] already.
+	[[nodiscard]] static std::uint8_t encodeSRGB8(float value, ColorSpace::Detail::SRGB8Tables const& tables) noexcept
+	{
+		int const code = tables.buckets[static_cast<int>(value * ColorSpace::Detail::srgb8BucketCount)];
+		return static_cast<std::uint8_t>(code + (value >= tables.thresholds[code] ? 1 : 0));
+	}
+
+	[[nodiscard]] static float toneMap(float value, ToneMapOperator toneMapOperator) noexcept
+	{
+		switch (toneMapOperator)
+		{
+		case ToneMapOperator::Reinhard:
+			return value / (1.f + value);
+		case ToneMapOperator::ACES:
+			return value * (2.51f * value + 0.03f) / (value * (2.43f * value + 0.59f) + 0.14f);
+		default:
+			return value;
+		}
+	}
+}
+
+void TexasGUI::Simd::Detail::halfToFloat_Scalar(
+	std::uint16_t const* src,
+	std::uint64_t count,
+	float* dst) noexcept
+{
+	// Same rebiasing trick as the SSE2 version, one value at a time.
+	float const rebias = 0x1p112f;
+	for (std::uint64_t i = 0; i < count; i++)
+	{
+		std::uint32_t const shifted = std::uint32_t(src[i] & 0x7FFF) << 13;
+		std::uint32_t const sign = std::uint32_t(src[i] & 0x8000) << 16;
+		std::uint32_t magnitude;
+		if (shifted >= (0x7C00u << 13))
+			magnitude = shifted | 0x7F800000 | (shifted > (0x7C00u << 13) ? 0x00400000 : 0);
+		else
+		{
+			float value;
+			std::memcpy(&value, &shifted, sizeof(value));
+			value *= rebias;
+			std::memcpy(&magnitude, &value, sizeof(magnitude));
+		}
+		std::uint32_t const bits = magnitude | sign;
+		std::memcpy(&dst[i], &bits, sizeof(bits));
+	}
+}
+
+void TexasGUI::Simd::Detail::floatToHalf_Scalar(
+	float const* src,
+	std::uint64_t count,
+	std::uint16_t* dst) noexcept
+{
+	for (std::uint64_t i = 0; i < count; i++)
+		dst[i] = TexasGUI::floatToHalf(src[i]);
+}
+
+void TexasGUI::Simd::Detail::swapRedBlue8_Scalar(
+	unsigned char const* src,
+	std::uint64_t pixelCount,
+	unsigned char* dst) noexcept
+{
+	for (std::uint64_t pixelIndex = 0; pixelIndex < pixelCount; pixelIndex++)
+	{
+		unsigned char const* srcPixel = src + pixelIndex * 4;
+		unsigned char* dstPixel = dst + pixelIndex * 4;
+
+		// src and dst may be the same.
+		unsigned char const red = srcPixel[0];
+		dstPixel[0] = srcPixel[2];
+		dstPixel[1] = srcPixel[1];
+		dstPixel[2] = red;
+		dstPixel[3] = srcPixel[3];
+	}
+}
+
+void TexasGUI::Simd::Detail::unorm16ToUnorm8_Scalar(
+	std::uint16_t const* src,
+	std::uint64_t count,
+	std::uint8_t* dst) noexcept
+{
+	// Exactly round(value * 255 / 65535).
+	for (std::uint64_t i = 0; i < count; i++)
+		dst[i] = static_cast<std::uint8_t>((std::uint32_t(src[i]) * 255 + 32895) >> 16);
+}
+
+void TexasGUI::Simd::Detail::unorm8ToUnorm16_Scalar(
+	std::uint8_t const* src,
+	std::uint64_t count,
+	std::uint16_t* dst) noexcept
+{
+	for (std::uint64_t i = 0; i < count; i++)
+		dst[i] = static_cast<std::uint16_t>(src[i] * 257);
+}
+
+void TexasGUI::Simd::Detail::decodeSRGBRGBA32F_Scalar(
+	float* rgba,
+	std::uint64_t pixelCount) noexcept
+{
+	for (std::uint64_t pixelIndex = 0; pixelIndex < pixelCount; pixelIndex++)
+	{
+		for (int i = 0; i < 3; i++)
+			rgba[pixelIndex * 4 + i] = ColorSpace::srgbToLinear(rgba[pixelIndex * 4 + i]);
+	}
+}
+
+void TexasGUI::Simd::Detail::encodeSRGBRGBA32F_Scalar(
+	float* rgba,
+	std::uint64_t pixelCount) noexcept
+{
+	for (std::uint64_t pixelIndex = 0; pixelIndex < pixelCount; pixelIndex++)
+	{
+		for (int i = 0; i < 3; i++)
+			rgba[pixelIndex * 4 + i] = ColorSpace::linearToSRGB(rgba[pixelIndex * 4 + i]);
+	}
+}
+
+void TexasGUI::Simd::Detail::decodeSRGBRGBA8ToRGBA32F_Scalar(
+	unsigned char const* src,
+	std::uint64_t pixelCount,
+	float* dst) noexcept
+{
+	float const* toLinear = ColorSpace::Detail::srgb8Tables().toLinear;
+	for (std::uint64_t pixelIndex = 0; pixelIndex < pixelCount; pixelIndex++)
+	{
+		unsigned char const* srcPixel = src + pixelIndex * 4;
+		float* dstPixel = dst + pixelIndex * 4;
+		dstPixel[0] = toLinear[srcPixel[0]];
+		dstPixel[1] = toLinear[srcPixel[1]];
+		dstPixel[2] = toLinear[srcPixel[2]];
+		dstPixel[3] = toLinear[256 + srcPixel[3]];
+	}
+}
+
+void TexasGUI::Simd::Detail::encodeSRGBRGBA32FToRGBA8_Scalar(
+	float const* src,
+	std::uint64_t pixelCount,
+	unsigned char* dst) noexcept
+{
+	ColorSpace::Detail::SRGB8Tables const& tables = ColorSpace::Detail::srgb8Tables();
+	for (std::uint64_t pixelIndex = 0; pixelIndex < pixelCount; pixelIndex++)
+	{
+		for (int i = 0; i < 4; i++)
+		{
+			float value = src[pixelIndex * 4 + i];
+			value = value > 0.f ? (value < 1.f ? value : 1.f) : 0.f;
+			dst[pixelIndex * 4 + i] = i < 3 ? encodeSRGB8(value, tables) : static_cast<unsigned char>(value * 255.f + 0.5f);
+		}
+	}
+}
+
+void TexasGUI::Simd::Detail::toneMapRGBA32FToRGBA8_Scalar(
+	float const* src,
+	std::uint64_t pixelCount,
+	float const* scale,
+	float const* offset,
+	ToneMapOperator toneMapOperator,
+	bool encodeSRGB,
+	unsigned char* dst) noexcept
+{
+	ColorSpace::Detail::SRGB8Tables const& tables = ColorSpace::Detail::srgb8Tables();
+	for (std::uint64_t pixelIndex = 0; pixelIndex < pixelCount; pixelIndex++)
+	{
+		for (int i = 0; i < 4; i++)
+		{
+			float value = src[pixelIndex * 4 + i] * scale[i] + offset[i];
+			// Written so NaN ends up as 0, and infinity as 1 even though the operators turn it into NaN.
+			value = value > 0.f ? value : 0.f;
+			if (i < 3)
+				value = toneMap(value, toneMapOperator);
+			value = value < 1.f ? value : 1.f;
+
+			if (encodeSRGB && i < 3)
+				dst[pixelIndex * 4 + i] = encodeSRGB8(value, tables);
+			else
+				dst[pixelIndex * 4 + i] = static_cast<unsigned char>(value * 255.f + 0.5f);
+		}
+	}
+}
+
+void TexasGUI::Simd::Detail::resampleRowRGBA32F_Scalar(
+	float const* src,
+	std::uint32_t const* firstTaps,
+	float const* weights,
+	std::uint32_t tapCount,
+	std::uint64_t dstCount,
+	float* dst) noexcept
+{
+	for (std::uint64_t i = 0; i < dstCount; i++)
+	{
+		float const* taps = src + std::uint64_t(firstTaps[i]) * 4;
+		float const* tapWeights = weights + i * tapCount;
+		float sum[4] = {};
+		for (std::uint32_t k = 0; k < tapCount; k++)
+		{
+			for (int c = 0; c < 4; c++)
+				sum[c] += tapWeights[k] * taps[k * 4 + c];
+		}
+		std::memcpy(dst + i * 4, sum, sizeof(sum));
+	}
+}
+
+void TexasGUI::Simd::Detail::blendRowsRGBA32F_Scalar(
+	float const* const* rows,
+	float const* weights,
+	std::uint32_t rowCount,
+	std::uint64_t pixelCount,
+	float* dst) noexcept
+{
+	std::uint64_t const count = pixelCount * 4;
+	for (std::uint64_t i = 0; i < count; i++)
+	{
+		float sum = 0.f;
+		for (std::uint32_t k = 0; k < rowCount; k++)
+			sum += weights[k] * rows[k][i];
+		dst[i] = sum;
+	}
+}
+
+void TexasGUI::Simd::Detail::sumSquaredErrorRGBA32F_Scalar(
+	float const* a,
+	float const* b,
+	std::uint64_t pixelCount,
+	double* sums) noexcept
+{
+	// Even and odd pixels have their own sums, the vectorized versions need two of them in flight.
+	double even[4] = {};
+	double odd[4] = {};
+	std::uint64_t pixelIndex = 0;
+	for (; pixelIndex + 2 <= pixelCount; pixelIndex += 2)
+	{
+		for (int c = 0; c < 4; c++)
+		{
+			double const difference0 = a[pixelIndex * 4 + c] - b[pixelIndex * 4 + c];
+			double const difference1 = a[pixelIndex * 4 + 4 + c] - b[pixelIndex * 4 + 4 + c];
+			even[c] += difference0 * difference0;
+			odd[c] += difference1 * difference1;
+		}
+	}
+	if (pixelIndex < pixelCount)
+	{
+		for (int c = 0; c < 4; c++)
+		{
+			double const difference = a[pixelIndex * 4 + c] - b[pixelIndex * 4 + c];
+			even[c] += difference * difference;
+		}
+	}
+	for (int c = 0; c < 4; c++)
+		sums[c] += even[c] + odd[c];
+}
+
+void TexasGUI::Simd::Detail::ssimBlockSumsRGBA32F_Scalar(
+	float const* a,
+	float const* b,
+	std::uint64_t rowStride,
+	std::uint64_t blockCount,
+	float* sums) noexcept
+{
+	for (std::uint64_t blockIndex = 0; blockIndex < blockCount; blockIndex++)
+	{
+		float blockSums[16] = {};
+		for (std::uint64_t y = 0; y < 4; y++)
+		{
+			float const* rowA = a + y * rowStride + blockIndex * 16;
+			float const* rowB = b + y * rowStride + blockIndex * 16;
+			for (int i = 0; i < 16; i++)
+			{
+				int const c = i & 3;
+				float const valueA = rowA[i];
+				float const valueB = rowB[i];
+				blockSums[c] += valueA;
+				blockSums[4 + c] += valueB;
+				blockSums[8 + c] += valueA * valueA + valueB * valueB;
+				blockSums[12 + c] += valueA * valueB;
+			}
+		}
+		std::memcpy(sums + blockIndex * 16, blockSums, sizeof(blockSums));
+	}
+}
+
+void TexasGUI::Simd::Detail::expandRGB8ToRGBA8_Scalar(
+	unsigned char const* src,
+	std::uint64_t pixelCount,
+	unsigned char* dst) noexcept
+{
+	for (std::uint64_t pixelIndex = 0; pixelIndex < pixelCount; pixelIndex++)
+	{
+		unsigned char const* srcPixel = src + pixelIndex * 3;
+		unsigned char* dstPixel = dst + pixelIndex * 4;
+
+		dstPixel[0] = srcPixel[0];
+		dstPixel[1] = srcPixel[1];
+		dstPixel[2] = srcPixel[2];
+		dstPixel[3] = 255;
+	}
+}
+
+void TexasGUI::Simd::Detail::minMaxU8_Scalar(
+	unsigned char const* src,
+	std::uint64_t pixelCount,
+	std::uint8_t channelCount,
+	std::uint8_t* min,
+	std::uint8_t* max) noexcept
+{
+	std::uint8_t tempMin[4] = { 255, 255, 255, 255 };
+	std::uint8_t tempMax[4] = { 0, 0, 0, 0 };
+	for (std::uint64_t pixelIndex = 0; pixelIndex < pixelCount; pixelIndex++)
+	{
+		unsigned char const* srcPixel = src + pixelIndex * channelCount;
+		for (std::uint8_t i = 0; i < channelCount; i++)
+		{
+			tempMin[i] = std::min(tempMin[i], srcPixel[i]);
+			tempMax[i] = std::max(tempMax[i], srcPixel[i]);
+		}
+	}
+	for (std::uint8_t i = 0; i < channelCount; i++)
+	{
+		min[i] = tempMin[i];
+		max[i] = tempMax[i];
+	}
+}
+
+void TexasGUI::Simd::Detail::expandRGB8ToRGBA8MinMax_Scalar(
+	unsigned char const* src,
+	std::uint64_t pixelCount,
+	unsigned char* dst,
+	std::uint8_t* min,
+	std::uint8_t* max) noexcept
+{
+	std::uint8_t tempMin[3] = { 255, 255, 255 };
+	std::uint8_t tempMax[3] = { 0, 0, 0 };
+	for (std::uint64_t pixelIndex = 0; pixelIndex < pixelCount; pixelIndex++)
+	{
+		unsigned char const* srcPixel = src + pixelIndex * 3;
+		unsigned char* dstPixel = dst + pixelIndex * 4;
+		for (std::uint8_t i = 0; i < 3; i++)
+		{
+			dstPixel[i] = srcPixel[i];
+			tempMin[i] = std::min(tempMin[i], srcPixel[i]);
+			tempMax[i] = std::max(tempMax[i], srcPixel[i]);
+		}
+		dstPixel[3] = 255;
+	}
+	for (std::uint8_t i = 0; i < 3; i++)
+	{
+		min[i] = tempMin[i];
+		max[i] = tempMax[i];
+	}
+}
+
+void TexasGUI::Simd::Detail::copyRGBA8MinMax_Scalar(
+	unsigned char const* src,
+	std::uint64_t pixelCount,
+	unsigned char* dst,
+	std::uint8_t* min,
+	std::uint8_t* max) noexcept
+{
+	std::memcpy(dst, src, pixelCount * 4);
+	minMaxU8_Scalar(src, pixelCount, 4, min, max);
+}
+
+#ifdef TEXASGUI_SIMD_X86
+namespace TexasGUI::Simd::Detail
+{
+	// Works on blocks of 16 pixels, which is channelCount whole vectors.
+	// Lane j of accumulator k then always holds channel (16 * k + j) % channelCount.
+	template<std::uint8_t channelCount>
+	static void minMaxU8_SSE2_Impl(
+		unsigned char const* src,
+		std::uint64_t pixelCount,
+		std::uint8_t* min,
+		std::uint8_t* max) noexcept
+	{
+		constexpr std::uint64_t pixelsPerBlock = 16;
+
+		__m128i accMin[channelCount];
+		__m128i accMax[channelCount];
+		for (std::uint8_t k = 0; k < channelCount; k++)
+		{
+			accMin[k] = _mm_set1_epi8(static_cast<char>(0xFF));
+			accMax[k] = _mm_setzero_si128();
+		}
+
+		std::uint64_t const blockCount = pixelCount / pixelsPerBlock;
+		for (std::uint64_t blockIndex = 0; blockIndex < blockCount; blockIndex++)
+		{
+			__m128i const* block = reinterpret_cast<__m128i const*>(src + blockIndex * pixelsPerBlock * channelCount);
+			for (std::uint8_t k = 0; k < channelCount; k++)
+			{
+				__m128i value = _mm_loadu_si128(block + k);
+				accMin[k] = _mm_min_epu8(accMin[k], value);
+				accMax[k] = _mm_max_epu8(accMax[k], value);
+			}
+		}
+
+		// Whatever doesn't fill a whole block.
+		std::uint64_t const doneCount = blockCount * pixelsPerBlock;
+		minMaxU8_Scalar(src + doneCount * channelCount, pixelCount - doneCount, channelCount, min, max);
+
+		alignas(16) std::uint8_t lanesMin[16];
+		alignas(16) std::uint8_t lanesMax[16];
+		for (std::uint8_t k = 0; k < channelCount; k++)
+		{
+			_mm_store_si128(reinterpret_cast<__m128i*>(lanesMin), accMin[k]);
+			_mm_store_si128(reinterpret_cast<__m128i*>(lanesMax), accMax[k]);
+			for (std::uint8_t j = 0; j < 16; j++)
+			{
+				std::uint8_t channel = (16 * k + j) % channelCount;
+				min[channel] = std::min(min[channel], lanesMin[j]);
+				max[channel] = std::max(max[channel], lanesMax[j]);
+			}
+		}
+	}
+
+	// The same steps as ColorSpace::inverseCbrt, value^(-1/3) for positive values.
+	[[nodiscard]] static __m128 inverseCbrt_SSE2(__m128 value) noexcept
+	{
+		__m128 const third = _mm_set1_ps(1.f / 3.f);
+		__m128 result = _mm_castsi128_ps(_mm_sub_epi32(
+			_mm_set1_epi32(ColorSpace::Detail::inverseCbrtGuess),
+			_mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(_mm_castps_si128(value)), third))));
+		__m128 const valueThird = _mm_mul_ps(value, third);
+		for (int i = 0; i < 3; i++)
+		{
+			__m128 const squared = _mm_mul_ps(result, result);
+			result = _mm_add_ps(result, _mm_sub_ps(_mm_mul_ps(result, third), _mm_mul_ps(valueThird, _mm_mul_ps(squared, squared))));
+		}
+		return result;
+	}
+
+	// The same steps as ColorSpace::inverseFifthRoot.
+	[[nodiscard]] static __m128 inverseFifthRoot_SSE2(__m128 value) noexcept
+	{
+		__m128 const fifth = _mm_set1_ps(0.2f);
+		__m128 result = _mm_castsi128_ps(_mm_sub_epi32(
+			_mm_set1_epi32(ColorSpace::Detail::inverseFifthRootGuess),
+			_mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(_mm_castps_si128(value)), fifth))));
+		__m128 const valueFifth = _mm_mul_ps(value, fifth);
+		for (int i = 0; i < 3; i++)
+		{
+			__m128 const squared = _mm_mul_ps(result, result);
+			__m128 const power6 = _mm_mul_ps(_mm_mul_ps(squared, squared), squared);
+			result = _mm_add_ps(result, _mm_sub_ps(_mm_mul_ps(result, fifth), _mm_mul_ps(valueFifth, power6)));
+		}
+		return result;
+	}
+
+	// ColorSpace::linearToSRGB on 4 values.
+	[[nodiscard]] static __m128 linearToSRGB_SSE2(__m128 value) noexcept
+	{
+		// maxps returns the second operand when either is NaN.
+		value = _mm_max_ps(value, _mm_setzero_ps());
+		value = _mm_min_ps(value, _mm_set1_ps(std::numeric_limits<float>::max()));
+		__m128 const root = _mm_sqrt_ps(value);
+		__m128 const curve = _mm_sub_ps(
+			_mm_mul_ps(_mm_set1_ps(1.055f), _mm_mul_ps(root, _mm_sqrt_ps(inverseCbrt_SSE2(root)))),
+			_mm_set1_ps(0.055f));
+		__m128 const isLinear = _mm_cmple_ps(value, _mm_set1_ps(0.0031308f));
+		return _mm_or_ps(_mm_and_ps(isLinear, _mm_mul_ps(value, _mm_set1_ps(12.92f))), _mm_andnot_ps(isLinear, curve));
+	}
+
+	// ColorSpace::srgbToLinear on 4 values.
+	[[nodiscard]] static __m128 srgbToLinear_SSE2(__m128 value) noexcept
+	{
+		__m128 const base = _mm_mul_ps(_mm_add_ps(value, _mm_set1_ps(0.055f)), _mm_set1_ps(1.f / 1.055f));
+		__m128 const product = _mm_mul_ps(base, inverseFifthRoot_SSE2(base));
+		__m128 const curve = _mm_mul_ps(_mm_mul_ps(product, product), product);
+		__m128 const isLinear = _mm_cmple_ps(value, _mm_set1_ps(0.04045f));
+		return _mm_or_ps(_mm_and_ps(isLinear, _mm_mul_ps(value, _mm_set1_ps(1.f / 12.92f))), _mm_andnot_ps(isLinear, curve));
+	}
+
+	// Writes one pixel of RGBA values clamped to [0, 1] as RGBA8, with the color sRGB encoded.
+	// The table lookups are scalar, SSE2 has no gathers.
+	static void storeSRGB8Pixel_SSE2(__m128 value, ColorSpace::Detail::SRGB8Tables const& tables, unsigned char* dst) noexcept
+	{
+		float const bucketCount = static_cast<float>(ColorSpace::Detail::srgb8BucketCount);
+		alignas(16) float values[4];
+		alignas(16) std::int32_t quantized[4];
+		_mm_store_ps(values, value);
+		_mm_store_si128(reinterpret_cast<__m128i*>(quantized), _mm_cvttps_epi32(_mm_add_ps(
+			_mm_mul_ps(value, _mm_setr_ps(bucketCount, bucketCount, bucketCount, 255.f)),
+			_mm_setr_ps(0.f, 0.f, 0.f, 0.5f))));
+		for (int i = 0; i < 3; i++)
+		{
+			int const code = tables.buckets[quantized[i]];
+			dst[i] = static_cast<unsigned char>(code + (values[i] >= tables.thresholds[code] ? 1 : 0));
+		}
+		dst[3] = static_cast<unsigned char>(quantized[3]);
+	}
+}
+
+void TexasGUI::Simd::Detail::minMaxU8_SSE2(
+	unsigned char const* src,
+	std::uint64_t pixelCount,
+	std::uint8_t channelCount,
+	std::uint8_t* min,
+	std::uint8_t* max) noexcept
+{
+	switch (channelCount)
+	{
+	case 1:
+		minMaxU8_SSE2_Impl<1>(src, pixelCount, min, max);
+		return;
+	case 2:
+		minMaxU8_SSE2_Impl<2>(src, pixelCount, min, max);
+		return;
+	case 3:
+		minMaxU8_SSE2_Impl<3>(src, pixelCount, min, max);
+		return;
+	case 4:
+		minMaxU8_SSE2_Impl<4>(src, pixelCount, min, max);
+		return;
+	default:
+		minMaxU8_Scalar(src, pixelCount, channelCount, min, max);
+		return;
+	}
+}
+void TexasGUI::Simd::Detail::copyRGBA8MinMax_SSE2(
+	unsigned char const* src,
+	std::uint64_t pixelCount,
+	unsigned char* dst,
+	std::uint8_t* min,
+	std::uint8_t* max) noexcept
+{
+	// 4 pixels per vector, lane j is always channel j % 4.
+	__m128i accMin = _mm_set1_epi8(static_cast<char>(0xFF));
+	__m128i accMax = _mm_setzero_si128();
+
+	std::uint64_t pixelIndex = 0;
+	for (; pixelIndex + 4 <= pixelCount; pixelIndex += 4)
+	{
+		__m128i value = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + pixelIndex * 4));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + pixelIndex * 4), value);
+		accMin = _mm_min_epu8(accMin, value);
+		accMax = _mm_max_epu8(accMax, value);
+	}
+
+	copyRGBA8MinMax_Scalar(src + pixelIndex * 4, pixelCount - pixelIndex, dst + pixelIndex * 4, min, max);
+
+	alignas(16) std::uint8_t lanesMin[16];
+	alignas(16) std::uint8_t lanesMax[16];
+	_mm_store_si128(reinterpret_cast<__m128i*>(lanesMin), accMin);
+	_mm_store_si128(reinterpret_cast<__m128i*>(lanesMax), accMax);
+	for (std::uint8_t j = 0; j < 16; j++)
+	{
+		min[j % 4] = std::min(min[j % 4], lanesMin[j]);
+		max[j % 4] = std::max(max[j % 4], lanesMax[j]);
+	}
+}
+
+void TexasGUI::Simd::Detail::halfToFloat_SSE2(
+	std::uint16_t const* src,
+	std::uint64_t count,
+	float* dst) noexcept
+{
+	// Shifting exponent and mantissa into place and multiplying by 2^112 rebiases the exponent,
+	// and turns half subnormals into float normals on the way. Infinity and NaN would overflow
+	// that, they get the maximum float exponent instead, and NaNs are quieted like F16C does.
+	__m128i const magnitudeMask = _mm_set1_epi32(0x7FFF);
+	__m128i const signMask = _mm_set1_epi32(0x8000);
+	__m128 const rebias = _mm_castsi128_ps(_mm_set1_epi32(0x77800000));
+	__m128i const infinityThreshold = _mm_set1_epi32((0x7C00 << 13) - 1);
+	__m128i const nanThreshold = _mm_set1_epi32(0x7C00 << 13);
+	__m128i const quietBit = _mm_set1_epi32(0x00400000);
+	__m128i const maxExponent = _mm_set1_epi32(0x7F800000);
+	__m128i const zero = _mm_setzero_si128();
+
+	auto convert = [&](__m128i halves) -> __m128
+	{
+		__m128i const shifted = _mm_slli_epi32(_mm_and_si128(halves, magnitudeMask), 13);
+		__m128i const sign = _mm_slli_epi32(_mm_and_si128(halves, signMask), 16);
+		__m128i const finite = _mm_castps_si128(_mm_mul_ps(_mm_castsi128_ps(shifted), rebias));
+		__m128i const isSpecial = _mm_cmpgt_epi32(shifted, infinityThreshold);
+		__m128i const isNaN = _mm_cmpgt_epi32(shifted, nanThreshold);
+		__m128i const special = _mm_or_si128(_mm_or_si128(shifted, maxExponent), _mm_and_si128(isNaN, quietBit));
+		__m128i const magnitude = _mm_or_si128(_mm_and_si128(isSpecial, special), _mm_andnot_si128(isSpecial, finite));
+		return _mm_castsi128_ps(_mm_or_si128(magnitude, sign));
+	};
+
+	std::uint64_t i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		__m128i const halves = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i));
+		_mm_storeu_ps(dst + i, convert(_mm_unpacklo_epi16(halves, zero)));
+		_mm_storeu_ps(dst + i + 4, convert(_mm_unpackhi_epi16(halves, zero)));
+	}
+
+	halfToFloat_Scalar(src + i, count - i, dst + i);
+}
+
+void TexasGUI::Simd::Detail::floatToHalf_SSE2(
+	float const* src,
+	std::uint64_t count,
+	std::uint16_t* dst) noexcept
+{
+	// Adding a magic number rounds subnormal results with the FPU, normal ones get their exponent rebiased
+	// and are rounded to nearest even by adding half an ulp, plus one if the kept mantissa is odd.
+	__m128 const signMask = _mm_castsi128_ps(_mm_set1_epi32(static_cast<int>(0x80000000)));
+	__m128i const overflowThreshold = _mm_set1_epi32(0x477FF000);
+	__m128i const normalThreshold = _mm_set1_epi32(0x38800000);
+	__m128 const subnormalMagic = _mm_castsi128_ps(_mm_set1_epi32(0x3F000000));
+	__m128i const normalBias = _mm_set1_epi32(0xFFF - 0x38000000);
+	__m128i const infinity = _mm_set1_epi32(0x7C00);
+	__m128i const quietBit = _mm_set1_epi32(0x0200);
+	__m128i const payloadMask = _mm_set1_epi32(0x03FF);
+
+	auto convert = [&](__m128 value) -> __m128i
+	{
+		__m128 const sign = _mm_and_ps(value, signMask);
+		__m128 const absolute = _mm_xor_ps(value, sign);
+		__m128i const magnitude = _mm_castps_si128(absolute);
+
+		__m128i const subnormal = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(absolute, subnormalMagic)), _mm_castps_si128(subnormalMagic));
+		__m128i const oddMantissa = _mm_srai_epi32(_mm_slli_epi32(magnitude, 18), 31);
+		__m128i const normal = _mm_srli_epi32(_mm_sub_epi32(_mm_add_epi32(magnitude, normalBias), oddMantissa), 13);
+		__m128i const isSubnormal = _mm_cmpgt_epi32(normalThreshold, magnitude);
+		__m128i const finite = _mm_or_si128(_mm_and_si128(isSubnormal, subnormal), _mm_andnot_si128(isSubnormal, normal));
+
+		__m128i const isNaN = _mm_castps_si128(_mm_cmpunord_ps(absolute, absolute));
+		__m128i const nan = _mm_or_si128(quietBit, _mm_and_si128(_mm_srli_epi32(magnitude, 13), payloadMask));
+		__m128i const special = _mm_or_si128(infinity, _mm_and_si128(isNaN, nan));
+		__m128i const isFinite = _mm_cmpgt_epi32(overflowThreshold, magnitude);
+		__m128i const result = _mm_or_si128(_mm_and_si128(isFinite, finite), _mm_andnot_si128(isFinite, special));
+		// The sign ends up in bit 15 and everything above it, which keeps the signed pack below from saturating.
+		return _mm_or_si128(result, _mm_srai_epi32(_mm_castps_si128(sign), 16));
+	};
+
+	std::uint64_t i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		__m128i const low = convert(_mm_loadu_ps(src + i));
+		__m128i const high = convert(_mm_loadu_ps(src + i + 4));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packs_epi32(low, high));
+	}
+
+	floatToHalf_Scalar(src + i, count - i, dst + i);
+}
+
+void TexasGUI::Simd::Detail::swapRedBlue8_SSE2(
+	unsigned char const* src,
+	std::uint64_t pixelCount,
+	unsigned char* dst) noexcept
+{
+	__m128i const keepMask = _mm_set1_epi32(static_cast<int>(0xFF00FF00));
+	__m128i const lowMask = _mm_set1_epi32(0x000000FF);
+
+	std::uint64_t pixelIndex = 0;
+	for (; pixelIndex + 4 <= pixelCount; pixelIndex += 4)
+	{
+		__m128i const pixels = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + pixelIndex * 4));
+		__m128i const red = _mm_slli_epi32(_mm_and_si128(pixels, lowMask), 16);
+		__m128i const blue = _mm_and_si128(_mm_srli_epi32(pixels, 16), lowMask);
+		__m128i const swapped = _mm_or_si128(_mm_and_si128(pixels, keepMask), _mm_or_si128(red, blue));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + pixelIndex * 4), swapped);
+	}
+
+	swapRedBlue8_Scalar(src + pixelIndex * 4, pixelCount - pixelIndex, dst + pixelIndex * 4);
+}
+
+void TexasGUI::Simd::Detail::unorm16ToUnorm8_SSE2(
+	std::uint16_t const* src,
+	std::uint64_t count,
+	std::uint8_t* dst) noexcept
+{
+	// round(v / 257) is (t - (t >> 8)) >> 8 with t = v + 128. Saturating the add only touches
+	// values that round to 255 anyway, and keeps everything in 16-bit lanes.
+	__m128i const half = _mm_set1_epi16(128);
+
+	auto convert = [&](__m128i values) -> __m128i
+	{
+		__m128i const t = _mm_adds_epu16(values, half);
+		return _mm_srli_epi16(_mm_sub_epi16(t, _mm_srli_epi16(t, 8)), 8);
+	};
+
+	std::uint64_t i = 0;
+	for (; i + 16 <= count; i += 16)
+	{
+		__m128i const low = convert(_mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i)));
+		__m128i const high = convert(_mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i + 8)));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(low, high));
+	}
+
+	unorm16ToUnorm8_Scalar(src + i, count - i, dst + i);
+}
+
+void TexasGUI::Simd::Detail::unorm8ToUnorm16_SSE2(
+	std::uint8_t const* src,
+	std::uint64_t count,
+	std::uint16_t* dst) noexcept
+{
+	// v * 257 is just the byte repeated.
+	std::uint64_t i = 0;
+	for (; i + 16 <= count; i += 16)
+	{
+		__m128i const values = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_unpacklo_epi8(values, values));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 8), _mm_unpackhi_epi8(values, values));
+	}
+
+	unorm8ToUnorm16_Scalar(src + i, count - i, dst + i);
+}
+
+void TexasGUI::Simd::Detail::decodeSRGBRGBA32F_SSE2(
+	float* rgba,
+	std::uint64_t pixelCount) noexcept
+{
+	// One pixel per vector, alpha is put back afterwards.
+	__m128 const colorMask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+	for (std::uint64_t pixelIndex = 0; pixelIndex < pixelCount; pixelIndex++)
+	{
+		__m128 const value = _mm_loadu_ps(rgba + pixelIndex * 4);
+		__m128 const decoded = srgbToLinear_SSE2(value);
+		_mm_storeu_ps(rgba + pixelIndex * 4, _mm_or_ps(_mm_and_ps(colorMask, decoded), _mm_andnot_ps(colorMask, value)));
+	}
+}
+
+void TexasGUI::Simd::Detail::encodeSRGBRGBA32F_SSE2(
+	float* rgba,
+	std::uint64_t pixelCount) noexcept
+{
+	__m128 const colorMask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+	for (std::uint64_t pixelIndex = 0; pixelIndex < pixelCount; pixelIndex++)
+	{
+		__m128 const value = _mm_loadu_ps(rgba + pixelIndex * 4);
+		__m128 const encoded = linearToSRGB_SSE2(value);
+		_mm_storeu_ps(rgba + pixelIndex * 4, _mm_or_ps(_mm_and_ps(colorMask, encoded), _mm_andnot_ps(colorMask, value)));
+	}
+}
+
+void TexasGUI::Simd::Detail::encodeSRGBRGBA32FToRGBA8_SSE2(
+	float const* src,
+	std::uint64_t pixelCount,
+	unsigned char* dst) noexcept
+{
+	ColorSpace::Detail::SRGB8Tables const& tables = ColorSpace::Detail::srgb8Tables();
+	__m128 const zero = _mm_setzero_ps();
+	__m128 const one = _mm_set1_ps(1.f);
+	for (std::uint64_t pixelIndex = 0; pixelIndex < pixelCount; pixelIndex++)
+	{
+		// maxps returns the second operand when either is NaN.
+		__m128 const value = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + pixelIndex * 4), zero), one);
+		storeSRGB8Pixel_SSE2(value, tables, dst + pixelIndex * 4);
+	}
+}
+
+void TexasGUI::Simd::Detail::toneMapRGBA32FToRGBA8_SSE2(
+	float const* src,
+	std::uint64_t pixelCount,
+	float const* scale,
+	float const* offset,
+	ToneMapOperator toneMapOperator,
+	bool encodeSRGB,
+	unsigned char* dst) noexcept
+{
+	// One pixel per vector. Lanes 0-2 are color, the operator leaves lane 3 alone.
+	__m128 const scaleVec = _mm_loadu_ps(scale);
+	__m128 const offsetVec = _mm_loadu_ps(offset);
+	__m128 const colorMask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+	__m128 const zero = _mm_setzero_ps();
+	__m128 const one = _mm_set1_ps(1.f);
+	__m128 const half = _mm_set1_ps(0.5f);
+	__m128 const quantizeScale = _mm_set1_ps(255.f);
+
+	// Returns the pixel clamped to [0, 1].
+	auto mapPixel = [&](float const* pixel) -> __m128
+	{
+		__m128 value = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(pixel), scaleVec), offsetVec);
+		// maxps returns the second operand when either is NaN.
+		value = _mm_max_ps(value, zero);
+		__m128 mapped = value;
+		if (toneMapOperator == ToneMapOperator::Reinhard)
+			mapped = _mm_div_ps(value, _mm_add_ps(one, value));
+		else if (toneMapOperator == ToneMapOperator::ACES)
+		{
+			__m128 const numerator = _mm_mul_ps(value, _mm_add_ps(_mm_mul_ps(_mm_set1_ps(2.51f), value), _mm_set1_ps(0.03f)));
+			__m128 const denominator = _mm_add_ps(
+				_mm_mul_ps(value, _mm_add_ps(_mm_mul_ps(_mm_set1_ps(2.43f), value), _mm_set1_ps(0.59f))),
+				_mm_set1_ps(0.14f));
+			mapped = _mm_div_ps(numerator, denominator);
+		}
+		value = _mm_or_ps(_mm_and_ps(colorMask, mapped), _mm_andnot_ps(colorMask, value));
+		// Same rule as maxps above, infinity that the operator turned into NaN becomes 1.
+		return _mm_min_ps(value, one);
+	};
+	auto quantizePixel = [&](float const* pixel) -> __m128i
+	{
+		return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(mapPixel(pixel), quantizeScale), half));
+	};
+
+	if (!encodeSRGB)
+	{
+		std::uint64_t pixelIndex = 0;
+		for (; pixelIndex + 4 <= pixelCount; pixelIndex += 4)
+		{
+			float const* block = src + pixelIndex * 4;
+			__m128i const low = _mm_packs_epi32(quantizePixel(block), quantizePixel(block + 4));
+			__m128i const high = _mm_packs_epi32(quantizePixel(block + 8), quantizePixel(block + 12));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + pixelIndex * 4), _mm_packus_epi16(low, high));
+		}
+		toneMapRGBA32FToRGBA8_Scalar(src + pixelIndex * 4, pixelCount - pixelIndex, scale, offset, toneMapOperator, encodeSRGB, dst + pixelIndex * 4);
+		return;
+	}
+
+	ColorSpace::Detail::SRGB8Tables const& tables = ColorSpace::Detail::srgb8Tables();
+	for (std::uint64_t pixelIndex = 0; pixelIndex < pixelCount; pixelIndex++)
+		storeSRGB8Pixel_SSE2(mapPixel(src + pixelIndex * 4), tables, dst + pixelIndex * 4);
+}
+
+void TexasGUI::Simd::Detail::resampleRowRGBA32F_SSE2(
+	float const* src,
+	std::uint32_t const* firstTaps,
+	float const* weights,
+	std::uint32_t tapCount,
+	std::uint64_t dstCount,
+	float* dst) noexcept
+{
+	for (std::uint64_t i = 0; i < dstCount; i++)
+	{
+		float const* taps = src + std::uint64_t(firstTaps[i]) * 4;
+		float const* tapWeights = weights + i * tapCount;
+		__m128 sum = _mm_setzero_ps();
+		for (std::uint32_t k = 0; k < tapCount; k++)
+			sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(tapWeights[k]), _mm_loadu_ps(taps + k * 4)));
+		_mm_storeu_ps(dst + i * 4, sum);
+	}
+}
+
+void TexasGUI::Simd::Detail::blendRowsRGBA32F_SSE2(
+	float const* const* rows,
+	float const* weights,
+	std::uint32_t rowCount,
+	std::uint64_t pixelCount,
+	float* dst) noexcept
+{
+	// Two pixels at a time, so there are two independent sums in flight.
+	std::uint64_t const count = pixelCount * 4;
+	std::uint64_t i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		__m128 sum0 = _mm_setzero_ps();
+		__m128 sum1 = _mm_setzero_ps();
+		for (std::uint32_t k = 0; k < rowCount; k++)
+		{
+			__m128 const weight = _mm_set1_ps(weights[k]);
+			sum0 = _mm_add_ps(sum0, _mm_mul_ps(weight, _mm_loadu_ps(rows[k] + i)));
+			sum1 = _mm_add_ps(sum1, _mm_mul_ps(weight, _mm_loadu_ps(rows[k] + i + 4)));
+		}
+		_mm_storeu_ps(dst + i, sum0);
+		_mm_storeu_ps(dst + i + 4, sum1);
+	}
+	for (; i < count; i += 4)
+	{
+		__m128 sum = _mm_setzero_ps();
+		for (std::uint32_t k = 0; k < rowCount; k++)
+			sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weights[k]), _mm_loadu_ps(rows[k] + i)));
+		_mm_storeu_ps(dst + i, sum);
+	}
+}
+
+void TexasGUI::Simd::Detail::sumSquaredErrorRGBA32F_SSE2(
+	float const* a,
+	float const* b,
+	std::uint64_t pixelCount,
+	double* sums) noexcept
+{
+	// Red and green in one register, blue and alpha in the other, for even and odd pixels.
+	__m128d evenLow = _mm_setzero_pd();
+	__m128d evenHigh = _mm_setzero_pd();
+	__m128d oddLow = _mm_setzero_pd();
+	__m128d oddHigh = _mm_setzero_pd();
+	std::uint64_t pixelIndex = 0;
+	for (; pixelIndex + 2 <= pixelCount; pixelIndex += 2)
+	{
+		__m128 const difference0 = _mm_sub_ps(_mm_loadu_ps(a + pixelIndex * 4), _mm_loadu_ps(b + pixelIndex * 4));
+		__m128 const difference1 = _mm_sub_ps(_mm_loadu_ps(a + pixelIndex * 4 + 4), _mm_loadu_ps(b + pixelIndex * 4 + 4));
+		__m128d const low0 = _mm_cvtps_pd(difference0);
+		__m128d const high0 = _mm_cvtps_pd(_mm_movehl_ps(difference0, difference0));
+		__m128d const low1 = _mm_cvtps_pd(difference1);
+		__m128d const high1 = _mm_cvtps_pd(_mm_movehl_ps(difference1, difference1));
+		evenLow = _mm_add_pd(evenLow, _mm_mul_pd(low0, low0));
+		evenHigh = _mm_add_pd(evenHigh, _mm_mul_pd(high0, high0));
+		oddLow = _mm_add_pd(oddLow, _mm_mul_pd(low1, low1));
+		oddHigh = _mm_add_pd(oddHigh, _mm_mul_pd(high1, high1));
+	}
+	if (pixelIndex < pixelCount)
+	{
+		__m128 const difference = _mm_sub_ps(_mm_loadu_ps(a + pixelIndex * 4), _mm_loadu_ps(b + pixelIndex * 4));
+		__m128d const low = _mm_cvtps_pd(difference);
+		__m128d const high = _mm_cvtps_pd(_mm_movehl_ps(difference, difference));
+		evenLow = _mm_add_pd(evenLow, _mm_mul_pd(low, low));
+		evenHigh = _mm_add_pd(evenHigh, _mm_mul_pd(high, high));
+	}
+	_mm_storeu_pd(sums, _mm_add_pd(_mm_loadu_pd(sums), _mm_add_pd(evenLow, oddLow)));
+	_mm_storeu_pd(sums + 2, _mm_add_pd(_mm_loadu_pd(sums + 2), _mm_add_pd(evenHigh, oddHigh)));
+}
+
+void TexasGUI::Simd::Detail::ssimBlockSumsRGBA32F_SSE2(
+	float const* a,
+	float const* b,
+	std::uint64_t rowStride,
+	std::uint64_t blockCount,
+	float* sums) noexcept
+{
+	for (std::uint64_t blockIndex = 0; blockIndex < blockCount; blockIndex++)
+	{
+		__m128 sumA = _mm_setzero_ps();
+		__m128 sumB = _mm_setzero_ps();
+		__m128 sumSquares = _mm_setzero_ps();
+		__m128 sumProducts = _mm_setzero_ps();
+		for (std::uint64_t y = 0; y < 4; y++)
+		{
+			float const* rowA = a + y * rowStride + blockIndex * 16;
+			float const* rowB = b + y * rowStride + blockIndex * 16;
+			for (int x = 0; x < 4; x++)
+			{
+				__m128 const valueA = _mm_loadu_ps(rowA + x * 4);
+				__m128 const valueB = _mm_loadu_ps(rowB + x * 4);
+				sumA = _mm_add_ps(sumA, valueA);
+				sumB = _mm_add_ps(sumB, valueB);
+				sumSquares = _mm_add_ps(sumSquares, _mm_add_ps(_mm_mul_ps(valueA, valueA), _mm_mul_ps(valueB, valueB)));
+				sumProducts = _mm_add_ps(sumProducts, _mm_mul_ps(valueA, valueB));
+			}
+		}
+		float* blockSums = sums + blockIndex * 16;
+		_mm_storeu_ps(blockSums, sumA);
+		_mm_storeu_ps(blockSums + 4, sumB);
+		_mm_storeu_ps(blockSums + 8, sumSquares);
+		_mm_storeu_ps(blockSums + 12, sumProducts);
+	}
+}
+#endif
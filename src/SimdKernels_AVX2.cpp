@@ -0,0 +1,521 @@
+#include "TexasGUI/SimdKernels.hpp"
+
+#include "TexasGUI/ColorSpace.hpp"
+
+// Built with AVX2 enabled, only ever called after the dispatcher has checked the CPU.
+#ifdef TEXASGUI_SIMD_X86
+#include <immintrin.h>
+
+#include <algorithm>
+#include <limits>
+
+void TexasGUI::Simd::Detail::expandRGB8ToRGBA8_AVX2(
+	unsigned char const* src,
+	std::uint64_t pixelCount,
+	unsigned char* dst) noexcept
+{
+	// vpshufb works per 128-bit lane, so each lane gets its own 4 RGB pixels (12 bytes).
+	__m256i const shuffleMask = _mm256_setr_epi8(
+		0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+		0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+	__m256i const alphaMask = _mm256_set1_epi32(static_cast<int>(0xFF000000));
+
+	std::uint64_t pixelIndex = 0;
+	// The last load of a block reads 4 bytes past it, so leave room for that.
+	for (; pixelIndex + 34 <= pixelCount; pixelIndex += 32)
+	{
+		unsigned char const* srcBlock = src + pixelIndex * 3;
+		__m256i* dstBlock = reinterpret_cast<__m256i*>(dst + pixelIndex * 4);
+		for (int i = 0; i < 4; i++)
+		{
+			__m128i low = _mm_loadu_si128(reinterpret_cast<__m128i const*>(srcBlock + i * 24));
+			__m128i high = _mm_loadu_si128(reinterpret_cast<__m128i const*>(srcBlock + i * 24 + 12));
+			__m256i rgb = _mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1);
+			__m256i rgba = _mm256_or_si256(_mm256_shuffle_epi8(rgb, shuffleMask), alphaMask);
+			_mm256_storeu_si256(dstBlock + i, rgba);
+		}
+	}
+
+	expandRGB8ToRGBA8_Scalar(src + pixelIndex * 3, pixelCount - pixelIndex, dst + pixelIndex * 4);
+}
+
+namespace TexasGUI::Simd::Detail
+{
+	// Same scheme as the SSE2 version, with blocks of 32 pixels.
+	template<std::uint8_t channelCount>
+	static void minMaxU8_AVX2_Impl(
+		unsigned char const* src,
+		std::uint64_t pixelCount,
+		std::uint8_t* min,
+		std::uint8_t* max) noexcept
+	{
+		constexpr std::uint64_t pixelsPerBlock = 32;
+
+		__m256i accMin[channelCount];
+		__m256i accMax[channelCount];
+		for (std::uint8_t k = 0; k < channelCount; k++)
+		{
+			accMin[k] = _mm256_set1_epi8(static_cast<char>(0xFF));
+			accMax[k] = _mm256_setzero_si256();
+		}
+
+		std::uint64_t const blockCount = pixelCount / pixelsPerBlock;
+		for (std::uint64_t blockIndex = 0; blockIndex < blockCount; blockIndex++)
+		{
+			__m256i const* block = reinterpret_cast<__m256i const*>(src + blockIndex * pixelsPerBlock * channelCount);
+			for (std::uint8_t k = 0; k < channelCount; k++)
+			{
+				__m256i value = _mm256_loadu_si256(block + k);
+				accMin[k] = _mm256_min_epu8(accMin[k], value);
+				accMax[k] = _mm256_max_epu8(accMax[k], value);
+			}
+		}
+
+		std::uint64_t const doneCount = blockCount * pixelsPerBlock;
+		minMaxU8_Scalar(src + doneCount * channelCount, pixelCount - doneCount, channelCount, min, max);
+
+		alignas(32) std::uint8_t lanesMin[32];
+		alignas(32) std::uint8_t lanesMax[32];
+		for (std::uint8_t k = 0; k < channelCount; k++)
+		{
+			_mm256_store_si256(reinterpret_cast<__m256i*>(lanesMin), accMin[k]);
+			_mm256_store_si256(reinterpret_cast<__m256i*>(lanesMax), accMax[k]);
+			for (std::uint8_t j = 0; j < 32; j++)
+			{
+				std::uint8_t channel = (32 * k + j) % channelCount;
+				min[channel] = std::min(min[channel], lanesMin[j]);
+				max[channel] = std::max(max[channel], lanesMax[j]);
+			}
+		}
+	}
+}
+
+void TexasGUI::Simd::Detail::minMaxU8_AVX2(
+	unsigned char const* src,
+	std::uint64_t pixelCount,
+	std::uint8_t channelCount,
+	std::uint8_t* min,
+	std::uint8_t* max) noexcept
+{
+	switch (channelCount)
+	{
+	case 1:
+		minMaxU8_AVX2_Impl<1>(src, pixelCount, min, max);
+		return;
+	case 2:
+		minMaxU8_AVX2_Impl<2>(src, pixelCount, min, max);
+		return;
+	case 3:
+		minMaxU8_AVX2_Impl<3>(src, pixelCount, min, max);
+		return;
+	case 4:
+		minMaxU8_AVX2_Impl<4>(src, pixelCount, min, max);
+		return;
+	default:
+		minMaxU8_Scalar(src, pixelCount, channelCount, min, max);
+		return;
+	}
+}
+
+void TexasGUI::Simd::Detail::expandRGB8ToRGBA8MinMax_AVX2(
+	unsigned char const* src,
+	std::uint64_t pixelCount,
+	unsigned char* dst,
+	std::uint8_t* min,
+	std::uint8_t* max) noexcept
+{
+	__m256i const shuffleMask = _mm256_setr_epi8(
+		0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+		0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+	__m256i const alphaMask = _mm256_set1_epi32(static_cast<int>(0xFF000000));
+
+	// Reduce on the expanded pixels, where lane j is always channel j % 4.
+	__m256i accMin = _mm256_set1_epi8(static_cast<char>(0xFF));
+	__m256i accMax = _mm256_setzero_si256();
+
+	std::uint64_t pixelIndex = 0;
+	for (; pixelIndex + 34 <= pixelCount; pixelIndex += 32)
+	{
+		unsigned char const* srcBlock = src + pixelIndex * 3;
+		__m256i* dstBlock = reinterpret_cast<__m256i*>(dst + pixelIndex * 4);
+		for (int i = 0; i < 4; i++)
+		{
+			__m128i low = _mm_loadu_si128(reinterpret_cast<__m128i const*>(srcBlock + i * 24));
+			__m128i high = _mm_loadu_si128(reinterpret_cast<__m128i const*>(srcBlock + i * 24 + 12));
+			__m256i rgb = _mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1);
+			__m256i rgba = _mm256_or_si256(_mm256_shuffle_epi8(rgb, shuffleMask), alphaMask);
+			_mm256_storeu_si256(dstBlock + i, rgba);
+			accMin = _mm256_min_epu8(accMin, rgba);
+			accMax = _mm256_max_epu8(accMax, rgba);
+		}
+	}
+
+	expandRGB8ToRGBA8MinMax_Scalar(src + pixelIndex * 3, pixelCount - pixelIndex, dst + pixelIndex * 4, min, max);
+
+	alignas(32) std::uint8_t lanesMin[32];
+	alignas(32) std::uint8_t lanesMax[32];
+	_mm256_store_si256(reinterpret_cast<__m256i*>(lanesMin), accMin);
+	_mm256_store_si256(reinterpret_cast<__m256i*>(lanesMax), accMax);
+	for (std::uint8_t j = 0; j < 32; j++)
+	{
+		// The alpha lanes are the constant we put there, not source data.
+		if (j % 4 == 3)
+			continue;
+		min[j % 4] = std::min(min[j % 4], lanesMin[j]);
+		max[j % 4] = std::max(max[j % 4], lanesMax[j]);
+	}
+}
+
+void TexasGUI::Simd::Detail::copyRGBA8MinMax_AVX2(
+	unsigned char const* src,
+	std::uint64_t pixelCount,
+	unsigned char* dst,
+	std::uint8_t* min,
+	std::uint8_t* max) noexcept
+{
+	// 8 pixels per vector, lane j is always channel j % 4.
+	__m256i accMin = _mm256_set1_epi8(static_cast<char>(0xFF));
+	__m256i accMax = _mm256_setzero_si256();
+
+	std::uint64_t pixelIndex = 0;
+	for (; pixelIndex + 8 <= pixelCount; pixelIndex += 8)
+	{
+		__m256i value = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(src + pixelIndex * 4));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + pixelIndex * 4), value);
+		accMin = _mm256_min_epu8(accMin, value);
+		accMax = _mm256_max_epu8(accMax, value);
+	}
+
+	copyRGBA8MinMax_Scalar(src + pixelIndex * 4, pixelCount - pixelIndex, dst + pixelIndex * 4, min, max);
+
+	alignas(32) std::uint8_t lanesMin[32];
+	alignas(32) std::uint8_t lanesMax[32];
+	_mm256_store_si256(reinterpret_cast<__m256i*>(lanesMin), accMin);
+	_mm256_store_si256(reinterpret_cast<__m256i*>(lanesMax), accMax);
+	for (std::uint8_t j = 0; j < 32; j++)
+	{
+		min[j % 4] = std::min(min[j % 4], lanesMin[j]);
+		max[j % 4] = std::max(max[j % 4], lanesMax[j]);
+	}
+}
+
+void TexasGUI::Simd::Detail::halfToFloat_AVX2(
+	std::uint16_t const* src,
+	std::uint64_t count,
+	float* dst) noexcept
+{
+	std::uint64_t i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		__m128i const halves = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i));
+		_mm256_storeu_ps(dst + i, _mm256_cvtph_ps(halves));
+	}
+
+	halfToFloat_Scalar(src + i, count - i, dst + i);
+}
+
+void TexasGUI::Simd::Detail::blendRowsRGBA32F_AVX2(
+	float const* const* rows,
+	float const* weights,
+	std::uint32_t rowCount,
+	std::uint64_t pixelCount,
+	float* dst) noexcept
+{
+	// Four pixels at a time, in two independent sums.
+	std::uint64_t const count = pixelCount * 4;
+	std::uint64_t i = 0;
+	for (; i + 16 <= count; i += 16)
+	{
+		__m256 sum0 = _mm256_setzero_ps();
+		__m256 sum1 = _mm256_setzero_ps();
+		for (std::uint32_t k = 0; k < rowCount; k++)
+		{
+			__m256 const weight = _mm256_set1_ps(weights[k]);
+			sum0 = _mm256_add_ps(sum0, _mm256_mul_ps(weight, _mm256_loadu_ps(rows[k] + i)));
+			sum1 = _mm256_add_ps(sum1, _mm256_mul_ps(weight, _mm256_loadu_ps(rows[k] + i + 8)));
+		}
+		_mm256_storeu_ps(dst + i, sum0);
+		_mm256_storeu_ps(dst + i + 8, sum1);
+	}
+
+	for (; i < count; i += 4)
+	{
+		__m128 sum = _mm_setzero_ps();
+		for (std::uint32_t k = 0; k < rowCount; k++)
+			sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weights[k]), _mm_loadu_ps(rows[k] + i)));
+		_mm_storeu_ps(dst + i, sum);
+	}
+}
+
+void TexasGUI::Simd::Detail::floatToHalf_AVX2(
+	float const* src,
+	std::uint64_t count,
+	std::uint16_t* dst) noexcept
+{
+	std::uint64_t i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		__m128i const halves = _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), halves);
+	}
+
+	floatToHalf_Scalar(src + i, count - i, dst + i);
+}
+
+void TexasGUI::Simd::Detail::swapRedBlue8_AVX2(
+	unsigned char const* src,
+	std::uint64_t pixelCount,
+	unsigned char* dst) noexcept
+{
+	__m256i const shuffleMask = _mm256_setr_epi8(
+		2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+		2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+
+	std::uint64_t pixelIndex = 0;
+	for (; pixelIndex + 8 <= pixelCount; pixelIndex += 8)
+	{
+		__m256i const pixels = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(src + pixelIndex * 4));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + pixelIndex * 4), _mm256_shuffle_epi8(pixels, shuffleMask));
+	}
+
+	swapRedBlue8_Scalar(src + pixelIndex * 4, pixelCount - pixelIndex, dst + pixelIndex * 4);
+}
+
+void TexasGUI::Simd::Detail::unorm16ToUnorm8_AVX2(
+	std::uint16_t const* src,
+	std::uint64_t count,
+	std::uint8_t* dst) noexcept
+{
+	// Same rounding as the SSE2 version.
+	__m256i const half = _mm256_set1_epi16(128);
+
+	auto convert = [&](__m256i values) -> __m256i
+	{
+		__m256i const t = _mm256_adds_epu16(values, half);
+		return _mm256_srli_epi16(_mm256_sub_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+	};
+
+	std::uint64_t i = 0;
+	for (; i + 32 <= count; i += 32)
+	{
+		__m256i const low = convert(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(src + i)));
+		__m256i const high = convert(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(src + i + 16)));
+		// The pack works per 128-bit lane, which leaves the middle two quarters swapped.
+		__m256i const packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(low, high), 0xD8);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), packed);
+	}
+
+	unorm16ToUnorm8_Scalar(src + i, count - i, dst + i);
+}
+
+namespace TexasGUI::Simd::Detail
+{
+	// The same steps as the SSE2 versions, 8 values at a time. There is no FMA, so the results stay identical.
+	[[nodiscard]] static __m256 inverseCbrt_AVX2(__m256 value) noexcept
+	{
+		__m256 const third = _mm256_set1_ps(1.f / 3.f);
+		__m256 result = _mm256_castsi256_ps(_mm256_sub_epi32(
+			_mm256_set1_epi32(ColorSpace::Detail::inverseCbrtGuess),
+			_mm256_cvttps_epi32(_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_castps_si256(value)), third))));
+		__m256 const valueThird = _mm256_mul_ps(value, third);
+		for (int i = 0; i < 3; i++)
+		{
+			__m256 const squared = _mm256_mul_ps(result, result);
+			result = _mm256_add_ps(result, _mm256_sub_ps(_mm256_mul_ps(result, third), _mm256_mul_ps(valueThird, _mm256_mul_ps(squared, squared))));
+		}
+		return result;
+	}
+
+	[[nodiscard]] static __m256 inverseFifthRoot_AVX2(__m256 value) noexcept
+	{
+		__m256 const fifth = _mm256_set1_ps(0.2f);
+		__m256 result = _mm256_castsi256_ps(_mm256_sub_epi32(
+			_mm256_set1_epi32(ColorSpace::Detail::inverseFifthRootGuess),
+			_mm256_cvttps_epi32(_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_castps_si256(value)), fifth))));
+		__m256 const valueFifth = _mm256_mul_ps(value, fifth);
+		for (int i = 0; i < 3; i++)
+		{
+			__m256 const squared = _mm256_mul_ps(result, result);
+			__m256 const power6 = _mm256_mul_ps(_mm256_mul_ps(squared, squared), squared);
+			result = _mm256_add_ps(result, _mm256_sub_ps(_mm256_mul_ps(result, fifth), _mm256_mul_ps(valueFifth, power6)));
+		}
+		return result;
+	}
+
+	[[nodiscard]] static __m256 linearToSRGB_AVX2(__m256 value) noexcept
+	{
+		value = _mm256_max_ps(value, _mm256_setzero_ps());
+		value = _mm256_min_ps(value, _mm256_set1_ps(std::numeric_limits<float>::max()));
+		__m256 const root = _mm256_sqrt_ps(value);
+		__m256 const curve = _mm256_sub_ps(
+			_mm256_mul_ps(_mm256_set1_ps(1.055f), _mm256_mul_ps(root, _mm256_sqrt_ps(inverseCbrt_AVX2(root)))),
+			_mm256_set1_ps(0.055f));
+		__m256 const isLinear = _mm256_cmp_ps(value, _mm256_set1_ps(0.0031308f), _CMP_LE_OQ);
+		return _mm256_blendv_ps(curve, _mm256_mul_ps(value, _mm256_set1_ps(12.92f)), isLinear);
+	}
+
+	[[nodiscard]] static __m256 srgbToLinear_AVX2(__m256 value) noexcept
+	{
+		__m256 const base = _mm256_mul_ps(_mm256_add_ps(value, _mm256_set1_ps(0.055f)), _mm256_set1_ps(1.f / 1.055f));
+		__m256 const product = _mm256_mul_ps(base, inverseFifthRoot_AVX2(base));
+		__m256 const curve = _mm256_mul_ps(_mm256_mul_ps(product, product), product);
+		__m256 const isLinear = _mm256_cmp_ps(value, _mm256_set1_ps(0.04045f), _CMP_LE_OQ);
+		return _mm256_blendv_ps(curve, _mm256_mul_ps(value, _mm256_set1_ps(1.f / 12.92f)), isLinear);
+	}
+
+	// Two RGBA pixels to 8-bit codes in 32-bit lanes, one bucket and one threshold gather per channel.
+	[[nodiscard]] static __m256i encodeSRGB8_AVX2(__m256 value, ColorSpace::Detail::SRGB8Tables const& tables) noexcept
+	{
+		// maxps returns the second operand when either is NaN.
+		value = _mm256_min_ps(_mm256_max_ps(value, _mm256_setzero_ps()), _mm256_set1_ps(1.f));
+		__m256i const bucket = _mm256_cvttps_epi32(_mm256_mul_ps(value, _mm256_set1_ps(static_cast<float>(ColorSpace::Detail::srgb8BucketCount))));
+		// Gathers read 32 bits, the code is the lowest byte of them.
+		__m256i code = _mm256_and_si256(
+			_mm256_i32gather_epi32(reinterpret_cast<int const*>(tables.buckets), bucket, 1),
+			_mm256_set1_epi32(0xFF));
+		__m256 const threshold = _mm256_i32gather_ps(tables.thresholds, code, 4);
+		// The comparison is all ones where the value is past the threshold, subtracting it adds 1.
+		code = _mm256_sub_epi32(code, _mm256_castps_si256(_mm256_cmp_ps(value, threshold, _CMP_GE_OQ)));
+		__m256i const alpha = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(value, _mm256_set1_ps(255.f)), _mm256_set1_ps(0.5f)));
+		return _mm256_blend_epi32(code, alpha, 0x88);
+	}
+}
+
+void TexasGUI::Simd::Detail::decodeSRGBRGBA32F_AVX2(
+	float* rgba,
+	std::uint64_t pixelCount) noexcept
+{
+	std::uint64_t pixelIndex = 0;
+	for (; pixelIndex + 2 <= pixelCount; pixelIndex += 2)
+	{
+		__m256 const value = _mm256_loadu_ps(rgba + pixelIndex * 4);
+		_mm256_storeu_ps(rgba + pixelIndex * 4, _mm256_blend_ps(srgbToLinear_AVX2(value), value, 0x88));
+	}
+
+	decodeSRGBRGBA32F_Scalar(rgba + pixelIndex * 4, pixelCount - pixelIndex);
+}
+
+void TexasGUI::Simd::Detail::encodeSRGBRGBA32F_AVX2(
+	float* rgba,
+	std::uint64_t pixelCount) noexcept
+{
+	std::uint64_t pixelIndex = 0;
+	for (; pixelIndex + 2 <= pixelCount; pixelIndex += 2)
+	{
+		__m256 const value = _mm256_loadu_ps(rgba + pixelIndex * 4);
+		_mm256_storeu_ps(rgba + pixelIndex * 4, _mm256_blend_ps(linearToSRGB_AVX2(value), value, 0x88));
+	}
+
+	encodeSRGBRGBA32F_Scalar(rgba + pixelIndex * 4, pixelCount - pixelIndex);
+}
+
+void TexasGUI::Simd::Detail::decodeSRGBRGBA8ToRGBA32F_AVX2(
+	unsigned char const* src,
+	std::uint64_t pixelCount,
+	float* dst) noexcept
+{
+	// Alpha lanes look up the second half of the table, which only scales.
+	float const* toLinear = ColorSpace::Detail::srgb8Tables().toLinear;
+	__m256i const alphaOffset = _mm256_setr_epi32(0, 0, 0, 256, 0, 0, 0, 256);
+
+	std::uint64_t pixelIndex = 0;
+	for (; pixelIndex + 2 <= pixelCount; pixelIndex += 2)
+	{
+		__m256i const codes = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<__m128i const*>(src + pixelIndex * 4)));
+		_mm256_storeu_ps(dst + pixelIndex * 4, _mm256_i32gather_ps(toLinear, _mm256_add_epi32(codes, alphaOffset), 4));
+	}
+
+	decodeSRGBRGBA8ToRGBA32F_Scalar(src + pixelIndex * 4, pixelCount - pixelIndex, dst + pixelIndex * 4);
+}
+
+void TexasGUI::Simd::Detail::encodeSRGBRGBA32FToRGBA8_AVX2(
+	float const* src,
+	std::uint64_t pixelCount,
+	unsigned char* dst) noexcept
+{
+	ColorSpace::Detail::SRGB8Tables const& tables = ColorSpace::Detail::srgb8Tables();
+	// The packs work per 128-bit lane, which leaves the pixels in the order 0 2 4 6 1 3 5 7.
+	__m256i const pixelOrder = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+	std::uint64_t pixelIndex = 0;
+	for (; pixelIndex + 8 <= pixelCount; pixelIndex += 8)
+	{
+		float const* block = src + pixelIndex * 4;
+		__m256i const low = _mm256_packs_epi32(encodeSRGB8_AVX2(_mm256_loadu_ps(block), tables), encodeSRGB8_AVX2(_mm256_loadu_ps(block + 8), tables));
+		__m256i const high = _mm256_packs_epi32(encodeSRGB8_AVX2(_mm256_loadu_ps(block + 16), tables), encodeSRGB8_AVX2(_mm256_loadu_ps(block + 24), tables));
+		__m256i const packed = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(low, high), pixelOrder);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + pixelIndex * 4), packed);
+	}
+
+	encodeSRGBRGBA32FToRGBA8_Scalar(src + pixelIndex * 4, pixelCount - pixelIndex, dst + pixelIndex * 4);
+}
+
+void TexasGUI::Simd::Detail::sumSquaredErrorRGBA32F_AVX2(
+	float const* a,
+	float const* b,
+	std::uint64_t pixelCount,
+	double* sums) noexcept
+{
+	// A pixel per register, widened to doubles, with even and odd pixels in separate sums.
+	__m256d even = _mm256_setzero_pd();
+	__m256d odd = _mm256_setzero_pd();
+	std::uint64_t pixelIndex = 0;
+	for (; pixelIndex + 2 <= pixelCount; pixelIndex += 2)
+	{
+		__m256 const difference = _mm256_sub_ps(_mm256_loadu_ps(a + pixelIndex * 4), _mm256_loadu_ps(b + pixelIndex * 4));
+		__m256d const difference0 = _mm256_cvtps_pd(_mm256_castps256_ps128(difference));
+		__m256d const difference1 = _mm256_cvtps_pd(_mm256_extractf128_ps(difference, 1));
+		even = _mm256_add_pd(even, _mm256_mul_pd(difference0, difference0));
+		odd = _mm256_add_pd(odd, _mm256_mul_pd(difference1, difference1));
+	}
+	if (pixelIndex < pixelCount)
+	{
+		__m256d const difference = _mm256_cvtps_pd(_mm_sub_ps(_mm_loadu_ps(a + pixelIndex * 4), _mm_loadu_ps(b + pixelIndex * 4)));
+		even = _mm256_add_pd(even, _mm256_mul_pd(difference, difference));
+	}
+	_mm256_storeu_pd(sums, _mm256_add_pd(_mm256_loadu_pd(sums), _mm256_add_pd(even, odd)));
+}
+
+void TexasGUI::Simd::Detail::ssimBlockSumsRGBA32F_AVX2(
+	float const* a,
+	float const* b,
+	std::uint64_t rowStride,
+	std::uint64_t blockCount,
+	float* sums) noexcept
+{
+	// Two neighbouring blocks at a time, one in each half, so every sum is added up in the same order as scalar.
+	auto loadPair = [](float const* first)
+	{
+		return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(first)), _mm_loadu_ps(first + 16), 1);
+	};
+	std::uint64_t blockIndex = 0;
+	for (; blockIndex + 2 <= blockCount; blockIndex += 2)
+	{
+		__m256 sumA = _mm256_setzero_ps();
+		__m256 sumB = _mm256_setzero_ps();
+		__m256 sumSquares = _mm256_setzero_ps();
+		__m256 sumProducts = _mm256_setzero_ps();
+		for (std::uint64_t y = 0; y < 4; y++)
+		{
+			float const* rowA = a + y * rowStride + blockIndex * 16;
+			float const* rowB = b + y * rowStride + blockIndex * 16;
+			for (int x = 0; x < 4; x++)
+			{
+				__m256 const valueA = loadPair(rowA + x * 4);
+				__m256 const valueB = loadPair(rowB + x * 4);
+				sumA = _mm256_add_ps(sumA, valueA);
+				sumB = _mm256_add_ps(sumB, valueB);
+				sumSquares = _mm256_add_ps(sumSquares, _mm256_add_ps(_mm256_mul_ps(valueA, valueA), _mm256_mul_ps(valueB, valueB)));
+				sumProducts = _mm256_add_ps(sumProducts, _mm256_mul_ps(valueA, valueB));
+			}
+		}
+		float* blockSums = sums + blockIndex * 16;
+		_mm256_storeu_ps(blockSums, _mm256_permute2f128_ps(sumA, sumB, 0x20));
+		_mm256_storeu_ps(blockSums + 8, _mm256_permute2f128_ps(sumSquares, sumProducts, 0x20));
+		_mm256_storeu_ps(blockSums + 16, _mm256_permute2f128_ps(sumA, sumB, 0x31));
+		_mm256_storeu_ps(blockSums + 24, _mm256_permute2f128_ps(sumSquares, sumProducts, 0x31));
+	}
+
+	ssimBlockSumsRGBA32F_Scalar(a + blockIndex * 16, b + blockIndex * 16, rowStride, blockCount - blockIndex, sums + blockIndex * 16);
+}
+#endif
@@ -0,0 +1,96 @@
+#include "TexasGUI/SimdKernels.hpp"
+
+// Built with SSSE3 enabled, only ever called after the dispatcher has checked the CPU.
+#ifdef TEXASGUI_SIMD_X86
+#include <tmmintrin.h>
+
+#include <algorithm>
+
+void TexasGUI::Simd::Detail::expandRGB8ToRGBA8_SSSE3(
+	unsigned char const* src,
+	std::uint64_t pixelCount,
+	unsigned char* dst) noexcept
+{
+	// Every 16-byte load holds 4 whole RGB pixels (12 bytes) that get spread out to 16 bytes.
+	__m128i const shuffleMask = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+	__m128i const alphaMask = _mm_set1_epi32(static_cast<int>(0xFF000000));
+
+	std::uint64_t pixelIndex = 0;
+	// The last load of a block reads 4 bytes past it, so leave room for that.
+	for (; pixelIndex + 18 <= pixelCount; pixelIndex += 16)
+	{
+		unsigned char const* srcBlock = src + pixelIndex * 3;
+		__m128i* dstBlock = reinterpret_cast<__m128i*>(dst + pixelIndex * 4);
+		for (int i = 0; i < 4; i++)
+		{
+			__m128i rgb = _mm_loadu_si128(reinterpret_cast<__m128i const*>(srcBlock + i * 12));
+			__m128i rgba = _mm_or_si128(_mm_shuffle_epi8(rgb, shuffleMask), alphaMask);
+			_mm_storeu_si128(dstBlock + i, rgba);
+		}
+	}
+
+	expandRGB8ToRGBA8_Scalar(src + pixelIndex * 3, pixelCount - pixelIndex, dst + pixelIndex * 4);
+}
+
+void TexasGUI::Simd::Detail::expandRGB8ToRGBA8MinMax_SSSE3(
+	unsigned char const* src,
+	std::uint64_t pixelCount,
+	unsigned char* dst,
+	std::uint8_t* min,
+	std::uint8_t* max) noexcept
+{
+	__m128i const shuffleMask = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+	__m128i const alphaMask = _mm_set1_epi32(static_cast<int>(0xFF000000));
+
+	// Reduce on the expanded pixels, where lane j is always channel j % 4.
+	__m128i accMin = _mm_set1_epi8(static_cast<char>(0xFF));
+	__m128i accMax = _mm_setzero_si128();
+
+	std::uint64_t pixelIndex = 0;
+	for (; pixelIndex + 18 <= pixelCount; pixelIndex += 16)
+	{
+		unsigned char const* srcBlock = src + pixelIndex * 3;
+		__m128i* dstBlock = reinterpret_cast<__m128i*>(dst + pixelIndex * 4);
+		for (int i = 0; i < 4; i++)
+		{
+			__m128i rgb = _mm_loadu_si128(reinterpret_cast<__m128i const*>(srcBlock + i * 12));
+			__m128i rgba = _mm_or_si128(_mm_shuffle_epi8(rgb, shuffleMask), alphaMask);
+			_mm_storeu_si128(dstBlock + i, rgba);
+			accMin = _mm_min_epu8(accMin, rgba);
+			accMax = _mm_max_epu8(accMax, rgba);
+		}
+	}
+
+	expandRGB8ToRGBA8MinMax_Scalar(src + pixelIndex * 3, pixelCount - pixelIndex, dst + pixelIndex * 4, min, max);
+
+	alignas(16) std::uint8_t lanesMin[16];
+	alignas(16) std::uint8_t lanesMax[16];
+	_mm_store_si128(reinterpret_cast<__m128i*>(lanesMin), accMin);
+	_mm_store_si128(reinterpret_cast<__m128i*>(lanesMax), accMax);
+	for (std::uint8_t j = 0; j < 16; j++)
+	{
+		// The alpha lanes are the constant we put there, not source data.
+		if (j % 4 == 3)
+			continue;
+		min[j % 4] = std::min(min[j % 4], lanesMin[j]);
+		max[j % 4] = std::max(max[j % 4], lanesMax[j]);
+	}
+}
+
+void TexasGUI::Simd::Detail::swapRedBlue8_SSSE3(
+	unsigned char const* src,
+	std::uint64_t pixelCount,
+	unsigned char* dst) noexcept
+{
+	__m128i const shuffleMask = _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+
+	std::uint64_t pixelIndex = 0;
+	for (; pixelIndex + 4 <= pixelCount; pixelIndex += 4)
+	{
+		__m128i const pixels = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + pixelIndex * 4));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + pixelIndex * 4), _mm_shuffle_epi8(pixels, shuffleMask));
+	}
+
+	swapRedBlue8_Scalar(src + pixelIndex * 4, pixelCount - pixelIndex, dst + pixelIndex * 4);
+}
+#endif
@@ -0,0 +1,547 @@
+#include "TexasGUI/Statistics.hpp"
+
+#include "TexasGUI/BCnDecoder.hpp"
+#include "TexasGUI/ColorSpace.hpp"
+#include "TexasGUI/FormatTraits.hpp"
+#include "TexasGUI/Parallel.hpp"
+
+#include <QMutexLocker>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include "Texas/Tools.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <utility>
+
+namespace TexasGUI
+{
+	// Small enough that a single mip level still keeps every core busy, each chunk is widened to doubles first.
+	constexpr std::uint64_t statisticsPixelsPerChunk = 1 << 16;
+
+	// Widens pixelCount tightly packed pixels to channelCount doubles each.
+	using LoadKernel = void(*)(unsigned char const*, std::uint64_t, double*);
+
+	template<Texas::PixelFormat pixelFormat, Texas::ChannelType channelType>
+	void LoadChannels_Internal(
+		unsigned char const* srcData,
+		std::uint64_t pixelCount,
+		double* dst)
+	{
+		using Traits = FormatTraits<pixelFormat, channelType>;
+		constexpr std::uint8_t channelCount = Traits::channelCount;
+		for (std::uint64_t pixelIndex = 0; pixelIndex < pixelCount; pixelIndex++)
+		{
+			unsigned char const* srcPixel = srcData + pixelIndex * Traits::bytesPerPixel;
+			for (std::uint8_t i = 0; i < channelCount; i++)
+				dst[pixelIndex * channelCount + i] = static_cast<double>(loadChannel<Traits>(srcPixel + i * Traits::bytesPerChannel));
+		}
+	}
+
+	struct StatisticsKernels
+	{
+		Texas::PixelFormat pixelFormat;
+		Texas::ChannelType channelType;
+		std::uint8_t channelCount;
+		std::uint8_t bytesPerPixel;
+		bool binPerValue;
+		double histogramMin;
+		// The largest stored value of unsigned channels, which sRGB decoding needs to normalize them. 0 otherwise.
+		double unsignedMax;
+		LoadKernel load;
+	};
+
+	template<Texas::PixelFormat pixelFormat, Texas::ChannelType channelType>
+	constexpr StatisticsKernels makeStatisticsKernels()
+	{
+		using Traits = FormatTraits<pixelFormat, channelType>;
+		StatisticsKernels kernels{ pixelFormat, channelType, 0, 0, false, 0.0, 0.0, nullptr };
+		if constexpr (Traits::isSupported)
+		{
+			kernels.channelCount = Traits::channelCount;
+			kernels.bytesPerPixel = Traits::bytesPerPixel;
+			kernels.binPerValue = Traits::bytesPerChannel == 1;
+			kernels.histogramMin = Traits::channelClass == ChannelClass::Signed ? -128.0 : 0.0;
+			if constexpr (Traits::channelClass == ChannelClass::Unsigned)
+				kernels.unsignedMax = static_cast<double>(std::numeric_limits<typename Traits::Storage>::max());
+			kernels.load = &LoadChannels_Internal<pixelFormat, channelType>;
+		}
+		return kernels;
+	}
+
+	constexpr std::size_t statisticsChannelTypeCount = sizeof(allChannelTypes) / sizeof(allChannelTypes[0]);
+
+	template<std::size_t... indices>
+	constexpr std::array<StatisticsKernels, sizeof...(indices)> makeStatisticsKernelTable(std::index_sequence<indices...>)
+	{
+		return { { makeStatisticsKernels<uncompressedPixelFormats[indices / statisticsChannelTypeCount], allChannelTypes[indices % statisticsChannelTypeCount]>()... } };
+	}
+
+	constexpr auto statisticsKernelTable = makeStatisticsKernelTable(
+		std::make_index_sequence<sizeof(uncompressedPixelFormats) / sizeof(uncompressedPixelFormats[0]) * statisticsChannelTypeCount>());
+
+	[[nodiscard]] static StatisticsKernels const* findStatisticsKernels(Texas::PixelFormat pixelFormat, Texas::ChannelType channelType)
+	{
+		for (StatisticsKernels const& kernels : statisticsKernelTable)
+		{
+			if (kernels.pixelFormat == pixelFormat && kernels.channelType == channelType)
+				return kernels.load != nullptr ? &kernels : nullptr;
+		}
+		return nullptr;
+	}
+
+	// Channels that carry data after decoding, the decoders fill in the rest.
+	[[nodiscard]] static std::uint8_t blockChannelCount(Texas::PixelFormat pixelFormat) noexcept
+	{
+		switch (pixelFormat)
+		{
+		case Texas::PixelFormat::BC4:
+			return 1;
+		case Texas::PixelFormat::BC5:
+			return 2;
+		case Texas::PixelFormat::BC1_RGB:
+		case Texas::PixelFormat::BC6H:
+			return 3;
+		default:
+			return 4;
+		}
+	}
+
+	// Signed BC4 and BC5, which the decoders hand back with 128 added to every value.
+	[[nodiscard]] static bool isSignedBlockFormat(Texas::TextureInfo const& texInfo) noexcept
+	{
+		return
+			texInfo.channelType == Texas::ChannelType::SignedNormalized &&
+			(texInfo.pixelFormat == Texas::PixelFormat::BC4 || texInfo.pixelFormat == Texas::PixelFormat::BC5);
+	}
+
+	// Decodes one block to 16 RGBA floats. Signed channels come out as [-127, 127], like SNORM8 reads.
+	static void decodeBlockToFloats(Texas::TextureInfo const& texInfo, unsigned char const* block, float* dst) noexcept
+	{
+		bool const isSignedNormalized = texInfo.channelType == Texas::ChannelType::SignedNormalized;
+		unsigned char decoded[16 * 4];
+		switch (texInfo.pixelFormat)
+		{
+		case Texas::PixelFormat::BC1_RGB:
+			BCn::decodeBC1(block, decoded, false);
+			break;
+		case Texas::PixelFormat::BC1_RGBA:
+			BCn::decodeBC1(block, decoded, true);
+			break;
+		case Texas::PixelFormat::BC2_RGBA:
+			BCn::decodeBC2(block, decoded);
+			break;
+		case Texas::PixelFormat::BC3_RGBA:
+			BCn::decodeBC3(block, decoded);
+			break;
+		case Texas::PixelFormat::BC4:
+			BCn::decodeBC4(block, decoded, isSignedNormalized);
+			break;
+		case Texas::PixelFormat::BC5:
+			BCn::decodeBC5(block, decoded, isSignedNormalized);
+			break;
+		case Texas::PixelFormat::BC6H:
+			BCn::decodeBC6H(block, dst, texInfo.channelType == Texas::ChannelType::SignedFloat);
+			return;
+		default:
+			BCn::decodeBC7(block, decoded);
+			break;
+		}
+		float const offset = isSignedBlockFormat(texInfo) ? 128.f : 0.f;
+		for (std::uint8_t i = 0; i < 16 * 4; i++)
+			dst[i] = decoded[i] - offset;
+	}
+
+	// Sums of one chunk, merged in chunk order afterwards so the result doesn't depend on scheduling.
+	struct ChunkMoments
+	{
+		std::uint64_t count[4] = {};
+		std::uint64_t nonFiniteCount[4] = {};
+		double sum[4] = {};
+		double sumOfSquares[4] = {};
+		// Of the color channels decoded from sRGB.
+		double linearSum[3] = {};
+		double linearSumOfSquares[3] = {};
+		double min[4] = {
+			std::numeric_limits<double>::infinity(),
+			std::numeric_limits<double>::infinity(),
+			std::numeric_limits<double>::infinity(),
+			std::numeric_limits<double>::infinity() };
+		double max[4] = {
+			-std::numeric_limits<double>::infinity(),
+			-std::numeric_limits<double>::infinity(),
+			-std::numeric_limits<double>::infinity(),
+			-std::numeric_limits<double>::infinity() };
+	};
+
+	// Chan et al.'s pairwise update, so large subresources don't lose the variance to cancellation.
+	struct MergedMoments
+	{
+		double mean = 0.0;
+		double m2 = 0.0;
+		std::uint64_t count = 0;
+
+		void merge(std::uint64_t chunkCount, double sum, double sumOfSquares) noexcept
+		{
+			if (chunkCount == 0)
+				return;
+			double const chunkCountValue = double(chunkCount);
+			double const chunkMean = sum / chunkCountValue;
+			double const chunkM2 = std::max(sumOfSquares - sum * chunkMean, 0.0);
+			double const delta = chunkMean - mean;
+			std::uint64_t const newCount = count + chunkCount;
+			mean += delta * chunkCountValue / double(newCount);
+			m2 += chunkM2 + delta * delta * double(count) * chunkCountValue / double(newCount);
+			count = newCount;
+		}
+
+		[[nodiscard]] double stddev() const noexcept
+		{
+			return count > 0 ? std::sqrt(m2 / double(count)) : 0.0;
+		}
+	};
+
+	[[nodiscard]] static int binIndex(double value, double histogramMin, double binScale) noexcept
+	{
+		int const bin = static_cast<int>((value - histogramMin) * binScale);
+		return std::clamp(bin, 0, SubresourceStatistics::binCount - 1);
+	}
+}
+
+std::uint32_t const* TexasGUI::SubresourceStatistics::channelHistogram(std::uint8_t channel) const noexcept
+{
+	return this->histogram.data() + std::size_t(channel) * binCount;
+}
+
+double TexasGUI::SubresourceStatistics::percentile(std::uint8_t channel, double fraction) const noexcept
+{
+	Channel const& stats = this->channels[channel];
+	if (stats.count == 0)
+		return 0.0;
+
+	std::uint32_t const* bins = channelHistogram(channel);
+	double const rank = std::clamp(fraction, 0.0, 1.0) * double(stats.count);
+	double const binWidth = this->binPerValue ? 1.0 : (this->histogramMax[channel] - this->histogramMin[channel]) / binCount;
+	std::uint64_t below = 0;
+	for (int bin = 0; bin < binCount; bin++)
+	{
+		if (bins[bin] == 0)
+			continue;
+		if (double(below + bins[bin]) >= rank)
+		{
+			if (this->binPerValue)
+				return this->histogramMin[channel] + bin;
+			double const withinBin = (rank - double(below)) / double(bins[bin]);
+			double const value = this->histogramMin[channel] + (bin + withinBin) * binWidth;
+			return std::clamp(value, stats.min, stats.max);
+		}
+		below += bins[bin];
+	}
+	return stats.max;
+}
+
+bool TexasGUI::ComputeSubresourceStatistics(
+	Texas::TextureInfo const& texInfo,
+	Texas::ConstByteSpan byteSpan,
+	std::uint64_t mipIndex,
+	std::uint64_t layerIndex,
+	SubresourceStatistics& statistics,
+	KernelProgress* progress,
+	int maxThreads)
+{
+	bool const isBlockCompressed = BCn::isBlockCompressed(texInfo.pixelFormat);
+	StatisticsKernels const* kernels = nullptr;
+	if (!isBlockCompressed)
+	{
+		kernels = findStatisticsKernels(texInfo.pixelFormat, texInfo.channelType);
+		if (kernels == nullptr)
+			return false;
+	}
+
+	Texas::Dimensions const mipDimensions = Texas::calculateMipDimensions(texInfo.baseDimensions, mipIndex);
+	unsigned char const* srcData = (unsigned char const*)byteSpan.data() + Texas::calculateLayerOffset(texInfo, mipIndex, layerIndex);
+	std::uint8_t const channelCount = isBlockCompressed ? blockChannelCount(texInfo.pixelFormat) : kernels->channelCount;
+
+	// Uncompressed chunks are runs of pixels. Block compressed ones are runs of block rows, which
+	// include the padding pixels of blocks on the right and bottom edges, those are skipped when loading.
+	std::uint64_t const blocksPerRow = (mipDimensions.width + 3) / 4;
+	std::uint64_t const blockRowsPerSlice = (mipDimensions.height + 3) / 4;
+	std::uint64_t const pixelCount = mipDimensions.width * mipDimensions.height * mipDimensions.depth;
+	std::uint64_t chunkCount;
+	std::uint64_t blockRowsPerChunk = 0;
+	if (isBlockCompressed)
+	{
+		blockRowsPerChunk = std::max<std::uint64_t>(statisticsPixelsPerChunk / (blocksPerRow * 16), 1);
+		chunkCount = (blockRowsPerSlice * mipDimensions.depth + blockRowsPerChunk - 1) / blockRowsPerChunk;
+	}
+	else
+		chunkCount = (pixelCount + statisticsPixelsPerChunk - 1) / statisticsPixelsPerChunk;
+
+	// Fills values with channelCount doubles per pixel and returns how many pixels that was.
+	auto loadChunk = [&](std::uint64_t chunkIndex, std::vector<double>& values) -> std::uint64_t
+	{
+		if (!isBlockCompressed)
+		{
+			std::uint64_t const firstPixel = chunkIndex * statisticsPixelsPerChunk;
+			std::uint64_t const chunkPixels = std::min(statisticsPixelsPerChunk, pixelCount - firstPixel);
+			values.resize(chunkPixels * channelCount);
+			kernels->load(srcData + firstPixel * kernels->bytesPerPixel, chunkPixels, values.data());
+			return chunkPixels;
+		}
+
+		std::uint8_t const bytesPerBlock = BCn::blockSize(texInfo.pixelFormat);
+		std::uint64_t const firstBlockRow = chunkIndex * blockRowsPerChunk;
+		std::uint64_t const lastBlockRow = std::min(firstBlockRow + blockRowsPerChunk, blockRowsPerSlice * mipDimensions.depth);
+		values.resize((lastBlockRow - firstBlockRow) * blocksPerRow * 16 * channelCount);
+		std::uint64_t chunkPixels = 0;
+		float decoded[16 * 4];
+		for (std::uint64_t blockRow = firstBlockRow; blockRow < lastBlockRow; blockRow++)
+		{
+			std::uint64_t const firstY = (blockRow % blockRowsPerSlice) * 4;
+			std::uint64_t const rowCount = std::min<std::uint64_t>(4, mipDimensions.height - firstY);
+			for (std::uint64_t blockX = 0; blockX < blocksPerRow; blockX++)
+			{
+				decodeBlockToFloats(texInfo, srcData + (blockRow * blocksPerRow + blockX) * bytesPerBlock, decoded);
+				std::uint64_t const columnCount = std::min<std::uint64_t>(4, mipDimensions.width - blockX * 4);
+				for (std::uint64_t y = 0; y < rowCount; y++)
+				{
+					for (std::uint64_t x = 0; x < columnCount; x++)
+					{
+						for (std::uint8_t i = 0; i < channelCount; i++)
+							values[chunkPixels * channelCount + i] = decoded[(y * 4 + x) * 4 + i];
+						chunkPixels++;
+					}
+				}
+			}
+		}
+		return chunkPixels;
+	};
+
+	bool const binPerValue = isBlockCompressed ? texInfo.pixelFormat != Texas::PixelFormat::BC6H : kernels->binPerValue;
+	bool const isSignedBlock = isBlockCompressed && isSignedBlockFormat(texInfo);
+	double const fixedHistogramMin = isBlockCompressed ? (isSignedBlock ? -128.0 : 0.0) : kernels->histogramMin;
+	std::uint64_t const passCount = binPerValue ? 1 : 2;
+	if (progress != nullptr)
+		progress->totalUnits.fetch_add(chunkCount * passCount, std::memory_order_relaxed);
+
+	// BC6H is the only block format with float channels, and those are always linear, as are signed BC4/BC5.
+	bool const isUnsignedBlock = texInfo.pixelFormat != Texas::PixelFormat::BC6H && !isSignedBlock;
+	double const unsignedMax = isBlockCompressed ? (isUnsignedBlock ? 255.0 : 0.0) : kernels->unsignedMax;
+	bool const isSRGB = unsignedMax > 0.0 && ColorSpace::isSRGBEncoded(texInfo);
+	// Alpha is never encoded.
+	std::uint8_t const colorChannelCount = isSRGB ? std::min<std::uint8_t>(channelCount, 3) : 0;
+
+	statistics = SubresourceStatistics{};
+	statistics.channelCount = channelCount;
+	statistics.isSRGBEncoded = isSRGB;
+	statistics.binPerValue = binPerValue;
+	statistics.histogram.assign(std::size_t(channelCount) * SubresourceStatistics::binCount, 0);
+	std::mutex histogramMutex;
+
+	// Adds one chunk's bins to the total.
+	auto mergeHistogram = [&](std::vector<std::uint32_t> const& chunkHistogram)
+	{
+		std::lock_guard<std::mutex> lock(histogramMutex);
+		for (std::size_t i = 0; i < chunkHistogram.size(); i++)
+			statistics.histogram[i] += chunkHistogram[i];
+	};
+
+	// First pass: moments and range. 8-bit formats know their histogram range up front and fill it in here too.
+	std::vector<ChunkMoments> chunkMoments(chunkCount);
+	parallelFor(chunkCount, [&](std::uint64_t chunkIndex)
+	{
+		if (progress != nullptr && progress->cancelled.load(std::memory_order_relaxed))
+			return;
+
+		std::vector<double> values;
+		std::uint64_t const chunkPixels = loadChunk(chunkIndex, values);
+		ChunkMoments& moments = chunkMoments[chunkIndex];
+		std::vector<std::uint32_t> chunkHistogram(binPerValue ? statistics.histogram.size() : 0, 0);
+		for (std::uint64_t pixelIndex = 0; pixelIndex < chunkPixels; pixelIndex++)
+		{
+			for (std::uint8_t i = 0; i < channelCount; i++)
+			{
+				double const value = values[pixelIndex * channelCount + i];
+				if (!std::isfinite(value))
+				{
+					moments.nonFiniteCount[i]++;
+					continue;
+				}
+				moments.count[i]++;
+				moments.sum[i] += value;
+				moments.sumOfSquares[i] += value * value;
+				moments.min[i] = std::min(moments.min[i], value);
+				moments.max[i] = std::max(moments.max[i], value);
+				if (binPerValue)
+					chunkHistogram[std::size_t(i) * SubresourceStatistics::binCount + binIndex(value, fixedHistogramMin, 1.0)]++;
+				if (i < colorChannelCount)
+				{
+					// 8 bits are looked up, anything wider goes through the curve.
+					double const linear = unsignedMax == 255.0 ?
+						double(ColorSpace::srgb8ToLinear(static_cast<std::uint8_t>(value))) :
+						double(ColorSpace::srgbToLinear(static_cast<float>(value / unsignedMax)));
+					moments.linearSum[i] += linear;
+					moments.linearSumOfSquares[i] += linear * linear;
+				}
+			}
+		}
+		if (binPerValue)
+			mergeHistogram(chunkHistogram);
+
+		if (progress != nullptr)
+			progress->completedUnits.fetch_add(1, std::memory_order_relaxed);
+	}, maxThreads);
+
+	if (progress != nullptr && progress->cancelled.load(std::memory_order_relaxed))
+		return false;
+
+	for (std::uint8_t i = 0; i < channelCount; i++)
+	{
+		SubresourceStatistics::Channel& channel = statistics.channels[i];
+		MergedMoments merged;
+		MergedMoments linear;
+		channel.min = std::numeric_limits<double>::infinity();
+		channel.max = -std::numeric_limits<double>::infinity();
+		for (ChunkMoments const& moments : chunkMoments)
+		{
+			channel.nonFiniteCount += moments.nonFiniteCount[i];
+			if (moments.count[i] == 0)
+				continue;
+			merged.merge(moments.count[i], moments.sum[i], moments.sumOfSquares[i]);
+			if (i < colorChannelCount)
+				linear.merge(moments.count[i], moments.linearSum[i], moments.linearSumOfSquares[i]);
+			channel.min = std::min(channel.min, moments.min[i]);
+			channel.max = std::max(channel.max, moments.max[i]);
+		}
+		std::uint64_t const count = merged.count;
+		channel.count = count;
+		channel.mean = merged.mean;
+		channel.stddev = merged.stddev();
+		channel.linearMean = linear.mean;
+		channel.linearStddev = linear.stddev();
+		if (count == 0)
+		{
+			channel.min = 0.0;
+			channel.max = 0.0;
+		}
+
+		if (binPerValue)
+		{
+			statistics.histogramMin[i] = fixedHistogramMin;
+			statistics.histogramMax[i] = fixedHistogramMin + SubresourceStatistics::binCount - 1;
+		}
+		else
+		{
+			statistics.histogramMin[i] = channel.min;
+			statistics.histogramMax[i] = channel.max;
+		}
+	}
+	if (binPerValue)
+		return true;
+
+	// Second pass: now that the range is known, the histogram.
+	double binScale[4] = {};
+	for (std::uint8_t i = 0; i < channelCount; i++)
+	{
+		double const range = statistics.histogramMax[i] - statistics.histogramMin[i];
+		// A flat channel ends up entirely in the first bin.
+		binScale[i] = range > 0.0 ? SubresourceStatistics::binCount / range : 0.0;
+	}
+	parallelFor(chunkCount, [&](std::uint64_t chunkIndex)
+	{
+		if (progress != nullptr && progress->cancelled.load(std::memory_order_relaxed))
+			return;
+
+		std::vector<double> values;
+		std::uint64_t const chunkPixels = loadChunk(chunkIndex, values);
+		std::vector<std::uint32_t> chunkHistogram(statistics.histogram.size(), 0);
+		for (std::uint64_t pixelIndex = 0; pixelIndex < chunkPixels; pixelIndex++)
+		{
+			for (std::uint8_t i = 0; i < channelCount; i++)
+			{
+				double const value = values[pixelIndex * channelCount + i];
+				if (std::isfinite(value))
+					chunkHistogram[std::size_t(i) * SubresourceStatistics::binCount + binIndex(value, statistics.histogramMin[i], binScale[i])]++;
+			}
+		}
+		mergeHistogram(chunkHistogram);
+
+		if (progress != nullptr)
+			progress->completedUnits.fetch_add(1, std::memory_order_relaxed);
+	}, maxThreads);
+
+	return progress == nullptr || !progress->cancelled.load(std::memory_order_relaxed);
+}
+
+TexasGUI::StatisticsCache::StatisticsCache(Texas::TextureInfo const& texInfo, Texas::ConstByteSpan byteSpan) :
+	texInfo(texInfo),
+	byteSpan(byteSpan)
+{
+}
+
+TexasGUI::StatisticsCache::~StatisticsCache()
+{
+	QList<QFuture<void>> futures;
+	{
+		QMutexLocker lock(&this->mutex);
+		if (this->activeProgress != nullptr)
+			this->activeProgress->cancelled.store(true);
+		futures = this->pending;
+		futures.append(this->active);
+	}
+	// The workers write into this object, let them land first.
+	for (QFuture<void>& future : futures)
+		future.waitForFinished();
+}
+
+std::shared_ptr<TexasGUI::SubresourceStatistics const> TexasGUI::StatisticsCache::find(std::uint64_t mipIndex, std::uint64_t layerIndex) const
+{
+	QMutexLocker lock(&this->mutex);
+	auto iter = this->entries.find(Key{ mipIndex, layerIndex });
+	if (iter == this->entries.end())
+		return nullptr;
+	return iter->second;
+}
+
+QFuture<void> TexasGUI::StatisticsCache::request(std::uint64_t mipIndex, std::uint64_t layerIndex)
+{
+	Key const key{ mipIndex, layerIndex };
+	QMutexLocker lock(&this->mutex);
+	if (this->activeProgress != nullptr && this->activeKey == key && !this->active.isFinished())
+		return this->active;
+
+	// Whatever was being computed is for a subresource that is no longer on screen.
+	if (this->activeProgress != nullptr)
+	{
+		this->activeProgress->cancelled.store(true);
+		this->pending.append(this->active);
+	}
+	for (int i = this->pending.size() - 1; i >= 0; i -= 1)
+	{
+		if (this->pending[i].isFinished())
+			this->pending.removeAt(i);
+	}
+
+	std::shared_ptr<KernelProgress> progress = std::make_shared<KernelProgress>();
+	this->activeKey = key;
+	this->activeProgress = progress;
+	this->active = QtConcurrent::run([this, key, progress]()
+	{
+		{
+			QMutexLocker lock(&this->mutex);
+			if (this->entries.count(key) != 0)
+				return;
+		}
+
+		std::shared_ptr<SubresourceStatistics> statistics = std::make_shared<SubresourceStatistics>();
+		if (!ComputeSubresourceStatistics(this->texInfo, this->byteSpan, key.mipIndex, key.layerIndex, *statistics, progress.get()))
+			return;
+
+		QMutexLocker lock(&this->mutex);
+		this->entries.emplace(key, static_cast<std::shared_ptr<SubresourceStatistics>&&>(statistics));
+	});
+	return this->active;
+}
@@ -0,0 +1,426 @@
+#include "TexasGUI/TextureKernels.hpp"
+
+#include "TexasGUI/BCnDecoder.hpp"
+#include "TexasGUI/FormatTraits.hpp"
+#include "TexasGUI/Parallel.hpp"
+#include "TexasGUI/SimdKernels.hpp"
+
+#include "Texas/Tools.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+namespace TexasGUI
+{
+	// Where one subresource's displayable pixels go when its conversion is fused into the min/max pass.
+	struct DisplayTarget
+	{
+		std::uint64_t mipIndex;
+		std::uint64_t layerIndex;
+		unsigned char* data;
+	};
+
+	// Finds the per-channel min/max of pixelCount tightly packed pixels and stores one value per channel
+	// the format has in resultMin and resultMax, in the member the format's MinMaxData::Type says.
+	// With buildDisplayable the pixels are also converted to RGBA8 into displayDst in the same pass.
+	template<Texas::PixelFormat pixelFormat, Texas::ChannelType channelType, bool buildDisplayable>
+	void FindMinMaxValues_Internal(
+		unsigned char const* srcData,
+		std::uint64_t pixelCount,
+		unsigned char* displayDst,
+		MinMaxData::Value* resultMin,
+		MinMaxData::Value* resultMax)
+	{
+		using Traits = FormatTraits<pixelFormat, channelType>;
+		using Value = typename Traits::Value;
+		constexpr std::uint8_t channelCount = Traits::channelCount;
+
+		Value min[channelCount];
+		Value max[channelCount];
+
+		constexpr bool isByteFormat = std::is_same_v<typename Traits::Storage, std::uint8_t>;
+		constexpr bool isPlainRGB8 = isByteFormat && !Traits::isBGR && channelCount == 3;
+		constexpr bool isPlainRGBA8 = isByteFormat && !Traits::isBGR && channelCount == 4;
+		if constexpr (isByteFormat && (!buildDisplayable || isPlainRGB8 || isPlainRGBA8))
+		{
+			// 8-bit unsigned formats get the SIMD kernels.
+			if constexpr (!buildDisplayable)
+				Simd::minMaxU8(srcData, pixelCount, channelCount, min, max);
+			else if constexpr (isPlainRGB8)
+				Simd::expandRGB8ToRGBA8MinMax(srcData, pixelCount, displayDst, min, max);
+			else
+				Simd::copyRGBA8MinMax(srcData, pixelCount, displayDst, min, max);
+		}
+		else
+		{
+			for (std::uint8_t i = 0; i < channelCount; i++)
+			{
+				min[i] = std::numeric_limits<Value>::max();
+				max[i] = std::numeric_limits<Value>::lowest();
+			}
+			for (std::uint64_t pixelIndex = 0; pixelIndex < pixelCount; pixelIndex++)
+			{
+				unsigned char const* srcPixel = srcData + pixelIndex * Traits::bytesPerPixel;
+				Value channels[channelCount];
+				for (std::uint8_t i = 0; i < channelCount; i++)
+				{
+					channels[i] = loadChannel<Traits>(srcPixel + i * Traits::bytesPerChannel);
+					min[i] = std::min(min[i], channels[i]);
+					max[i] = std::max(max[i], channels[i]);
+				}
+				if constexpr (buildDisplayable)
+					writeDisplayPixel<Traits>(channels, displayDst + pixelIndex * 4);
+			}
+		}
+
+		for (std::uint8_t i = 0; i < channelCount; i++)
+		{
+			if constexpr (Traits::minMaxType == MinMaxData::Type::Float)
+			{
+				resultMin[i].float64 = min[i];
+				resultMax[i].float64 = max[i];
+			}
+			else if constexpr (Traits::minMaxType == MinMaxData::Type::Int)
+			{
+				resultMin[i].int64 = min[i];
+				resultMax[i].int64 = max[i];
+			}
+			else
+			{
+				resultMin[i].uint64 = min[i];
+				resultMax[i].uint64 = max[i];
+			}
+		}
+	}
+
+	template<Texas::PixelFormat pixelFormat, Texas::ChannelType channelType>
+	void BuildDisplayableSubresource_Internal(
+		unsigned char const* srcData,
+		std::uint64_t pixelCount,
+		unsigned char* dstData)
+	{
+		using Traits = FormatTraits<pixelFormat, channelType>;
+		using Value = typename Traits::Value;
+		constexpr std::uint8_t channelCount = Traits::channelCount;
+
+		constexpr bool isByteFormat = std::is_same_v<typename Traits::Storage, std::uint8_t>;
+		if constexpr (isByteFormat && !Traits::isBGR && channelCount == 3)
+			Simd::expandRGB8ToRGBA8(srcData, pixelCount, dstData);
+		else if constexpr (isByteFormat && !Traits::isBGR && channelCount == 4)
+			std::memcpy(dstData, srcData, pixelCount * 4);
+		else
+		{
+			for (std::uint64_t pixelIndex = 0; pixelIndex < pixelCount; pixelIndex++)
+			{
+				unsigned char const* srcPixel = srcData + pixelIndex * Traits::bytesPerPixel;
+				Value channels[channelCount];
+				for (std::uint8_t i = 0; i < channelCount; i++)
+					channels[i] = loadChannel<Traits>(srcPixel + i * Traits::bytesPerChannel);
+				writeDisplayPixel<Traits>(channels, dstData + pixelIndex * 4);
+			}
+		}
+	}
+
+	using MinMaxKernel = void(*)(unsigned char const*, std::uint64_t, unsigned char*, MinMaxData::Value*, MinMaxData::Value*);
+	using DisplayKernel = void(*)(unsigned char const*, std::uint64_t, unsigned char*);
+
+	// One entry per format/channel type pair. Kernels are null if the pair isn't supported.
+	struct FormatKernels
+	{
+		Texas::PixelFormat pixelFormat;
+		Texas::ChannelType channelType;
+		MinMaxData::Type minMaxType;
+		std::uint8_t channelCount;
+		std::uint8_t bytesPerPixel;
+		MinMaxKernel minMax;
+		MinMaxKernel minMaxAndDisplayable;
+		DisplayKernel displayable;
+	};
+
+	template<Texas::PixelFormat pixelFormat, Texas::ChannelType channelType>
+	constexpr FormatKernels makeFormatKernels()
+	{
+		using Traits = FormatTraits<pixelFormat, channelType>;
+		FormatKernels kernels{ pixelFormat, channelType, {}, 0, 0, nullptr, nullptr, nullptr };
+		if constexpr (Traits::isSupported)
+		{
+			kernels.minMaxType = Traits::minMaxType;
+			kernels.channelCount = Traits::channelCount;
+			kernels.bytesPerPixel = Traits::bytesPerPixel;
+			kernels.minMax = &FindMinMaxValues_Internal<pixelFormat, channelType, false>;
+			kernels.minMaxAndDisplayable = &FindMinMaxValues_Internal<pixelFormat, channelType, true>;
+			kernels.displayable = &BuildDisplayableSubresource_Internal<pixelFormat, channelType>;
+		}
+		return kernels;
+	}
+
+	constexpr std::size_t channelTypeCount = sizeof(allChannelTypes) / sizeof(allChannelTypes[0]);
+
+	// Every uncompressed pixel format crossed with every channel type.
+	template<std::size_t... indices>
+	constexpr std::array<FormatKernels, sizeof...(indices)> makeFormatKernelTable(std::index_sequence<indices...>)
+	{
+		return { { makeFormatKernels<uncompressedPixelFormats[indices / channelTypeCount], allChannelTypes[indices % channelTypeCount]>()... } };
+	}
+
+	constexpr auto formatKernelTable = makeFormatKernelTable(
+		std::make_index_sequence<sizeof(uncompressedPixelFormats) / sizeof(uncompressedPixelFormats[0]) * channelTypeCount>());
+
+	[[nodiscard]] static FormatKernels const* findFormatKernels(Texas::PixelFormat pixelFormat, Texas::ChannelType channelType)
+	{
+		for (FormatKernels const& kernels : formatKernelTable)
+		{
+			if (kernels.pixelFormat == pixelFormat && kernels.channelType == channelType)
+				return kernels.minMax != nullptr ? &kernels : nullptr;
+		}
+		return nullptr;
+	}
+
+	// Large subresources are split into chunks of this many pixels so that
+	// a single big base level still keeps every core busy.
+	constexpr std::uint64_t minMaxPixelsPerChunk = 1 << 18;
+
+	static void mergeMinMax(
+		MinMaxData::Type type,
+		std::uint8_t channelCount,
+		MinMaxData::Value* intoMin,
+		MinMaxData::Value* intoMax,
+		MinMaxData::Value const* fromMin,
+		MinMaxData::Value const* fromMax)
+	{
+		for (std::uint8_t i = 0; i < channelCount; i++)
+		{
+			switch (type)
+			{
+			case MinMaxData::Type::Int:
+				intoMin[i].int64 = std::min(intoMin[i].int64, fromMin[i].int64);
+				intoMax[i].int64 = std::max(intoMax[i].int64, fromMax[i].int64);
+				break;
+			case MinMaxData::Type::UnsignedInt:
+				intoMin[i].uint64 = std::min(intoMin[i].uint64, fromMin[i].uint64);
+				intoMax[i].uint64 = std::max(intoMax[i].uint64, fromMax[i].uint64);
+				break;
+			case MinMaxData::Type::Float:
+				intoMin[i].float64 = std::min(intoMin[i].float64, fromMin[i].float64);
+				intoMax[i].float64 = std::max(intoMax[i].float64, fromMax[i].float64);
+				break;
+			}
+		}
+	}
+
+	// Every (mip, layer) pair is independent, so each one is split into chunks,
+	// the chunks are reduced in parallel and the partial results merged per subresource at the end.
+	//
+	// If displayTarget is set, the chunks of that subresource also convert their pixels to RGBA8,
+	// so they're only pulled through the cache once for both the statistics and the display.
+	static void FindMinMaxValues_Chunked(
+		Texas::TextureInfo const& texInfo,
+		Texas::ConstByteSpan byteSpan,
+		FormatKernels const& kernels,
+		MinMaxData& minMaxData,
+		DisplayTarget const* displayTarget,
+		KernelProgress* progress,
+		int maxThreads)
+	{
+		struct Subresource
+		{
+			std::uint64_t mipIndex;
+			std::uint64_t layerIndex;
+			unsigned char const* data;
+			std::atomic<std::uint64_t> remainingChunks;
+		};
+		struct Chunk
+		{
+			std::uint64_t subresourceIndex;
+			std::uint64_t firstPixel;
+			std::uint64_t pixelCount;
+			MinMaxData::Value min[4];
+			MinMaxData::Value max[4];
+		};
+
+		minMaxData.reset(kernels.minMaxType, kernels.channelCount, texInfo.mipCount, texInfo.layerCount);
+
+		std::vector<Subresource> subresources(texInfo.mipCount * texInfo.layerCount);
+		std::vector<Chunk> chunks;
+		for (std::uint64_t mipIndex = 0; mipIndex < texInfo.mipCount; mipIndex++)
+		{
+			Texas::Dimensions mipDimensions = Texas::calculateMipDimensions(texInfo.baseDimensions, mipIndex);
+			std::uint64_t pixelCount = mipDimensions.width * mipDimensions.height * mipDimensions.depth;
+			std::uint64_t chunkCount = std::max<std::uint64_t>((pixelCount + minMaxPixelsPerChunk - 1) / minMaxPixelsPerChunk, 1);
+
+			for (std::uint64_t layerIndex = 0; layerIndex < texInfo.layerCount; layerIndex++)
+			{
+				std::uint64_t subresourceIndex = mipIndex * texInfo.layerCount + layerIndex;
+				Subresource& subresource = subresources[subresourceIndex];
+				subresource.mipIndex = mipIndex;
+				subresource.layerIndex = layerIndex;
+				subresource.data = (unsigned char const*)byteSpan.data() + Texas::calculateLayerOffset(texInfo, mipIndex, layerIndex);
+				subresource.remainingChunks.store(chunkCount, std::memory_order_relaxed);
+
+				for (std::uint64_t chunkIndex = 0; chunkIndex < chunkCount; chunkIndex++)
+				{
+					Chunk chunk{};
+					chunk.subresourceIndex = subresourceIndex;
+					chunk.firstPixel = chunkIndex * minMaxPixelsPerChunk;
+					chunk.pixelCount = std::min(minMaxPixelsPerChunk, pixelCount - chunk.firstPixel);
+					chunks.push_back(chunk);
+				}
+			}
+		}
+
+		parallelFor(chunks.size(), [&](std::uint64_t chunkIndex)
+		{
+			if (progress != nullptr && progress->cancelled.load(std::memory_order_relaxed))
+				return;
+
+			Chunk& chunk = chunks[chunkIndex];
+			Subresource& subresource = subresources[chunk.subresourceIndex];
+			unsigned char const* srcData = subresource.data + chunk.firstPixel * kernels.bytesPerPixel;
+			bool const isDisplayTarget =
+				displayTarget != nullptr &&
+				displayTarget->mipIndex == subresource.mipIndex &&
+				displayTarget->layerIndex == subresource.layerIndex;
+			if (isDisplayTarget)
+				kernels.minMaxAndDisplayable(srcData, chunk.pixelCount, displayTarget->data + chunk.firstPixel * 4, chunk.min, chunk.max);
+			else
+				kernels.minMax(srcData, chunk.pixelCount, nullptr, chunk.min, chunk.max);
+
+			if (subresource.remainingChunks.fetch_sub(1, std::memory_order_relaxed) == 1 && progress != nullptr)
+				progress->completedUnits.fetch_add(1, std::memory_order_relaxed);
+		}, maxThreads);
+
+		if (progress != nullptr && progress->cancelled.load(std::memory_order_relaxed))
+			return;
+
+		// Chunks of a subresource are contiguous and start at pixel 0.
+		for (Chunk const& chunk : chunks)
+		{
+			Subresource const& subresource = subresources[chunk.subresourceIndex];
+			MinMaxData::Value* min = minMaxData.min(subresource.mipIndex, subresource.layerIndex);
+			MinMaxData::Value* max = minMaxData.max(subresource.mipIndex, subresource.layerIndex);
+			if (chunk.firstPixel == 0)
+			{
+				std::copy(chunk.min, chunk.min + kernels.channelCount, min);
+				std::copy(chunk.max, chunk.max + kernels.channelCount, max);
+			}
+			else
+				mergeMinMax(minMaxData.type, kernels.channelCount, min, max, chunk.min, chunk.max);
+		}
+	}
+
+	// Returns false if the format isn't supported.
+	static bool FindMinMaxValues_Dispatch(
+		Texas::TextureInfo const& texInfo,
+		Texas::ConstByteSpan byteSpan,
+		MinMaxData& minMaxData,
+		DisplayTarget const* displayTarget,
+		KernelProgress* progress,
+		int maxThreads)
+	{
+		FormatKernels const* kernels = findFormatKernels(texInfo.pixelFormat, texInfo.channelType);
+		if (kernels == nullptr)
+			return false;
+		FindMinMaxValues_Chunked(texInfo, byteSpan, *kernels, minMaxData, displayTarget, progress, maxThreads);
+		return true;
+	}
+
+	void MinMaxData::reset(Type type, std::uint8_t channelCount, std::uint64_t mipCount, std::uint64_t layerCount)
+	{
+		this->type = type;
+		this->channelCount = channelCount;
+		this->mipCount = mipCount;
+		this->layerCount = layerCount;
+		this->values.assign(mipCount * layerCount * channelCount * 2, Value{});
+	}
+
+	void FindMinMaxValues(
+		Texas::TextureInfo texInfo,
+		Texas::ConstByteSpan byteSpan,
+		MinMaxData& minMaxData,
+		KernelProgress* progress,
+		int maxThreads)
+	{
+		FindMinMaxValues_Dispatch(texInfo, byteSpan, minMaxData, nullptr, progress, maxThreads);
+	}
+
+	// QByteArray sizes are ints, larger subresources can only be displayed a tile at a time.
+	[[nodiscard]] static bool fitsInByteArray(std::uint64_t pixelCount)
+	{
+		return pixelCount <= static_cast<std::uint64_t>(std::numeric_limits<int>::max()) / 4;
+	}
+
+	bool FindMinMaxValuesAndBuildDisplayable(
+		Texas::TextureInfo texInfo,
+		Texas::ConstByteSpan byteSpan,
+		MinMaxData& minMaxData,
+		std::uint64_t displayMipIndex,
+		std::uint64_t displayLayerIndex,
+		QByteArray& displayData,
+		KernelProgress* progress,
+		int maxThreads)
+	{
+		Texas::Dimensions mipDimensions = Texas::calculateMipDimensions(texInfo.baseDimensions, displayMipIndex);
+		std::uint64_t pixelCount = mipDimensions.width * mipDimensions.height * mipDimensions.depth;
+		if (!fitsInByteArray(pixelCount))
+		{
+			displayData.clear();
+			FindMinMaxValues_Dispatch(texInfo, byteSpan, minMaxData, nullptr, progress, maxThreads);
+			return false;
+		}
+		displayData = QByteArray(static_cast<int>(pixelCount * 4), Qt::Initialization::Uninitialized);
+
+		DisplayTarget displayTarget{};
+		displayTarget.mipIndex = displayMipIndex;
+		displayTarget.layerIndex = displayLayerIndex;
+		displayTarget.data = (unsigned char*)displayData.data();
+
+		// Formats without statistics, like the block compressed ones, can still have a displayable image.
+		if (!FindMinMaxValues_Dispatch(texInfo, byteSpan, minMaxData, &displayTarget, progress, maxThreads))
+			return BuildDisplayableSubresource(texInfo, byteSpan, displayMipIndex, displayLayerIndex, displayData);
+		return true;
+	}
+
+	bool BuildDisplayableSubresource(
+		Texas::TextureInfo const& texInfo,
+		Texas::ConstByteSpan byteSpan,
+		std::uint64_t mipIndex,
+		std::uint64_t layerIndex,
+		QByteArray& byteArray)
+	{
+		Texas::Dimensions mipDimensions = Texas::calculateMipDimensions(texInfo.baseDimensions, mipIndex);
+		std::uint64_t pixelCount = mipDimensions.width * mipDimensions.height * mipDimensions.depth;
+		unsigned char const* srcData = (unsigned char const*)byteSpan.data() + Texas::calculateLayerOffset(texInfo, mipIndex, layerIndex);
+		if (!fitsInByteArray(pixelCount))
+		{
+			byteArray.clear();
+			return false;
+		}
+
+		// Only the requested subresource is decoded.
+		if (BCn::isBlockCompressed(texInfo.pixelFormat))
+		{
+			byteArray = QByteArray(static_cast<int>(pixelCount * 4), Qt::Initialization::Uninitialized);
+			return BCn::decodeSubresourceToRGBA8(
+				texInfo,
+				byteSpan,
+				mipIndex,
+				layerIndex,
+				(unsigned char*)byteArray.data());
+		}
+
+		FormatKernels const* kernels = findFormatKernels(texInfo.pixelFormat, texInfo.channelType);
+		if (kernels == nullptr)
+		{
+			byteArray.clear();
+			return false;
+		}
+
+		byteArray = QByteArray(static_cast<int>(pixelCount * 4), Qt::Initialization::Uninitialized);
+		kernels->displayable(srcData, pixelCount, (unsigned char*)byteArray.data());
+		return true;
+	}
+}
@@ -0,0 +1,459 @@
+#include "TextureViewport.hpp"
+
+#include "TexasGUI/LatencyRecorder.hpp"
+#include "TexasGUI/TileSource.hpp"
+
+#include <QKeyEvent>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QPaintEvent>
+#include <QScrollBar>
+#include <QWheelEvent>
+
+#include "Texas/Tools.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+namespace TexasGUI
+{
+	constexpr std::uint64_t defaultTileCacheBudget = 128ull * 1024 * 1024;
+	// One notch of a regular mouse wheel.
+	constexpr double wheelZoomStep = 1.25;
+}
+
+TexasGUI::TextureViewport::TextureViewport(QWidget* parent) :
+	QAbstractScrollArea(parent)
+{
+	this->setFocusPolicy(Qt::StrongFocus);
+	this->horizontalScrollBar()->setSingleStep(32);
+	this->verticalScrollBar()->setSingleStep(32);
+	setTileCacheBudget(defaultTileCacheBudget);
+
+	this->scheduler = new TileScheduler(this);
+	QObject::connect(this->scheduler, SIGNAL(tilesFinished()), this, SLOT(tilesFinished()), Qt::QueuedConnection);
+}
+
+void TexasGUI::TextureViewport::setSource(TileSource* source)
+{
+	// Waits for the tiles in flight, nothing reads from the old source after this.
+	this->scheduler->setSource(source);
+	this->source = source;
+	this->sourceFailed = false;
+	this->hasShown = false;
+	this->hasRequested = false;
+	this->waitingSince.start();
+	this->sourceTiles.clear();
+	this->presentationCache.clear();
+	this->requestedMip = 0;
+	this->layerIndex = 0;
+	updateDisplayedMip();
+	updateScrollBars();
+	this->viewport()->update();
+}
+
+void TexasGUI::TextureViewport::setSubresource(std::uint64_t mipIndex, std::uint64_t layerIndex)
+{
+	if (this->source == nullptr)
+		return;
+	Texas::TextureInfo const& texInfo = this->source->textureInfo();
+	mipIndex = std::min<std::uint64_t>(mipIndex, texInfo.mipCount - 1);
+	layerIndex = std::min<std::uint64_t>(layerIndex, texInfo.layerCount - 1);
+	if (mipIndex == this->requestedMip && layerIndex == this->layerIndex)
+		return;
+	this->requestedMip = mipIndex;
+	this->layerIndex = layerIndex;
+	this->sourceFailed = false;
+	this->waitingSince.start();
+	updateDisplayedMip();
+	updateScrollBars();
+	this->viewport()->update();
+}
+
+void TexasGUI::TextureViewport::setScaleToBase(bool scaleToBase)
+{
+	if (scaleToBase == this->scaleMipToBase)
+		return;
+	this->scaleMipToBase = scaleToBase;
+	updateScrollBars();
+	this->viewport()->update();
+}
+
+void TexasGUI::TextureViewport::setAutomaticMip(bool automaticMip)
+{
+	this->automaticMip = automaticMip;
+	updateDisplayedMip();
+	updateScrollBars();
+	this->viewport()->update();
+}
+
+void TexasGUI::TextureViewport::setFloatVisualization(FloatVisualization const& visualization)
+{
+	if (visualization == this->visualization)
+		return;
+	this->visualization = visualization;
+	this->sourceFailed = false;
+	// Not a move to another subresource, so a change of tone mapping isn't timed as one.
+	this->viewport()->update();
+}
+
+double TexasGUI::TextureViewport::zoom() const
+{
+	return this->zoomFactor;
+}
+
+std::uint64_t TexasGUI::TextureViewport::displayedMip() const
+{
+	return this->displayedMipIndex;
+}
+
+void TexasGUI::TextureViewport::setZoom(double zoom, QPoint anchor)
+{
+	zoom = std::clamp(zoom, minZoom, maxZoom);
+	if (zoom == this->zoomFactor)
+		return;
+
+	QPointF const anchoredContent = (QPointF(anchor) - contentOrigin()) / this->zoomFactor;
+	this->zoomFactor = zoom;
+	updateDisplayedMip();
+	updateScrollBars();
+	this->horizontalScrollBar()->setValue(qRound(anchoredContent.x() * zoom - anchor.x()));
+	this->verticalScrollBar()->setValue(qRound(anchoredContent.y() * zoom - anchor.y()));
+	this->viewport()->update();
+	emit zoomChanged(zoom);
+}
+
+void TexasGUI::TextureViewport::fitToWindow()
+{
+	QSizeF const content = contentSize();
+	if (content.isEmpty())
+		return;
+	QSize const viewportSize = this->viewport()->size();
+	double const zoom = std::min(viewportSize.width() / content.width(), viewportSize.height() / content.height());
+	setZoom(zoom, QPoint(viewportSize.width() / 2, viewportSize.height() / 2));
+}
+
+void TexasGUI::TextureViewport::setTileCacheBudget(std::uint64_t bytes)
+{
+	int const kibibytes = static_cast<int>(std::min<std::uint64_t>(bytes / 1024, INT_MAX));
+	this->sourceTiles.setMaxCost(kibibytes);
+	this->presentationCache.setMemoryBudget(bytes);
+}
+
+QSizeF TexasGUI::TextureViewport::contentSize() const
+{
+	if (this->source == nullptr)
+		return QSizeF();
+	Texas::TextureInfo const& texInfo = this->source->textureInfo();
+	std::uint64_t const contentMip = this->scaleMipToBase || this->automaticMip ? 0 : this->requestedMip;
+	Texas::Dimensions const dims = Texas::calculateMipDimensions(texInfo.baseDimensions, contentMip);
+	return QSizeF(dims.width, dims.height);
+}
+
+QPointF TexasGUI::TextureViewport::contentOrigin() const
+{
+	// Content smaller than the viewport is centered, larger content follows the scroll bars.
+	QSizeF const screenSize = contentSize() * this->zoomFactor;
+	QSize const viewportSize = this->viewport()->size();
+	double x = -this->horizontalScrollBar()->value();
+	if (screenSize.width() < viewportSize.width())
+		x = std::floor((viewportSize.width() - screenSize.width()) / 2);
+	double y = -this->verticalScrollBar()->value();
+	if (screenSize.height() < viewportSize.height())
+		y = std::floor((viewportSize.height() - screenSize.height()) / 2);
+	return QPointF(x, y);
+}
+
+void TexasGUI::TextureViewport::updateDisplayedMip()
+{
+	if (this->source == nullptr)
+		return;
+	if (!this->automaticMip)
+	{
+		this->displayedMipIndex = this->requestedMip;
+		return;
+	}
+
+	// Mip level m has 2^-m texels per base level pixel.
+	std::uint64_t const mipCount = this->source->textureInfo().mipCount;
+	std::uint64_t mipIndex = 0;
+	while (mipIndex + 1 < mipCount && std::ldexp(this->zoomFactor, static_cast<int>(mipIndex + 1)) <= 1.0)
+		mipIndex += 1;
+	if (mipIndex != this->displayedMipIndex)
+	{
+		this->displayedMipIndex = mipIndex;
+		this->sourceFailed = false;
+		emit displayedMipChanged(static_cast<int>(mipIndex));
+	}
+}
+
+void TexasGUI::TextureViewport::updateScrollBars()
+{
+	QSizeF const screenSize = contentSize() * this->zoomFactor;
+	QSize const viewportSize = this->viewport()->size();
+	this->horizontalScrollBar()->setPageStep(viewportSize.width());
+	this->horizontalScrollBar()->setRange(0, std::max(0, static_cast<int>(std::ceil(screenSize.width())) - viewportSize.width()));
+	this->verticalScrollBar()->setPageStep(viewportSize.height());
+	this->verticalScrollBar()->setRange(0, std::max(0, static_cast<int>(std::ceil(screenSize.height())) - viewportSize.height()));
+}
+
+void TexasGUI::TextureViewport::tilesFinished()
+{
+	bool showsNewTiles = false;
+	for (TileScheduler::Tile& tile : this->scheduler->takeFinishedTiles())
+	{
+		bool const isDisplayed =
+			tile.mipIndex == this->displayedMipIndex &&
+			tile.layerIndex == this->layerIndex &&
+			tile.visualizationKey == this->visualization.cacheKey();
+		if (tile.image.isNull())
+		{
+			// Read ahead tiles failing doesn't matter until they are actually looked at.
+			if (isDisplayed && !tile.isPrefetch)
+				this->sourceFailed = true;
+			continue;
+		}
+
+		TileKey const key{ tile.mipIndex, tile.layerIndex, tile.tileX, tile.tileY, tile.visualizationKey };
+		int const cost = std::max(1, static_cast<int>(tile.image.sizeInBytes() / 1024));
+		this->sourceTiles.insert(key, new QImage(static_cast<QImage&&>(tile.image)), cost);
+		showsNewTiles = showsNewTiles || isDisplayed;
+	}
+	if (showsNewTiles || this->sourceFailed)
+		this->viewport()->update();
+}
+
+bool TexasGUI::TextureViewport::presentedTile(
+	std::uint64_t mipIndex,
+	std::uint64_t layerIndex,
+	int visualizationKey,
+	std::uint32_t tileX,
+	std::uint32_t tileY,
+	QSize size,
+	QPixmap& pixmap)
+{
+	PresentationKey key{};
+	key.mipIndex = mipIndex;
+	key.layerIndex = layerIndex;
+	key.tileX = tileX;
+	key.tileY = tileY;
+	key.scaleToBase = this->scaleMipToBase;
+	key.visualizationKey = visualizationKey;
+	key.width = size.width();
+	key.height = size.height();
+	if (this->presentationCache.find(key, pixmap))
+		return true;
+
+	// Source tiles only ever come from the scheduler, the GUI thread doesn't read any itself.
+	QImage const* image = this->sourceTiles.object(TileKey{ mipIndex, layerIndex, tileX, tileY, visualizationKey });
+	if (image == nullptr)
+		return false;
+	if (image->size() == size)
+	{
+		// The source tile stays cached, so this is the only conversion it goes through.
+		pixmap = QPixmap::fromImage(*image);
+	}
+	else
+	{
+		// Magnified texels stay sharp so they can be inspected, minified ones are filtered to avoid aliasing.
+		bool const magnifying = size.width() > image->width();
+		QImage scaled = image->scaled(size, Qt::IgnoreAspectRatio, magnifying ? Qt::FastTransformation : Qt::SmoothTransformation);
+		// Nothing else holds on to the scaled image, so the pixmap can take its pixels instead of copying them.
+		pixmap = QPixmap::fromImage(static_cast<QImage&&>(scaled));
+	}
+	this->presentationCache.insert(key, pixmap);
+	return true;
+}
+
+void TexasGUI::TextureViewport::paintEvent(QPaintEvent* event)
+{
+	QPainter painter(this->viewport());
+	painter.fillRect(event->rect(), this->palette().color(QPalette::Window));
+	if (this->source == nullptr)
+		return;
+	if (this->sourceFailed)
+	{
+		painter.drawText(this->viewport()->rect(), Qt::AlignCenter, "Unable to display this texture.");
+		return;
+	}
+	Latency::ScopedStage paintStage(Latency::Stage::Paint);
+
+	Texas::Dimensions const mipDims = Texas::calculateMipDimensions(this->source->textureInfo().baseDimensions, this->displayedMipIndex);
+	QSizeF const content = contentSize();
+	QPointF const origin = contentOrigin();
+	// Screen pixels per texel of the displayed mip.
+	double const scaleX = this->zoomFactor * content.width() / mipDims.width;
+	double const scaleY = this->zoomFactor * content.height() / mipDims.height;
+
+	// Every tile on screen, not just the damaged ones, so the scheduler knows what to read ahead.
+	// The painter clips away whatever isn't damaged.
+	QRect const visible = this->viewport()->rect();
+	double const firstTexelX = std::max(0.0, (visible.left() - origin.x()) / scaleX);
+	double const firstTexelY = std::max(0.0, (visible.top() - origin.y()) / scaleY);
+	double const lastTexelX = (visible.right() + 1 - origin.x()) / scaleX;
+	double const lastTexelY = (visible.bottom() + 1 - origin.y()) / scaleY;
+	if (lastTexelX <= 0 || lastTexelY <= 0)
+		return;
+	std::uint32_t const tileCountX = static_cast<std::uint32_t>((mipDims.width + tileSize - 1) / tileSize);
+	std::uint32_t const tileCountY = static_cast<std::uint32_t>((mipDims.height + tileSize - 1) / tileSize);
+	std::uint32_t const firstTileX = static_cast<std::uint32_t>(firstTexelX / tileSize);
+	std::uint32_t const firstTileY = static_cast<std::uint32_t>(firstTexelY / tileSize);
+	std::uint32_t const tileEndX = std::min(tileCountX, static_cast<std::uint32_t>(lastTexelX / tileSize) + 1);
+	std::uint32_t const tileEndY = std::min(tileCountY, static_cast<std::uint32_t>(lastTexelY / tileSize) + 1);
+
+	// While the tiles of a new subresource are on their way, the last one that was complete stays on screen.
+	bool const canShowPrevious = this->hasShown && this->shownMip == this->displayedMipIndex;
+
+	TileScheduler::Request request{};
+	for (std::uint32_t tileY = firstTileY; tileY < tileEndY; tileY++)
+	{
+		// Both edges of every tile are rounded the same way, so neighbours meet without gaps.
+		int const top = static_cast<int>(std::floor(origin.y() + std::uint64_t(tileY) * tileSize * scaleY));
+		int const bottom = static_cast<int>(std::floor(origin.y() + std::min<std::uint64_t>(std::uint64_t(tileY + 1) * tileSize, mipDims.height) * scaleY));
+		for (std::uint32_t tileX = firstTileX; tileX < tileEndX; tileX++)
+		{
+			int const left = static_cast<int>(std::floor(origin.x() + std::uint64_t(tileX) * tileSize * scaleX));
+			int const right = static_cast<int>(std::floor(origin.x() + std::min<std::uint64_t>(std::uint64_t(tileX + 1) * tileSize, mipDims.width) * scaleX));
+			if (right <= left || bottom <= top)
+				continue;
+			QSize const size(right - left, bottom - top);
+			request.visibleTiles.push_back({ tileX, tileY });
+
+			QPixmap pixmap;
+			if (presentedTile(this->displayedMipIndex, this->layerIndex, this->visualization.cacheKey(), tileX, tileY, size, pixmap))
+			{
+				painter.drawPixmap(left, top, pixmap);
+				continue;
+			}
+			request.tiles.push_back({ tileX, tileY });
+			if (canShowPrevious && presentedTile(this->shownMip, this->shownLayer, this->shownVisualizationKey, tileX, tileY, size, pixmap))
+				painter.drawPixmap(left, top, pixmap);
+		}
+	}
+
+	if (request.tiles.empty())
+	{
+		if (this->waitingSince.isValid())
+		{
+			Latency::record(this->hasShown ? Latency::Stage::SubresourceSwitch : Latency::Stage::FirstPaint, this->waitingSince.nsecsElapsed());
+			this->waitingSince.invalidate();
+		}
+		this->hasShown = true;
+		this->shownMip = this->displayedMipIndex;
+		this->shownLayer = this->layerIndex;
+		this->shownVisualizationKey = this->visualization.cacheKey();
+	}
+
+	// Arriving at a new subresource is worth a request even if it's all cached, that's what starts the read ahead.
+	bool const isNewSubresource =
+		!this->hasRequested ||
+		this->requestedMipIndex != this->displayedMipIndex ||
+		this->requestedLayerIndex != this->layerIndex ||
+		this->requestedVisualizationKey != this->visualization.cacheKey();
+	if (!request.tiles.empty() || isNewSubresource)
+	{
+		this->hasRequested = true;
+		this->requestedMipIndex = this->displayedMipIndex;
+		this->requestedLayerIndex = this->layerIndex;
+		this->requestedVisualizationKey = this->visualization.cacheKey();
+		request.mipIndex = this->displayedMipIndex;
+		request.layerIndex = this->layerIndex;
+		request.visualization = this->visualization;
+		this->scheduler->request(static_cast<TileScheduler::Request&&>(request));
+	}
+}
+
+void TexasGUI::TextureViewport::resizeEvent(QResizeEvent* event)
+{
+	QAbstractScrollArea::resizeEvent(event);
+	updateScrollBars();
+}
+
+void TexasGUI::TextureViewport::scrollContentsBy(int dx, int dy)
+{
+	Q_UNUSED(dx);
+	Q_UNUSED(dy);
+	this->viewport()->update();
+}
+
+void TexasGUI::TextureViewport::wheelEvent(QWheelEvent* event)
+{
+	double const notches = event->angleDelta().y() / 120.0;
+	if (notches == 0)
+	{
+		QAbstractScrollArea::wheelEvent(event);
+		return;
+	}
+	setZoom(this->zoomFactor * std::pow(wheelZoomStep, notches), event->position().toPoint());
+	event->accept();
+}
+
+void TexasGUI::TextureViewport::mousePressEvent(QMouseEvent* event)
+{
+	if (event->button() != Qt::LeftButton)
+	{
+		QAbstractScrollArea::mousePressEvent(event);
+		return;
+	}
+	this->isPanning = true;
+	this->lastPanPosition = event->pos();
+	this->viewport()->setCursor(Qt::ClosedHandCursor);
+}
+
+void TexasGUI::TextureViewport::mouseMoveEvent(QMouseEvent* event)
+{
+	if (!this->isPanning)
+	{
+		QAbstractScrollArea::mouseMoveEvent(event);
+		return;
+	}
+	QPoint const delta = event->pos() - this->lastPanPosition;
+	this->lastPanPosition = event->pos();
+	this->horizontalScrollBar()->setValue(this->horizontalScrollBar()->value() - delta.x());
+	this->verticalScrollBar()->setValue(this->verticalScrollBar()->value() - delta.y());
+}
+
+void TexasGUI::TextureViewport::mouseReleaseEvent(QMouseEvent* event)
+{
+	if (event->button() != Qt::LeftButton || !this->isPanning)
+	{
+		QAbstractScrollArea::mouseReleaseEvent(event);
+		return;
+	}
+	this->isPanning = false;
+	this->viewport()->unsetCursor();
+}
+
+void TexasGUI::TextureViewport::mouseDoubleClickEvent(QMouseEvent* event)
+{
+	// Toggles between 1:1 and the whole texture.
+	if (this->zoomFactor == 1.0)
+		fitToWindow();
+	else
+		setZoom(1.0, event->pos());
+}
+
+void TexasGUI::TextureViewport::keyPressEvent(QKeyEvent* event)
+{
+	QPoint const center(this->viewport()->width() / 2, this->viewport()->height() / 2);
+	switch (event->key())
+	{
+	case Qt::Key_Plus:
+	case Qt::Key_Equal:
+		setZoom(this->zoomFactor * 2, center);
+		break;
+	case Qt::Key_Minus:
+		setZoom(this->zoomFactor / 2, center);
+		break;
+	case Qt::Key_0:
+		setZoom(1.0, center);
+		break;
+	case Qt::Key_F:
+		fitToWindow();
+		break;
+	default:
+		QAbstractScrollArea::keyPressEvent(event);
+		break;
+	}
+}
@@ -0,0 +1,220 @@
+#include "TileScheduler.hpp"
+
+#include "TexasGUI/TileSource.hpp"
+
+#include <QMutexLocker>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include "Texas/Tools.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace TexasGUI
+{
+	struct TileScheduler::Batch
+	{
+		std::uint64_t generation = 0;
+		Request request{};
+		// Read after the request, (mip, layer) pairs nearest first.
+		std::vector<std::pair<std::uint64_t, std::uint64_t>> prefetchTargets{};
+	};
+
+	[[nodiscard]] static bool containsAll(
+		std::vector<std::pair<std::uint32_t, std::uint32_t>> const& tiles,
+		std::vector<std::pair<std::uint32_t, std::uint32_t>> const& subset)
+	{
+		for (auto const& tile : subset)
+		{
+			if (std::find(tiles.begin(), tiles.end(), tile) == tiles.end())
+				return false;
+		}
+		return true;
+	}
+}
+
+TexasGUI::TileScheduler::TileScheduler(QObject* parent) :
+	QObject(parent)
+{
+	this->watcher = new QFutureWatcher<void>(this);
+	QObject::connect(this->watcher, SIGNAL(finished()), this, SLOT(batchFinished()));
+}
+
+TexasGUI::TileScheduler::~TileScheduler()
+{
+	cancel();
+	this->watcher->waitForFinished();
+}
+
+void TexasGUI::TileScheduler::setSource(TileSource* source)
+{
+	cancel();
+	this->watcher->waitForFinished();
+	this->isActive = false;
+	// The last request was for the old texture, it says nothing about where the user goes in this one.
+	this->previousMip = 0;
+	this->previousLayer = 0;
+	this->source = source;
+	QMutexLocker lock(&this->finishedMutex);
+	this->finishedTiles.clear();
+}
+
+void TexasGUI::TileScheduler::request(Request request)
+{
+	if (this->source == nullptr)
+		return;
+
+	// Painting asks again for tiles that haven't arrived yet, that must not restart the batch reading them.
+	bool const sameSubresource =
+		request.mipIndex == this->active.mipIndex &&
+		request.layerIndex == this->active.layerIndex &&
+		request.visualization == this->active.visualization;
+	if (this->isActive && !this->hasPending && sameSubresource && containsAll(this->active.tiles, request.tiles))
+		return;
+
+	this->pending = static_cast<Request&&>(request);
+	this->hasPending = true;
+	if (this->watcher->isRunning())
+	{
+		// The worker sees this before its next tile and returns, batchFinished starts the pending one.
+		this->generation.fetch_add(1);
+		return;
+	}
+	startBatch();
+}
+
+void TexasGUI::TileScheduler::cancel()
+{
+	this->hasPending = false;
+	this->generation.fetch_add(1);
+}
+
+std::vector<TexasGUI::TileScheduler::Tile> TexasGUI::TileScheduler::takeFinishedTiles()
+{
+	QMutexLocker lock(&this->finishedMutex);
+	return static_cast<std::vector<Tile>&&>(this->finishedTiles);
+}
+
+KTX::Region TexasGUI::TileScheduler::tileRegion(
+	Texas::TextureInfo const& texInfo,
+	std::uint64_t mipIndex,
+	std::uint32_t tileX,
+	std::uint32_t tileY)
+{
+	Texas::Dimensions const mipDims = Texas::calculateMipDimensions(texInfo.baseDimensions, mipIndex);
+	KTX::Region region{};
+	region.x = std::uint64_t(tileX) * tileSize;
+	region.y = std::uint64_t(tileY) * tileSize;
+	region.width = std::min<std::uint64_t>(tileSize, mipDims.width - region.x);
+	region.height = std::min<std::uint64_t>(tileSize, mipDims.height - region.y);
+	return region;
+}
+
+void TexasGUI::TileScheduler::batchFinished()
+{
+	this->isActive = false;
+	if (this->hasPending)
+		startBatch();
+}
+
+void TexasGUI::TileScheduler::startBatch()
+{
+	std::shared_ptr<Batch> batch = std::make_shared<Batch>();
+	batch->generation = this->generation.fetch_add(1) + 1;
+	batch->request = static_cast<Request&&>(this->pending);
+	this->hasPending = false;
+
+	// Read ahead in whichever direction the user went last, layers take precedence.
+	Texas::TextureInfo const& texInfo = this->source->textureInfo();
+	std::uint64_t const mipIndex = batch->request.mipIndex;
+	std::uint64_t const layerIndex = batch->request.layerIndex;
+	if (layerIndex != this->previousLayer && mipIndex == this->previousMip)
+	{
+		bool const forwards = layerIndex > this->previousLayer;
+		for (std::uint64_t step = 1; step <= prefetchDepth; step++)
+		{
+			if (forwards && layerIndex + step < texInfo.layerCount)
+				batch->prefetchTargets.push_back({ mipIndex, layerIndex + step });
+			else if (!forwards && layerIndex >= step)
+				batch->prefetchTargets.push_back({ mipIndex, layerIndex - step });
+		}
+	}
+	else if (mipIndex > this->previousMip)
+	{
+		for (std::uint64_t step = 1; step <= prefetchDepth && mipIndex + step < texInfo.mipCount; step++)
+			batch->prefetchTargets.push_back({ mipIndex + step, layerIndex });
+	}
+	this->previousMip = mipIndex;
+	this->previousLayer = layerIndex;
+
+	this->active.mipIndex = batch->request.mipIndex;
+	this->active.layerIndex = batch->request.layerIndex;
+	this->active.visualization = batch->request.visualization;
+	this->active.tiles = batch->request.tiles;
+	this->isActive = true;
+	this->watcher->setFuture(QtConcurrent::run(this, &TileScheduler::runBatch, batch));
+}
+
+void TexasGUI::TileScheduler::runBatch(std::shared_ptr<Batch> batch)
+{
+	Texas::TextureInfo const& texInfo = this->source->textureInfo();
+	Request const& request = batch->request;
+
+	auto readTile = [&](std::uint64_t mipIndex, std::uint64_t layerIndex, std::uint32_t tileX, std::uint32_t tileY, bool isPrefetch)
+	{
+		Tile tile{};
+		tile.mipIndex = mipIndex;
+		tile.layerIndex = layerIndex;
+		tile.visualizationKey = request.visualization.cacheKey();
+		tile.tileX = tileX;
+		tile.tileY = tileY;
+		tile.isPrefetch = isPrefetch;
+
+		// Tiles past the edge of a smaller mip level don't exist.
+		Texas::Dimensions const mipDims = Texas::calculateMipDimensions(texInfo.baseDimensions, mipIndex);
+		if (std::uint64_t(tileX) * tileSize >= mipDims.width || std::uint64_t(tileY) * tileSize >= mipDims.height)
+			return;
+
+		KTX::Region const region = tileRegion(texInfo, mipIndex, tileX, tileY);
+		QByteArray rgba;
+		if (this->source->readTile(mipIndex, layerIndex, region, request.visualization, isPrefetch, rgba))
+		{
+			tile.image = QImage(static_cast<int>(region.width), static_cast<int>(region.height), QImage::Format::Format_RGBA8888);
+			for (int row = 0; row < tile.image.height(); row++)
+				std::memcpy(tile.image.scanLine(row), rgba.constData() + row * region.width * 4, region.width * 4);
+		}
+
+		bool wasEmpty = false;
+		{
+			QMutexLocker lock(&this->finishedMutex);
+			wasEmpty = this->finishedTiles.empty();
+			this->finishedTiles.push_back(static_cast<Tile&&>(tile));
+		}
+		// One notification is enough for everything that piles up before the GUI thread gets to it.
+		if (wasEmpty)
+			emit tilesFinished();
+	};
+
+	for (auto const& [tileX, tileY] : request.tiles)
+	{
+		if (this->generation.load() != batch->generation)
+			return;
+		readTile(request.mipIndex, request.layerIndex, tileX, tileY, false);
+	}
+	for (auto const& [mipIndex, layerIndex] : batch->prefetchTargets)
+	{
+		// Smaller mip levels cover less, so the visible tile coordinates shrink with them.
+		int const mipShift = static_cast<int>(mipIndex - request.mipIndex);
+		std::vector<std::pair<std::uint32_t, std::uint32_t>> readTiles;
+		for (auto const& [tileX, tileY] : request.visibleTiles)
+		{
+			if (this->generation.load() != batch->generation)
+				return;
+			std::pair<std::uint32_t, std::uint32_t> const tile{ tileX >> mipShift, tileY >> mipShift };
+			if (std::find(readTiles.begin(), readTiles.end(), tile) != readTiles.end())
+				continue;
+			readTiles.push_back(tile);
+			readTile(mipIndex, layerIndex, tile.first, tile.second, true);
+		}
+	}
+}
@@ -0,0 +1,190 @@
+#include "TexasGUI/TileSource.hpp"
+
+#include "TexasGUI/DisplayCache.hpp"
+#include "TexasGUI/KTXFormat.hpp"
+
+#include "Texas/Tools.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+TexasGUI::FloatRange TexasGUI::TileSource::floatRange(std::uint64_t mipIndex, std::uint64_t layerIndex)
+{
+	std::pair<std::uint64_t, std::uint64_t> const key{ mipIndex, layerIndex };
+	{
+		std::lock_guard<std::mutex> lock(this->floatRangeMutex);
+		auto iter = this->floatRanges.find(key);
+		if (iter != this->floatRanges.end())
+			return iter->second;
+	}
+
+	// Not holding the lock, this is a whole pass over the subresource.
+	FloatRange const range = computeFloatRange(mipIndex, layerIndex);
+	std::lock_guard<std::mutex> lock(this->floatRangeMutex);
+	this->floatRanges.emplace(key, range);
+	return range;
+}
+
+TexasGUI::DisplayCacheTileSource::DisplayCacheTileSource(
+	Texas::TextureInfo const& texInfo,
+	Texas::ConstByteSpan byteSpan,
+	DisplayCache& displayCache) :
+	texInfo(texInfo),
+	byteSpan(byteSpan),
+	displayCache(&displayCache)
+{
+}
+
+Texas::TextureInfo const& TexasGUI::DisplayCacheTileSource::textureInfo() const noexcept
+{
+	return this->texInfo;
+}
+
+bool TexasGUI::DisplayCacheTileSource::readTile(
+	std::uint64_t mipIndex,
+	std::uint64_t layerIndex,
+	KTX::Region const& region,
+	FloatVisualization const& visualization,
+	bool isPrefetch,
+	QByteArray& rgba)
+{
+	if (isFloatFormat(this->texInfo))
+	{
+		FloatRange range{};
+		if (visualization.mode == FloatVisualizationMode::Remap)
+			range = floatRange(mipIndex, layerIndex);
+		std::byte const* slice = this->byteSpan.data() + Texas::calculateLayerOffset(this->texInfo, mipIndex, layerIndex);
+		std::uint64_t const rowPitch = KTX::subresourceLayout(this->texInfo, mipIndex).rowSize;
+		return visualizeFloatRegion(this->texInfo, slice, rowPitch, region, visualization, range, rgba);
+	}
+
+	QByteArray subresource = isPrefetch ?
+		this->displayCache->prefetch(mipIndex, layerIndex) :
+		this->displayCache->get(mipIndex, layerIndex);
+	if (subresource.isEmpty())
+		return false;
+
+	Texas::Dimensions const mipDims = Texas::calculateMipDimensions(this->texInfo.baseDimensions, mipIndex);
+	std::uint64_t const srcPitch = mipDims.width * 4;
+	std::uint64_t const dstPitch = region.width * 4;
+	rgba = QByteArray(static_cast<int>(dstPitch * region.height), Qt::Initialization::Uninitialized);
+	for (std::uint64_t row = 0; row < region.height; row++)
+	{
+		std::memcpy(
+			rgba.data() + row * dstPitch,
+			subresource.constData() + (region.y + row) * srcPitch + region.x * 4,
+			dstPitch);
+	}
+	return true;
+}
+
+TexasGUI::FloatRange TexasGUI::DisplayCacheTileSource::computeFloatRange(std::uint64_t mipIndex, std::uint64_t layerIndex)
+{
+	Texas::Dimensions const mipDims = Texas::calculateMipDimensions(this->texInfo.baseDimensions, mipIndex);
+	KTX::Region region{};
+	region.width = mipDims.width;
+	region.height = mipDims.height;
+	std::byte const* slice = this->byteSpan.data() + Texas::calculateLayerOffset(this->texInfo, mipIndex, layerIndex);
+	FloatRange range{};
+	findFloatRange(this->texInfo, slice, KTX::subresourceLayout(this->texInfo, mipIndex).rowSize, region, range);
+	return range;
+}
+
+TexasGUI::KTXTileSource::KTXTileSource(KTX::TiledReader const& reader) :
+	reader(&reader)
+{
+}
+
+Texas::TextureInfo const& TexasGUI::KTXTileSource::textureInfo() const noexcept
+{
+	return this->reader->textureInfo();
+}
+
+bool TexasGUI::KTXTileSource::readTile(
+	std::uint64_t mipIndex,
+	std::uint64_t layerIndex,
+	KTX::Region const& region,
+	FloatVisualization const& visualization,
+	bool,
+	QByteArray& rgba)
+{
+	Texas::TextureInfo const& texInfo = this->reader->textureInfo();
+	if (!isFloatFormat(texInfo))
+		return this->reader->readDisplayRegion(mipIndex, layerIndex, region, rgba);
+
+	FloatRange range{};
+	if (visualization.mode == FloatVisualizationMode::Remap)
+		range = floatRange(mipIndex, layerIndex);
+
+	KTX::Region readArea = region;
+	std::vector<std::byte> data;
+	if (!this->reader->readRegion(mipIndex, layerIndex, readArea, data))
+		return false;
+
+	// readArea may have grown to whole blocks, region is cropped back out of it.
+	KTX::Region localRegion = region;
+	localRegion.x = region.x - readArea.x;
+	localRegion.y = region.y - readArea.y;
+	localRegion.z = 0;
+	return visualizeFloatRegion(texInfo, data.data(), KTX::packedRowSize(texInfo.pixelFormat, readArea.width), localRegion, visualization, range, rgba);
+}
+
+TexasGUI::FloatRange TexasGUI::KTXTileSource::computeFloatRange(std::uint64_t mipIndex, std::uint64_t layerIndex)
+{
+	// A multiple of the block height, so strips of block compressed formats don't overlap.
+	constexpr std::uint64_t stripHeight = 64;
+
+	Texas::TextureInfo const& texInfo = this->reader->textureInfo();
+	Texas::Dimensions const mipDims = Texas::calculateMipDimensions(texInfo.baseDimensions, mipIndex);
+	FloatRange range{};
+	std::vector<std::byte> data;
+	for (std::uint64_t y = 0; y < mipDims.height; y += stripHeight)
+	{
+		KTX::Region strip{};
+		strip.y = y;
+		strip.width = mipDims.width;
+		strip.height = std::min(stripHeight, mipDims.height - y);
+		if (!this->reader->readRegion(mipIndex, layerIndex, strip, data))
+			break;
+
+		KTX::Region localStrip = strip;
+		localStrip.y = 0;
+		findFloatRange(texInfo, data.data(), KTX::packedRowSize(texInfo.pixelFormat, strip.width), localStrip, range);
+	}
+	return range;
+}
+
+TexasGUI::DiffHeatmapTileSource::DiffHeatmapTileSource(Compare::Input const& a, Compare::Input const& b, float maxError) :
+	a(a),
+	b(b),
+	maxError(maxError),
+	texInfo(a.texInfo)
+{
+	this->texInfo.pixelFormat = Texas::PixelFormat::RGBA_8;
+	this->texInfo.channelType = Texas::ChannelType::UnsignedNormalized;
+	this->texInfo.colorSpace = Texas::ColorSpace::sRGB;
+	this->texInfo.mipCount = Compare::comparedMipCount(a.texInfo, b.texInfo);
+	this->texInfo.layerCount = Compare::comparedLayerCount(a.texInfo, b.texInfo);
+}
+
+Texas::TextureInfo const& TexasGUI::DiffHeatmapTileSource::textureInfo() const noexcept
+{
+	return this->texInfo;
+}
+
+bool TexasGUI::DiffHeatmapTileSource::readTile(
+	std::uint64_t mipIndex,
+	std::uint64_t layerIndex,
+	KTX::Region const& region,
+	FloatVisualization const&,
+	bool,
+	QByteArray& rgba)
+{
+	return Compare::buildDiffHeatmap(this->a, this->b, mipIndex, layerIndex, region, this->maxError, rgba);
+}
+
+TexasGUI::FloatRange TexasGUI::DiffHeatmapTileSource::computeFloatRange(std::uint64_t, std::uint64_t)
+{
+	return FloatRange{};
+}